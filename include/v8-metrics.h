@@ -48,13 +48,27 @@ struct WasmModulesPerIsolate {
   size_t count = 0;
 };
 
+// Reported for each module after wasm code GC freed some of its code.
+struct WasmModuleCodeSpaceUsage {
+  size_t code_space_count = 0;
+  size_t committed_code_space_in_bytes = 0;
+  size_t live_code_size_in_bytes = 0;
+  size_t freed_code_size_in_bytes = 0;
+  // Committed code space which does not hold live code.
+  size_t fragmented_code_space_in_bytes = 0;
+  // Code which was moved by code-space compaction in response to this GC.
+  size_t relocated_code_size_in_bytes = 0;
+};
+
 #define V8_MAIN_THREAD_METRICS_EVENTS(V) \
   V(WasmModuleDecoded)                   \
   V(WasmModuleCompiled)                  \
   V(WasmModuleInstantiated)              \
   V(WasmModuleTieredUp)
 
-#define V8_THREAD_SAFE_METRICS_EVENTS(V) V(WasmModulesPerIsolate)
+#define V8_THREAD_SAFE_METRICS_EVENTS(V) \
+  V(WasmModulesPerIsolate)              \
+  V(WasmModuleCodeSpaceUsage)
 
 /**
  * This class serves as a base class for recording event-based metrics in V8.
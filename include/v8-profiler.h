@@ -8,6 +8,7 @@
 #include <limits.h>
 
 #include <memory>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -1098,6 +1099,50 @@ class V8_EXPORT CodeEventHandler {
   void* internal_listener_;
 };
 
+/**
+ * Execution statistics of the regular expressions with a given source and
+ * flags, see RegExpProfiler::GetStatistics.
+ */
+struct RegExpStatistics {
+  std::string source;  // UTF-8.
+  RegExp::Flags flags;
+  // The number of times an engine was run.  This is not the number of
+  // matches: global regular expressions find their matches in batches, and
+  // each batch counts as one execution.
+  uint64_t executions;
+  // The number of executions started on each engine.
+  uint64_t atom_executions;
+  uint64_t interpreted_executions;
+  uint64_t native_code_executions;
+  uint64_t experimental_executions;
+  double total_time_ms;
+  // Only counted for interpreted executions.
+  uint64_t backtracks;
+  // Executions that exceeded the backtrack limit and fell back to the
+  // linear-time engine.
+  uint64_t backtrack_limit_fallbacks;
+};
+
+/**
+ * Access to the execution statistics of regular expressions, which are only
+ * collected if V8 runs with --regexp-stats.  They are meant to find regular
+ * expressions that take a lot of time or backtrack excessively.
+ */
+class V8_EXPORT RegExpProfiler {
+ public:
+  /**
+   * Returns the statistics of the regular expressions executed in |isolate|
+   * so far, ordered by total time, most first.  Empty if the statistics
+   * aren't collected.
+   */
+  static std::vector<RegExpStatistics> GetStatistics(Isolate* isolate);
+
+  /**
+   * Discards the statistics collected so far in |isolate|.
+   */
+  static void ResetStatistics(Isolate* isolate);
+};
+
 }  // namespace v8
 
 
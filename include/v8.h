@@ -4966,10 +4966,20 @@ class V8_EXPORT CompiledWasmModule {
  public:
   /**
    * Serialize the compiled module. The serialized data does not include the
-   * wire bytes.
+   * wire bytes. Functions which were not compiled yet are compiled lazily
+   * after deserialization.
    */
   OwnedBuffer Serialize();
 
+  /**
+   * Serialize the compiled module like |Serialize|, but keep the code of
+   * functions in |previous| (the result of an earlier serialization of the same
+   * module) for which this module has no code of the same quality. This allows
+   * to grow an existing cache entry over the lifetime of the module. If
+   * |previous| cannot be used, this is equivalent to |Serialize|.
+   */
+  OwnedBuffer SerializeAndMerge(MemorySpan<const uint8_t> previous);
+
   /**
    * Get the (wasm-encoded) wire bytes that were used to compile this module.
    */
@@ -7893,6 +7903,27 @@ class V8_EXPORT HeapCodeStatistics {
   friend class Isolate;
 };
 
+/**
+ * Statistics about the megamorphic stub caches of an isolate, which map
+ * (map, name) pairs to property access handlers for loads and stores.
+ */
+class V8_EXPORT StubCacheStatistics {
+ public:
+  StubCacheStatistics();
+  size_t load_lookups() { return load_lookups_; }
+  size_t load_misses() { return load_misses_; }
+  size_t store_lookups() { return store_lookups_; }
+  size_t store_misses() { return store_misses_; }
+
+ private:
+  size_t load_lookups_;
+  size_t load_misses_;
+  size_t store_lookups_;
+  size_t store_misses_;
+
+  friend class Isolate;
+};
+
 /**
  * A JIT code event is issued each time code is added, moved or removed.
  *
@@ -8901,6 +8932,15 @@ class V8_EXPORT Isolate {
    */
   bool GetHeapCodeAndMetadataStatistics(HeapCodeStatistics* object_statistics);
 
+  /**
+   * Get the number of lookups in the megamorphic stub caches, and how many of
+   * them missed, since the isolate was created.
+   *
+   * \param stub_cache_statistics The StubCacheStatistics object to fill in.
+   * \returns true on success.
+   */
+  bool GetStubCacheStatistics(StubCacheStatistics* stub_cache_statistics);
+
   /**
    * This API is experimental and may change significantly.
    *
@@ -54,6 +54,7 @@
 #include "src/handles/persistent-handles.h"
 #include "src/heap/embedder-tracing.h"
 #include "src/heap/heap-inl.h"
+#include "src/ic/stub-cache.h"
 #include "src/init/bootstrapper.h"
 #include "src/init/icu_util.h"
 #include "src/init/startup-data-util.h"
@@ -101,6 +102,7 @@
 #include "src/profiler/heap-snapshot-generator-inl.h"
 #include "src/profiler/profile-generator-inl.h"
 #include "src/profiler/tick-sample.h"
+#include "src/regexp/regexp-stats.h"
 #include "src/regexp/regexp-utils.h"
 #include "src/runtime/runtime.h"
 #include "src/snapshot/code-serializer.h"
@@ -5991,6 +5993,9 @@ HeapCodeStatistics::HeapCodeStatistics()
       bytecode_and_metadata_size_(0),
       external_script_source_size_(0) {}
 
+StubCacheStatistics::StubCacheStatistics()
+    : load_lookups_(0), load_misses_(0), store_lookups_(0), store_misses_(0) {}
+
 bool v8::V8::InitializeICU(const char* icu_data_file) {
   return i::InitializeICU(icu_data_file);
 }
@@ -7503,6 +7508,18 @@ OwnedBuffer CompiledWasmModule::Serialize() {
   return {std::move(buffer), buffer_size};
 }
 
+OwnedBuffer CompiledWasmModule::SerializeAndMerge(
+    MemorySpan<const uint8_t> previous) {
+  TRACE_EVENT0("v8.wasm", "wasm.SerializeModule");
+  i::wasm::WasmSerializer wasm_serializer(native_module_.get());
+  wasm_serializer.MergeWith({previous.data(), previous.size()});
+  size_t buffer_size = wasm_serializer.GetSerializedNativeModuleSize();
+  std::unique_ptr<uint8_t[]> buffer(new uint8_t[buffer_size]);
+  if (!wasm_serializer.SerializeNativeModule({buffer.get(), buffer_size}))
+    return {};
+  return {std::move(buffer), buffer_size};
+}
+
 MemorySpan<const uint8_t> CompiledWasmModule::GetWireBytesRef() {
   i::Vector<const uint8_t> bytes_vec = native_module_->wire_bytes();
   return {bytes_vec.begin(), bytes_vec.size()};
@@ -8876,6 +8893,21 @@ bool Isolate::GetHeapCodeAndMetadataStatistics(
   return true;
 }
 
+bool Isolate::GetStubCacheStatistics(
+    StubCacheStatistics* stub_cache_statistics) {
+  if (!stub_cache_statistics) return false;
+
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(this);
+  i::StubCache* load_stub_cache = isolate->load_stub_cache();
+  i::StubCache* store_stub_cache = isolate->store_stub_cache();
+
+  stub_cache_statistics->load_lookups_ = load_stub_cache->lookup_count();
+  stub_cache_statistics->load_misses_ = load_stub_cache->miss_count();
+  stub_cache_statistics->store_lookups_ = store_stub_cache->lookup_count();
+  stub_cache_statistics->store_misses_ = store_stub_cache->miss_count();
+  return true;
+}
+
 v8::MaybeLocal<v8::Promise> Isolate::MeasureMemory(
     v8::Local<v8::Context> context, MeasureMemoryMode mode) {
   return v8::MaybeLocal<v8::Promise>();
@@ -11003,6 +11035,41 @@ void CodeEventHandler::Disable() {
       ->StopListening();
 }
 
+std::vector<RegExpStatistics> RegExpProfiler::GetStatistics(Isolate* isolate) {
+  i::Isolate* i_isolate = reinterpret_cast<i::Isolate*>(isolate);
+  std::vector<RegExpStatistics> result;
+  if (i_isolate->regexp_stats() == nullptr) return result;
+
+  using Engine = i::RegExpStats::Engine;
+  for (const i::RegExpStats::Entry& entry :
+       i_isolate->regexp_stats()->SortedEntries()) {
+    RegExpStatistics stats;
+    stats.source = entry.source;
+    stats.flags = static_cast<RegExp::Flags>(static_cast<int>(entry.flags));
+    stats.executions = entry.executions;
+    stats.atom_executions =
+        entry.executions_per_engine[static_cast<int>(Engine::kAtom)];
+    stats.interpreted_executions =
+        entry.executions_per_engine[static_cast<int>(Engine::kBytecode)];
+    stats.native_code_executions =
+        entry.executions_per_engine[static_cast<int>(Engine::kNativeCode)];
+    stats.experimental_executions =
+        entry.executions_per_engine[static_cast<int>(Engine::kExperimental)];
+    stats.total_time_ms = entry.total_time.InMillisecondsF();
+    stats.backtracks = entry.backtracks;
+    stats.backtrack_limit_fallbacks = entry.backtrack_limit_fallbacks;
+    result.push_back(std::move(stats));
+  }
+  return result;
+}
+
+void RegExpProfiler::ResetStatistics(Isolate* isolate) {
+  i::Isolate* i_isolate = reinterpret_cast<i::Isolate*>(isolate);
+  if (i_isolate->regexp_stats() != nullptr) {
+    i_isolate->regexp_stats()->Reset();
+  }
+}
+
 static i::HeapGraphEdge* ToInternal(const HeapGraphEdge* edge) {
   return const_cast<i::HeapGraphEdge*>(
       reinterpret_cast<const i::HeapGraphEdge*>(edge));
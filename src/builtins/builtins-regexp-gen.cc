@@ -416,6 +416,14 @@ TNode<HeapObject> RegExpBuiltinsAssembler::RegExpExecInternal(
 
   GotoIf(UintPtrGreaterThan(int_last_index, int_string_length), &if_failure);
 
+  // Executions are recorded in the runtime if --regexp-stats is set.
+  TNode<Word32T> regexp_stats_flag = UncheckedCast<Word32T>(Load(
+      MachineType::Uint8(),
+      ExternalConstant(ExternalReference::address_of_regexp_stats_flag())));
+  GotoIfNot(Word32Equal(Word32And(regexp_stats_flag, Int32Constant(0xFF)),
+                        Int32Constant(0)),
+            &runtime);
+
   // Since the RegExp has been compiled, data contains a fixed array.
   TNode<FixedArray> data = CAST(LoadObjectField(regexp, JSRegExp::kDataOffset));
   {
@@ -515,6 +523,40 @@ TNode<HeapObject> RegExpBuiltinsAssembler::RegExpExecInternal(
   GotoIf(TaggedIsSmi(var_code.value()), &runtime);
   TNode<Code> code = CAST(var_code.value());
 
+  // Skip to the first position at which one of the leading literals of the
+  // regexp occurs, or fail if there is none (see RegExpPrefilter).
+  TVARIABLE(IntPtrT, var_last_index, int_last_index);
+  {
+    Label next(this);
+    TNode<Object> prefilter = UnsafeLoadFixedArrayElement(
+        data, JSRegExp::kIrregexpPrefilterIndex);
+    GotoIf(TaggedIsSmi(prefilter), &next);
+
+    TNode<BoolT> is_one_byte =
+        IsOneByteStringInstanceType(to_direct.instance_type());
+    TNode<ExternalReference> find_candidate =
+        ExternalConstant(ExternalReference::re_find_prefilter_candidate());
+    TNode<Int32T> candidate = UncheckedCast<Int32T>(CallCFunction(
+        find_candidate, MachineType::Int32(),
+        std::make_pair(MachineType::AnyTagged(), prefilter),
+        std::make_pair(MachineType::Pointer(), var_string_start.value()),
+        std::make_pair(MachineType::Pointer(), var_string_end.value()),
+        std::make_pair(MachineType::Int32(),
+                       SelectInt32Constant(is_one_byte, 1, 0))));
+    GotoIf(Int32LessThan(candidate, Int32Constant(0)), &if_failure);
+
+    TNode<IntPtrT> offset = ChangeInt32ToIntPtr(candidate);
+    var_last_index = IntPtrAdd(int_last_index, offset);
+    var_string_start = RawPtrAdd(
+        var_string_start.value(),
+        Select<IntPtrT>(
+            is_one_byte, [=] { return offset; },
+            [=] { return WordShl(offset, IntPtrConstant(1)); }));
+    Goto(&next);
+
+    BIND(&next);
+  }
+
   Label if_success(this), if_exception(this, Label::kDeferred);
   {
     IncrementCounter(isolate()->counters()->regexp_entry_native(), 1);
@@ -534,7 +576,7 @@ TNode<HeapObject> RegExpBuiltinsAssembler::RegExpExecInternal(
 
     // Argument 1: Previous index.
     MachineType arg1_type = type_int32;
-    TNode<Int32T> arg1 = TruncateIntPtrToInt32(int_last_index);
+    TNode<Int32T> arg1 = TruncateIntPtrToInt32(var_last_index.value());
 
     // Argument 2: Start of string data. This argument is ignored in the
     // interpreter.
@@ -1428,8 +1470,6 @@ TNode<JSArray> RegExpBuiltinsAssembler::RegExpPrototypeSplitBody(
   CSA_ASSERT(this, IsFastRegExpPermissive(context, regexp));
   CSA_ASSERT(this, Word32BinaryNot(FastFlagGetter(regexp, JSRegExp::kSticky)));
 
-  const TNode<IntPtrT> int_limit = SmiUntag(limit);
-
   const ElementsKind kind = PACKED_ELEMENTS;
 
   const TNode<NativeContext> native_context = LoadNativeContext(context);
@@ -1485,162 +1525,11 @@ TNode<JSArray> RegExpBuiltinsAssembler::RegExpPrototypeSplitBody(
     BIND(&next);
   }
 
-  // Loop preparations.
-
-  GrowableFixedArray array(state());
-
-  TVARIABLE(Smi, var_last_matched_until, SmiZero());
-  TVARIABLE(Smi, var_next_search_from, SmiZero());
-
-  Label loop(this, {array.var_array(), array.var_length(), array.var_capacity(),
-                    &var_last_matched_until, &var_next_search_from}),
-      push_suffix_and_out(this), out(this);
-  Goto(&loop);
-
-  BIND(&loop);
-  {
-    const TNode<Smi> next_search_from = var_next_search_from.value();
-    const TNode<Smi> last_matched_until = var_last_matched_until.value();
-
-    // We're done if we've reached the end of the string.
-    {
-      Label next(this);
-      Branch(SmiEqual(next_search_from, string_length), &push_suffix_and_out,
-             &next);
-      BIND(&next);
-    }
-
-    // Search for the given {regexp}.
-
-    const TNode<Object> last_match_info = LoadContextElement(
-        native_context, Context::REGEXP_LAST_MATCH_INFO_INDEX);
-
-    const TNode<HeapObject> match_indices_ho =
-        CAST(CallBuiltin(Builtins::kRegExpExecInternal, context, regexp, string,
-                         next_search_from, last_match_info));
-
-    // We're done if no match was found.
-    {
-      Label next(this);
-      Branch(IsNull(match_indices_ho), &push_suffix_and_out, &next);
-      BIND(&next);
-    }
-
-    TNode<FixedArray> match_indices = CAST(match_indices_ho);
-    const TNode<Smi> match_from = CAST(UnsafeLoadFixedArrayElement(
-        match_indices, RegExpMatchInfo::kFirstCaptureIndex));
-
-    // We're done if the match starts beyond the string.
-    {
-      Label next(this);
-      Branch(SmiEqual(match_from, string_length), &push_suffix_and_out, &next);
-      BIND(&next);
-    }
-
-    const TNode<Smi> match_to = CAST(UnsafeLoadFixedArrayElement(
-        match_indices, RegExpMatchInfo::kFirstCaptureIndex + 1));
-
-    // Advance index and continue if the match is empty.
-    {
-      Label next(this);
-
-      GotoIfNot(SmiEqual(match_to, next_search_from), &next);
-      GotoIfNot(SmiEqual(match_to, last_matched_until), &next);
-
-      const TNode<BoolT> is_unicode =
-          FastFlagGetter(regexp, JSRegExp::kUnicode);
-      const TNode<Number> new_next_search_from =
-          AdvanceStringIndex(string, next_search_from, is_unicode, true);
-      var_next_search_from = CAST(new_next_search_from);
-      Goto(&loop);
-
-      BIND(&next);
-    }
-
-    // A valid match was found, add the new substring to the array.
-    {
-      const TNode<Smi> from = last_matched_until;
-      const TNode<Smi> to = match_from;
-      array.Push(CallBuiltin(Builtins::kSubString, context, string, from, to));
-      GotoIf(WordEqual(array.length(), int_limit), &out);
-    }
-
-    // Add all captures to the array.
-    {
-      const TNode<Smi> num_registers = CAST(LoadFixedArrayElement(
-          match_indices, RegExpMatchInfo::kNumberOfCapturesIndex));
-      const TNode<IntPtrT> int_num_registers = SmiUntag(num_registers);
-
-      TVARIABLE(IntPtrT, var_reg, IntPtrConstant(2));
-
-      Label nested_loop(this, {array.var_array(), array.var_length(),
-                               array.var_capacity(), &var_reg}),
-          nested_loop_out(this);
-      Branch(IntPtrLessThan(var_reg.value(), int_num_registers), &nested_loop,
-             &nested_loop_out);
-
-      BIND(&nested_loop);
-      {
-        const TNode<IntPtrT> reg = var_reg.value();
-        const TNode<Object> from = LoadFixedArrayElement(
-            match_indices, reg,
-            RegExpMatchInfo::kFirstCaptureIndex * kTaggedSize);
-        const TNode<Smi> to = CAST(LoadFixedArrayElement(
-            match_indices, reg,
-            (RegExpMatchInfo::kFirstCaptureIndex + 1) * kTaggedSize));
-
-        Label select_capture(this), select_undefined(this), store_value(this);
-        TVARIABLE(Object, var_value);
-        Branch(SmiEqual(to, SmiConstant(-1)), &select_undefined,
-               &select_capture);
-
-        BIND(&select_capture);
-        {
-          var_value =
-              CallBuiltin(Builtins::kSubString, context, string, from, to);
-          Goto(&store_value);
-        }
-
-        BIND(&select_undefined);
-        {
-          var_value = UndefinedConstant();
-          Goto(&store_value);
-        }
-
-        BIND(&store_value);
-        {
-          array.Push(var_value.value());
-          GotoIf(WordEqual(array.length(), int_limit), &out);
-
-          const TNode<IntPtrT> new_reg = IntPtrAdd(reg, IntPtrConstant(2));
-          var_reg = new_reg;
-
-          Branch(IntPtrLessThan(new_reg, int_num_registers), &nested_loop,
-                 &nested_loop_out);
-        }
-      }
-
-      BIND(&nested_loop_out);
-    }
-
-    var_last_matched_until = match_to;
-    var_next_search_from = match_to;
-    Goto(&loop);
-  }
-
-  BIND(&push_suffix_and_out);
-  {
-    const TNode<Smi> from = var_last_matched_until.value();
-    const TNode<Smi> to = string_length;
-    array.Push(CallBuiltin(Builtins::kSubString, context, string, from, to));
-    Goto(&out);
-  }
-
-  BIND(&out);
-  {
-    var_result = array.ToJSArray(context);
-    Goto(&done);
-  }
+  // The matches are iterated over in the runtime, which batches them where
+  // possible and allocates the result array with its final length.
+  var_result = CAST(CallRuntime(Runtime::kRegExpSplitUnmodified, context,
+                                regexp, string, limit));
+  Goto(&done);
 
   BIND(&return_empty_array);
   {
@@ -60,6 +60,14 @@ const char* const
         "Store StubCache::secondary_->key",
         "Store StubCache::secondary_->value",
         "Store StubCache::secondary_->map",
+        "Load StubCache::primary_mask_",
+        "Load StubCache::secondary_mask_",
+        "Store StubCache::primary_mask_",
+        "Store StubCache::secondary_mask_",
+        "Load StubCache::lookup_count_",
+        "Load StubCache::miss_count_",
+        "Store StubCache::lookup_count_",
+        "Store StubCache::miss_count_",
         // Native code counters:
         STATS_COUNTER_NATIVE_CODE_LIST(ADD_STATS_COUNTER_NAME)
 };
@@ -235,6 +243,19 @@ void ExternalReferenceTable::AddStubCache(Isolate* isolate, int* index) {
       index);
   Add(store_stub_cache->map_reference(StubCache::kSecondary).address(), index);
 
+  // Stub cache table masks
+  Add(load_stub_cache->mask_reference(StubCache::kPrimary).address(), index);
+  Add(load_stub_cache->mask_reference(StubCache::kSecondary).address(), index);
+  Add(store_stub_cache->mask_reference(StubCache::kPrimary).address(), index);
+  Add(store_stub_cache->mask_reference(StubCache::kSecondary).address(),
+      index);
+
+  // Stub cache statistics
+  Add(load_stub_cache->lookup_count_reference().address(), index);
+  Add(load_stub_cache->miss_count_reference().address(), index);
+  Add(store_stub_cache->lookup_count_reference().address(), index);
+  Add(store_stub_cache->miss_count_reference().address(), index);
+
   CHECK_EQ(kSpecialReferenceCount + kExternalReferenceCount +
                kBuiltinsReferenceCount + kRuntimeReferenceCount +
                kIsolateAddressReferenceCount + kAccessorReferenceCount +
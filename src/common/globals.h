@@ -206,6 +206,11 @@ constexpr int kDoubleSizeLog2 = 3;
 constexpr size_t kMaxWasmCodeMB = 4095;
 constexpr size_t kMaxWasmCodeMemory = kMaxWasmCodeMB * MB;
 
+// Default log2 sizes of the megamorphic stub cache tables, see
+// --stub-cache-primary-bits and --stub-cache-secondary-bits.
+constexpr int kStubCacheDefaultPrimaryTableBits = 11;
+constexpr int kStubCacheDefaultSecondaryTableBits = 9;
+
 #if V8_HOST_ARCH_64_BIT
 constexpr int kSystemPointerSizeLog2 = 3;
 constexpr intptr_t kIntptrSignBit =
@@ -2563,6 +2563,9 @@ CodeGenerator::CodeGenResult CodeGenerator::AssembleArchInstruction(
       int lanes = i.InputInt32(1);
       int index = i.InputInt32(2);
       switch (lanes) {
+        case 2:
+          __ Dup(dst.V2D(), src.V2D(), index);
+          break;
         case 4:
           __ Dup(dst.V4S(), src.V4S(), index);
           break;
@@ -2580,6 +2583,33 @@ CodeGenerator::CodeGenResult CodeGenerator::AssembleArchInstruction(
     }
       SIMD_DESTRUCTIVE_BINOP_CASE(kArm64S128Select, Bsl, 16B);
       SIMD_BINOP_CASE(kArm64S128AndNot, Bic, 16B);
+    case kArm64S64x2Shuffle: {
+      Simd128Register dst = i.OutputSimd128Register().V2D(),
+                      src0 = i.InputSimd128Register(0).V2D(),
+                      src1 = i.InputSimd128Register(1).V2D();
+      UseScratchRegisterScope scope(tasm());
+      VRegister temp = scope.AcquireV(kFormat2D);
+      if (dst == src0) {
+        __ Mov(temp, src0);
+        src0 = temp;
+      } else if (dst == src1) {
+        __ Mov(temp, src1);
+        src1 = temp;
+      }
+      // Perform shuffle as a vmov per lane.
+      int32_t shuffle = i.InputInt32(2);
+      for (int i = 0; i < 2; i++) {
+        VRegister src = src0;
+        int lane = shuffle & 0x3;
+        if (lane >= 2) {
+          src = src1;
+          lane &= 0x1;
+        }
+        __ Mov(dst, i, src, lane);
+        shuffle >>= 8;
+      }
+      break;
+    }
     case kArm64S32x4Shuffle: {
       Simd128Register dst = i.OutputSimd128Register().V4S(),
                       src0 = i.InputSimd128Register(0).V4S(),
@@ -2609,6 +2639,8 @@ CodeGenerator::CodeGenResult CodeGenerator::AssembleArchInstruction(
       }
       break;
     }
+      SIMD_BINOP_CASE(kArm64S64x2ZipLeft, Zip1, 2D);
+      SIMD_BINOP_CASE(kArm64S64x2ZipRight, Zip2, 2D);
       SIMD_BINOP_CASE(kArm64S32x4ZipLeft, Zip1, 4S);
       SIMD_BINOP_CASE(kArm64S32x4ZipRight, Zip2, 4S);
       SIMD_BINOP_CASE(kArm64S32x4UnzipLeft, Uzp1, 4S);
@@ -339,6 +339,9 @@ namespace compiler {
   V(Arm64S128Not)                           \
   V(Arm64S128Select)                        \
   V(Arm64S128AndNot)                        \
+  V(Arm64S64x2ZipLeft)                      \
+  V(Arm64S64x2ZipRight)                     \
+  V(Arm64S64x2Shuffle)                      \
   V(Arm64S32x4ZipLeft)                      \
   V(Arm64S32x4ZipRight)                     \
   V(Arm64S32x4UnzipLeft)                    \
@@ -308,6 +308,9 @@ int InstructionScheduler::GetTargetInstructionFlags(
     case kArm64S128Not:
     case kArm64S128Select:
     case kArm64S128AndNot:
+    case kArm64S64x2ZipLeft:
+    case kArm64S64x2ZipRight:
+    case kArm64S64x2Shuffle:
     case kArm64S32x4ZipLeft:
     case kArm64S32x4ZipRight:
     case kArm64S32x4UnzipLeft:
@@ -3694,6 +3694,10 @@ struct ShuffleEntry {
 };
 
 static const ShuffleEntry arch_shuffles[] = {
+    {{0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23},
+     kArm64S64x2ZipLeft},
+    {{8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31},
+     kArm64S64x2ZipRight},
     {{0, 1, 2, 3, 16, 17, 18, 19, 4, 5, 6, 7, 20, 21, 22, 23},
      kArm64S32x4ZipLeft},
     {{8, 9, 10, 11, 24, 25, 26, 27, 12, 13, 14, 15, 28, 29, 30, 31},
@@ -3704,7 +3708,7 @@ static const ShuffleEntry arch_shuffles[] = {
      kArm64S32x4UnzipRight},
     {{0, 1, 2, 3, 16, 17, 18, 19, 8, 9, 10, 11, 24, 25, 26, 27},
      kArm64S32x4TransposeLeft},
-    {{4, 5, 6, 7, 20, 21, 22, 23, 12, 13, 14, 15, 21, 22, 23, 24},
+    {{4, 5, 6, 7, 20, 21, 22, 23, 12, 13, 14, 15, 28, 29, 30, 31},
      kArm64S32x4TransposeRight},
     {{4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11},
      kArm64S32x2Reverse},
@@ -3781,6 +3785,7 @@ void InstructionSelector::VisitI8x16Shuffle(Node* node) {
   uint8_t shuffle[kSimd128Size];
   bool is_swizzle;
   CanonicalizeShuffle(node, shuffle, &is_swizzle);
+  uint8_t shuffle64x2[2];
   uint8_t shuffle32x4[4];
   Arm64OperandGenerator g(this);
   ArchOpcode opcode;
@@ -3798,6 +3803,20 @@ void InstructionSelector::VisitI8x16Shuffle(Node* node) {
     return;
   }
   int index = 0;
+  if (wasm::SimdShuffle::TryMatch64x2Shuffle(shuffle, shuffle64x2)) {
+    if (wasm::SimdShuffle::TryMatchSplat<2>(shuffle, &index)) {
+      DCHECK_GT(2, index);
+      Emit(kArm64S128Dup, g.DefineAsRegister(node), g.UseRegister(input0),
+           g.UseImmediate(2), g.UseImmediate(index % 2));
+    } else if (wasm::SimdShuffle::TryMatchIdentity(shuffle)) {
+      EmitIdentity(node);
+    } else {
+      Emit(kArm64S64x2Shuffle, g.DefineAsRegister(node), g.UseRegister(input0),
+           g.UseRegister(input1),
+           g.UseImmediate(shuffle64x2[0] | (shuffle64x2[1] << 8)));
+    }
+    return;
+  }
   if (wasm::SimdShuffle::TryMatch32x4Shuffle(shuffle, shuffle32x4)) {
     if (wasm::SimdShuffle::TryMatchSplat<4>(shuffle, &index)) {
       DCHECK_GT(4, index);
@@ -3738,6 +3738,18 @@ CodeGenerator::CodeGenResult CodeGenerator::AssembleArchInstruction(
       __ Pblendw(i.OutputSimd128Register(), kScratchDoubleReg, i.InputUint8(3));
       break;
     }
+    case kX64Shufps: {
+      // Lanes 0 and 1 are taken from src0, lanes 2 and 3 from src1.
+      XMMRegister dst = i.OutputSimd128Register();
+      DCHECK_EQ(dst, i.InputSimd128Register(0));
+      if (CpuFeatures::IsSupported(AVX)) {
+        CpuFeatureScope avx_scope(tasm(), AVX);
+        __ vshufps(dst, dst, i.InputSimd128Register(1), i.InputUint8(2));
+      } else {
+        __ shufps(dst, i.InputSimd128Register(1), i.InputUint8(2));
+      }
+      break;
+    }
     case kX64S16x8Blend: {
       ASSEMBLE_SIMD_IMM_SHUFFLE(Pblendw, i.InputUint8(2));
       break;
@@ -336,6 +336,7 @@ namespace compiler {
   V(X64S128Store64Lane)                   \
   V(X64S32x4Swizzle)                      \
   V(X64S32x4Shuffle)                      \
+  V(X64Shufps)                            \
   V(X64S16x8Blend)                        \
   V(X64S16x8HalfShuffle1)                 \
   V(X64S16x8HalfShuffle2)                 \
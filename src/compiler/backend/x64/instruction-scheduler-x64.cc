@@ -298,6 +298,7 @@ int InstructionScheduler::GetTargetInstructionFlags(
     case kX64I8x16Shuffle:
     case kX64S32x4Swizzle:
     case kX64S32x4Shuffle:
+    case kX64Shufps:
     case kX64S16x8Blend:
     case kX64S16x8HalfShuffle1:
     case kX64S16x8HalfShuffle2:
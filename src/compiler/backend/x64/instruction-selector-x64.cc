@@ -3494,6 +3494,12 @@ void InstructionSelector::VisitI8x16Shuffle(Node* node) {
         opcode = kX64S16x8Blend;
         uint8_t blend_mask = wasm::SimdShuffle::PackBlend4(shuffle32x4);
         imms[imm_count++] = blend_mask;
+      } else if (wasm::SimdShuffle::TryMatchShufps(shuffle32x4)) {
+        // A single shufps covers 32x4 unzips and all shuffles which take the
+        // low half from src0 and the high half from src1.
+        opcode = kX64Shufps;
+        src1_needs_reg = true;
+        imms[imm_count++] = shuffle_mask;
       } else {
         opcode = kX64S32x4Shuffle;
         no_same_as_first = true;
@@ -773,6 +773,34 @@ void ReduceNode(const Operator* op, EscapeAnalysisTracker::Scope* current,
       current->SetEscaped(object);
       break;
     }
+    case IrOpcode::kEnsureWritableFastElements: {
+      Node* object = current->ValueInput(0);
+      Node* elements = current->ValueInput(1);
+      const VirtualObject* vobject = current->GetVirtualObject(elements);
+      Variable map_field;
+      Node* map;
+      if (vobject && !vobject->HasEscaped() &&
+          vobject->FieldAt(HeapObject::kMapOffset).To(&map_field) &&
+          current->Get(map_field).To(&map)) {
+        if (map) {
+          Type const map_type = NodeProperties::GetType(map);
+          if (map_type.IsHeapConstant() &&
+              !map_type.AsHeapConstant()->Ref().AsMap().IsFixedCowArrayMap()) {
+            // A freshly allocated backing store is never copy-on-write, so
+            // the {elements} are writable already and can stay virtual.
+            current->SetReplacement(elements);
+            break;
+          }
+        } else {
+          // If the variable has no value, we have not reached the fixed-point
+          // yet.
+          break;
+        }
+      }
+      current->SetEscaped(object);
+      current->SetEscaped(elements);
+      break;
+    }
     case IrOpcode::kCheckHeapObject: {
       Node* checked = current->ValueInput(0);
       switch (checked->opcode()) {
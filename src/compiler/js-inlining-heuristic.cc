@@ -92,11 +92,17 @@ JSInliningHeuristic::Candidate JSInliningHeuristic::CollectFunctions(
       out.num_functions = 0;
       return out;
     }
+    // At most one of the targets may be unknown; it is then called through a
+    // generic call in the fallback branch of the dispatch.
+    int unknown_count = 0;
     for (int n = 0; n < value_input_count; ++n) {
       HeapObjectMatcher m(callee->InputAt(n));
       if (!m.HasResolvedValue() || !m.Ref(broker()).IsJSFunction()) {
-        out.num_functions = 0;
-        return out;
+        if (++unknown_count > 1 || value_input_count == 1) {
+          out.num_functions = 0;
+          return out;
+        }
+        continue;
       }
 
       out.functions[n] = m.Ref(broker()).AsJSFunction();
@@ -227,6 +233,10 @@ Reduction JSInliningHeuristic::Reduce(Node* node) {
   // invocations of the caller.
   if (candidate.frequency.IsKnown() &&
       candidate.frequency.value() < FLAG_min_inlining_frequency) {
+    TRACE("Not considering call site #"
+          << node->id() << ":" << node->op()->mnemonic()
+          << ", because its frequency " << candidate.frequency
+          << " is below the threshold");
     return NoChange();
   }
 
@@ -267,6 +277,11 @@ void JSInliningHeuristic::Finalize() {
     int total_size =
         total_inlined_bytecode_size_ + static_cast<int>(size_of_candidate);
     if (total_size > FLAG_max_inlined_bytecode_size_cumulative) {
+      TRACE("Not inlining call site #"
+            << candidate.node->id() << ":" << candidate.node->op()->mnemonic()
+            << " with frequency " << candidate.frequency
+            << ", because its size " << candidate.total_size
+            << " exceeds the remaining budget");
       // Try if any smaller functions are available to inline.
       continue;
     }
@@ -630,12 +645,22 @@ void JSInliningHeuristic::CreateOrReuseDispatch(Node* node, Node* callee,
   Node* fallthrough_control = NodeProperties::GetControlInput(node);
   int const num_calls = candidate.num_functions;
 
-  // Create the appropriate control flow to dispatch to the cloned calls.
+  // The {fallback} call is reached when none of the other targets matched.
+  // It is the generic call through {callee} if one of the targets is unknown,
+  // and the call to the last known target otherwise.
+  int fallback = num_calls - 1;
   for (int i = 0; i < num_calls; ++i) {
-    // TODO(2206): Make comparison be based on underlying SharedFunctionInfo
-    // instead of the target JSFunction reference directly.
-    Node* target = jsgraph()->Constant(candidate.functions[i].value());
-    if (i != (num_calls - 1)) {
+    if (!candidate.functions[i].has_value()) fallback = i;
+  }
+
+  // Create the appropriate control flow to dispatch to the cloned calls.
+  for (int k = 0; k < num_calls; ++k) {
+    int const i = (k == num_calls - 1) ? fallback : (k < fallback ? k : k + 1);
+    Node* target;
+    if (i != fallback) {
+      // TODO(2206): Make comparison be based on underlying SharedFunctionInfo
+      // instead of the target JSFunction reference directly.
+      target = jsgraph()->Constant(candidate.functions[i].value());
       Node* check =
           graph()->NewNode(simplified()->ReferenceEqual(), callee, target);
       Node* branch =
@@ -643,6 +668,9 @@ void JSInliningHeuristic::CreateOrReuseDispatch(Node* node, Node* callee,
       fallthrough_control = graph()->NewNode(common()->IfFalse(), branch);
       if_successes[i] = graph()->NewNode(common()->IfTrue(), branch);
     } else {
+      target = candidate.functions[i].has_value()
+                   ? jsgraph()->Constant(candidate.functions[i].value())
+                   : callee;
       if_successes[i] = fallthrough_control;
     }
 
@@ -780,6 +808,11 @@ void JSInliningHeuristic::PrintCandidates() {
        << candidate.node->id() << " with frequency " << candidate.frequency
        << ", " << candidate.num_functions << " target(s):" << std::endl;
     for (int i = 0; i < candidate.num_functions; ++i) {
+      if (!candidate.functions[i].has_value() &&
+          !candidate.shared_info.has_value()) {
+        os << "  - target: unknown (generic call)" << std::endl;
+        continue;
+      }
       SharedFunctionInfoRef shared = candidate.functions[i].has_value()
                                          ? candidate.functions[i]->shared()
                                          : candidate.shared_info.value();
@@ -4,11 +4,13 @@
 
 #include "src/compiler/loop-variable-optimizer.h"
 
+#include "src/compiler/all-nodes.h"
 #include "src/compiler/common-operator.h"
 #include "src/compiler/graph.h"
 #include "src/compiler/node-marker.h"
 #include "src/compiler/node-properties.h"
 #include "src/compiler/node.h"
+#include "src/compiler/simplified-operator.h"
 #include "src/zone/zone-containers.h"
 #include "src/zone/zone.h"
 
@@ -345,6 +347,50 @@ void LoopVariableOptimizer::ChangeToPhisAndInsertGuards() {
   }
 }
 
+bool LoopVariableOptimizer::IsBoundedByLoopCondition(Node* control,
+                                                     Node* index,
+                                                     Node* length) {
+  for (Constraint constraint : limits_.Get(control)) {
+    if (constraint.left == index && constraint.right == length &&
+        constraint.kind == InductionVariable::kStrict) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void LoopVariableOptimizer::MarkRedundantBoundsChecks(
+    SimplifiedOperatorBuilder* simplified) {
+  AllNodes all(zone(), graph());
+  for (Node* node : all.reachable) {
+    if (node->opcode() != IrOpcode::kCheckBounds) continue;
+    CheckBoundsParameters const& p = CheckBoundsParametersOf(node->op());
+    if (p.flags() & CheckBoundsFlag::kAbortOnOutOfBounds) continue;
+
+    Node* control = NodeProperties::GetControlInput(node);
+    if (!reduced_.Get(control)) continue;
+
+    // The upper bound comes from a dominating {index < length} comparison
+    // against the very same length value, the lower bound from the type of
+    // the index (which includes the induction variable range).
+    Node* index = NodeProperties::GetValueInput(node, 0);
+    Node* length = NodeProperties::GetValueInput(node, 1);
+    if (!NodeProperties::IsTyped(index)) continue;
+    Type const index_type = NodeProperties::GetType(index);
+    if (!index_type.Is(Type::PlainNumber()) || index_type.Min() < 0.0) {
+      continue;
+    }
+    if (!IsBoundedByLoopCondition(control, index, length)) continue;
+
+    TRACE("Bounds check %i is redundant (index %i, length %i)\n", node->id(),
+          index->id(), length->id());
+    NodeProperties::ChangeOp(
+        node, simplified->CheckBounds(
+                  p.check_parameters().feedback(),
+                  p.flags() | CheckBoundsFlag::kAbortOnOutOfBounds));
+  }
+}
+
 #undef TRACE
 
 }  // namespace compiler
@@ -16,6 +16,7 @@ namespace compiler {
 class CommonOperatorBuilder;
 class Graph;
 class Node;
+class SimplifiedOperatorBuilder;
 
 class InductionVariable : public ZoneObject {
  public:
@@ -81,6 +82,11 @@ class LoopVariableOptimizer {
   void ChangeToInductionVariablePhis();
   void ChangeToPhisAndInsertGuards();
 
+  // Turns CheckBounds nodes into non-deoptimizing checks if the loop
+  // conditions that dominate them already prove 0 <= index < length.
+  // Requires a typed graph and must be called after {Run}.
+  void MarkRedundantBoundsChecks(SimplifiedOperatorBuilder* simplified);
+
  private:
   const int kAssumedLoopEntryIndex = 0;
   const int kFirstBackedge = 1;
@@ -110,6 +116,7 @@ class LoopVariableOptimizer {
                       InductionVariable::ConstraintKind kind, bool polarity);
 
   void TakeConditionsFromFirstControl(Node* node);
+  bool IsBoundedByLoopCondition(Node* control, Node* index, Node* length);
   const InductionVariable* FindInductionVariable(Node* node);
   InductionVariable* TryGetInductionVariable(Node* phi);
   void DetectInductionVariables(Node* loop);
@@ -1896,6 +1896,17 @@ struct LoadEliminationPhase {
   }
 };
 
+struct BoundsCheckEliminationPhase {
+  DECL_PIPELINE_PHASE_CONSTANTS(BoundsCheckElimination)
+
+  void Run(PipelineData* data, Zone* temp_zone) {
+    LoopVariableOptimizer induction_vars(data->jsgraph()->graph(),
+                                         data->common(), temp_zone);
+    induction_vars.Run();
+    induction_vars.MarkRedundantBoundsChecks(data->jsgraph()->simplified());
+  }
+};
+
 struct MemoryOptimizationPhase {
   DECL_PIPELINE_PHASE_CONSTANTS(MemoryOptimization)
 
@@ -2560,6 +2571,15 @@ bool PipelineImpl::OptimizeGraph(Linkage* linkage) {
     Run<LoadEliminationPhase>();
     RunPrintAndVerify(LoadEliminationPhase::phase_name());
   }
+
+  // Bounds checks are only relaxed when they are not needed as speculation
+  // barriers, see the matching condition in SimplifiedLowering.
+  if (FLAG_turbo_loop_variable && FLAG_turbo_loop_bounds_check_elimination &&
+      data->info()->GetPoisoningMitigationLevel() ==
+          PoisoningMitigationLevel::kDontPoison) {
+    Run<BoundsCheckEliminationPhase>();
+    RunPrintAndVerify(BoundsCheckEliminationPhase::phase_name());
+  }
   data->DeleteTyper();
 
   if (FLAG_turbo_escape) {
@@ -3286,6 +3306,35 @@ void PipelineImpl::ComputeScheduledGraph() {
   TraceScheduleAndVerify(data->info(), data, data->schedule(), "schedule");
 }
 
+namespace {
+
+// The linear-scan register allocator produces better code, but its compile
+// time grows much faster than linearly with the size of the function. With
+// --turbo-mid-tier-regalloc-threshold, huge wasm functions use the
+// single-pass mid-tier allocator instead. It is off by default until the
+// mid-tier allocator is complete. JavaScript functions only use it with
+// --turbo-force-mid-tier-regalloc.
+bool ShouldUseMidTierRegisterAllocator(PipelineData* data) {
+  OptimizedCompilationInfo* info = data->info();
+  if (info->IsTurboprop()) return FLAG_turboprop_mid_tier_reg_alloc;
+  if (!info->IsOptimizing() && !info->IsWasm()) return false;
+  if (FLAG_turbo_force_mid_tier_regalloc) return true;
+  if (!info->IsWasm()) return false;
+  int const virtual_registers = data->sequence()->VirtualRegisterCount();
+  if (FLAG_turbo_mid_tier_regalloc_threshold <= 0 ||
+      virtual_registers <= FLAG_turbo_mid_tier_regalloc_threshold) {
+    return false;
+  }
+  if (FLAG_trace_turbo_alloc) {
+    StdoutStream{} << "Using mid-tier register allocator for "
+                   << info->GetDebugName().get() << " (" << virtual_registers
+                   << " virtual registers)" << std::endl;
+  }
+  return true;
+}
+
+}  // namespace
+
 bool PipelineImpl::SelectInstructions(Linkage* linkage) {
   auto call_descriptor = linkage->GetIncomingDescriptor();
   PipelineData* data = this->data_;
@@ -3374,7 +3423,12 @@ bool PipelineImpl::SelectInstructions(Linkage* linkage) {
 
   data->DeleteGraphZone();
 
-  data->BeginPhaseKind("V8.TFRegisterAllocation");
+  bool const use_mid_tier_register_allocator =
+      !call_descriptor->HasRestrictedAllocatableRegisters() &&
+      ShouldUseMidTierRegisterAllocator(data);
+  data->BeginPhaseKind(use_mid_tier_register_allocator
+                           ? "V8.TFMidTierRegisterAllocation"
+                           : "V8.TFRegisterAllocation");
 
   bool run_verifier = FLAG_turbo_verify_allocation;
 
@@ -3398,7 +3452,7 @@ bool PipelineImpl::SelectInstructions(Linkage* linkage) {
       config = RegisterConfiguration::Default();
     }
 
-    if (data->info()->IsTurboprop() && FLAG_turboprop_mid_tier_reg_alloc) {
+    if (use_mid_tier_register_allocator) {
       AllocateRegistersForMidTier(config, call_descriptor, run_verifier);
     } else {
       AllocateRegistersForTopTier(config, call_descriptor, run_verifier);
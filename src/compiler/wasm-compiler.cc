@@ -6,6 +6,8 @@
 
 #include <memory>
 
+#include "include/v8-fast-api-calls.h"
+#include "src/api/api-inl.h"
 #include "src/base/optional.h"
 #include "src/base/platform/elapsed-timer.h"
 #include "src/base/platform/platform.h"
@@ -41,6 +43,7 @@
 #include "src/logging/counters.h"
 #include "src/logging/log.h"
 #include "src/objects/heap-number.h"
+#include "src/objects/templates-inl.h"
 #include "src/roots/roots.h"
 #include "src/tracing/trace-event.h"
 #include "src/trap-handler/trap-handler.h"
@@ -2236,9 +2239,23 @@ Node* WasmGraphBuilder::MemoryGrow(Node* input) {
   // Just encode the stub index. This will be patched at relocation.
   Node* call_target = mcgraph()->RelocatableIntPtrConstant(
       wasm::WasmCode::kWasmMemoryGrow, RelocInfo::WASM_STUB_CALL);
-  return SetEffectControl(
-      graph()->NewNode(mcgraph()->common()->Call(call_descriptor), call_target,
-                       input, effect(), control()));
+  if (!env_->module->is_memory64) {
+    return SetEffectControl(
+        graph()->NewNode(mcgraph()->common()->Call(call_descriptor),
+                         call_target, input, effect(), control()));
+  }
+
+  // The runtime stub takes a 32-bit delta. Growing a memory64 memory by 2^32
+  // pages or more always fails.
+  auto done = gasm_->MakeLabel(MachineRepresentation::kWord64);
+  gasm_->GotoIfNot(
+      gasm_->Uint64LessThanOrEqual(input, gasm_->Int64Constant(kMaxUInt32)),
+      &done, gasm_->Int64Constant(-1));
+  Node* old_pages = gasm_->Call(call_descriptor, call_target,
+                                gasm_->TruncateInt64ToInt32(input));
+  gasm_->Goto(&done, gasm_->ChangeInt32ToInt64(old_pages));
+  gasm_->Bind(&done);
+  return done.PhiAt(0);
 }
 
 Node* WasmGraphBuilder::Throw(uint32_t exception_index,
@@ -3591,6 +3608,8 @@ Node* WasmGraphBuilder::CurrentMemoryPages() {
       graph()->NewNode(mcgraph()->machine()->WordShr(), mem_size,
                        mcgraph()->Int32Constant(wasm::kWasmPageSizeLog2));
   result = BuildTruncateIntPtrToInt32(result);
+  // The number of pages fits in 32 bits, also for memory64.
+  if (env_->module->is_memory64) result = gasm_->ChangeUint32ToUint64(result);
   return result;
 }
 
@@ -3775,11 +3794,23 @@ Node* WasmGraphBuilder::BoundsCheckMem(uint8_t access_size, Node* index,
                                        wasm::WasmCodePosition position,
                                        EnforceBoundsCheck enforce_check) {
   DCHECK_LE(1, access_size);
-  index = Uint32ToUintptr(index);
+  index = MemoryIndexToUintptr(index, position);
   if (!FLAG_wasm_bounds_checks) return index;
 
   if (use_trap_handler() && enforce_check == kCanOmitBoundsCheck) {
-    return index;
+    if (!env_->module->is_memory64) return index;
+    // The guard regions cover a 32-bit index plus a 32-bit offset. If the
+    // memory can never grow beyond 4 GiB, a memory64 index which does not fit
+    // in 32 bits is always out of bounds, and everything else is left to the
+    // trap handler. Larger memories are checked explicitly below.
+    if (env_->max_memory_size <= uint64_t{kMaxUInt32} + 1 &&
+        offset <= kMaxUInt32) {
+      Node* high_word = graph()->NewNode(mcgraph()->machine()->Word64Shr(),
+                                         index, Int64Constant(32));
+      TrapIfFalse(wasm::kTrapMemOutOfBounds,
+                  gasm_->Word64Equal(high_word, Int64Constant(0)), position);
+      return index;
+    }
   }
 
   // If the offset does not fit in a uintptr_t, this can never succeed on this
@@ -4177,6 +4208,10 @@ Node* WasmGraphBuilder::LoadTransform(wasm::ValueType type, MachineType memtype,
 Node* WasmGraphBuilder::Prefetch(Node* index, uint64_t offset,
                                  uint32_t alignment, bool temporal) {
   uintptr_t capped_offset = static_cast<uintptr_t>(offset);
+  // Prefetches do not fault, so there is no need for a bounds check.
+  if (env_->module->is_memory64 && mcgraph()->machine()->Is32()) {
+    index = gasm_->TruncateInt64ToInt32(index);
+  }
   const Operator* prefetchOp =
       temporal ? mcgraph()->machine()->PrefetchTemporal()
                : mcgraph()->machine()->PrefetchNonTemporal();
@@ -4382,6 +4417,19 @@ Node* WasmGraphBuilder::BuildAsmjsLoadMem(MachineType type, Node* index) {
                           GetAsmJsOOBValue(type.representation(), mcgraph()));
 }
 
+// Converts a memory index to {uintptr_t} representation. Memory64 indexes are
+// 64 bit already; on 32-bit platforms, any index which does not fit in 32 bits
+// is out of bounds.
+Node* WasmGraphBuilder::MemoryIndexToUintptr(Node* index,
+                                             wasm::WasmCodePosition position) {
+  if (!env_->module->is_memory64) return Uint32ToUintptr(index);
+  if (mcgraph()->machine()->Is64()) return index;
+  Node* high_word = gasm_->TruncateInt64ToInt32(graph()->NewNode(
+      mcgraph()->machine()->Word64Shr(), index, Int64Constant(32)));
+  TrapIfTrue(wasm::kTrapMemOutOfBounds, high_word, position);
+  return gasm_->TruncateInt64ToInt32(index);
+}
+
 Node* WasmGraphBuilder::Uint32ToUintptr(Node* node) {
   if (mcgraph()->machine()->Is32()) return node;
   // Fold instances of ChangeUint32ToUint64(IntConstant) directly.
@@ -5455,7 +5503,8 @@ Node* WasmGraphBuilder::MemoryInit(uint32_t data_segment_index, Node* dst,
 
   Node* stack_slot = StoreArgsInStackSlot(
       {{MachineType::PointerRepresentation(), instance_node_.get()},
-       {MachineRepresentation::kWord32, dst},
+       {MachineType::PointerRepresentation(),
+        MemoryIndexToUintptr(dst, position)},
        {MachineRepresentation::kWord32, src},
        {MachineRepresentation::kWord32,
         gasm_->Uint32Constant(data_segment_index)},
@@ -5510,9 +5559,12 @@ Node* WasmGraphBuilder::MemoryCopy(Node* dst, Node* src, Node* size,
 
   Node* stack_slot = StoreArgsInStackSlot(
       {{MachineType::PointerRepresentation(), instance_node_.get()},
-       {MachineRepresentation::kWord32, dst},
-       {MachineRepresentation::kWord32, src},
-       {MachineRepresentation::kWord32, size}});
+       {MachineType::PointerRepresentation(),
+        MemoryIndexToUintptr(dst, position)},
+       {MachineType::PointerRepresentation(),
+        MemoryIndexToUintptr(src, position)},
+       {MachineType::PointerRepresentation(),
+        MemoryIndexToUintptr(size, position)}});
 
   MachineType sig_types[] = {MachineType::Int32(), MachineType::Pointer()};
   MachineSignature sig(1, 1, sig_types);
@@ -5527,9 +5579,11 @@ Node* WasmGraphBuilder::MemoryFill(Node* dst, Node* value, Node* size,
 
   Node* stack_slot = StoreArgsInStackSlot(
       {{MachineType::PointerRepresentation(), instance_node_.get()},
-       {MachineRepresentation::kWord32, dst},
+       {MachineType::PointerRepresentation(),
+        MemoryIndexToUintptr(dst, position)},
        {MachineRepresentation::kWord32, value},
-       {MachineRepresentation::kWord32, size}});
+       {MachineType::PointerRepresentation(),
+        MemoryIndexToUintptr(size, position)}});
 
   MachineType sig_types[] = {MachineType::Int32(), MachineType::Pointer()};
   MachineSignature sig(1, 1, sig_types);
@@ -6790,6 +6844,40 @@ class WasmWrapperGraphBuilder : public WasmGraphBuilder {
                         global_proxy);
   }
 
+  // Calls {callable_node} via the generic Call builtin, passing the wasm
+  // parameters converted to JS values.
+  Node* BuildCallBuiltinCall(Node* callable_node, Node* native_context,
+                             Node* undefined_node) {
+    int wasm_count = static_cast<int>(sig_->parameter_count());
+    base::SmallVector<Node*, 16> args(wasm_count + 7);
+    int pos = 0;
+    args[pos++] = GetBuiltinPointerTarget(Builtins::kCall_ReceiverIsAny);
+    args[pos++] = callable_node;
+    args[pos++] = mcgraph()->Int32Constant(wasm_count);  // argument count
+    args[pos++] = undefined_node;                        // receiver
+
+    auto call_descriptor = Linkage::GetStubCallDescriptor(
+        graph()->zone(), CallTrampolineDescriptor{}, wasm_count + 1,
+        CallDescriptor::kNoFlags, Operator::kNoProperties,
+        StubCallMode::kCallBuiltinPointer);
+
+    // Convert wasm numbers to JS values.
+    pos = AddArgumentNodes(VectorOf(args), pos, wasm_count, sig_);
+
+    // The native_context is sufficient here, because all kind of callables
+    // which depend on the context provide their own context. The context
+    // here is only needed if the target is a constructor to throw a
+    // TypeError, if the target is a native function, or if the target is a
+    // callable JSObject, which can only be constructed by the runtime.
+    args[pos++] = native_context;
+    args[pos++] = effect();
+    args[pos++] = control();
+
+    DCHECK_EQ(pos, args.size());
+    return graph()->NewNode(mcgraph()->common()->Call(call_descriptor), pos,
+                            args.begin());
+  }
+
   bool BuildWasmToJSWrapper(WasmImportCallKind kind, int expected_arity) {
     int wasm_count = static_cast<int>(sig_->parameter_count());
 
@@ -6937,33 +7025,8 @@ class WasmWrapperGraphBuilder : public WasmGraphBuilder {
       // === General case of unknown callable ==================================
       // =======================================================================
       case WasmImportCallKind::kUseCallBuiltin: {
-        base::SmallVector<Node*, 16> args(wasm_count + 7);
-        int pos = 0;
-        args[pos++] = GetBuiltinPointerTarget(Builtins::kCall_ReceiverIsAny);
-        args[pos++] = callable_node;
-        args[pos++] = mcgraph()->Int32Constant(wasm_count);  // argument count
-        args[pos++] = undefined_node;                        // receiver
-
-        auto call_descriptor = Linkage::GetStubCallDescriptor(
-            graph()->zone(), CallTrampolineDescriptor{}, wasm_count + 1,
-            CallDescriptor::kNoFlags, Operator::kNoProperties,
-            StubCallMode::kCallBuiltinPointer);
-
-        // Convert wasm numbers to JS values.
-        pos = AddArgumentNodes(VectorOf(args), pos, wasm_count, sig_);
-
-        // The native_context is sufficient here, because all kind of callables
-        // which depend on the context provide their own context. The context
-        // here is only needed if the target is a constructor to throw a
-        // TypeError, if the target is a native function, or if the target is a
-        // callable JSObject, which can only be constructed by the runtime.
-        args[pos++] = native_context;
-        args[pos++] = effect();
-        args[pos++] = control();
-
-        DCHECK_EQ(pos, args.size());
-        call = graph()->NewNode(mcgraph()->common()->Call(call_descriptor), pos,
-                                args.begin());
+        call = BuildCallBuiltinCall(callable_node, native_context,
+                                    undefined_node);
         break;
       }
       default:
@@ -6997,6 +7060,103 @@ class WasmWrapperGraphBuilder : public WasmGraphBuilder {
     return true;
   }
 
+  // Calls the C function {c_function} of an API function directly with the
+  // raw wasm values. The C function has no JS frame and must neither allocate
+  // nor call into JS. If it requests a fallback via its
+  // {v8::FastApiCallbackOptions}, the callable is called like any other JS
+  // callable.
+  void BuildJSFastApiCallWrapper(Address c_function, bool bound_receiver) {
+    DCHECK_EQ(0, sig_->return_count());
+    int wasm_count = static_cast<int>(sig_->parameter_count());
+
+    // Build the start and the parameter nodes.
+    SetEffectControl(Start(wasm_count + 4));
+
+    instance_node_.set(Param(wasm::kWasmInstanceParameterIndex));
+
+    Node* native_context =
+        LOAD_INSTANCE_FIELD(NativeContext, MachineType::TaggedPointer());
+
+    // The callable is passed as the last parameter, after Wasm arguments.
+    Node* callable_node = Param(wasm_count + 1);
+
+    Node* undefined_node = BuildLoadUndefinedValueFromInstance();
+
+    // Bound functions pass their bound receiver. Other API functions are
+    // called with an undefined receiver, which sloppy API functions see as
+    // the global proxy.
+    Node* receiver_node =
+        bound_receiver
+            ? LOAD_TAGGED_POINTER(callable_node,
+                                  wasm::ObjectAccess::ToTagged(
+                                      JSBoundFunction::kBoundThisOffset))
+            : LOAD_FIXED_ARRAY_SLOT_PTR(native_context,
+                                        Context::GLOBAL_PROXY_INDEX);
+
+    // The {v8::FastApiCallbackOptions} are passed as the last C argument.
+    STATIC_ASSERT(sizeof(v8::FastApiCallbackOptions) == 1);
+    Node* options = graph()->NewNode(mcgraph()->machine()->StackSlot(
+        sizeof(v8::FastApiCallbackOptions), kSystemPointerSize));
+    STORE_RAW(options, 0, Int32Constant(0), MachineRepresentation::kWord8,
+              kNoWriteBarrier);
+
+    MachineSignature::Builder c_sig(graph()->zone(), 0, wasm_count + 2);
+    c_sig.AddParam(MachineType::AnyTagged());  // receiver
+    for (wasm::ValueType type : sig_->parameters()) {
+      c_sig.AddParam(type.machine_type());
+    }
+    c_sig.AddParam(MachineType::Pointer());  // options
+    auto call_descriptor =
+        Linkage::GetSimplifiedCDescriptor(graph()->zone(), c_sig.Build());
+
+    base::SmallVector<Node*, 16> args(wasm_count + 5);
+    int pos = 0;
+    Node* function = graph()->NewNode(mcgraph()->common()->ExternalConstant(
+        ExternalReference::Create(c_function)));
+    args[pos++] = function;
+    args[pos++] = receiver_node;
+    for (int i = 0; i < wasm_count; ++i) {
+      args[pos++] = Param(i + 1);  // Start from index 1 to skip the instance.
+    }
+    args[pos++] = options;
+
+    BuildModifyThreadInWasmFlag(false);
+    // Make the C function visible to the CPU profiler.
+    Node* isolate_root = BuildLoadIsolateRoot();
+    STORE_RAW(isolate_root, IsolateData::fast_api_call_target_offset(),
+              function, MachineType::PointerRepresentation(), kNoWriteBarrier);
+    args[pos++] = effect();
+    args[pos++] = control();
+    DCHECK_EQ(pos, args.size());
+    SetEffect(graph()->NewNode(mcgraph()->common()->Call(call_descriptor), pos,
+                               args.begin()));
+    STORE_RAW(isolate_root, IsolateData::fast_api_call_target_offset(),
+              mcgraph()->IntPtrConstant(0),
+              MachineType::PointerRepresentation(), kNoWriteBarrier);
+
+    Node* fallback = gasm_->Load(MachineType::Uint8(), options, 0);
+    Node* branch = graph()->NewNode(
+        mcgraph()->common()->Branch(BranchHint::kTrue),
+        gasm_->Word32Equal(fallback, Int32Constant(0)), control());
+    Node* old_effect = effect();
+
+    // The C function requested the fallback, do a regular JS call.
+    SetControl(graph()->NewNode(mcgraph()->common()->IfFalse(), branch));
+    Node* call =
+        BuildCallBuiltinCall(callable_node, native_context, undefined_node);
+    SetEffect(call);
+    SetSourcePosition(call, 0);
+    BuildModifyThreadInWasmFlag(true);
+    Return(Int32Constant(0));
+
+    SetEffectControl(old_effect, graph()->NewNode(
+                                     mcgraph()->common()->IfTrue(), branch));
+    BuildModifyThreadInWasmFlag(true);
+    Return(Int32Constant(0));
+
+    if (ContainsInt64(sig_)) LowerInt64(kCalledFromWasm);
+  }
+
   void BuildCapiCallWrapper(Address address) {
     // Store arguments on our stack, then align the stack for calling to C.
     int param_bytes = 0;
@@ -7316,6 +7476,82 @@ std::unique_ptr<OptimizedCompilationJob> NewJSToWasmCompilationJob(
       WasmAssemblerOptions());
 }
 
+namespace {
+
+bool IsSupportedWasmFastApiType(wasm::ValueType type,
+                                const CTypeInfo& type_info) {
+  if (type_info.IsArray()) return false;
+  switch (type_info.GetType()) {
+    case CTypeInfo::Type::kInt32:
+    case CTypeInfo::Type::kUint32:
+      return type == wasm::kWasmI32;
+#ifdef V8_TARGET_ARCH_64_BIT
+    case CTypeInfo::Type::kInt64:
+    case CTypeInfo::Type::kUint64:
+      return type == wasm::kWasmI64;
+#endif
+#ifdef V8_ENABLE_FP_PARAMS_IN_C_LINKAGE
+    case CTypeInfo::Type::kFloat32:
+      return type == wasm::kWasmF32;
+    case CTypeInfo::Type::kFloat64:
+      return type == wasm::kWasmF64;
+#endif
+    default:
+      return false;
+  }
+}
+
+// Returns the API function called by {callable} if its C function can be
+// called directly with the parameters of {expected_sig}. Besides API functions
+// themselves, this accepts API functions bound to a receiver object, which is
+// then passed as the receiver of the C function.
+MaybeHandle<JSFunction> GetWasmFastApiFunction(
+    Handle<JSReceiver> callable, const wasm::FunctionSig* expected_sig) {
+  Isolate* isolate = callable->GetIsolate();
+  Handle<JSReceiver> target = callable;
+  if (target->IsJSBoundFunction()) {
+    auto bound_function = Handle<JSBoundFunction>::cast(target);
+    if (bound_function->bound_arguments().length() != 0) return {};
+    if (!bound_function->bound_this().IsJSReceiver()) return {};
+    target = handle(bound_function->bound_target_function(), isolate);
+  }
+  if (!target->IsJSFunction()) return {};
+  auto function = Handle<JSFunction>::cast(target);
+  SharedFunctionInfo shared = function->shared();
+  if (!shared.IsApiFunction()) return {};
+
+  // As for fast API calls from optimized code, the receiver is not checked.
+  FunctionTemplateInfo info = shared.get_api_func_data();
+  if (!info.accept_any_receiver() || !info.signature().IsUndefined(isolate)) {
+    return {};
+  }
+  if (v8::ToCData<Address>(info.GetCFunction()) == kNullAddress) return {};
+  const CFunctionInfo* c_signature =
+      v8::ToCData<CFunctionInfo*>(info.GetCSignature());
+
+  // C functions can only return void, and take the receiver as the first
+  // argument.
+  if (expected_sig->return_count() != 0) return {};
+  DCHECK(c_signature->ReturnInfo().GetType() == CTypeInfo::Type::kVoid);
+  if (c_signature->ArgumentCount() != expected_sig->parameter_count() + 1) {
+    return {};
+  }
+  const CTypeInfo& receiver_info = c_signature->ArgumentInfo(0);
+  if (receiver_info.GetType() != CTypeInfo::Type::kV8Value ||
+      receiver_info.IsArray()) {
+    return {};
+  }
+  for (unsigned i = 0; i < expected_sig->parameter_count(); ++i) {
+    if (!IsSupportedWasmFastApiType(expected_sig->GetParam(i),
+                                    c_signature->ArgumentInfo(i + 1))) {
+      return {};
+    }
+  }
+  return function;
+}
+
+}  // namespace
+
 std::pair<WasmImportCallKind, Handle<JSReceiver>> ResolveWasmImportCall(
     Handle<JSReceiver> callable, const wasm::FunctionSig* expected_sig,
     const wasm::WasmModule* module,
@@ -7357,6 +7593,11 @@ std::pair<WasmImportCallKind, Handle<JSReceiver>> ResolveWasmImportCall(
   if (!wasm::IsJSCompatibleSignature(expected_sig, module, enabled_features)) {
     return std::make_pair(WasmImportCallKind::kRuntimeTypeError, callable);
   }
+  // Check for API functions which can be called without a JS frame.
+  if (FLAG_wasm_fast_api &&
+      !GetWasmFastApiFunction(callable, expected_sig).is_null()) {
+    return std::make_pair(WasmImportCallKind::kWasmToJSFastApi, callable);
+  }
   // For JavaScript calls, determine whether the target has an arity match.
   if (callable->IsJSFunction()) {
     Handle<JSFunction> function = Handle<JSFunction>::cast(callable);
@@ -7655,6 +7896,56 @@ wasm::WasmCode* CompileWasmCapiCallWrapper(wasm::WasmEngine* wasm_engine,
   return native_module->PublishCode(std::move(wasm_code));
 }
 
+wasm::WasmCode* CompileWasmJSFastCallWrapper(wasm::WasmEngine* wasm_engine,
+                                             wasm::NativeModule* native_module,
+                                             const wasm::FunctionSig* sig,
+                                             Handle<JSReceiver> callable) {
+  TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("v8.wasm.detailed"),
+               "wasm.CompileWasmJSFastCallWrapper");
+
+  Handle<JSFunction> function =
+      GetWasmFastApiFunction(callable, sig).ToHandleChecked();
+  Address c_function = v8::ToCData<Address>(
+      function->shared().get_api_func_data().GetCFunction());
+
+  Zone zone(wasm_engine->allocator(), ZONE_NAME, kCompressGraphZone);
+
+  SourcePositionTable* source_positions = nullptr;
+  MachineGraph* mcgraph = zone.New<MachineGraph>(
+      zone.New<Graph>(&zone), zone.New<CommonOperatorBuilder>(&zone),
+      zone.New<MachineOperatorBuilder>(
+          &zone, MachineType::PointerRepresentation(),
+          InstructionSelector::SupportedMachineOperatorFlags(),
+          InstructionSelector::AlignmentRequirements()));
+
+  WasmWrapperGraphBuilder builder(
+      &zone, mcgraph, sig, native_module->module(), source_positions,
+      StubCallMode::kCallWasmRuntimeStub, native_module->enabled_features());
+  builder.BuildJSFastApiCallWrapper(c_function,
+                                    callable->IsJSBoundFunction());
+
+  // Run the compiler pipeline to generate machine code.
+  CallDescriptor* call_descriptor =
+      GetWasmCallDescriptor(&zone, sig, WasmGraphBuilder::kNoRetpoline,
+                            WasmCallKind::kWasmImportWrapper);
+  if (mcgraph->machine()->Is32()) {
+    call_descriptor = GetI32WasmCallDescriptor(&zone, call_descriptor);
+  }
+
+  const char* debug_name = "WasmJSFastApiCall";
+  wasm::WasmCompilationResult result = Pipeline::GenerateCodeForWasmNativeStub(
+      wasm_engine, call_descriptor, mcgraph, CodeKind::WASM_TO_JS_FUNCTION,
+      wasm::WasmCode::kWasmToJsWrapper, debug_name, WasmStubAssemblerOptions(),
+      source_positions);
+  std::unique_ptr<wasm::WasmCode> wasm_code = native_module->AddCode(
+      wasm::kAnonymousFuncIndex, result.code_desc, result.frame_slot_count,
+      result.tagged_parameter_slots,
+      result.protected_instructions_data.as_vector(),
+      result.source_positions.as_vector(), wasm::WasmCode::kWasmToJsWrapper,
+      wasm::ExecutionTier::kNone, wasm::kNoDebugging);
+  return native_module->PublishCode(std::move(wasm_code));
+}
+
 MaybeHandle<Code> CompileWasmToJSWrapper(Isolate* isolate,
                                          const wasm::FunctionSig* sig,
                                          WasmImportCallKind kind,
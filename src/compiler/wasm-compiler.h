@@ -61,6 +61,7 @@ enum class WasmImportCallKind : uint8_t {
   kLinkError,                // static Wasm->Wasm type error
   kRuntimeTypeError,         // runtime Wasm->JS type error
   kWasmToCapi,               // fast Wasm->C-API call
+  kWasmToJSFastApi,          // fast Wasm->C call of a JS API function
   kWasmToWasm,               // fast Wasm->Wasm call
   kJSFunctionArityMatch,     // fast Wasm->JS call
   kJSFunctionArityMismatch,  // Wasm->JS, needs adapter frame
@@ -117,6 +118,13 @@ wasm::WasmCode* CompileWasmCapiCallWrapper(wasm::WasmEngine*,
                                            const wasm::FunctionSig*,
                                            Address address);
 
+// Compiles a wrapper which calls the C function of the API function behind
+// {callable} directly, see {WasmImportCallKind::kWasmToJSFastApi}.
+wasm::WasmCode* CompileWasmJSFastCallWrapper(wasm::WasmEngine*,
+                                             wasm::NativeModule*,
+                                             const wasm::FunctionSig*,
+                                             Handle<JSReceiver> callable);
+
 // Returns an OptimizedCompilationJob object for a JS to Wasm wrapper.
 std::unique_ptr<OptimizedCompilationJob> NewJSToWasmCompilationJob(
     Isolate* isolate, wasm::WasmEngine* wasm_engine,
@@ -463,13 +471,15 @@ class WasmGraphBuilder {
   // offset fits in a platform-dependent uintptr_t.
   Node* MemBuffer(uintptr_t offset);
 
-  // BoundsCheckMem receives a uint32 {index} node and returns a ptrsize index.
+  // BoundsCheckMem receives a uint32 {index} node (uint64 for memory64) and
+  // returns a ptrsize index.
   Node* BoundsCheckMem(uint8_t access_size, Node* index, uint64_t offset,
                        wasm::WasmCodePosition, EnforceBoundsCheck);
 
   Node* CheckBoundsAndAlignment(int8_t access_size, Node* index,
                                 uint64_t offset, wasm::WasmCodePosition);
 
+  Node* MemoryIndexToUintptr(Node* index, wasm::WasmCodePosition);
   Node* Uint32ToUintptr(Node*);
   const Operator* GetSafeLoadOperator(int offset, wasm::ValueType type);
   const Operator* GetSafeStoreOperator(int offset, wasm::ValueType type);
@@ -2589,7 +2589,51 @@ void Shell::WriteLcovData(v8::Isolate* isolate, const char* file) {
   }
 }
 
+namespace {
+// The flags in the order of RegExp.prototype.flags.
+std::string RegExpFlagsToString(RegExp::Flags flags) {
+  std::string result;
+  if (flags & RegExp::kGlobal) result += 'g';
+  if (flags & RegExp::kIgnoreCase) result += 'i';
+  if (flags & RegExp::kLinear) result += 'l';
+  if (flags & RegExp::kMultiline) result += 'm';
+  if (flags & RegExp::kDotAll) result += 's';
+  if (flags & RegExp::kUnicode) result += 'u';
+  if (flags & RegExp::kSticky) result += 'y';
+  return result;
+}
+
+// Prints the regexps with the most total execution time, see
+// --dump-regexp-stats.
+void DumpRegExpStatistics(v8::Isolate* isolate, size_t count) {
+  std::vector<RegExpStatistics> stats = RegExpProfiler::GetStatistics(isolate);
+  if (stats.size() > count) stats.resize(count);
+
+  std::cout << std::setw(12) << "Time (ms)" << std::setw(12) << "Executions"
+            << std::setw(14) << "Backtracks" << std::setw(11) << "Fallbacks"
+            << "  " << std::setw(32) << std::left
+            << "Atom/Bytecode/Native/Linear" << std::right << "  RegExp\n";
+  for (const RegExpStatistics& entry : stats) {
+    std::ostringstream engines;
+    engines << entry.atom_executions << "/" << entry.interpreted_executions
+            << "/" << entry.native_code_executions << "/"
+            << entry.experimental_executions;
+    std::cout << std::setw(12) << std::fixed << std::setprecision(3)
+              << entry.total_time_ms << std::setw(12) << entry.executions
+              << std::setw(14) << entry.backtracks << std::setw(11)
+              << entry.backtrack_limit_fallbacks << "  " << std::setw(32)
+              << std::left << engines.str() << std::right << "  /"
+              << entry.source << "/" << RegExpFlagsToString(entry.flags)
+              << "\n";
+  }
+}
+}  // namespace
+
 void Shell::OnExit(v8::Isolate* isolate) {
+  if (i::FLAG_dump_regexp_stats > 0) {
+    DumpRegExpStatistics(isolate, i::FLAG_dump_regexp_stats);
+  }
+
   isolate->Dispose();
 
   if (i::FLAG_dump_counters || i::FLAG_dump_counters_nvp) {
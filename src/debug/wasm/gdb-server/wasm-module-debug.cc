@@ -314,7 +314,11 @@ uint32_t WasmModuleDebug::GetWasmData(Isolate* isolate, uint32_t offset,
     const wasm::WasmModule* module = module_object->module();
     if (!module->data_segments.empty()) {
       const WasmDataSegment& segment = module->data_segments[0];
-      uint32_t data_offset = EvalUint32InitExpr(instance, segment.dest_addr);
+      uint32_t data_offset =
+          module->is_memory64
+              ? static_cast<uint32_t>(
+                    EvalUint64InitExpr(instance, segment.dest_addr))
+              : EvalUint32InitExpr(instance, segment.dest_addr);
       offset += data_offset;
 
       uint8_t* mem_start = instance->memory_start();
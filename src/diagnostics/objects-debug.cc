@@ -1247,9 +1247,17 @@ void JSRegExp::JSRegExpVerify(Isolate* isolate) {
 
       bool is_compiled = latin1_code.IsCode();
       if (is_compiled) {
-        CHECK_EQ(Code::cast(latin1_code).builtin_index(),
-                 Builtins::kRegExpExperimentalTrampoline);
-        CHECK_EQ(uc16_code, latin1_code);
+        if (Code::cast(latin1_code).kind() == CodeKind::REGEXP) {
+          // Native code compiled from the dfa after tier-up.
+          CHECK(uc16_code.IsCode());
+          CHECK_EQ(Code::cast(uc16_code).kind(), CodeKind::REGEXP);
+          CHECK_EQ(arr.get(JSRegExp::kIrregexpTicksUntilTierUpIndex),
+                   uninitialized);
+        } else {
+          CHECK_EQ(Code::cast(latin1_code).builtin_index(),
+                   Builtins::kRegExpExperimentalTrampoline);
+          CHECK_EQ(uc16_code, latin1_code);
+        }
 
         CHECK(latin1_bytecode.IsByteArray());
         CHECK_EQ(uc16_bytecode, latin1_bytecode);
@@ -1265,9 +1273,18 @@ void JSRegExp::JSRegExpVerify(Isolate* isolate) {
                uninitialized);
       CHECK(arr.get(JSRegExp::kIrregexpCaptureCountIndex).IsSmi());
       CHECK_GE(Smi::ToInt(arr.get(JSRegExp::kIrregexpCaptureCountIndex)), 0);
-      CHECK_EQ(arr.get(JSRegExp::kIrregexpTicksUntilTierUpIndex),
-               uninitialized);
+      Object ticks = arr.get(JSRegExp::kIrregexpTicksUntilTierUpIndex);
+      CHECK(ticks == uninitialized || Smi::ToInt(ticks) >= 0);
       CHECK_EQ(arr.get(JSRegExp::kIrregexpBacktrackLimit), uninitialized);
+      Object prefilter = arr.get(JSRegExp::kIrregexpPrefilterIndex);
+      CHECK(prefilter == uninitialized || prefilter.IsByteArray());
+      // Smi : Hasn't fallen back to irregexp (-1).
+      // FixedArray: IRREGEXP data to run the regexp on irregexp.
+      Object fallback = arr.get(JSRegExp::kExperimentalIrregexpFallbackIndex);
+      CHECK(fallback == uninitialized ||
+            (fallback.IsFixedArray() &&
+             FixedArray::cast(fallback).get(JSRegExp::kTagIndex) ==
+                 Smi::FromInt(JSRegExp::IRREGEXP)));
       break;
     }
     case JSRegExp::IRREGEXP: {
@@ -1305,6 +1322,21 @@ void JSRegExp::JSRegExpVerify(Isolate* isolate) {
       CHECK(arr.get(JSRegExp::kIrregexpMaxRegisterCountIndex).IsSmi());
       CHECK(arr.get(JSRegExp::kIrregexpTicksUntilTierUpIndex).IsSmi());
       CHECK(arr.get(JSRegExp::kIrregexpBacktrackLimit).IsSmi());
+      Object prefilter = arr.get(JSRegExp::kIrregexpPrefilterIndex);
+      CHECK((prefilter.IsSmi() &&
+             Smi::ToInt(prefilter) == JSRegExp::kUninitializedValue) ||
+            prefilter.IsByteArray());
+      // Smi : Hasn't fallen back to the experimental engine (-1), or must
+      //       not fall back to it (-2).
+      // FixedArray: EXPERIMENTAL data to run the regexp on that engine.
+      Object fallback = arr.get(JSRegExp::kIrregexpExperimentalFallbackIndex);
+      CHECK((fallback.IsSmi() &&
+             (Smi::ToInt(fallback) == JSRegExp::kUninitializedValue ||
+              Smi::ToInt(fallback) ==
+                  JSRegExp::kNoExperimentalFallbackValue)) ||
+            (fallback.IsFixedArray() &&
+             FixedArray::cast(fallback).get(JSRegExp::kTagIndex) ==
+                 Smi::FromInt(JSRegExp::EXPERIMENTAL)));
       break;
     }
     default:
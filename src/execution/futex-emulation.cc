@@ -7,6 +7,7 @@
 #include <limits>
 
 #include "src/api/api-inl.h"
+#include "src/base/functional.h"
 #include "src/base/logging.h"
 #include "src/base/macros.h"
 #include "src/execution/isolate.h"
@@ -30,6 +31,29 @@ class FutexWaitList {
   FutexWaitList(const FutexWaitList&) = delete;
   FutexWaitList& operator=(const FutexWaitList&) = delete;
 
+  struct HeadAndTail {
+    FutexWaitListNode* head;
+    FutexWaitListNode* tail;
+  };
+
+  // Waiters are spread over a fixed number of buckets by their wait location,
+  // so that waiting on and waking different locations doesn't contend on a
+  // single lock.
+  struct Bucket {
+    // Protects the composition of |location_lists| (i.e. no elements may be
+    // added or removed without holding this mutex), and the waiting_ field of
+    // the async nodes on them.
+    base::Mutex mutex;
+    // Location inside a shared buffer -> linked list of Nodes waiting on that
+    // location.
+    std::map<int8_t*, HeadAndTail> location_lists;
+  };
+
+  Bucket* BucketFor(int8_t* wait_location) {
+    return &buckets_[base::hash_value(wait_location) % kNumBuckets];
+  }
+
+  // The bucket mutex for the node's wait location must be held.
   void AddNode(FutexWaitListNode* node);
   void RemoveNode(FutexWaitListNode* node);
 
@@ -74,8 +98,10 @@ class FutexWaitList {
     *tail = new_tail;
   }
 
-  // For checking the internal consistency of the FutexWaitList.
-  void Verify();
+  // For checking the internal consistency of the FutexWaitList. The mutex of
+  // the bucket and the promise list mutex, respectively, must be held.
+  void VerifyBucket(Bucket* bucket);
+  void VerifyPromiseLists();
   // Verifies the local consistency of |node|. If it's the first node of its
   // list, it must be |head|, and if it's the last node, it must be |tail|.
   void VerifyNode(FutexWaitListNode* node, FutexWaitListNode* head,
@@ -86,13 +112,12 @@ class FutexWaitList {
  private:
   friend class FutexEmulation;
 
-  struct HeadAndTail {
-    FutexWaitListNode* head;
-    FutexWaitListNode* tail;
-  };
-  // Location inside a shared buffer -> linked list of Nodes waiting on that
-  // location.
-  std::map<int8_t*, HeadAndTail> location_lists_;
+  static constexpr size_t kNumBuckets = 256;
+  Bucket buckets_[kNumBuckets];
+
+  // Protects the composition of |isolate_promises_to_resolve_|. When taken
+  // together with a bucket mutex, the bucket mutex must be taken first.
+  base::Mutex promise_lists_mutex_;
 
   // Isolate* -> linked list of Nodes which are waiting for their Promises to
   // be resolved.
@@ -100,12 +125,6 @@ class FutexWaitList {
 };
 
 namespace {
-// `g_mutex` protects the composition of `g_wait_list` (i.e. no elements may be
-// added or removed without holding this mutex), as well as the `waiting_`
-// and `interrupted_` fields for each individual list node that is currently
-// part of the list. It must be the mutex used together with the `cond_`
-// condition variable of such nodes.
-base::LazyMutex g_mutex = LAZY_MUTEX_INITIALIZER;
 base::LazyInstance<FutexWaitList>::type g_wait_list = LAZY_INSTANCE_INITIALIZER;
 }  // namespace
 
@@ -125,12 +144,12 @@ bool FutexWaitListNode::CancelTimeoutTask() {
 
 void FutexWaitListNode::NotifyWake() {
   DCHECK(!IsAsync());
-  // Lock the FutexEmulation mutex before notifying. We know that the mutex
-  // will have been unlocked if we are currently waiting on the condition
-  // variable. The mutex will not be locked if FutexEmulation::Wait hasn't
-  // locked it yet. In that case, we set the interrupted_
-  // flag to true, which will be tested after the mutex locked by a future wait.
-  NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
+  // Lock the node's mutex before notifying. We know that the mutex will have
+  // been unlocked if we are currently waiting on the condition variable. The
+  // mutex will not be locked if FutexEmulation::Wait hasn't locked it yet. In
+  // that case, we set the interrupted_ flag to true, which will be tested
+  // after the mutex locked by a future wait.
+  NoGarbageCollectionMutexGuard lock_guard(&mutex_);
 
   // if not waiting, this will not have any effect.
   cond_.NotifyOne();
@@ -167,19 +186,20 @@ class AsyncWaiterTimeoutTask : public CancelableTask {
 
 void FutexEmulation::NotifyAsyncWaiter(FutexWaitListNode* node) {
   // This function can run in any thread.
-
-  g_mutex.Pointer()->AssertHeld();
+  FutexWaitList* wait_list = g_wait_list.Pointer();
+  wait_list->BucketFor(node->wait_location_)->mutex.AssertHeld();
 
   // Nullify the timeout time; this distinguishes timed out waiters from
   // woken up ones.
   node->async_timeout_time_ = base::TimeTicks();
 
-  g_wait_list.Pointer()->RemoveNode(node);
+  wait_list->RemoveNode(node);
 
   // Schedule a task for resolving the Promise. It's still possible that the
   // timeout task runs before the promise resolving task. In that case, the
   // timeout task will just ignore the node.
-  auto& isolate_map = g_wait_list.Pointer()->isolate_promises_to_resolve_;
+  NoGarbageCollectionMutexGuard lock_guard(&wait_list->promise_lists_mutex_);
+  auto& isolate_map = wait_list->isolate_promises_to_resolve_;
   auto it = isolate_map.find(node->isolate_for_async_waiters_);
   if (it == isolate_map.end()) {
     // This Isolate doesn't have other Promises to resolve at the moment.
@@ -194,14 +214,18 @@ void FutexEmulation::NotifyAsyncWaiter(FutexWaitListNode* node) {
     it->second.tail->next_ = node;
     it->second.tail = node;
   }
+  wait_list->VerifyPromiseLists();
 }
 
 void FutexWaitList::AddNode(FutexWaitListNode* node) {
   DCHECK_NULL(node->prev_);
   DCHECK_NULL(node->next_);
-  auto it = location_lists_.find(node->wait_location_);
-  if (it == location_lists_.end()) {
-    location_lists_.insert(
+  Bucket* bucket = BucketFor(node->wait_location_);
+  bucket->mutex.AssertHeld();
+  auto& location_lists = bucket->location_lists;
+  auto it = location_lists.find(node->wait_location_);
+  if (it == location_lists.end()) {
+    location_lists.insert(
         std::make_pair(node->wait_location_, HeadAndTail{node, node}));
   } else {
     it->second.tail->next_ = node;
@@ -209,12 +233,15 @@ void FutexWaitList::AddNode(FutexWaitListNode* node) {
     it->second.tail = node;
   }
 
-  Verify();
+  VerifyBucket(bucket);
 }
 
 void FutexWaitList::RemoveNode(FutexWaitListNode* node) {
-  auto it = location_lists_.find(node->wait_location_);
-  DCHECK_NE(location_lists_.end(), it);
+  Bucket* bucket = BucketFor(node->wait_location_);
+  bucket->mutex.AssertHeld();
+  auto& location_lists = bucket->location_lists;
+  auto it = location_lists.find(node->wait_location_);
+  DCHECK_NE(location_lists.end(), it);
   DCHECK(NodeIsOnList(node, it->second.head));
 
   if (node->prev_) {
@@ -233,12 +260,12 @@ void FutexWaitList::RemoveNode(FutexWaitListNode* node) {
 
   // If the node was the last one on its list, delete the whole list.
   if (node->prev_ == nullptr && node->next_ == nullptr) {
-    location_lists_.erase(it);
+    location_lists.erase(it);
   }
 
   node->prev_ = node->next_ = nullptr;
 
-  Verify();
+  VerifyBucket(bucket);
 }
 
 void AtomicsWaitWakeHandle::Wake() {
@@ -246,11 +273,12 @@ void AtomicsWaitWakeHandle::Wake() {
   // itself would likely just add unnecessary complexity..
   // The split lock by itself isn’t an issue, as long as the caller properly
   // synchronizes this with the closing `AtomicsWaitCallback`.
+  FutexWaitListNode* node = isolate_->futex_wait_list_node();
   {
-    NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
+    NoGarbageCollectionMutexGuard lock_guard(&node->mutex_);
     stopped_ = true;
   }
-  isolate_->futex_wait_list_node()->NotifyWake();
+  node->NotifyWake();
 }
 
 enum WaitReturnValue : int { kOk = 0, kNotEqual = 1, kTimedOut = 2 };
@@ -379,29 +407,36 @@ Object FutexEmulation::WaitSync(Isolate* isolate,
   Handle<Object> result;
   AtomicsWaitEvent callback_result = AtomicsWaitEvent::kWokenUp;
 
+  FutexWaitList* wait_list = g_wait_list.Pointer();
+  FutexWaitListNode* node = isolate->futex_wait_list_node();
+  std::shared_ptr<BackingStore> backing_store = array_buffer->GetBackingStore();
+  DCHECK(backing_store);
+  int8_t* wait_location =
+      FutexWaitList::ToWaitLocation(backing_store.get(), addr);
+  FutexWaitList::Bucket* bucket = wait_list->BucketFor(wait_location);
+
   do {  // Not really a loop, just makes it easier to break out early.
-    NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
-
-    std::shared_ptr<BackingStore> backing_store =
-        array_buffer->GetBackingStore();
-    DCHECK(backing_store);
-    FutexWaitListNode* node = isolate->futex_wait_list_node();
-    node->backing_store_ = backing_store;
-    node->wait_addr_ = addr;
-    auto wait_location =
-        FutexWaitList::ToWaitLocation(backing_store.get(), addr);
-    node->wait_location_ = wait_location;
-    node->waiting_ = true;
-
-    // Reset node->waiting_ = false when leaving this scope (but while
-    // still holding the lock).
-    FutexWaitListNode::ResetWaitingOnScopeExit reset_waiting(node);
-
-    std::atomic<T>* p = reinterpret_cast<std::atomic<T>*>(wait_location);
-    if (p->load() != value) {
-      result = handle(Smi::FromInt(WaitReturnValue::kNotEqual), isolate);
-      callback_result = AtomicsWaitEvent::kNotEqual;
-      break;
+    {
+      NoGarbageCollectionMutexGuard bucket_guard(&bucket->mutex);
+
+      std::atomic<T>* p = reinterpret_cast<std::atomic<T>*>(wait_location);
+      if (p->load() != value) {
+        result = handle(Smi::FromInt(WaitReturnValue::kNotEqual), isolate);
+        callback_result = AtomicsWaitEvent::kNotEqual;
+        break;
+      }
+
+      // Lock order is bucket mutex before node mutex, as in Wake.
+      NoGarbageCollectionMutexGuard node_guard(&node->mutex_);
+      node->backing_store_ = backing_store;
+      node->wait_addr_ = addr;
+      node->wait_location_ = wait_location;
+      node->waiting_ = true;
+
+      // Once the node is on the list and the bucket mutex is released,
+      // FutexEmulation::Wake can find it and wake it up by resetting
+      // node->waiting_, which is checked below before going to sleep.
+      wait_list->AddNode(node);
     }
 
     base::TimeTicks timeout_time;
@@ -412,77 +447,86 @@ Object FutexEmulation::WaitSync(Isolate* isolate,
       timeout_time = current_time + rel_timeout;
     }
 
-    g_wait_list.Pointer()->AddNode(node);
-
-    while (true) {
-      bool interrupted = node->interrupted_;
-      node->interrupted_ = false;
-
-      // Unlock the mutex here to prevent deadlock from lock ordering between
-      // mutex and mutexes locked by HandleInterrupts.
-      lock_guard.Unlock();
-
-      // Because the mutex is unlocked, we have to be careful about not dropping
-      // an interrupt. The notification can happen in three different places:
-      // 1) Before Wait is called: the notification will be dropped, but
-      //    interrupted_ will be set to 1. This will be checked below.
-      // 2) After interrupted has been checked here, but before mutex is
-      //    acquired: interrupted is checked again below, with mutex locked.
-      //    Because the wakeup signal also acquires mutex, we know it will not
-      //    be able to notify until mutex is released below, when waiting on
-      //    the condition variable.
-      // 3) After the mutex is released in the call to WaitFor(): this
-      // notification will wake up the condition variable. node->waiting() will
-      // be false, so we'll loop and then check interrupts.
-      if (interrupted) {
-        Object interrupt_object = isolate->stack_guard()->HandleInterrupts();
-        if (interrupt_object.IsException(isolate)) {
-          result = handle(interrupt_object, isolate);
-          callback_result = AtomicsWaitEvent::kTerminatedExecution;
-          lock_guard.Lock();
-          break;
+    {
+      NoGarbageCollectionMutexGuard lock_guard(&node->mutex_);
+
+      // Reset node->waiting_ = false when leaving this scope (but while
+      // still holding the lock), so that a timed out or terminated waiter is
+      // not counted as woken by a concurrent Wake.
+      FutexWaitListNode::ResetWaitingOnScopeExit reset_waiting(node);
+
+      while (true) {
+        bool interrupted = node->interrupted_;
+        node->interrupted_ = false;
+
+        // Unlock the mutex here to prevent deadlock from lock ordering between
+        // mutex and mutexes locked by HandleInterrupts.
+        lock_guard.Unlock();
+
+        // Because the mutex is unlocked, we have to be careful about not
+        // dropping an interrupt. The notification can happen in three
+        // different places:
+        // 1) Before Wait is called: the notification will be dropped, but
+        //    interrupted_ will be set to 1. This will be checked below.
+        // 2) After interrupted has been checked here, but before mutex is
+        //    acquired: interrupted is checked again below, with mutex locked.
+        //    Because the wakeup signal also acquires mutex, we know it will
+        //    not be able to notify until mutex is released below, when
+        //    waiting on the condition variable.
+        // 3) After the mutex is released in the call to WaitFor(): this
+        // notification will wake up the condition variable. node->waiting()
+        // will be false, so we'll loop and then check interrupts.
+        if (interrupted) {
+          Object interrupt_object = isolate->stack_guard()->HandleInterrupts();
+          if (interrupt_object.IsException(isolate)) {
+            result = handle(interrupt_object, isolate);
+            callback_result = AtomicsWaitEvent::kTerminatedExecution;
+            lock_guard.Lock();
+            break;
+          }
         }
-      }
 
-      lock_guard.Lock();
+        lock_guard.Lock();
 
-      if (node->interrupted_) {
-        // An interrupt occurred while the mutex was unlocked. Don't wait yet.
-        continue;
-      }
-
-      if (stop_handle.has_stopped()) {
-        node->waiting_ = false;
-        callback_result = AtomicsWaitEvent::kAPIStopped;
-      }
+        if (node->interrupted_) {
+          // An interrupt occurred while the mutex was unlocked. Don't wait yet.
+          continue;
+        }
 
-      if (!node->waiting_) {
-        result = handle(Smi::FromInt(WaitReturnValue::kOk), isolate);
-        break;
-      }
+        if (stop_handle.has_stopped()) {
+          node->waiting_ = false;
+          callback_result = AtomicsWaitEvent::kAPIStopped;
+        }
 
-      // No interrupts, now wait.
-      if (use_timeout) {
-        current_time = base::TimeTicks::Now();
-        if (current_time >= timeout_time) {
-          result = handle(Smi::FromInt(WaitReturnValue::kTimedOut), isolate);
-          callback_result = AtomicsWaitEvent::kTimedOut;
+        if (!node->waiting_) {
+          result = handle(Smi::FromInt(WaitReturnValue::kOk), isolate);
           break;
         }
 
-        base::TimeDelta time_until_timeout = timeout_time - current_time;
-        DCHECK_GE(time_until_timeout.InMicroseconds(), 0);
-        bool wait_for_result =
-            node->cond_.WaitFor(g_mutex.Pointer(), time_until_timeout);
-        USE(wait_for_result);
-      } else {
-        node->cond_.Wait(g_mutex.Pointer());
-      }
+        // No interrupts, now wait.
+        if (use_timeout) {
+          current_time = base::TimeTicks::Now();
+          if (current_time >= timeout_time) {
+            result = handle(Smi::FromInt(WaitReturnValue::kTimedOut), isolate);
+            callback_result = AtomicsWaitEvent::kTimedOut;
+            break;
+          }
+
+          base::TimeDelta time_until_timeout = timeout_time - current_time;
+          DCHECK_GE(time_until_timeout.InMicroseconds(), 0);
+          bool wait_for_result =
+              node->cond_.WaitFor(&node->mutex_, time_until_timeout);
+          USE(wait_for_result);
+        } else {
+          node->cond_.Wait(&node->mutex_);
+        }
 
-      // Spurious wakeup, interrupt or timeout.
+        // Spurious wakeup, interrupt or timeout.
+      }
     }
 
-    g_wait_list.Pointer()->RemoveNode(node);
+    NoGarbageCollectionMutexGuard bucket_guard(&bucket->mutex);
+    wait_list->RemoveNode(node);
   } while (false);
 
   isolate->RunAtomicsWaitCallback(callback_result, array_buffer, addr, value,
@@ -586,8 +630,10 @@ Object FutexEmulation::WaitAsync(Isolate* isolate,
       new FutexWaitListNode(backing_store, addr, promise_capability, isolate);
 
   {
-    NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
-    g_wait_list.Pointer()->AddNode(node);
+    FutexWaitList* wait_list = g_wait_list.Pointer();
+    NoGarbageCollectionMutexGuard lock_guard(
+        &wait_list->BucketFor(node->wait_location_)->mutex);
+    wait_list->AddNode(node);
   }
   if (use_timeout) {
     node->async_timeout_time_ = base::TimeTicks::Now() + rel_timeout;
@@ -619,9 +665,11 @@ Object FutexEmulation::Wake(Handle<JSArrayBuffer> array_buffer, size_t addr,
   std::shared_ptr<BackingStore> backing_store = array_buffer->GetBackingStore();
   auto wait_location = FutexWaitList::ToWaitLocation(backing_store.get(), addr);
 
-  NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
+  FutexWaitList* wait_list = g_wait_list.Pointer();
+  FutexWaitList::Bucket* bucket = wait_list->BucketFor(wait_location);
+  NoGarbageCollectionMutexGuard lock_guard(&bucket->mutex);
 
-  auto& location_lists = g_wait_list.Pointer()->location_lists_;
+  auto& location_lists = bucket->location_lists;
   auto it = location_lists.find(wait_location);
   if (it == location_lists.end()) {
     return Smi::zero();
@@ -632,6 +680,32 @@ Object FutexEmulation::Wake(Handle<JSArrayBuffer> array_buffer, size_t addr,
     std::shared_ptr<BackingStore> node_backing_store =
         node->backing_store_.lock();
 
+    if (!node->IsAsync()) {
+      // The waiting_ flag of sync nodes is protected by the node's own mutex,
+      // which WaitSync sleeps on. Sync nodes are only on the list while their
+      // Isolate is in WaitSync, which keeps the BackingStore alive, so they
+      // never need to be cleaned up here.
+      bool woken = false;
+      if (backing_store.get() == node_backing_store.get()) {
+        NoGarbageCollectionMutexGuard node_guard(&node->mutex_);
+        if (node->waiting_) {
+          DCHECK_EQ(addr, node->wait_addr_);
+          node->waiting_ = false;
+          // WaitSync will remove the node from the list.
+          node->cond_.NotifyOne();
+          woken = true;
+        }
+      }
+      if (woken) {
+        if (num_waiters_to_wake != kWakeAll) {
+          --num_waiters_to_wake;
+        }
+        waiters_woken++;
+      }
+      node = node->next_;
+      continue;
+    }
+
     if (!node->waiting_) {
       node = node->next_;
       continue;
@@ -647,12 +721,7 @@ Object FutexEmulation::Wake(Handle<JSArrayBuffer> array_buffer, size_t addr,
       // since NotifyAsyncWaiter will take the node out of the linked list.
       auto old_node = node;
       node = node->next_;
-      if (old_node->IsAsync()) {
-        NotifyAsyncWaiter(old_node);
-      } else {
-        // WaitSync will remove the node from the list.
-        old_node->cond_.NotifyOne();
-      }
+      NotifyAsyncWaiter(old_node);
       if (num_waiters_to_wake != kWakeAll) {
         --num_waiters_to_wake;
       }
@@ -690,7 +759,7 @@ Object FutexEmulation::Wake(Handle<JSArrayBuffer> array_buffer, size_t addr,
     if (delete_this_node) {
       auto old_node = node;
       node = node->next_;
-      g_wait_list.Pointer()->RemoveNode(old_node);
+      wait_list->RemoveNode(old_node);
       DCHECK_EQ(CancelableTaskManager::kInvalidTaskId,
                 old_node->timeout_task_id_);
       delete old_node;
@@ -704,7 +773,8 @@ Object FutexEmulation::Wake(Handle<JSArrayBuffer> array_buffer, size_t addr,
 
 void FutexEmulation::CleanupAsyncWaiterPromise(FutexWaitListNode* node) {
   // This function must run in the main thread of node's Isolate. This function
-  // may allocate memory. To avoid deadlocks, we shouldn't be holding g_mutex.
+  // may allocate memory. To avoid deadlocks, we shouldn't be holding any
+  // FutexWaitList mutex.
 
   DCHECK(FLAG_harmony_atomics_waitasync);
   DCHECK(node->IsAsync());
@@ -783,9 +853,10 @@ void FutexEmulation::ResolveAsyncWaiterPromises(Isolate* isolate) {
 
   FutexWaitListNode* node;
   {
-    NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
+    FutexWaitList* wait_list = g_wait_list.Pointer();
+    NoGarbageCollectionMutexGuard lock_guard(&wait_list->promise_lists_mutex_);
 
-    auto& isolate_map = g_wait_list.Pointer()->isolate_promises_to_resolve_;
+    auto& isolate_map = wait_list->isolate_promises_to_resolve_;
     auto it = isolate_map.find(isolate);
     DCHECK_NE(isolate_map.end(), it);
 
@@ -817,7 +888,9 @@ void FutexEmulation::HandleAsyncWaiterTimeout(FutexWaitListNode* node) {
   DCHECK(node->IsAsync());
 
   {
-    NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
+    FutexWaitList* wait_list = g_wait_list.Pointer();
+    NoGarbageCollectionMutexGuard lock_guard(
+        &wait_list->BucketFor(node->wait_location_)->mutex);
 
     node->timeout_task_id_ = CancelableTaskManager::kInvalidTaskId;
     if (!node->waiting_) {
@@ -825,7 +898,7 @@ void FutexEmulation::HandleAsyncWaiterTimeout(FutexWaitListNode* node) {
       // resolved. Ignore the timeout.
       return;
     }
-    g_wait_list.Pointer()->RemoveNode(node);
+    wait_list->RemoveNode(node);
   }
 
   // "node" has been taken out of the lists, so it's ok to access it without
@@ -838,14 +911,16 @@ void FutexEmulation::HandleAsyncWaiterTimeout(FutexWaitListNode* node) {
 }
 
 void FutexEmulation::IsolateDeinit(Isolate* isolate) {
-  NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
+  FutexWaitList* wait_list = g_wait_list.Pointer();
 
   // Iterate all locations to find nodes belonging to "isolate" and delete them.
   // The Isolate is going away; don't bother cleaning up the Promises in the
   // NativeContext. Also we don't need to cancel the timeout tasks, since they
-  // will be cancelled by Isolate::Deinit.
-  {
-    auto& location_lists = g_wait_list.Pointer()->location_lists_;
+  // will be cancelled by Isolate::Deinit. Nodes which are concurrently woken
+  // move to the promise lists, which are processed after all buckets.
+  for (FutexWaitList::Bucket& bucket : wait_list->buckets_) {
+    NoGarbageCollectionMutexGuard lock_guard(&bucket.mutex);
+    auto& location_lists = bucket.location_lists;
     auto it = location_lists.begin();
     while (it != location_lists.end()) {
       FutexWaitListNode*& head = it->second.head;
@@ -859,10 +934,12 @@ void FutexEmulation::IsolateDeinit(Isolate* isolate) {
         ++it;
       }
     }
+    wait_list->VerifyBucket(&bucket);
   }
 
   {
-    auto& isolate_map = g_wait_list.Pointer()->isolate_promises_to_resolve_;
+    NoGarbageCollectionMutexGuard lock_guard(&wait_list->promise_lists_mutex_);
+    auto& isolate_map = wait_list->isolate_promises_to_resolve_;
     auto it = isolate_map.find(isolate);
     if (it != isolate_map.end()) {
       auto node = it->second.head;
@@ -873,9 +950,8 @@ void FutexEmulation::IsolateDeinit(Isolate* isolate) {
       }
       isolate_map.erase(it);
     }
+    wait_list->VerifyPromiseLists();
   }
-
-  g_wait_list.Pointer()->Verify();
 }
 
 Object FutexEmulation::NumWaitersForTesting(Handle<JSArrayBuffer> array_buffer,
@@ -883,10 +959,12 @@ Object FutexEmulation::NumWaitersForTesting(Handle<JSArrayBuffer> array_buffer,
   DCHECK_LT(addr, array_buffer->byte_length());
   std::shared_ptr<BackingStore> backing_store = array_buffer->GetBackingStore();
 
-  NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
-
   auto wait_location = FutexWaitList::ToWaitLocation(backing_store.get(), addr);
-  auto& location_lists = g_wait_list.Pointer()->location_lists_;
+  FutexWaitList::Bucket* bucket =
+      g_wait_list.Pointer()->BucketFor(wait_location);
+  NoGarbageCollectionMutexGuard lock_guard(&bucket->mutex);
+
+  auto& location_lists = bucket->location_lists;
   auto it = location_lists.find(wait_location);
   if (it == location_lists.end()) {
     return Smi::zero();
@@ -896,8 +974,13 @@ Object FutexEmulation::NumWaitersForTesting(Handle<JSArrayBuffer> array_buffer,
   while (node != nullptr) {
     std::shared_ptr<BackingStore> node_backing_store =
         node->backing_store_.lock();
-    if (backing_store.get() == node_backing_store.get() && node->waiting_) {
-      waiters++;
+    if (backing_store.get() == node_backing_store.get()) {
+      if (node->IsAsync()) {
+        if (node->waiting_) waiters++;
+      } else {
+        NoGarbageCollectionMutexGuard node_guard(&node->mutex_);
+        if (node->waiting_) waiters++;
+      }
     }
 
     node = node->next_;
@@ -907,16 +990,17 @@ Object FutexEmulation::NumWaitersForTesting(Handle<JSArrayBuffer> array_buffer,
 }
 
 Object FutexEmulation::NumAsyncWaitersForTesting(Isolate* isolate) {
-  NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
-
   int waiters = 0;
-  for (const auto& it : g_wait_list.Pointer()->location_lists_) {
-    FutexWaitListNode* node = it.second.head;
-    while (node != nullptr) {
-      if (node->isolate_for_async_waiters_ == isolate && node->waiting_) {
-        waiters++;
+  for (FutexWaitList::Bucket& bucket : g_wait_list.Pointer()->buckets_) {
+    NoGarbageCollectionMutexGuard lock_guard(&bucket.mutex);
+    for (const auto& it : bucket.location_lists) {
+      FutexWaitListNode* node = it.second.head;
+      while (node != nullptr) {
+        if (node->isolate_for_async_waiters_ == isolate && node->waiting_) {
+          waiters++;
+        }
+        node = node->next_;
       }
-      node = node->next_;
     }
   }
 
@@ -928,10 +1012,11 @@ Object FutexEmulation::NumUnresolvedAsyncPromisesForTesting(
   DCHECK_LT(addr, array_buffer->byte_length());
   std::shared_ptr<BackingStore> backing_store = array_buffer->GetBackingStore();
 
-  NoGarbageCollectionMutexGuard lock_guard(g_mutex.Pointer());
+  FutexWaitList* wait_list = g_wait_list.Pointer();
+  NoGarbageCollectionMutexGuard lock_guard(&wait_list->promise_lists_mutex_);
 
   int waiters = 0;
-  auto& isolate_map = g_wait_list.Pointer()->isolate_promises_to_resolve_;
+  auto& isolate_map = wait_list->isolate_promises_to_resolve_;
   for (const auto& it : isolate_map) {
     FutexWaitListNode* node = it.second.head;
     while (node != nullptr) {
@@ -974,16 +1059,21 @@ void FutexWaitList::VerifyNode(FutexWaitListNode* node, FutexWaitListNode* head,
 #endif  // DEBUG
 }
 
-void FutexWaitList::Verify() {
+void FutexWaitList::VerifyBucket(Bucket* bucket) {
 #ifdef DEBUG
-  for (const auto& it : location_lists_) {
+  for (const auto& it : bucket->location_lists) {
+    DCHECK_EQ(bucket, BucketFor(it.first));
     FutexWaitListNode* node = it.second.head;
     while (node != nullptr) {
       VerifyNode(node, it.second.head, it.second.tail);
       node = node->next_;
     }
   }
+#endif  // DEBUG
+}
 
+void FutexWaitList::VerifyPromiseLists() {
+#ifdef DEBUG
   for (const auto& it : isolate_promises_to_resolve_) {
     auto node = it.second.head;
     while (node != nullptr) {
@@ -87,6 +87,7 @@ class FutexWaitListNode {
   };
 
  private:
+  friend class AtomicsWaitWakeHandle;
   friend class FutexEmulation;
   friend class FutexWaitList;
 
@@ -95,8 +96,12 @@ class FutexWaitListNode {
   std::shared_ptr<TaskRunner> task_runner_;
   CancelableTaskManager* cancelable_task_manager_ = nullptr;
 
+  // Only used by sync FutexWaitListNodes. |mutex_| is the mutex used together
+  // with |cond_|, and protects waiting_ and interrupted_ of the node.
+  base::Mutex mutex_;
   base::ConditionVariable cond_;
-  // prev_ and next_ are protected by FutexEmulation::mutex_.
+  // prev_ and next_ are protected by the mutex of the FutexWaitList bucket
+  // which contains the node's wait location.
   FutexWaitListNode* prev_ = nullptr;
   FutexWaitListNode* next_ = nullptr;
 
@@ -113,9 +118,9 @@ class FutexWaitListNode {
   // update the head and tail of the list).
   int8_t* wait_location_ = nullptr;
 
-  // waiting_ and interrupted_ are protected by FutexEmulation::mutex_
-  // if this node is currently contained in FutexEmulation::wait_list_
-  // or an AtomicsWaitWakeHandle has access to it.
+  // For sync nodes, waiting_ and interrupted_ are protected by mutex_. For
+  // async nodes, waiting_ is protected by the mutex of the bucket containing
+  // the node's wait location.
   bool waiting_ = false;
   bool interrupted_ = false;
 
@@ -77,7 +77,9 @@
 #include "src/objects/visitors.h"
 #include "src/profiler/heap-profiler.h"
 #include "src/profiler/tracing-cpu-profiler.h"
+#include "src/regexp/experimental/experimental-interpreter.h"
 #include "src/regexp/regexp-stack.h"
+#include "src/regexp/regexp-stats.h"
 #include "src/snapshot/embedded/embedded-data.h"
 #include "src/snapshot/embedded/embedded-file-writer.h"
 #include "src/snapshot/read-only-deserializer.h"
@@ -3172,6 +3174,15 @@ Isolate::~Isolate() {
   delete regexp_stack_;
   regexp_stack_ = nullptr;
 
+  delete regexp_stats_;
+  regexp_stats_ = nullptr;
+
+  delete experimental_regexp_lookaround_cache_;
+  experimental_regexp_lookaround_cache_ = nullptr;
+
+  delete experimental_regexp_dfa_cache_;
+  experimental_regexp_dfa_cache_ = nullptr;
+
   delete descriptor_lookup_cache_;
   descriptor_lookup_cache_ = nullptr;
 
@@ -3519,6 +3530,9 @@ bool Isolate::Init(SnapshotData* startup_snapshot_data,
   materialized_object_store_ = new MaterializedObjectStore(this);
   regexp_stack_ = new RegExpStack();
   regexp_stack_->isolate_ = this;
+  experimental_regexp_lookaround_cache_ =
+      new ExperimentalRegExpLookaroundCache();
+  experimental_regexp_dfa_cache_ = new ExperimentalRegExpDfaCache();
   date_cache_ = new DateCache();
   heap_profiler_ = new HeapProfiler(heap());
   interpreter_ = new interpreter::Interpreter(this);
@@ -3876,6 +3890,11 @@ void Isolate::IncreaseTotalRegexpCodeGenerated(Handle<HeapObject> code) {
   total_regexp_code_generated_ += code->Size();
 }
 
+RegExpStats* Isolate::EnsureRegExpStats() {
+  if (regexp_stats_ == nullptr) regexp_stats_ = new RegExpStats();
+  return regexp_stats_;
+}
+
 bool Isolate::NeedsDetailedOptimizedCodeLineInfo() const {
   return NeedsSourcePositionsForProfiling() ||
          detailed_source_positions_for_profiling();
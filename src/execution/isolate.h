@@ -81,6 +81,8 @@ class Deoptimizer;
 class DescriptorLookupCache;
 class EmbeddedFileWriterInterface;
 class EternalHandles;
+class ExperimentalRegExpDfaCache;
+class ExperimentalRegExpLookaroundCache;
 class HandleScopeImplementer;
 class HeapObjectToIndexHashMap;
 class HeapProfiler;
@@ -95,6 +97,7 @@ class PersistentHandles;
 class PersistentHandlesList;
 class ReadOnlyArtifacts;
 class RegExpStack;
+class RegExpStats;
 class RootVisitor;
 class RuntimeProfiler;
 class SetupIsolateDelegate;
@@ -1136,11 +1139,25 @@ class V8_EXPORT_PRIVATE Isolate final : private HiddenFactory {
 
   RegExpStack* regexp_stack() { return regexp_stack_; }
 
+  ExperimentalRegExpLookaroundCache* experimental_regexp_lookaround_cache() {
+    return experimental_regexp_lookaround_cache_;
+  }
+
+  ExperimentalRegExpDfaCache* experimental_regexp_dfa_cache() {
+    return experimental_regexp_dfa_cache_;
+  }
+
   size_t total_regexp_code_generated() { return total_regexp_code_generated_; }
   void IncreaseTotalRegexpCodeGenerated(Handle<HeapObject> code);
 
   std::vector<int>* regexp_indices() { return &regexp_indices_; }
 
+  // Returns nullptr unless --regexp-stats is set.
+  RegExpStats* regexp_stats() {
+    if (V8_LIKELY(!FLAG_regexp_stats)) return nullptr;
+    return EnsureRegExpStats();
+  }
+
   Debug* debug() { return debug_; }
 
   void* is_profiling_address() { return &is_profiling_; }
@@ -1665,6 +1682,8 @@ class V8_EXPORT_PRIVATE Isolate final : private HiddenFactory {
   void InitializeCodeRanges();
   void AddCodeMemoryRange(MemoryRange range);
 
+  RegExpStats* EnsureRegExpStats();
+
   static void RemoveContextIdCallback(const v8::WeakCallbackInfo<void>& data);
 
   class ThreadDataTable {
@@ -1813,6 +1832,10 @@ class V8_EXPORT_PRIVATE Isolate final : private HiddenFactory {
 #endif  // !V8_INTL_SUPPORT
   RegExpStack* regexp_stack_ = nullptr;
   std::vector<int> regexp_indices_;
+  RegExpStats* regexp_stats_ = nullptr;
+  ExperimentalRegExpLookaroundCache* experimental_regexp_lookaround_cache_ =
+      nullptr;
+  ExperimentalRegExpDfaCache* experimental_regexp_dfa_cache_ = nullptr;
   DateCache* date_cache_ = nullptr;
   base::RandomNumberGenerator* random_number_generator_ = nullptr;
   base::RandomNumberGenerator* fuzzer_rng_ = nullptr;
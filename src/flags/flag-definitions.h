@@ -504,6 +504,14 @@ DEFINE_INT(interrupt_budget, 144 * KB,
 
 // Flags for inline caching and feedback vectors.
 DEFINE_BOOL(use_ic, true, "use inline caching")
+DEFINE_INT(stub_cache_primary_bits,
+           v8::internal::kStubCacheDefaultPrimaryTableBits,
+           "log2 of the number of entries in the primary megamorphic stub "
+           "cache tables")
+DEFINE_INT(stub_cache_secondary_bits,
+           v8::internal::kStubCacheDefaultSecondaryTableBits,
+           "log2 of the number of entries in the secondary megamorphic stub "
+           "cache tables")
 DEFINE_INT(budget_for_feedback_vector_allocation, 1 * KB,
            "The budget in amount of bytecode executed by a function before we "
            "decide to allocate feedback vectors")
@@ -708,11 +716,18 @@ DEFINE_BOOL(turbo_profiling_log_builtins, false,
             "that V8 was built with v8_enable_builtins_profiling=true)")
 DEFINE_BOOL(turbo_verify_allocation, DEBUG_BOOL,
             "verify register allocation in TurboFan")
+DEFINE_BOOL(turbo_force_mid_tier_regalloc, false,
+            "use the mid-tier register allocator for all TurboFan code")
+DEFINE_INT(turbo_mid_tier_regalloc_threshold, 0,
+           "use the mid-tier register allocator for wasm functions with "
+           "more virtual registers than this (0 to disable)")
 DEFINE_BOOL(turbo_move_optimization, true, "optimize gap moves in TurboFan")
 DEFINE_BOOL(turbo_jt, true, "enable jump threading in TurboFan")
 DEFINE_BOOL(turbo_loop_peeling, true, "Turbofan loop peeling")
 DEFINE_BOOL(turbo_loop_variable, true, "Turbofan loop variable optimization")
 DEFINE_BOOL(turbo_loop_rotation, true, "Turbofan loop rotation")
+DEFINE_BOOL(turbo_loop_bounds_check_elimination, true,
+            "Turbofan bounds check elimination based on loop conditions")
 DEFINE_BOOL(turbo_cf_optimization, true, "optimize control flow in TurboFan")
 DEFINE_BOOL(turbo_escape, true, "enable escape analysis")
 DEFINE_BOOL(turbo_allocation_folding, true, "Turbofan allocation folding")
@@ -796,6 +811,8 @@ DEFINE_BOOL(wasm_test_streaming, false,
             "use streaming compilation instead of async compilation for tests")
 DEFINE_UINT(wasm_max_mem_pages, v8::internal::wasm::kSpecMaxMemoryPages,
             "maximum number of 64KiB memory pages per wasm memory")
+DEFINE_UINT(wasm_max_mem64_pages, v8::internal::wasm::kV8MaxWasmMemory64Pages,
+            "maximum number of 64KiB memory pages per wasm memory64 memory")
 DEFINE_UINT(wasm_max_table_size, v8::internal::wasm::kV8MaxWasmTableSize,
             "maximum table size of a wasm instance")
 DEFINE_UINT(wasm_max_code_space, v8::internal::kMaxWasmCodeMB,
@@ -805,6 +822,13 @@ DEFINE_BOOL(wasm_tier_up, true,
             "have an effect)")
 DEFINE_BOOL(wasm_dynamic_tiering, false,
             "enable dynamic tier up to the optimizing compiler")
+DEFINE_INT(wasm_tiering_budget, 1024,
+           "number of calls after which a Liftoff function is tiered up with "
+           "--wasm-dynamic-tiering (rounded up to a power of two)")
+DEFINE_BOOL(wasm_function_code_cache, false,
+            "share TurboFan code of identical functions across wasm modules")
+DEFINE_UINT(wasm_function_code_cache_max_size, 64,
+            "maximum size of the wasm function code cache (in MB)")
 DEFINE_DEBUG_BOOL(trace_wasm_decoder, false, "trace decoding of wasm code")
 DEFINE_DEBUG_BOOL(trace_wasm_compiler, false, "trace compiling of wasm code")
 DEFINE_DEBUG_BOOL(trace_wasm_interpreter, false,
@@ -877,6 +901,8 @@ DEFINE_BOOL(wasm_stack_checks, true,
             "enable stack checks (disable for performance testing only)")
 DEFINE_BOOL(wasm_math_intrinsics, true,
             "intrinsify some Math imports into wasm")
+DEFINE_BOOL(wasm_fast_api, false,
+            "call the C function of imported API functions directly from wasm")
 
 DEFINE_BOOL(wasm_trap_handler, true,
             "use signal handlers to catch out of bounds memory access in wasm"
@@ -909,6 +935,13 @@ DEFINE_BOOL(wasm_code_gc, true, "enable garbage collection of wasm code")
 DEFINE_BOOL(trace_wasm_code_gc, false, "trace garbage collection of wasm code")
 DEFINE_BOOL(stress_wasm_code_gc, false,
             "stress test garbage collection of wasm code")
+DEFINE_BOOL(wasm_code_compaction, false,
+            "move live wasm code into free gaps of the code space after wasm "
+            "code GC")
+DEFINE_NEG_NEG_IMPLICATION(wasm_code_gc, wasm_code_compaction)
+DEFINE_UINT(wasm_code_compaction_threshold, 25,
+            "minimum percentage of committed wasm code space which does not "
+            "hold live code before code gets compacted")
 DEFINE_INT(wasm_max_initial_code_space_reservation, 0,
            "maximum size of the initial wasm code space reservation (in MB)")
 
@@ -1292,6 +1325,8 @@ DEFINE_BOOL(always_osr, false, "always try to OSR functions")
 DEFINE_BOOL(prepare_always_opt, false, "prepare for turning on always opt")
 
 DEFINE_BOOL(trace_serializer, false, "print code serializer trace")
+DEFINE_BOOL(serialize_regexp_data, true,
+            "include the data of compiled regexp literals in the code cache")
 #ifdef DEBUG
 DEFINE_BOOL(external_reference_stats, false,
             "print statistics on external references used during serialization")
@@ -1388,6 +1423,15 @@ DEFINE_BOOL(allow_natives_for_differential_fuzzing, false,
 DEFINE_IMPLICATION(allow_natives_for_differential_fuzzing, allow_natives_syntax)
 DEFINE_IMPLICATION(allow_natives_for_differential_fuzzing, fuzzing)
 DEFINE_BOOL(parse_only, false, "only parse the sources")
+DEFINE_BOOL(parallel_preparse, false,
+            "preparse the top-level function declarations of large external "
+            "string or UTF-8 streamed scripts on worker threads (IIFE "
+            "bundles are not supported)")
+DEFINE_INT(parallel_preparse_min_size, 1024,
+           "minimum size of a script to preparse in parallel (in KBytes)")
+DEFINE_BOOL(parallel_preparse_join, false,
+            "let the parser wait until all chunks are preparsed in parallel "
+            "(for testing)")
 
 // simulator-arm.cc, simulator-arm64.cc and simulator-mips.cc
 DEFINE_BOOL(trace_sim, false, "Trace simulator execution")
@@ -1491,6 +1535,9 @@ DEFINE_INT(regexp_tier_up_ticks, 1,
            "tiering-up to the compiler")
 DEFINE_BOOL(regexp_peephole_optimization, REGEXP_PEEPHOLE_OPTIMIZATION_BOOL,
             "enable peephole optimization for regexp bytecode")
+DEFINE_BOOL(regexp_prefilter, true,
+            "skip to positions at which one of the leading literals of a "
+            "regexp occurs before running the matcher")
 DEFINE_BOOL(trace_regexp_peephole_optimization, false,
             "trace regexp bytecode peephole optimization")
 DEFINE_BOOL(trace_regexp_bytecodes, false, "trace regexp bytecode execution")
@@ -1498,6 +1545,12 @@ DEFINE_BOOL(trace_regexp_assembler, false,
             "trace regexp macro assembler calls.")
 DEFINE_BOOL(trace_regexp_parser, false, "trace regexp parsing")
 DEFINE_BOOL(trace_regexp_tier_up, false, "trace regexp tiering up execution")
+DEFINE_BOOL(regexp_stats, false,
+            "collect execution statistics of regexps per source and flags")
+DEFINE_BOOL(regexp_shared_cache, false,
+            "share regexp bytecode between all isolates of the process")
+DEFINE_SIZE_T(regexp_shared_cache_size, 4096,
+              "maximum size of the shared regexp cache (in KBytes)")
 
 DEFINE_BOOL(enable_experimental_regexp_engine, false,
             "recognize regexps with 'l' flag, run them on experimental engine")
@@ -1507,6 +1560,22 @@ DEFINE_IMPLICATION(default_to_experimental_regexp_engine,
                    enable_experimental_regexp_engine)
 DEFINE_BOOL(trace_experimental_regexp_engine, false,
             "trace execution of experimental regexp engine")
+DEFINE_BOOL(experimental_regexp_engine_lazy_dfa, true,
+            "find matches of the experimental regexp engine with a lazily "
+            "built dfa where possible")
+DEFINE_UINT(experimental_regexp_engine_dfa_cache_size, 256,
+            "memory budget in KB for the states of the lazy dfa of the "
+            "experimental regexp engine")
+DEFINE_BOOL(experimental_regexp_engine_native_code, true,
+            "tier up experimental regexps without capture groups to native "
+            "code compiled from their dfa, using the regexp tier up flags")
+DEFINE_UINT(experimental_regexp_engine_max_native_dfa_states, 256,
+            "maximum number of dfa states of an experimental regexp that is "
+            "compiled to native code")
+DEFINE_UINT(experimental_regexp_engine_backreference_memo_size, 1024,
+            "maximum number of different thread states per input position "
+            "that the experimental regexp engine tracks for regexps with "
+            "back references before it falls back to backtracking")
 
 DEFINE_BOOL(enable_experimental_regexp_engine_on_excessive_backtracks, true,
             "fall back to a breadth-first regexp engine on excessive "
@@ -1583,6 +1652,10 @@ DEFINE_BOOL(help, false, "Print usage message, including flags, on console")
 DEFINE_BOOL(dump_counters, false, "Dump counters on exit")
 DEFINE_BOOL(dump_counters_nvp, false,
             "Dump counters as name-value pairs on exit")
+DEFINE_INT(dump_regexp_stats, 0,
+           "Dump the statistics of the given number of regexps with the most "
+           "execution time on exit")
+DEFINE_IMPLICATION(dump_regexp_stats, regexp_stats)
 DEFINE_BOOL(use_external_strings, false, "Use external strings for source code")
 DEFINE_STRING(map_counters, "", "Map counters to a file")
 DEFINE_BOOL(mock_arraybuffer_allocator, false,
@@ -1910,6 +1983,7 @@ DEFINE_BOOL(single_threaded, false, "disable the use of background tasks")
 DEFINE_IMPLICATION(single_threaded, single_threaded_gc)
 DEFINE_NEG_IMPLICATION(single_threaded, concurrent_recompilation)
 DEFINE_NEG_IMPLICATION(single_threaded, compiler_dispatcher)
+DEFINE_NEG_IMPLICATION(single_threaded, parallel_preparse)
 
 //
 // Parallel and concurrent GC (Orinoco) related flags.
@@ -3181,6 +3181,8 @@ void Factory::SetRegExpIrregexpData(Handle<JSRegExp> regexp,
   store->set(JSRegExp::kIrregexpCaptureNameMapIndex, uninitialized);
   store->set(JSRegExp::kIrregexpTicksUntilTierUpIndex, ticks_until_tier_up);
   store->set(JSRegExp::kIrregexpBacktrackLimit, Smi::FromInt(backtrack_limit));
+  store->set(JSRegExp::kIrregexpPrefilterIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpExperimentalFallbackIndex, uninitialized);
   regexp->set_data(*store);
 }
 
@@ -3190,6 +3192,14 @@ void Factory::SetRegExpExperimentalData(Handle<JSRegExp> regexp,
                                         int capture_count) {
   Handle<FixedArray> store = NewFixedArray(JSRegExp::kExperimentalDataSize);
   Smi uninitialized = Smi::FromInt(JSRegExp::kUninitializedValue);
+  // Only the match boundaries are computed by native code, see
+  // ExperimentalRegExpDfaCompiler.
+  const bool can_tier_up = FLAG_experimental_regexp_engine_native_code &&
+                           !FLAG_regexp_interpret_all && capture_count == 0;
+  Smi ticks_until_tier_up =
+      can_tier_up ? Smi::FromInt(FLAG_regexp_tier_up ? FLAG_regexp_tier_up_ticks
+                                                     : 0)
+                  : uninitialized;
 
   store->set(JSRegExp::kTagIndex, Smi::FromInt(JSRegExp::EXPERIMENTAL));
   store->set(JSRegExp::kSourceIndex, *source);
@@ -3201,8 +3211,10 @@ void Factory::SetRegExpExperimentalData(Handle<JSRegExp> regexp,
   store->set(JSRegExp::kIrregexpMaxRegisterCountIndex, uninitialized);
   store->set(JSRegExp::kIrregexpCaptureCountIndex, Smi::FromInt(capture_count));
   store->set(JSRegExp::kIrregexpCaptureNameMapIndex, uninitialized);
-  store->set(JSRegExp::kIrregexpTicksUntilTierUpIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpTicksUntilTierUpIndex, ticks_until_tier_up);
   store->set(JSRegExp::kIrregexpBacktrackLimit, uninitialized);
+  store->set(JSRegExp::kIrregexpPrefilterIndex, uninitialized);
+  store->set(JSRegExp::kIrregexpExperimentalFallbackIndex, uninitialized);
   regexp->set_data(*store);
 }
 
@@ -82,6 +82,7 @@
 #include "src/objects/shared-function-info.h"
 #include "src/objects/slots-atomic-inl.h"
 #include "src/objects/slots-inl.h"
+#include "src/regexp/experimental/experimental-interpreter.h"
 #include "src/regexp/regexp.h"
 #include "src/snapshot/embedded/embedded-data.h"
 #include "src/snapshot/serializer-deserializer.h"
@@ -2215,6 +2216,8 @@ void Heap::MarkCompactPrologue() {
   isolate_->descriptor_lookup_cache()->Clear();
   RegExpResultsCache::Clear(string_split_cache());
   RegExpResultsCache::Clear(regexp_multiple_cache());
+  isolate_->experimental_regexp_lookaround_cache()->Clear();
+  isolate_->experimental_regexp_dfa_cache()->Clear();
 
   isolate_->compilation_cache()->MarkCompactPrologue();
 
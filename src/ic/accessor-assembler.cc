@@ -2561,7 +2561,8 @@ enum AccessorAssembler::StubCacheTable : int {
   kSecondary = static_cast<int>(StubCache::kSecondary)
 };
 
-TNode<IntPtrT> AccessorAssembler::StubCachePrimaryOffset(TNode<Name> name,
+TNode<IntPtrT> AccessorAssembler::StubCachePrimaryOffset(StubCache* stub_cache,
+                                                         TNode<Name> name,
                                                          TNode<Map> map) {
   // Compute the hash of the name (use entire hash field).
   TNode<Uint32T> raw_hash_field = LoadNameRawHashField(name);
@@ -2579,25 +2580,26 @@ TNode<IntPtrT> AccessorAssembler::StubCachePrimaryOffset(TNode<Name> name,
       WordXor(map_word, WordShr(map_word, StubCache::kMapKeyShift))));
   // Base the offset on a simple combination of name and map.
   TNode<Word32T> hash = Int32Add(raw_hash_field, map32);
-  uint32_t mask = (StubCache::kPrimaryTableSize - 1)
-                  << StubCache::kCacheIndexShift;
-  TNode<UintPtrT> result =
-      ChangeUint32ToWord(Word32And(hash, Int32Constant(mask)));
+  // The table size is chosen per isolate, so load the mask from the cache.
+  TNode<Uint32T> mask = Load<Uint32T>(
+      ExternalConstant(ExternalReference::Create(
+          stub_cache->mask_reference(StubCache::kPrimary))));
+  TNode<UintPtrT> result = ChangeUint32ToWord(Word32And(hash, mask));
   return Signed(result);
 }
 
 TNode<IntPtrT> AccessorAssembler::StubCacheSecondaryOffset(
-    TNode<Name> name, TNode<IntPtrT> seed) {
+    StubCache* stub_cache, TNode<Name> name, TNode<IntPtrT> seed) {
   // See v8::internal::StubCache::SecondaryOffset().
 
   // Use the seed from the primary cache in the secondary cache.
   TNode<Int32T> name32 = TruncateIntPtrToInt32(BitcastTaggedToWord(name));
   TNode<Int32T> hash = Int32Sub(TruncateIntPtrToInt32(seed), name32);
   hash = Int32Add(hash, Int32Constant(StubCache::kSecondaryMagic));
-  int32_t mask = (StubCache::kSecondaryTableSize - 1)
-                 << StubCache::kCacheIndexShift;
-  TNode<UintPtrT> result =
-      ChangeUint32ToWord(Word32And(hash, Int32Constant(mask)));
+  TNode<Uint32T> mask = Load<Uint32T>(
+      ExternalConstant(ExternalReference::Create(
+          stub_cache->mask_reference(StubCache::kSecondary))));
+  TNode<UintPtrT> result = ChangeUint32ToWord(Word32And(hash, mask));
   return Signed(result);
 }
 
@@ -2606,35 +2608,55 @@ void AccessorAssembler::TryProbeStubCacheTable(
     TNode<Object> name, TNode<Map> map, Label* if_handler,
     TVariable<MaybeObject>* var_handler, Label* if_miss) {
   StubCache::Table table = static_cast<StubCache::Table>(table_id);
-  // The {table_offset} holds the entry offset times four (due to masking
+  // The {table_offset} holds the bucket offset times four (due to masking
   // and shifting optimizations).
   const int kMultiplier =
-      sizeof(StubCache::Entry) >> StubCache::kCacheIndexShift;
+      (StubCache::kAssociativity * sizeof(StubCache::Entry)) >>
+      StubCache::kCacheIndexShift;
   entry_offset = IntPtrMul(entry_offset, IntPtrConstant(kMultiplier));
 
   TNode<ExternalReference> key_base = ExternalConstant(
       ExternalReference::Create(stub_cache->key_reference(table)));
 
-  // Check that the key in the entry matches the name.
-  DCHECK_EQ(0, offsetof(StubCache::Entry, key));
-  TNode<HeapObject> cached_key =
-      CAST(Load(MachineType::TaggedPointer(), key_base, entry_offset));
-  GotoIf(TaggedNotEqual(name, cached_key), if_miss);
-
-  // Check that the map in the entry matches.
-  TNode<Object> cached_map = Load<Object>(
-      key_base,
-      IntPtrAdd(entry_offset, IntPtrConstant(offsetof(StubCache::Entry, map))));
-  GotoIf(TaggedNotEqual(map, cached_map), if_miss);
+  // Check each entry of the bucket in turn; the loop is unrolled.
+  for (int way = 0; way < StubCache::kAssociativity; way++) {
+    const bool is_last_way = way == StubCache::kAssociativity - 1;
+    Label next_way(this);
+    Label* if_mismatch = is_last_way ? if_miss : &next_way;
+    const int kWayOffset = way * static_cast<int>(sizeof(StubCache::Entry));
+    TNode<IntPtrT> way_offset =
+        IntPtrAdd(entry_offset, IntPtrConstant(kWayOffset));
+
+    // Check that the key in the entry matches the name.
+    DCHECK_EQ(0, offsetof(StubCache::Entry, key));
+    TNode<HeapObject> cached_key =
+        CAST(Load(MachineType::TaggedPointer(), key_base, way_offset));
+    GotoIf(TaggedNotEqual(name, cached_key), if_mismatch);
+
+    // Check that the map in the entry matches.
+    TNode<Object> cached_map = Load<Object>(
+        key_base,
+        IntPtrAdd(way_offset, IntPtrConstant(offsetof(StubCache::Entry, map))));
+    GotoIf(TaggedNotEqual(map, cached_map), if_mismatch);
+
+    TNode<MaybeObject> handler = ReinterpretCast<MaybeObject>(
+        Load(MachineType::AnyTagged(), key_base,
+             IntPtrAdd(way_offset,
+                       IntPtrConstant(offsetof(StubCache::Entry, value)))));
+
+    // We found the handler.
+    *var_handler = handler;
+    Goto(if_handler);
 
-  TNode<MaybeObject> handler = ReinterpretCast<MaybeObject>(
-      Load(MachineType::AnyTagged(), key_base,
-           IntPtrAdd(entry_offset,
-                     IntPtrConstant(offsetof(StubCache::Entry, value)))));
+    if (!is_last_way) BIND(&next_way);
+  }
+}
 
-  // We found the handler.
-  *var_handler = handler;
-  Goto(if_handler);
+void AccessorAssembler::IncrementStubCacheCounter(ExternalReference counter) {
+  TNode<ExternalReference> counter_address = ExternalConstant(counter);
+  TNode<IntPtrT> value = Load<IntPtrT>(counter_address);
+  StoreNoWriteBarrier(MachineType::PointerRepresentation(), counter_address,
+                      IntPtrAdd(value, IntPtrConstant(1)));
 }
 
 void AccessorAssembler::TryProbeStubCache(StubCache* stub_cache,
@@ -2646,6 +2668,8 @@ void AccessorAssembler::TryProbeStubCache(StubCache* stub_cache,
 
   Counters* counters = isolate()->counters();
   IncrementCounter(counters->megamorphic_stub_cache_probes(), 1);
+  IncrementStubCacheCounter(
+      ExternalReference::Create(stub_cache->lookup_count_reference()));
 
   // Check that the {lookup_start_object} isn't a smi.
   GotoIf(TaggedIsSmi(lookup_start_object), &miss);
@@ -2654,7 +2678,7 @@ void AccessorAssembler::TryProbeStubCache(StubCache* stub_cache,
 
   // Probe the primary table.
   TNode<IntPtrT> primary_offset =
-      StubCachePrimaryOffset(name, lookup_start_object_map);
+      StubCachePrimaryOffset(stub_cache, name, lookup_start_object_map);
   TryProbeStubCacheTable(stub_cache, kPrimary, primary_offset, name,
                          lookup_start_object_map, if_handler, var_handler,
                          &try_secondary);
@@ -2663,7 +2687,7 @@ void AccessorAssembler::TryProbeStubCache(StubCache* stub_cache,
   {
     // Probe the secondary table.
     TNode<IntPtrT> secondary_offset =
-        StubCacheSecondaryOffset(name, primary_offset);
+        StubCacheSecondaryOffset(stub_cache, name, primary_offset);
     TryProbeStubCacheTable(stub_cache, kSecondary, secondary_offset, name,
                            lookup_start_object_map, if_handler, var_handler,
                            &miss);
@@ -2672,6 +2696,8 @@ void AccessorAssembler::TryProbeStubCache(StubCache* stub_cache,
   BIND(&miss);
   {
     IncrementCounter(counters->megamorphic_stub_cache_misses(), 1);
+    IncrementStubCacheCounter(
+        ExternalReference::Create(stub_cache->miss_count_reference()));
     Goto(if_miss);
   }
 }
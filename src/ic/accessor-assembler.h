@@ -61,13 +61,15 @@ class V8_EXPORT_PRIVATE AccessorAssembler : public CodeStubAssembler {
                          Label* if_handler, TVariable<MaybeObject>* var_handler,
                          Label* if_miss);
 
-  TNode<IntPtrT> StubCachePrimaryOffsetForTesting(TNode<Name> name,
+  TNode<IntPtrT> StubCachePrimaryOffsetForTesting(StubCache* stub_cache,
+                                                  TNode<Name> name,
                                                   TNode<Map> map) {
-    return StubCachePrimaryOffset(name, map);
+    return StubCachePrimaryOffset(stub_cache, name, map);
   }
-  TNode<IntPtrT> StubCacheSecondaryOffsetForTesting(TNode<Name> name,
+  TNode<IntPtrT> StubCacheSecondaryOffsetForTesting(StubCache* stub_cache,
+                                                    TNode<Name> name,
                                                     TNode<IntPtrT> seed) {
-    return StubCacheSecondaryOffset(name, seed);
+    return StubCacheSecondaryOffset(stub_cache, name, seed);
   }
 
   struct LoadICParameters {
@@ -462,8 +464,10 @@ class V8_EXPORT_PRIVATE AccessorAssembler : public CodeStubAssembler {
   // including stub cache header.
   enum StubCacheTable : int;
 
-  TNode<IntPtrT> StubCachePrimaryOffset(TNode<Name> name, TNode<Map> map);
-  TNode<IntPtrT> StubCacheSecondaryOffset(TNode<Name> name,
+  TNode<IntPtrT> StubCachePrimaryOffset(StubCache* stub_cache,
+                                        TNode<Name> name, TNode<Map> map);
+  TNode<IntPtrT> StubCacheSecondaryOffset(StubCache* stub_cache,
+                                          TNode<Name> name,
                                           TNode<IntPtrT> seed);
 
   void TryProbeStubCacheTable(StubCache* stub_cache, StubCacheTable table_id,
@@ -472,6 +476,10 @@ class V8_EXPORT_PRIVATE AccessorAssembler : public CodeStubAssembler {
                               TVariable<MaybeObject>* var_handler,
                               Label* if_miss);
 
+  // Increments one of the statistics counters of a stub cache, see
+  // StubCache::lookup_count_reference().
+  void IncrementStubCacheCounter(ExternalReference counter);
+
   void BranchIfPrototypesHaveNoElements(TNode<Map> receiver_map,
                                         Label* definitely_no_elements,
                                         Label* possibly_elements);
@@ -4,6 +4,8 @@
 
 #include "src/ic/stub-cache.h"
 
+#include <algorithm>
+
 #include "src/ast/ast.h"
 #include "src/base/bits.h"
 #include "src/heap/heap-inl.h"  // For InYoungGeneration().
@@ -14,15 +16,45 @@
 namespace v8 {
 namespace internal {
 
-StubCache::StubCache(Isolate* isolate) : isolate_(isolate) {
+namespace {
+
+int TableSize(int table_bits) {
+  table_bits = std::max(StubCache::kMinTableBits,
+                        std::min(table_bits, StubCache::kMaxTableBits));
+  return 1 << table_bits;
+}
+
+}  // namespace
+
+StubCache::StubCache(Isolate* isolate)
+    : StubCache(isolate, FLAG_stub_cache_primary_bits,
+                FLAG_stub_cache_secondary_bits) {}
+
+StubCache::StubCache(Isolate* isolate, int primary_table_bits,
+                     int secondary_table_bits)
+    : primary_table_size_(TableSize(primary_table_bits)),
+      secondary_table_size_(TableSize(secondary_table_bits)),
+      primary_mask_(
+          static_cast<uint32_t>(primary_table_size_ / kAssociativity - 1)
+          << kCacheIndexShift),
+      secondary_mask_(
+          static_cast<uint32_t>(secondary_table_size_ / kAssociativity - 1)
+          << kCacheIndexShift),
+      isolate_(isolate) {
   // Ensure the nullptr (aka Smi::zero()) which StubCache::Get() returns
   // when the entry is not found is not considered as a handler.
   DCHECK(!IC::IsHandler(MaybeObject()));
+  // The tables are allocated eagerly, as their addresses are recorded in the
+  // external reference table.
+  primary_.reset(new Entry[primary_table_size_]);
+  secondary_.reset(new Entry[secondary_table_size_]);
 }
 
 void StubCache::Initialize() {
-  DCHECK(base::bits::IsPowerOfTwo(kPrimaryTableSize));
-  DCHECK(base::bits::IsPowerOfTwo(kSecondaryTableSize));
+  STATIC_ASSERT(base::bits::IsPowerOfTwo(kAssociativity));
+  STATIC_ASSERT(kAssociativity <= 1 << kMinTableBits);
+  DCHECK(base::bits::IsPowerOfTwo(primary_table_size_));
+  DCHECK(base::bits::IsPowerOfTwo(secondary_table_size_));
   Clear();
 }
 
@@ -40,7 +72,7 @@ int StubCache::PrimaryOffset(Name name, Map map) {
       static_cast<uint32_t>(map.ptr() ^ (map.ptr() >> kMapKeyShift));
   // Base the offset on a simple combination of name and map.
   uint32_t key = map_low32bits + field;
-  return key & ((kPrimaryTableSize - 1) << kCacheIndexShift);
+  return key & primary_mask_;
 }
 
 // Hash algorithm for the secondary table.  This algorithm is replicated in
@@ -50,7 +82,7 @@ int StubCache::SecondaryOffset(Name name, int seed) {
   // Use the seed from the primary cache in the secondary cache.
   uint32_t name_low32bits = static_cast<uint32_t>(name.ptr());
   uint32_t key = (seed - name_low32bits) + kSecondaryMagic;
-  return key & ((kSecondaryTableSize - 1) << kCacheIndexShift);
+  return key & secondary_mask_;
 }
 
 int StubCache::PrimaryOffsetForTesting(Name name, Map map) {
@@ -78,48 +110,80 @@ bool CommonStubCacheChecks(StubCache* stub_cache, Name name, Map map,
 }  // namespace
 #endif
 
+// static
+int StubCache::FindInBucket(Entry* bucket, StrongTaggedValue key,
+                            StrongTaggedValue map) {
+  for (int way = 0; way < kAssociativity; way++) {
+    if (bucket[way].key == key && bucket[way].map == map) return way;
+  }
+  return -1;
+}
+
+// static
+void StubCache::MoveToFront(Entry* bucket, int way, const Entry& new_entry) {
+  DCHECK_LT(way, kAssociativity);
+  for (; way > 0; way--) bucket[way] = bucket[way - 1];
+  bucket[0] = new_entry;
+}
+
 void StubCache::Set(Name name, Map map, MaybeObject handler) {
   DCHECK(CommonStubCacheChecks(this, name, map, handler));
 
-  // Compute the primary entry.
+  Entry new_entry;
+  new_entry.key = StrongTaggedValue(name);
+  new_entry.value = TaggedValue(handler);
+  new_entry.map = StrongTaggedValue(map);
+
+  // Compute the primary bucket.
   int primary_offset = PrimaryOffset(name, map);
-  Entry* primary = entry(primary_, primary_offset);
-  MaybeObject old_handler(
-      TaggedValue::ToMaybeObject(isolate(), primary->value));
-  // If the primary entry has useful data in it, we retire it to the
-  // secondary cache before overwriting it.
-  if (old_handler != MaybeObject::FromObject(
-                         isolate()->builtins()->builtin(Builtins::kIllegal)) &&
-      !primary->map.IsSmi()) {
-    Map old_map =
-        Map::cast(StrongTaggedValue::ToObject(isolate(), primary->map));
-    int seed = PrimaryOffset(
-        Name::cast(StrongTaggedValue::ToObject(isolate(), primary->key)),
-        old_map);
-    int secondary_offset = SecondaryOffset(
-        Name::cast(StrongTaggedValue::ToObject(isolate(), primary->key)), seed);
-    Entry* secondary = entry(secondary_, secondary_offset);
-    *secondary = *primary;
+  Entry* primary = entry(primary_.get(), primary_offset);
+  int way = FindInBucket(primary, new_entry.key, new_entry.map);
+  if (way < 0) {
+    // Make room by evicting the last entry of the bucket. If it has useful
+    // data in it, we retire it to the secondary cache.
+    way = kAssociativity - 1;
+    Entry victim = primary[way];
+    MaybeObject old_handler(
+        TaggedValue::ToMaybeObject(isolate(), victim.value));
+    MaybeObject empty = MaybeObject::FromObject(
+        isolate()->builtins()->builtin(Builtins::kIllegal));
+    if (old_handler != empty && !victim.map.IsSmi()) {
+      Name old_name =
+          Name::cast(StrongTaggedValue::ToObject(isolate(), victim.key));
+      Map old_map =
+          Map::cast(StrongTaggedValue::ToObject(isolate(), victim.map));
+      // All entries of a bucket share the primary offset, which seeds the
+      // secondary hash.
+      DCHECK_EQ(primary_offset, PrimaryOffset(old_name, old_map));
+      USE(old_map);
+      int secondary_offset = SecondaryOffset(old_name, primary_offset);
+      Entry* secondary = entry(secondary_.get(), secondary_offset);
+      int secondary_way = FindInBucket(secondary, victim.key, victim.map);
+      if (secondary_way < 0) secondary_way = kAssociativity - 1;
+      MoveToFront(secondary, secondary_way, victim);
+    }
   }
 
   // Update primary cache.
-  primary->key = StrongTaggedValue(name);
-  primary->value = TaggedValue(handler);
-  primary->map = StrongTaggedValue(map);
+  MoveToFront(primary, way, new_entry);
   isolate()->counters()->megamorphic_stub_cache_updates()->Increment();
 }
 
 MaybeObject StubCache::Get(Name name, Map map) {
   DCHECK(CommonStubCacheChecks(this, name, map, MaybeObject()));
+  StrongTaggedValue key(name);
+  StrongTaggedValue map_key(map);
   int primary_offset = PrimaryOffset(name, map);
-  Entry* primary = entry(primary_, primary_offset);
-  if (primary->key == name && primary->map == map) {
-    return TaggedValue::ToMaybeObject(isolate(), primary->value);
+  Entry* primary = entry(primary_.get(), primary_offset);
+  int way = FindInBucket(primary, key, map_key);
+  if (way >= 0) {
+    return TaggedValue::ToMaybeObject(isolate(), primary[way].value);
   }
   int secondary_offset = SecondaryOffset(name, primary_offset);
-  Entry* secondary = entry(secondary_, secondary_offset);
-  if (secondary->key == name && secondary->map == map) {
-    return TaggedValue::ToMaybeObject(isolate(), secondary->value);
+  Entry* secondary = entry(secondary_.get(), secondary_offset);
+  way = FindInBucket(secondary, key, map_key);
+  if (way >= 0) {
+    return TaggedValue::ToMaybeObject(isolate(), secondary[way].value);
   }
   return MaybeObject();
 }
@@ -128,12 +192,12 @@ void StubCache::Clear() {
   MaybeObject empty = MaybeObject::FromObject(
       isolate_->builtins()->builtin(Builtins::kIllegal));
   Name empty_string = ReadOnlyRoots(isolate()).empty_string();
-  for (int i = 0; i < kPrimaryTableSize; i++) {
+  for (int i = 0; i < primary_table_size_; i++) {
     primary_[i].key = StrongTaggedValue(empty_string);
     primary_[i].map = StrongTaggedValue(Smi::zero());
     primary_[i].value = TaggedValue(empty);
   }
-  for (int j = 0; j < kSecondaryTableSize; j++) {
+  for (int j = 0; j < secondary_table_size_; j++) {
     secondary_[j].key = StrongTaggedValue(empty_string);
     secondary_[j].map = StrongTaggedValue(Smi::zero());
     secondary_[j].value = TaggedValue(empty);
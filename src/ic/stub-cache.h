@@ -5,6 +5,8 @@
 #ifndef V8_IC_STUB_CACHE_H_
 #define V8_IC_STUB_CACHE_H_
 
+#include <memory>
+
 #include "src/objects/name.h"
 #include "src/objects/tagged-value.h"
 
@@ -15,6 +17,9 @@ namespace internal {
 // It maps (map, name, type) to property access handlers. The cache does not
 // need explicit invalidation when a prototype chain is modified, since the
 // handlers verify the chain.
+//
+// Both tables are set-associative: a hash selects a bucket of
+// kAssociativity entries, and a lookup checks every entry of the bucket.
 
 
 class SCTableReference {
@@ -49,6 +54,9 @@ class V8_EXPORT_PRIVATE StubCache {
   // Clear the lookup table (@ mark compact collection).
   void Clear();
 
+  // The number of entries in a bucket of either table.
+  static const int kAssociativity = 2;
+
   enum Table { kPrimary, kSecondary };
 
   SCTableReference key_reference(StubCache::Table table) {
@@ -66,16 +74,47 @@ class V8_EXPORT_PRIVATE StubCache {
         reinterpret_cast<Address>(&first_entry(table)->value));
   }
 
+  // The masks used by the generated code to compute table offsets, see
+  // {PrimaryOffset} and {SecondaryOffset}.
+  SCTableReference mask_reference(StubCache::Table table) {
+    switch (table) {
+      case StubCache::kPrimary:
+        return SCTableReference(reinterpret_cast<Address>(&primary_mask_));
+      case StubCache::kSecondary:
+        return SCTableReference(reinterpret_cast<Address>(&secondary_mask_));
+    }
+    UNREACHABLE();
+  }
+
+  // The statistics counters incremented by the generated probing code, see
+  // {lookup_count} and {miss_count}.
+  SCTableReference lookup_count_reference() {
+    return SCTableReference(reinterpret_cast<Address>(&lookup_count_));
+  }
+
+  SCTableReference miss_count_reference() {
+    return SCTableReference(reinterpret_cast<Address>(&miss_count_));
+  }
+
   StubCache::Entry* first_entry(StubCache::Table table) {
     switch (table) {
       case StubCache::kPrimary:
-        return StubCache::primary_;
+        return primary_.get();
       case StubCache::kSecondary:
-        return StubCache::secondary_;
+        return secondary_.get();
     }
     UNREACHABLE();
   }
 
+  // The number of entries, not buckets, in each table.
+  int primary_table_size() const { return primary_table_size_; }
+  int secondary_table_size() const { return secondary_table_size_; }
+
+  // The number of probes of the generated code, and how many of them found
+  // no handler in either table. Clearing the cache keeps the counts.
+  size_t lookup_count() const { return lookup_count_; }
+  size_t miss_count() const { return miss_count_; }
+
   Isolate* isolate() { return isolate_; }
 
   // Setting kCacheIndexShift to Name::kHashShift is convenient because it
@@ -85,23 +124,35 @@ class V8_EXPORT_PRIVATE StubCache {
   // the STATIC_ASSERT below, in {entry(...)}).
   static const int kCacheIndexShift = Name::kHashShift;
 
-  static const int kPrimaryTableBits = 11;
-  static const int kPrimaryTableSize = (1 << kPrimaryTableBits);
-  static const int kSecondaryTableBits = 9;
-  static const int kSecondaryTableSize = (1 << kSecondaryTableBits);
+  // The table sizes are chosen per isolate, see --stub-cache-primary-bits and
+  // --stub-cache-secondary-bits. These bounds keep the offsets computed by
+  // {PrimaryOffset} and {SecondaryOffset} within 32 bits.
+  static const int kMinTableBits = 4;
+  static const int kMaxTableBits = 20;
+
+  // The log2 of the default primary table size, see
+  // --stub-cache-primary-bits.
+  static const int kDefaultPrimaryTableBits = kStubCacheDefaultPrimaryTableBits;
 
   // We compute the hash code for a map as follows:
   //   <code> = <address> ^ (<address> >> kMapKeyShift)
-  static const int kMapKeyShift = kPrimaryTableBits + kCacheIndexShift;
+  // The shift folds the map address bits just above the primary table index
+  // into the index, which mixes in the bits that differ between maps
+  // allocated in the same page.  It used to be derived from the fixed table
+  // size.  It is baked into the embedded builtins, so it can't follow the
+  // table size of an isolate, and stays at the shift for the default size,
+  // which keeps the hash of default-sized caches unchanged.
+  static const int kMapKeyShift = kDefaultPrimaryTableBits + kCacheIndexShift;
 
   // Some magic number used in the secondary hash computation.
   static const int kSecondaryMagic = 0xb16ca6e5;
 
-  static int PrimaryOffsetForTesting(Name name, Map map);
-  static int SecondaryOffsetForTesting(Name name, int seed);
+  int PrimaryOffsetForTesting(Name name, Map map);
+  int SecondaryOffsetForTesting(Name name, int seed);
 
   // The constructor is made public only for the purposes of testing.
   explicit StubCache(Isolate* isolate);
+  StubCache(Isolate* isolate, int primary_table_bits, int secondary_table_bits);
   StubCache(const StubCache&) = delete;
   StubCache& operator=(const StubCache&) = delete;
 
@@ -109,37 +160,55 @@ class V8_EXPORT_PRIVATE StubCache {
   // The stub cache has a primary and secondary level.  The two levels have
   // different hashing algorithms in order to avoid simultaneous collisions
   // in both caches.  Unlike a probing strategy (quadratic or otherwise) the
-  // update strategy on updates is fairly clear and simple:  Any existing entry
-  // in the primary cache is moved to the secondary cache, and secondary cache
-  // entries are overwritten.
+  // update strategy on updates is fairly clear and simple:  A new entry is
+  // inserted at the front of its primary bucket, and the entry that falls
+  // off the end of the bucket is moved to the front of its secondary bucket.
+  // Entries falling off the end of a secondary bucket are dropped.
 
   // Hash algorithm for the primary table.  This algorithm is replicated in
   // assembler for every architecture.  Returns an index into the table that
   // is scaled by 1 << kCacheIndexShift.
-  static int PrimaryOffset(Name name, Map map);
+  int PrimaryOffset(Name name, Map map);
 
   // Hash algorithm for the secondary table.  This algorithm is replicated in
   // assembler for every architecture.  Returns an index into the table that
   // is scaled by 1 << kCacheIndexShift.
-  static int SecondaryOffset(Name name, int seed);
+  int SecondaryOffset(Name name, int seed);
 
-  // Compute the entry for a given offset in exactly the same way as
-  // we do in generated code.  We generate an hash code that already
-  // ends in Name::kHashShift 0s.  Then we multiply it so it is a multiple
-  // of sizeof(Entry).  This makes it easier to avoid making mistakes
-  // in the hashed offset computations.
+  // Compute the first entry of the bucket for a given offset in exactly the
+  // same way as we do in generated code.  We generate an hash code that
+  // already ends in Name::kHashShift 0s.  Then we multiply it so it is a
+  // multiple of the bucket size.  This makes it easier to avoid making
+  // mistakes in the hashed offset computations.
   static Entry* entry(Entry* table, int offset) {
     // The size of {Entry} must be a multiple of 1 << kCacheIndexShift.
     STATIC_ASSERT((sizeof(*table) >> kCacheIndexShift) << kCacheIndexShift ==
                   sizeof(*table));
-    const int multiplier = sizeof(*table) >> kCacheIndexShift;
+    const int multiplier =
+        (kAssociativity * sizeof(*table)) >> kCacheIndexShift;
     return reinterpret_cast<Entry*>(reinterpret_cast<Address>(table) +
                                     offset * multiplier);
   }
 
+  // Returns the index of the entry for (key, map) in {bucket}, or -1.
+  static int FindInBucket(Entry* bucket, StrongTaggedValue key,
+                          StrongTaggedValue map);
+
+  // Stores {new_entry} at the front of {bucket}, moving the entries in front
+  // of index {way} back by one. The entry at {way} is overwritten.
+  static void MoveToFront(Entry* bucket, int way, const Entry& new_entry);
+
  private:
-  Entry primary_[kPrimaryTableSize];
-  Entry secondary_[kSecondaryTableSize];
+  std::unique_ptr<Entry[]> primary_;
+  std::unique_ptr<Entry[]> secondary_;
+  const int primary_table_size_;
+  const int secondary_table_size_;
+  // The number of buckets minus one, scaled by 1 << kCacheIndexShift.
+  const uint32_t primary_mask_;
+  const uint32_t secondary_mask_;
+  // Word-sized, as the generated code increments them with word operations.
+  size_t lookup_count_ = 0;
+  size_t miss_count_ = 0;
   Isolate* isolate_;
 
   friend class Isolate;
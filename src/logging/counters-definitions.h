@@ -262,6 +262,12 @@ namespace internal {
   SC(total_parse_size, V8.TotalParseSize)                          \
   /* Amount of source code skipped over using preparsing. */       \
   SC(total_preparse_skipped, V8.TotalPreparseSkipped)              \
+  /* Functions preparsed on worker threads, and how many of */     \
+  /* them the parser skipped with the worker's result. */          \
+  SC(parallel_preparse_results_produced,                           \
+     V8.ParallelPreparseResultsProduced)                           \
+  SC(parallel_preparse_results_consumed,                           \
+     V8.ParallelPreparseResultsConsumed)                           \
   /* Amount of compiled source code. */                            \
   SC(total_compile_size, V8.TotalCompileSize)                      \
   /* Number of contexts created from scratch. */                   \
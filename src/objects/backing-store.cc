@@ -62,6 +62,23 @@ enum class AllocationStatus {
   kOtherFailure  // Failed for an unknown reason
 };
 
+size_t GetReservationSize(bool has_guard_regions, size_t byte_capacity) {
+#if V8_TARGET_ARCH_64_BIT
+  if (has_guard_regions) {
+    // Memory64 memories can be larger than the range covered by the positive
+    // guard region. Those are bounds-checked explicitly, so just reserve their
+    // capacity then.
+    return static_cast<size_t>(
+        kNegativeGuardSize +
+        std::max(kFullGuardSize - kNegativeGuardSize, uint64_t{byte_capacity}));
+  }
+#else
+  DCHECK(!has_guard_regions);
+#endif
+
+  return byte_capacity;
+}
+
 base::AddressRegion GetReservedRegion(bool has_guard_regions,
                                       void* buffer_start,
                                       size_t byte_capacity) {
@@ -76,8 +93,9 @@ base::AddressRegion GetReservedRegion(bool has_guard_regions,
     Address start = reinterpret_cast<Address>(buffer_start);
     DCHECK_EQ(8, sizeof(size_t));  // only use on 64-bit
     DCHECK_EQ(0, start % AllocatePageSize());
-    return base::AddressRegion(start - kNegativeGuardSize,
-                               static_cast<size_t>(kFullGuardSize));
+    return base::AddressRegion(
+        start - kNegativeGuardSize,
+        GetReservationSize(has_guard_regions, byte_capacity));
   }
 #endif
 
@@ -86,16 +104,6 @@ base::AddressRegion GetReservedRegion(bool has_guard_regions,
                              byte_capacity);
 }
 
-size_t GetReservationSize(bool has_guard_regions, size_t byte_capacity) {
-#if V8_TARGET_ARCH_64_BIT
-  if (has_guard_regions) return kFullGuardSize;
-#else
-  DCHECK(!has_guard_regions);
-#endif
-
-  return byte_capacity;
-}
-
 void RecordStatus(Isolate* isolate, AllocationStatus status) {
   isolate->counters()->wasm_memory_allocation_result()->AddSample(
       static_cast<int>(status));
@@ -323,7 +331,7 @@ std::unique_ptr<BackingStore> BackingStore::TryAllocateWasmMemory(
 
   // Compute size of reserved memory.
 
-  size_t engine_max_pages = wasm::max_mem_pages();
+  size_t engine_max_pages = wasm::max_any_mem_pages();
   maximum_pages = std::min(engine_max_pages, maximum_pages);
   // If the platform doesn't support so many pages, attempting to allocate
   // is guaranteed to fail, so we don't even try.
@@ -428,7 +436,7 @@ std::unique_ptr<BackingStore> BackingStore::AllocateWasmMemory(
   DCHECK_EQ(0, wasm::kWasmPageSize % AllocatePageSize());
 
   // Enforce engine limitation on the maximum number of pages.
-  if (initial_pages > wasm::kV8MaxWasmMemoryPages) return nullptr;
+  if (initial_pages > wasm::max_any_mem_pages()) return nullptr;
   if (initial_pages > kPlatformMaxPages) return nullptr;
 
   auto backing_store =
@@ -96,7 +96,7 @@ void JSRegExp::SetCaptureNameMap(Handle<FixedArray> capture_name_map) {
 }
 
 bool JSRegExp::HasCompiledCode() const {
-  if (TypeTag() != IRREGEXP) return false;
+  if (!TypeSupportsCaptures(TypeTag())) return false;
   Smi uninitialized = Smi::FromInt(kUninitializedValue);
 #ifdef DEBUG
   DCHECK(DataAt(kIrregexpLatin1CodeIndex).IsCode() ||
@@ -119,6 +119,19 @@ void JSRegExp::DiscardCompiledCodeForSerialization() {
   SetDataAt(kIrregexpUC16CodeIndex, uninitialized);
   SetDataAt(kIrregexpLatin1BytecodeIndex, uninitialized);
   SetDataAt(kIrregexpUC16BytecodeIndex, uninitialized);
+  // The data to fall back to is created again when it is needed, but
+  // irregexps that must not fall back keep their marker.
+  if (DataAt(kIrregexpExperimentalFallbackIndex) !=
+      Smi::FromInt(kNoExperimentalFallbackValue)) {
+    SetDataAt(kIrregexpExperimentalFallbackIndex, uninitialized);
+  }
+  if (TypeTag() == EXPERIMENTAL &&
+      DataAt(kIrregexpTicksUntilTierUpIndex) == uninitialized &&
+      CaptureCount() == 0) {
+    // The regexp may have tiered up to native code, so it has to try again
+    // once it is recompiled. See ExperimentalRegExp::TierUpIfMarked.
+    SetDataAt(kIrregexpTicksUntilTierUpIndex, Smi::zero());
+  }
 }
 
 }  // namespace internal
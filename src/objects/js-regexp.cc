@@ -241,7 +241,7 @@ Handle<JSRegExp> JSRegExp::Copy(Handle<JSRegExp> regexp) {
 }
 
 Object JSRegExp::Code(bool is_latin1) const {
-  DCHECK_EQ(TypeTag(), JSRegExp::IRREGEXP);
+  DCHECK(TypeSupportsCaptures(TypeTag()));
   return DataAt(code_index(is_latin1));
 }
 
@@ -255,13 +255,23 @@ bool JSRegExp::ShouldProduceBytecode() {
          (FLAG_regexp_tier_up && !MarkedForTierUp());
 }
 
-// Only irregexps are subject to tier-up.
+// Irregexps are subject to tier-up, and so are experimental regexps whose dfa
+// can be compiled to native code until they have tiered up, see
+// Factory::SetRegExpExperimentalData.
 bool JSRegExp::CanTierUp() {
-  return FLAG_regexp_tier_up && TypeTag() == JSRegExp::IRREGEXP;
+  switch (TypeTag()) {
+    case JSRegExp::IRREGEXP:
+      return FLAG_regexp_tier_up;
+    case JSRegExp::EXPERIMENTAL:
+      return DataAt(kIrregexpTicksUntilTierUpIndex) !=
+             Smi::FromInt(kUninitializedValue);
+    default:
+      return false;
+  }
 }
 
-// An irregexp is considered to be marked for tier up if the tier-up ticks
-// value reaches zero.
+// A regexp is considered to be marked for tier up if the tier-up ticks value
+// reaches zero.
 bool JSRegExp::MarkedForTierUp() {
   DCHECK(data().IsFixedArray());
 
@@ -281,8 +291,7 @@ void JSRegExp::ResetLastTierUpTick() {
 }
 
 void JSRegExp::TierUpTick() {
-  DCHECK(FLAG_regexp_tier_up);
-  DCHECK_EQ(TypeTag(), JSRegExp::IRREGEXP);
+  DCHECK(CanTierUp());
   int tier_up_ticks = Smi::ToInt(DataAt(kIrregexpTicksUntilTierUpIndex));
   if (tier_up_ticks == 0) {
     return;
@@ -292,8 +301,7 @@ void JSRegExp::TierUpTick() {
 }
 
 void JSRegExp::MarkTierUpForNextExec() {
-  DCHECK(FLAG_regexp_tier_up);
-  DCHECK_EQ(TypeTag(), JSRegExp::IRREGEXP);
+  DCHECK(CanTierUp());
   FixedArray::cast(data()).set(JSRegExp::kIrregexpTicksUntilTierUpIndex,
                                Smi::zero());
 }
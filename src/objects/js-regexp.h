@@ -196,7 +196,24 @@ class JSRegExp : public TorqueGeneratedJSRegExp<JSRegExp, JSObject> {
   // TODO(jgruber): If needed, this limit could be packed into other fields
   // above to save space.
   static const int kIrregexpBacktrackLimit = kDataIndex + 8;
-  static const int kIrregexpDataSize = kDataIndex + 9;
+  // A ByteArray with the literals that all matches start with, used to skip
+  // to candidate positions before running the matcher, or kUninitializedValue
+  // if there is no such set of literals or it hasn't been computed yet. See
+  // RegExpPrefilter.
+  static const int kIrregexpPrefilterIndex = kDataIndex + 9;
+  // The EXPERIMENTAL data array that the regexp falls back to on excessive
+  // backtracking, or kUninitializedValue if it hasn't fallen back yet.  It
+  // keeps the compiled experimental bytecode and native code across
+  // executions.  kNoExperimentalFallbackValue if the regexp must not fall
+  // back, see kExperimentalIrregexpFallbackIndex.
+  static const int kIrregexpExperimentalFallbackIndex = kDataIndex + 10;
+  static const int kIrregexpDataSize = kDataIndex + 11;
+  // For EXPERIMENTAL regexps, the same slot holds the IRREGEXP data array that
+  // the regexp falls back to when the experimental engine gives up on back
+  // references, or kUninitializedValue if it hasn't fallen back yet.  That
+  // data has no backtrack limit and doesn't fall back in turn.
+  static const int kExperimentalIrregexpFallbackIndex =
+      kIrregexpExperimentalFallbackIndex;
 
   // TODO(mbid,v8:10765): At the moment the EXPERIMENTAL data array conforms
   // to the format of an IRREGEXP data array, with most fields set to some
@@ -222,6 +239,9 @@ class JSRegExp : public TorqueGeneratedJSRegExp<JSRegExp, JSObject> {
   // The uninitialized value for a regexp code object.
   static const int kUninitializedValue = -1;
 
+  // See kIrregexpExperimentalFallbackIndex.
+  static const int kNoExperimentalFallbackValue = -2;
+
   // The heuristic value for the length of the subject string for which we
   // tier-up to the compiler immediately, instead of using the interpreter.
   static constexpr int kTierUpForSubjectLengthValue = 1000;
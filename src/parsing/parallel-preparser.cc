@@ -0,0 +1,251 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/parsing/parallel-preparser.h"
+
+#include <algorithm>
+
+#include "src/flags/flags.h"
+#include "src/init/v8.h"
+#include "src/parsing/parser.h"
+#include "src/parsing/preparse-data-impl.h"
+#include "src/parsing/scanner.h"
+#include "src/tracing/trace-event.h"
+#include "src/utils/utils.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+// Returns the position of the next "function" keyword at the beginning of a
+// line in [position, end), or kNoSourcePosition.
+int FindFunctionDeclaration(Utf16CharacterStream* stream, int position,
+                            int end) {
+  static const char kFunction[] = "function";
+  static constexpr int kFunctionLength = arraysize(kFunction) - 1;
+
+  bool at_line_start = true;
+  if (position > 0) {
+    stream->Seek(position - 1);
+    at_line_start = stream->Advance() == '\n';
+  } else {
+    stream->Seek(0);
+  }
+  for (; position < end; position++) {
+    uc32 c = stream->Advance();
+    if (c == Utf16CharacterStream::kEndOfInput) break;
+    if (at_line_start && c == 'f') {
+      int i = 1;
+      while (i < kFunctionLength && stream->Advance() == kFunction[i]) i++;
+      if (i == kFunctionLength && stream->Advance() == ' ') return position;
+      stream->Seek(position + 1);
+    }
+    at_line_start = c == '\n';
+  }
+  return kNoSourcePosition;
+}
+
+ZonePreparseData* CopyPreparseData(ZonePreparseData* data, Zone* zone) {
+  Vector<uint8_t> byte_data(data->byte_data()->data(),
+                            data->byte_data()->size());
+  ZonePreparseData* copy =
+      zone->New<ZonePreparseData>(zone, &byte_data, data->children_length());
+  for (int i = 0; i < data->children_length(); i++) {
+    copy->set_child(i, CopyPreparseData(data->get_child(i), zone));
+  }
+  return copy;
+}
+
+}  // namespace
+
+class ParallelPreparser::JobTask final : public v8::JobTask {
+ public:
+  explicit JobTask(ParallelPreparser* preparser) : preparser_(preparser) {}
+
+  void Run(JobDelegate* delegate) final { preparser_->Run(delegate); }
+
+  size_t GetMaxConcurrency(size_t worker_count) const final {
+    return preparser_->GetMaxConcurrency(worker_count);
+  }
+
+ private:
+  ParallelPreparser* const preparser_;
+};
+
+// static
+std::unique_ptr<ParallelPreparser> ParallelPreparser::MaybeCreate(
+    ParseInfo* info, const Utf16CharacterStream* stream, int source_length) {
+  if (!FLAG_parallel_preparse) return {};
+  if (source_length != kUnknownSourceLength &&
+      source_length < FLAG_parallel_preparse_min_size * KB) {
+    return {};
+  }
+  const UnoptimizedCompileFlags& flags = info->flags();
+  if (!flags.is_toplevel() || flags.is_eval() || flags.is_module() ||
+      flags.is_repl_mode() || info->is_wrapped_as_function()) {
+    return {};
+  }
+  if (!stream->can_be_cloned_for_parallel_access()) return {};
+  return std::make_unique<ParallelPreparser>(info, stream, source_length);
+}
+
+ParallelPreparser::ParallelPreparser(ParseInfo* info,
+                                     const Utf16CharacterStream* stream,
+                                     int source_length)
+    : flags_(info->flags()),
+      state_(info->state()),
+      stream_(stream),
+      source_length_(source_length),
+      main_thread_stack_limit_(info->stack_limit()) {}
+
+ParallelPreparser::~ParallelPreparser() {
+  if (job_handle_ && job_handle_->IsValid()) job_handle_->Cancel();
+}
+
+void ParallelPreparser::MaybeStart(int position, LanguageMode language_mode) {
+  DCHECK(!started());
+  // The size check of MaybeCreate, for streamed scripts.
+  if (source_length_ == kUnknownSourceLength &&
+      position < FLAG_parallel_preparse_min_size * KB) {
+    return;
+  }
+  started_ = true;
+  language_mode_ = language_mode;
+  parser_position_.store(position, std::memory_order_relaxed);
+  chunks_ahead_ = V8::GetCurrentPlatform()->NumberOfWorkerThreads();
+  AddChunks(position);
+}
+
+void ParallelPreparser::AddChunks(int position) {
+  // The parser preparses the chunk it is in itself.
+  next_chunk_start_ = std::max(next_chunk_start_, position + kChunkSize);
+  int end = source_length_;
+  if (source_length_ == kUnknownSourceLength) {
+    if (end_of_input_.load(std::memory_order_relaxed)) return;
+    end = position + kChunkSize * (chunks_ahead_ + 1);
+  }
+  if (next_chunk_start_ >= end) return;
+
+  std::vector<Chunk> new_chunks;
+  for (; next_chunk_start_ < end; next_chunk_start_ += kChunkSize) {
+    Chunk chunk;
+    chunk.start = next_chunk_start_;
+    chunk.end = source_length_ == kUnknownSourceLength
+                    ? next_chunk_start_ + kChunkSize
+                    : std::min(next_chunk_start_ + kChunkSize, source_length_);
+    chunk.state = std::make_unique<UnoptimizedCompileState>(*state_);
+    chunk.info = ParseInfo::ForParallelPreparse(flags_, chunk.state.get());
+    chunk.info->set_character_stream(stream_->Clone());
+    new_chunks.push_back(std::move(chunk));
+  }
+  {
+    base::MutexGuard guard(&mutex_);
+    for (Chunk& chunk : new_chunks) chunks_.push_back(std::move(chunk));
+    remaining_chunks_.store(static_cast<int>(chunks_.size() - next_chunk_),
+                            std::memory_order_relaxed);
+  }
+
+  if (job_handle_ && job_handle_->IsValid()) {
+    job_handle_->NotifyConcurrencyIncrease();
+    return;
+  }
+  job_handle_ = V8::GetCurrentPlatform()->PostJob(
+      TaskPriority::kUserBlocking, std::make_unique<JobTask>(this));
+  if (FLAG_parallel_preparse_join) job_handle_->Join();
+}
+
+ParallelPreparser::Chunk* ParallelPreparser::TakeChunk() {
+  base::MutexGuard guard(&mutex_);
+  if (next_chunk_ == chunks_.size()) return nullptr;
+  Chunk* chunk = &chunks_[next_chunk_++];
+  remaining_chunks_.store(static_cast<int>(chunks_.size() - next_chunk_),
+                          std::memory_order_relaxed);
+  return chunk;
+}
+
+bool ParallelPreparser::Consume(int position, LanguageMode language_mode,
+                                Zone* zone, Result* result,
+                                ProducedPreparseData** produced_preparse_data) {
+  DCHECK(started());
+  parser_position_.store(position, std::memory_order_relaxed);
+  if (source_length_ == kUnknownSourceLength) AddChunks(position);
+  if (language_mode != language_mode_) return false;
+  {
+    base::MutexGuard guard(&mutex_);
+    auto it = results_.find(position);
+    if (it == results_.end()) return false;
+    *result = std::move(it->second);
+    results_.erase(it);
+  }
+  results_consumed_++;
+  *produced_preparse_data =
+      result->preparse_data == nullptr
+          ? nullptr
+          : ProducedPreparseData::For(
+                CopyPreparseData(result->preparse_data, zone), zone);
+  return true;
+}
+
+void ParallelPreparser::Run(JobDelegate* delegate) {
+  TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("v8.compile"),
+               "V8.ParallelPreparse");
+  while (!delegate->ShouldYield()) {
+    Chunk* chunk = TakeChunk();
+    if (chunk == nullptr) return;
+    PreparseChunk(chunk, delegate);
+  }
+}
+
+size_t ParallelPreparser::GetMaxConcurrency(size_t worker_count) const {
+  return remaining_chunks_.load(std::memory_order_relaxed) + worker_count;
+}
+
+void ParallelPreparser::PreparseChunk(Chunk* chunk, JobDelegate* delegate) {
+  ParseInfo* info = chunk->info.get();
+  uintptr_t stack_limit =
+      delegate->IsJoiningThread()
+          ? main_thread_stack_limit_
+          : GetCurrentStackPosition() - FLAG_stack_size * KB;
+  info->SetPerThreadState(stack_limit, nullptr);
+  Parser parser(info);
+  parser.InitializeEmptyScopeChain(info);
+  Utf16CharacterStream* stream = info->character_stream();
+
+  // Streamed scripts may end before the chunk.  Reading the chunk waits for
+  // the data if it hasn't arrived yet.
+  stream->Seek(chunk->start);
+  if (stream->Peek() == Utf16CharacterStream::kEndOfInput) {
+    end_of_input_.store(true, std::memory_order_relaxed);
+    return;
+  }
+
+  int position = chunk->start;
+  while (!delegate->ShouldYield()) {
+    // Skip the functions the parser has reached already.
+    position = std::max(position,
+                        parser_position_.load(std::memory_order_relaxed));
+    position = FindFunctionDeclaration(stream, position, chunk->end);
+    if (position == kNoSourcePosition) return;
+
+    stream->Seek(position);
+    int parameters_position;
+    Result result;
+    if (parser.PreparseTopLevelFunction(language_mode_, &parameters_position,
+                                        &result)) {
+      position = result.end_position;
+      base::MutexGuard guard(&mutex_);
+      results_.emplace(parameters_position, std::move(result));
+      results_produced_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      // Not a function declaration, or one with an error.  The parser reports
+      // the error when it reaches the function, and we go on with the next
+      // declaration, which may be inside the text we failed to preparse.
+      position++;
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,187 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_PARSING_PARALLEL_PREPARSER_H_
+#define V8_PARSING_PARALLEL_PREPARSER_H_
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "include/v8-platform.h"
+#include "src/base/platform/mutex.h"
+#include "src/common/globals.h"
+#include "src/parsing/parse-info.h"
+
+namespace v8 {
+namespace internal {
+
+class ProducedPreparseData;
+class Utf16CharacterStream;
+class ZonePreparseData;
+
+// Preparses the top-level function declarations of a large script on worker
+// threads while the parser parses the script, enabled with
+// --parallel-preparse.
+//
+// The script is split into chunks after the first top-level function
+// declaration the parser lazily parses.  Streamed scripts, whose length isn't
+// known, are split as the parser goes, into as many chunks ahead of the parser
+// as there are worker threads.  Each worker takes a chunk, finds the
+// text "function " at column 0 followed by a name and a parameter list, as
+// bundlers emit top-level declarations, and preparses these functions with a
+// parser of its own, like Parser::SkipFunction would.  A function with a
+// preparse error is left to the parser, which reports the error when it gets
+// there, and the worker continues with the next declaration.
+//
+// When the parser reaches a top-level function declaration which a worker has
+// preparsed, it skips it with the worker's result.  The parser preparses the
+// functions itself which no worker has reached, so neither waits for the
+// other, and the parse time of the script is bounded by the parser's own
+// chunk and the functions it preparses itself.
+//
+// Workers can't tell a function declaration at the beginning of a line from
+// text in a comment or string, or from a function nested in another, so
+// results are keyed by the position of the parameters, and only consumed for
+// top-level function declarations at exactly that position.  Preparsing
+// top-level functions doesn't depend on anything outside of the function but
+// the language mode, so such a result is the same as the parser's own.  Since
+// the outer scope is the script scope, the unresolved variables of the
+// function don't need to be tracked.
+//
+// This deliberately covers only part of the scripts the web sends:
+// - Only scripts whose source can be read on other threads, i.e. external
+//   strings and UTF-8 streamed sources, are preparsed in parallel.  Heap
+//   strings and one- or two-byte streamed sources never are.  Workers which
+//   get ahead of the network wait for the data like the parser does.
+// - Only function declarations in the script scope are.  IIFE bundles, which
+//   wrap everything in a function, are not supported: their functions are in
+//   a function scope, and skipping them would need their unresolved
+//   variables, which workers can't resolve in the parser's scopes.  The
+//   parser doesn't create a parallel preparser for scripts starting with
+//   "(" or "!", and bundles which indent their declarations don't give the
+//   workers anything to do.
+// - The workers only start once the parser reaches a lazily parsed top-level
+//   declaration, and for streamed scripts only beyond the first
+//   --parallel-preparse-min-size KB.  Scripts without one are parsed as
+//   before.
+class ParallelPreparser final {
+ public:
+  // The result of preparsing a function.
+  struct Result {
+    int end_position = kNoSourcePosition;
+    int num_parameters = -1;
+    int function_length = -1;
+    int num_inner_functions = 0;
+    LanguageMode language_mode = LanguageMode::kSloppy;
+    bool allow_eval_cache = true;
+    // In the zone of the chunk, or nullptr if there is no data.
+    ZonePreparseData* preparse_data = nullptr;
+    // The use counters which preparsing the function incremented.
+    std::vector<std::pair<v8::Isolate::UseCounterFeature, int>> use_counts;
+  };
+
+  // The source length of streamed scripts.
+  static constexpr int kUnknownSourceLength = -1;
+
+  // Returns a parallel preparser for the script parsed with `info` from
+  // `stream`, or nullptr if the script is too small or can't be preparsed in
+  // parallel.  `source_length` may be kUnknownSourceLength.
+  static std::unique_ptr<ParallelPreparser> MaybeCreate(
+      ParseInfo* info, const Utf16CharacterStream* stream, int source_length);
+
+  ParallelPreparser(ParseInfo* info, const Utf16CharacterStream* stream,
+                    int source_length);
+  // Cancels the workers and waits for them.  A worker waiting for streamed
+  // data delays this until the data arrives.
+  ~ParallelPreparser();
+  ParallelPreparser(const ParallelPreparser&) = delete;
+  ParallelPreparser& operator=(const ParallelPreparser&) = delete;
+
+  // Starts the workers on the part of the script after `position`, preparsing
+  // in `language_mode`, unless the script is streamed and `position` is in its
+  // first --parallel-preparse-min-size KB.
+  void MaybeStart(int position, LanguageMode language_mode);
+  bool started() const { return started_; }
+
+  // Returns the result for the top-level function declaration whose
+  // parameters start at `position`, if a worker has preparsed it in
+  // `language_mode`, with its preparse data copied to `zone`.  Workers skip
+  // the functions before `position` from then on, and streamed scripts get
+  // new chunks ahead of it.
+  bool Consume(int position, LanguageMode language_mode, Zone* zone,
+               Result* result, ProducedPreparseData** produced_preparse_data);
+
+  // The number of functions the workers preparsed, and the number of results
+  // which were consumed.
+  int results_produced() const {
+    return results_produced_.load(std::memory_order_relaxed);
+  }
+  int results_consumed() const { return results_consumed_; }
+
+ private:
+  class JobTask;
+  struct Chunk {
+    int start;
+    int end;
+    // The worker's parse info, with a clone of the character stream.  The
+    // preparse data of the results lives in its zone.
+    std::unique_ptr<UnoptimizedCompileState> state;
+    std::unique_ptr<ParseInfo> info;
+  };
+
+  // The size of a chunk, in characters.
+  static constexpr int kChunkSize = 256 * KB;
+
+  // Adds the chunks after the one the parser is in at `position`, up to the
+  // end of the script, or for streamed scripts up to `chunks_ahead_` chunks,
+  // and lets the workers run on them.
+  void AddChunks(int position);
+  // Returns the next chunk for a worker, or nullptr if there is none.
+  Chunk* TakeChunk();
+
+  void Run(JobDelegate* delegate);
+  size_t GetMaxConcurrency(size_t worker_count) const;
+  void PreparseChunk(Chunk* chunk, JobDelegate* delegate);
+
+  const UnoptimizedCompileFlags flags_;
+  const UnoptimizedCompileState* const state_;
+  const Utf16CharacterStream* const stream_;
+  const int source_length_;
+  // For chunks preparsed on the main thread with --parallel-preparse-join.
+  const uintptr_t main_thread_stack_limit_;
+  LanguageMode language_mode_ = LanguageMode::kSloppy;
+  bool started_ = false;
+  // The number of chunks of streamed scripts ahead of the parser.
+  int chunks_ahead_ = 0;
+  // The start of the chunk which AddChunks adds next.
+  int next_chunk_start_ = 0;
+
+  // Workers take the chunks in order.  Chunks are only added by the parser,
+  // and only removed when the preparser is destroyed.  Guarded by `mutex_`.
+  std::deque<Chunk> chunks_;
+  size_t next_chunk_ = 0;
+  // The number of chunks which no worker has taken yet.
+  std::atomic<int> remaining_chunks_{0};
+  // Whether a worker found that the script ends before its chunk.
+  std::atomic<bool> end_of_input_{false};
+  // The position of the last function the parser reached.
+  std::atomic<int> parser_position_{0};
+  std::atomic<int> results_produced_{0};
+  int results_consumed_ = 0;
+
+  base::Mutex mutex_;
+  // The results by the position of the parameters.  Guarded by `mutex_`.
+  std::unordered_map<int, Result> results_;
+
+  std::unique_ptr<JobHandle> job_handle_;
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_PARSING_PARALLEL_PREPARSER_H_
@@ -537,7 +537,8 @@ void Parser::ParseProgram(Isolate* isolate, Handle<Script> script,
   }
 
   scanner_.Initialize();
-  FunctionLiteral* result = DoParseProgram(isolate, info);
+  FunctionLiteral* result = DoParseProgramWithParallelPreparser(
+      isolate, info, String::cast(script->source()).length());
   MaybeResetCharacterStream(info, result);
   MaybeProcessSourceRanges(info, result, stack_limit_);
   PostProcessParseResult(isolate, info, result);
@@ -559,6 +560,26 @@ void Parser::ParseProgram(Isolate* isolate, Handle<Script> script,
   }
 }
 
+FunctionLiteral* Parser::DoParseProgramWithParallelPreparser(
+    Isolate* isolate, ParseInfo* info, int source_length) {
+  // IIFE bundles, which start with "(function" or "!function", are not
+  // supported, see ParallelPreparser.
+  Token::Value first_token = scanner()->peek();
+  if (first_token != Token::LPAREN && first_token != Token::NOT) {
+    parallel_preparser_ =
+        ParallelPreparser::MaybeCreate(info, scanner_.stream(), source_length);
+  }
+  FunctionLiteral* result = DoParseProgram(isolate, info);
+  if (parallel_preparser_) {
+    parallel_preparse_results_produced_ =
+        parallel_preparser_->results_produced();
+    parallel_preparse_results_consumed_ =
+        parallel_preparser_->results_consumed();
+    parallel_preparser_.reset();
+  }
+  return result;
+}
+
 FunctionLiteral* Parser::DoParseProgram(Isolate* isolate, ParseInfo* info) {
   // Note that this function can be called from the main thread or from a
   // background thread. We should not access anything Isolate / heap dependent
@@ -2735,6 +2756,14 @@ bool Parser::SkipFunction(const AstRawString* function_name, FunctionKind kind,
     return true;
   }
 
+  if (parallel_preparser_ && function_scope->outer_scope()->is_script_scope() &&
+      kind == FunctionKind::kNormalFunction &&
+      function_syntax_kind == FunctionSyntaxKind::kDeclaration &&
+      ConsumeParallelPreparseResult(function_scope, num_parameters,
+                                    function_length, produced_preparse_data)) {
+    return true;
+  }
+
   Scanner::BookmarkScope bookmark(scanner());
   bookmark.Set(function_scope->start_position());
 
@@ -2798,6 +2827,119 @@ bool Parser::SkipFunction(const AstRawString* function_name, FunctionKind kind,
   return true;
 }
 
+bool Parser::ConsumeParallelPreparseResult(
+    DeclarationScope* function_scope, int* num_parameters,
+    int* function_length, ProducedPreparseData** produced_preparse_data) {
+  if (!parallel_preparser_->started()) {
+    parallel_preparser_->MaybeStart(function_scope->start_position(),
+                                    function_scope->language_mode());
+    return false;
+  }
+  ParallelPreparser::Result result;
+  if (!parallel_preparser_->Consume(
+          function_scope->start_position(), function_scope->language_mode(),
+          main_zone(), &result, produced_preparse_data)) {
+    return false;
+  }
+
+  // Skip the function like with consumed preparse data.  The outer scope is
+  // the script scope, so there are no unresolved variables to migrate.
+  function_scope->set_end_position(result.end_position);
+  scanner()->SeekForward(result.end_position - 1);
+  Expect(Token::RBRACE);
+  SetLanguageMode(function_scope, result.language_mode);
+  total_preparse_skipped_ +=
+      function_scope->end_position() - function_scope->start_position();
+  *num_parameters = result.num_parameters;
+  *function_length = result.function_length;
+  SkipFunctionLiterals(result.num_inner_functions);
+  if (!result.allow_eval_cache) {
+    set_allow_eval_cache(false);
+    reusable_preparser()->set_allow_eval_cache(false);
+  }
+  for (const auto& use_count : result.use_counts) {
+    use_counts_[use_count.first] += use_count.second;
+  }
+  function_scope->ResetAfterPreparsing(ast_value_factory_, false);
+  return true;
+}
+
+bool Parser::PreparseTopLevelFunction(LanguageMode language_mode,
+                                      int* parameters_position,
+                                      ParallelPreparser::Result* result) {
+  parsing_on_main_thread_ = false;
+  if (!allow_lazy_) return false;
+
+  ParsingModeScope mode(this, PARSE_LAZILY);
+  ResetFunctionLiteralId();
+  scanner_.Initialize();
+  scanner_.clear_octal_position();
+
+  DeclarationScope* script_scope = original_scope_->AsDeclarationScope();
+  FunctionState function_state(&function_state_, &scope_, script_scope);
+  if (!Check(Token::FUNCTION) || peek() != Token::IDENTIFIER) return false;
+  Consume(Token::IDENTIFIER);
+  const AstRawString* name = GetIdentifier();
+  if (!Check(Token::LPAREN)) return false;
+
+  DeclarationScope* scope =
+      NewFunctionScope(FunctionKind::kNormalFunction, &preparser_zone_);
+  SetLanguageMode(scope, language_mode);
+  scope->set_start_position(position());
+  *parameters_position = position();
+
+  // Collect the use counts and eval cache bit of this function only.
+  for (int feature = 0; feature < v8::Isolate::kUseCounterFeatureCount;
+       ++feature) {
+    use_counts_[feature] = 0;
+  }
+  set_allow_eval_cache(true);
+  reusable_preparser()->set_allow_eval_cache(true);
+
+  int num_parameters = -1;
+  int function_length = -1;
+  ProducedPreparseData* produced_preparse_data = nullptr;
+  bool success = SkipFunction(name, FunctionKind::kNormalFunction,
+                              FunctionSyntaxKind::kDeclaration, scope,
+                              &num_parameters, &function_length,
+                              &produced_preparse_data) &&
+                 !has_error();
+  // The parser checks this after skipping the function, but the scanner
+  // doesn't see the octal literals of a function it seeks over.
+  if (success && is_strict(scope->language_mode())) {
+    CheckStrictOctalLiteral(scope->start_position(), scope->end_position());
+    success = !has_error();
+  }
+  if (!success) {
+    // The main parser reports the error when it reaches the function.  Reset
+    // the error state so that the next function can be preparsed.  Lazy
+    // parsing was allowed above, SkipFunction turns it off after errors which
+    // the preparser can't identify.
+    pending_error_handler()->clear_pending_error();
+    scanner_.reset_parser_error_flag();
+    allow_lazy_ = true;
+    return false;
+  }
+
+  result->end_position = scope->end_position();
+  result->num_parameters = num_parameters;
+  result->function_length = function_length;
+  result->num_inner_functions = GetLastFunctionLiteralId();
+  result->language_mode = scope->language_mode();
+  result->allow_eval_cache = allow_eval_cache();
+  result->preparse_data = produced_preparse_data == nullptr
+                              ? nullptr
+                              : produced_preparse_data->Serialize(zone());
+  for (int feature = 0; feature < v8::Isolate::kUseCounterFeatureCount;
+       ++feature) {
+    if (use_counts_[feature] == 0) continue;
+    result->use_counts.emplace_back(
+        static_cast<v8::Isolate::UseCounterFeature>(feature),
+        use_counts_[feature]);
+  }
+  return true;
+}
+
 Block* Parser::BuildParameterInitializationBlock(
     const ParserFormalParameters& parameters) {
   DCHECK(!parameters.is_simple);
@@ -3250,6 +3392,10 @@ void Parser::UpdateStatistics(Isolate* isolate, Handle<Script> script) {
   }
   isolate->counters()->total_preparse_skipped()->Increment(
       total_preparse_skipped_);
+  isolate->counters()->parallel_preparse_results_produced()->Increment(
+      parallel_preparse_results_produced_);
+  isolate->counters()->parallel_preparse_results_consumed()->Increment(
+      parallel_preparse_results_consumed_);
 }
 
 void Parser::ParseOnBackground(ParseInfo* info, int start_position,
@@ -3275,7 +3421,8 @@ void Parser::ParseOnBackground(ParseInfo* info, int start_position,
     DCHECK_EQ(start_position, 0);
     DCHECK_EQ(end_position, 0);
     DCHECK_EQ(function_literal_id, kFunctionLiteralIdTopLevel);
-    result = DoParseProgram(/* isolate = */ nullptr, info);
+    result = DoParseProgramWithParallelPreparser(
+        /* isolate = */ nullptr, info, ParallelPreparser::kUnknownSourceLength);
   } else {
     result = DoParseFunction(/* isolate = */ nullptr, info, start_position,
                              end_position, function_literal_id,
@@ -15,6 +15,7 @@
 #include "src/base/threaded-list.h"
 #include "src/common/globals.h"
 #include "src/parsing/import-assertions.h"
+#include "src/parsing/parallel-preparser.h"
 #include "src/parsing/parse-info.h"
 #include "src/parsing/parser-base.h"
 #include "src/parsing/parsing.h"
@@ -144,6 +145,15 @@ class V8_EXPORT_PRIVATE Parser : public NON_EXPORTED_BASE(ParserBase<Parser>) {
   // consist of only the native context.
   void InitializeEmptyScopeChain(ParseInfo* info);
 
+  // Preparses the top-level function declaration at the position of the
+  // character stream, for ParallelPreparser.  Returns false if there is no
+  // function declaration at the position or it couldn't be preparsed.  The
+  // error state is reset after a function with an error, so the parser can
+  // be used for the next one.
+  bool PreparseTopLevelFunction(LanguageMode language_mode,
+                                int* parameters_position,
+                                ParallelPreparser::Result* result);
+
   // Deserialize the scope chain prior to parsing in which the script is going
   // to be executed. If the script is a top-level script, or the scope chain
   // consists of only a native context, maybe_outer_scope_info should be an
@@ -229,6 +239,13 @@ class V8_EXPORT_PRIVATE Parser : public NON_EXPORTED_BASE(ParserBase<Parser>) {
 
   // Called by ParseProgram after setting up the scanner.
   FunctionLiteral* DoParseProgram(Isolate* isolate, ParseInfo* info);
+  // Calls DoParseProgram with a parallel preparser for the script if it
+  // qualifies, see ParallelPreparser::MaybeCreate, and doesn't start with an
+  // IIFE.  `source_length` is
+  // ParallelPreparser::kUnknownSourceLength for streamed scripts.
+  FunctionLiteral* DoParseProgramWithParallelPreparser(Isolate* isolate,
+                                                       ParseInfo* info,
+                                                       int source_length);
 
   // Parse with the script as if the source is implicitly wrapped in a function.
   // We manually construct the AST and scopes for a top-level function and the
@@ -429,6 +446,13 @@ class V8_EXPORT_PRIVATE Parser : public NON_EXPORTED_BASE(ParserBase<Parser>) {
                     int* function_length,
                     ProducedPreparseData** produced_preparsed_scope_data);
 
+  // Skips the top-level function declaration with a result of the parallel
+  // preparser, if it has one.  Starts the parallel preparser on the first
+  // function that it's called for.
+  bool ConsumeParallelPreparseResult(
+      DeclarationScope* function_scope, int* num_parameters,
+      int* function_length, ProducedPreparseData** produced_preparse_data);
+
   Block* BuildParameterInitializationBlock(
       const ParserFormalParameters& parameters);
   Block* BuildRejectPromiseOnException(Block* block,
@@ -1080,6 +1104,9 @@ class V8_EXPORT_PRIVATE Parser : public NON_EXPORTED_BASE(ParserBase<Parser>) {
   bool temp_zoned_;
   ConsumedPreparseData* consumed_preparse_data_;
   std::vector<uint8_t> preparse_data_buffer_;
+  std::unique_ptr<ParallelPreparser> parallel_preparser_;
+  int parallel_preparse_results_produced_ = 0;
+  int parallel_preparse_results_consumed_ = 0;
 
   // If not kNoSourcePosition, indicates that the first function literal
   // encountered is a dynamic function, see CreateDynamicFunction(). This field
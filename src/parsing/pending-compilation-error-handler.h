@@ -74,6 +74,13 @@ class PendingCompilationErrorHandler {
     has_pending_error_ = false;
     unidentifiable_error_ = false;
   }
+  // Forgets the pending error, for parsers whose errors are reported by
+  // another parser, see ParallelPreparser.
+  void clear_pending_error() {
+    has_pending_error_ = false;
+    stack_overflow_ = false;
+    unidentifiable_error_ = false;
+  }
   bool has_error_unidentifiable_by_preparser() const {
     return unidentifiable_error_;
   }
@@ -8,11 +8,13 @@
 #include <vector>
 
 #include "include/v8.h"
+#include "src/base/platform/mutex.h"
 #include "src/common/globals.h"
 #include "src/handles/handles.h"
 #include "src/logging/counters.h"
 #include "src/objects/objects-inl.h"
 #include "src/parsing/scanner.h"
+#include "src/strings/unicode-decoder.h"
 #include "src/strings/unicode-inl.h"
 
 namespace v8 {
@@ -419,6 +421,10 @@ bool BufferedUtf16CharacterStream::ReadBlock() {
 // character position is tricky because the byte position cannot be derived
 // from the character position.
 //
+// The chunks are off-heap, so the stream can be cloned for other threads.
+// Clones share the chunks, which every stream fetches from the embedder
+// through SharedChunks, and decode them on their own.
+//
 // TODO(verwaest): Decode utf8 chunks into utf16 chunks on the blink side
 // instead so we don't need to buffer.
 
@@ -427,17 +433,15 @@ class Utf8ExternalStreamingStream final : public BufferedUtf16CharacterStream {
   Utf8ExternalStreamingStream(
       ScriptCompiler::ExternalSourceStream* source_stream)
       : current_({0, {0, 0, 0, unibrow::Utf8::State::kAccept}}),
-        source_stream_(source_stream) {}
-  ~Utf8ExternalStreamingStream() final {
-    for (const Chunk& chunk : chunks_) delete[] chunk.data;
-  }
+        shared_chunks_(std::make_shared<SharedChunks>(source_stream)) {}
 
   bool can_access_heap() const final { return false; }
 
-  bool can_be_cloned() const final { return false; }
+  bool can_be_cloned() const final { return true; }
 
   std::unique_ptr<Utf16CharacterStream> Clone() const override {
-    UNREACHABLE();
+    return std::unique_ptr<Utf16CharacterStream>(
+        new Utf8ExternalStreamingStream(*this));
   }
 
  protected:
@@ -472,6 +476,44 @@ class Utf8ExternalStreamingStream final : public BufferedUtf16CharacterStream {
     StreamPosition start;
   };
 
+  // The chunks fetched by the stream and its clones, which own their data.
+  // The embedder's source stream may only be called by one thread at a time,
+  // so fetching is serialized.
+  class SharedChunks final {
+   public:
+    explicit SharedChunks(ScriptCompiler::ExternalSourceStream* source_stream)
+        : source_stream_(source_stream) {}
+    ~SharedChunks() {
+      for (const Chunk& chunk : chunks_) delete[] chunk.data;
+    }
+    SharedChunks(const SharedChunks&) = delete;
+    SharedChunks& operator=(const SharedChunks&) = delete;
+
+    // Appends the next chunk to `chunks`, which holds the first chunks of the
+    // stream.  The chunk is fetched from the embedder unless another stream
+    // has fetched it already.  `start` is the position at the end of the last
+    // chunk in `chunks`.
+    void FetchNext(std::vector<Chunk>* chunks, StreamPosition start,
+                   RuntimeCallStats* stats);
+
+   private:
+    // Copies the chunks which `chunks` is missing, if there are any.
+    bool CopyMissing(std::vector<Chunk>* chunks);
+
+    ScriptCompiler::ExternalSourceStream* const source_stream_;
+    // Held while calling the embedder.
+    base::Mutex fetch_mutex_;
+    // Guards `chunks_`.
+    base::Mutex mutex_;
+    std::vector<Chunk> chunks_;
+  };
+
+  // Clones start at the beginning, with the chunks fetched so far.
+  Utf8ExternalStreamingStream(const Utf8ExternalStreamingStream& other)
+      : chunks_(other.chunks_),
+        current_({0, {0, 0, 0, unibrow::Utf8::State::kAccept}}),
+        shared_chunks_(other.shared_chunks_) {}
+
   // Within the current chunk, skip forward from current_ towards position.
   bool SkipToPosition(size_t position);
   // Within the current chunk, fill the buffer_ (while it has capacity).
@@ -482,11 +524,45 @@ class Utf8ExternalStreamingStream final : public BufferedUtf16CharacterStream {
   // (This call is potentially expensive.)
   void SearchPosition(size_t position);
 
+  // The chunks this stream knows of, copied from `shared_chunks_`.
   std::vector<Chunk> chunks_;
   Position current_;
-  ScriptCompiler::ExternalSourceStream* source_stream_;
+  std::shared_ptr<SharedChunks> shared_chunks_;
 };
 
+bool Utf8ExternalStreamingStream::SharedChunks::CopyMissing(
+    std::vector<Chunk>* chunks) {
+  base::MutexGuard guard(&mutex_);
+  if (chunks->size() == chunks_.size()) return false;
+  DCHECK_LT(chunks->size(), chunks_.size());
+  chunks->insert(chunks->end(), chunks_.begin() + chunks->size(),
+                 chunks_.end());
+  return true;
+}
+
+void Utf8ExternalStreamingStream::SharedChunks::FetchNext(
+    std::vector<Chunk>* chunks, StreamPosition start,
+    RuntimeCallStats* stats) {
+  if (CopyMissing(chunks)) return;
+
+  base::MutexGuard fetch_guard(&fetch_mutex_);
+  // Another stream may have fetched the chunk while we waited.
+  if (CopyMissing(chunks)) return;
+
+  const uint8_t* data = nullptr;
+  size_t length;
+  {
+    RuntimeCallTimerScope scope(stats,
+                                RuntimeCallCounterId::kGetMoreDataCallback);
+    length = source_stream_->GetMoreData(&data);
+  }
+  Chunk chunk = {data, length, start};
+  base::MutexGuard guard(&mutex_);
+  DCHECK_EQ(chunks->size(), chunks_.size());
+  chunks_.push_back(chunk);
+  chunks->push_back(chunk);
+}
+
 bool Utf8ExternalStreamingStream::SkipToPosition(size_t position) {
   DCHECK_LE(current_.pos.chars, position);  // We can only skip forward.
 
@@ -592,25 +668,21 @@ void Utf8ExternalStreamingStream::FillBufferFromCurrentChunk() {
 
   const uint16_t* max_buffer_end = buffer_start_ + kBufferSize;
   while (cursor < end && output_cursor + 1 < max_buffer_end) {
+    // Fast path for well-formed sequences.
+    if (state == unibrow::Utf8::State::kAccept) {
+      TranscodeWellFormedUtf8(&cursor, end, &output_cursor, max_buffer_end);
+      if (cursor == end || output_cursor + 1 >= max_buffer_end) break;
+    }
     unibrow::uchar t =
         unibrow::Utf8::ValueOfIncremental(&cursor, &state, &incomplete_char);
     if (V8_LIKELY(t <= unibrow::Utf16::kMaxNonSurrogateCharCode)) {
-      *(output_cursor++) = static_cast<uc16>(t);  // The most frequent case.
+      *(output_cursor++) = static_cast<uc16>(t);
     } else if (t == unibrow::Utf8::kIncomplete) {
       continue;
     } else {
       *(output_cursor++) = unibrow::Utf16::LeadSurrogate(t);
       *(output_cursor++) = unibrow::Utf16::TrailSurrogate(t);
     }
-    // Fast path for ascii sequences.
-    size_t remaining = end - cursor;
-    size_t max_buffer = max_buffer_end - output_cursor;
-    int max_length = static_cast<int>(std::min(remaining, max_buffer));
-    DCHECK_EQ(state, unibrow::Utf8::State::kAccept);
-    int ascii_length = NonAsciiStart(cursor, max_length);
-    CopyChars(output_cursor, cursor, ascii_length);
-    cursor += ascii_length;
-    output_cursor += ascii_length;
   }
 
   current_.pos.bytes = chunk.start.bytes + (cursor - chunk.data);
@@ -623,15 +695,11 @@ void Utf8ExternalStreamingStream::FillBufferFromCurrentChunk() {
 }
 
 bool Utf8ExternalStreamingStream::FetchChunk() {
-  RuntimeCallTimerScope scope(runtime_call_stats(),
-                              RuntimeCallCounterId::kGetMoreDataCallback);
   DCHECK_EQ(current_.chunk_no, chunks_.size());
   DCHECK(chunks_.empty() || chunks_.back().length != 0);
 
-  const uint8_t* chunk = nullptr;
-  size_t length = source_stream_->GetMoreData(&chunk);
-  chunks_.push_back({chunk, length, current_.pos});
-  return length > 0;
+  shared_chunks_->FetchNext(&chunks_, current_.pos, runtime_call_stats());
+  return chunks_.back().length > 0;
 }
 
 void Utf8ExternalStreamingStream::SearchPosition(size_t position) {
@@ -20,6 +20,13 @@ std::ostream& PrintAsciiOrHex(std::ostream& os, uc16 c) {
   return os;
 }
 
+std::ostream& operator<<(std::ostream& os,
+                         RegExpInstruction::LookaroundPayload lookaround) {
+  return os << lookaround.index
+            << (lookaround.is_positive ? " POSITIVE" : " NEGATIVE")
+            << (lookaround.is_ahead ? " AHEAD" : " BEHIND");
+}
+
 }  // namespace
 
 std::ostream& operator<<(std::ostream& os, const RegExpInstruction& inst) {
@@ -70,6 +77,18 @@ std::ostream& operator<<(std::ostream& os, const RegExpInstruction& inst) {
     case RegExpInstruction::CLEAR_REGISTER:
       os << "CLEAR_REGISTER " << inst.payload.register_index;
       break;
+    case RegExpInstruction::READ_LOOKAROUND_TABLE:
+      os << "READ_LOOKAROUND_TABLE " << inst.payload.lookaround;
+      break;
+    case RegExpInstruction::START_LOOKAROUND:
+      os << "START_LOOKAROUND " << inst.payload.lookaround;
+      break;
+    case RegExpInstruction::WRITE_LOOKAROUND_TABLE:
+      os << "WRITE_LOOKAROUND_TABLE " << inst.payload.lookaround;
+      break;
+    case RegExpInstruction::CONSUME_BACK_REFERENCE:
+      os << "CONSUME_BACK_REFERENCE " << inst.payload.register_index;
+      break;
   }
   return os;
 }
@@ -51,6 +51,32 @@
 //   position (CP) within the input, then continue with the next instruction.
 // - CLEAR_REGISTER: Clear the register specified in the payload by resetting
 //   it to the initial value -1.
+// - READ_LOOKAROUND_TABLE: Check whether the lookaround specified in the
+//   payload holds (or doesn't hold, for negative lookarounds) at the current
+//   input position.  Abort this thread if not, otherwise continue with the
+//   next instruction.
+// - CONSUME_BACK_REFERENCE: Check whether the input at the current position
+//   continues with the substring captured by the capture group whose begin
+//   register is specified in the payload; the end register is the next one.
+//   An undefined capture matches the empty string.  Abort this thread if
+//   false, otherwise advance the input position by the length of the capture
+//   and continue with the next instruction.
+//
+// Lookarounds are not matched by the threads of the program itself.  Their
+// bodies are compiled into separate automata after the final ACCEPT of the
+// program, each of which starts with START_LOOKAROUND:
+// - START_LOOKAROUND: Marks the beginning of the automaton of the lookaround
+//   specified in the payload, and whether it is a lookahead or a lookbehind.
+//   The automaton is a /[^]*/ preamble followed by the body of the
+//   lookaround, in reverse for lookaheads.  It is run over the whole input
+//   before the program, forwards for lookbehinds and backwards for
+//   lookaheads, with a set of pcs as state and without registers or
+//   priorities.
+// - WRITE_LOOKAROUND_TABLE: Record that the lookaround specified in the
+//   payload holds at the current input position and stop this thread.  This
+//   is where the automaton of the lookaround accepts.
+// The automaton of a lookaround may only read the tables of lookarounds with
+// a higher index, so the tables are computed from the highest index down.
 //
 // Special care must be exercised with respect to thread priority.  It is
 // possible that more than one thread executes an ACCEPT statement.  The output
@@ -99,6 +125,10 @@ struct RegExpInstruction {
     FORK,
     JMP,
     SET_REGISTER_TO_CP,
+    READ_LOOKAROUND_TABLE,
+    START_LOOKAROUND,
+    WRITE_LOOKAROUND_TABLE,
+    CONSUME_BACK_REFERENCE,
   };
 
   struct Uc16Range {
@@ -106,6 +136,14 @@ struct RegExpInstruction {
     uc16 max;  // Inclusive.
   };
 
+  struct LookaroundPayload {
+    // Index of the lookaround, in the order of the START_LOOKAROUND
+    // instructions.
+    uint16_t index;
+    bool is_positive;
+    bool is_ahead;
+  };
+
   static RegExpInstruction ConsumeRange(uc16 min, uc16 max) {
     RegExpInstruction result;
     result.opcode = CONSUME_RANGE;
@@ -164,16 +202,54 @@ struct RegExpInstruction {
     return result;
   }
 
+  static RegExpInstruction ReadLookaroundTable(int index, bool is_positive,
+                                               bool is_ahead) {
+    RegExpInstruction result;
+    result.opcode = READ_LOOKAROUND_TABLE;
+    result.payload.lookaround = LookaroundPayload{
+        static_cast<uint16_t>(index), is_positive, is_ahead};
+    return result;
+  }
+
+  static RegExpInstruction StartLookaround(int index, bool is_positive,
+                                           bool is_ahead) {
+    RegExpInstruction result;
+    result.opcode = START_LOOKAROUND;
+    result.payload.lookaround = LookaroundPayload{
+        static_cast<uint16_t>(index), is_positive, is_ahead};
+    return result;
+  }
+
+  static RegExpInstruction WriteLookaroundTable(int index, bool is_positive,
+                                                bool is_ahead) {
+    RegExpInstruction result;
+    result.opcode = WRITE_LOOKAROUND_TABLE;
+    result.payload.lookaround = LookaroundPayload{
+        static_cast<uint16_t>(index), is_positive, is_ahead};
+    return result;
+  }
+
+  static RegExpInstruction ConsumeBackReference(int32_t register_index) {
+    RegExpInstruction result;
+    result.opcode = CONSUME_BACK_REFERENCE;
+    result.payload.register_index = register_index;
+    return result;
+  }
+
   Opcode opcode;
   union {
     // Payload of CONSUME_RANGE:
     Uc16Range consume_range;
     // Payload of FORK and JMP, the next/forked program counter (pc):
     int32_t pc;
-    // Payload of SET_REGISTER_TO_CP and CLEAR_REGISTER:
+    // Payload of SET_REGISTER_TO_CP, CLEAR_REGISTER and
+    // CONSUME_BACK_REFERENCE:
     int32_t register_index;
     // Payload of ASSERTION:
     RegExpAssertion::AssertionType assertion_type;
+    // Payload of READ_LOOKAROUND_TABLE, START_LOOKAROUND and
+    // WRITE_LOOKAROUND_TABLE:
+    LookaroundPayload lookaround;
   } payload;
   STATIC_ASSERT(sizeof(payload) == 4);
 };
@@ -4,7 +4,11 @@
 
 #include "src/regexp/experimental/experimental-compiler.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "src/regexp/experimental/experimental.h"
+#include "src/zone/zone-containers.h"
 #include "src/zone/zone-list-inl.h"
 
 namespace v8 {
@@ -22,13 +26,13 @@ class CanBeHandledVisitor final : private RegExpVisitor {
   static bool Check(RegExpTree* tree, JSRegExp::Flags flags,
                     int capture_count) {
     if (!AreSuitableFlags(flags)) return false;
-    CanBeHandledVisitor visitor;
+    CanBeHandledVisitor visitor(flags);
     tree->Accept(&visitor, nullptr);
     return visitor.result_;
   }
 
  private:
-  CanBeHandledVisitor() = default;
+  explicit CanBeHandledVisitor(JSRegExp::Flags flags) : flags_(flags) {}
 
   static bool AreSuitableFlags(JSRegExp::Flags flags) {
     // TODO(mbid, v8:10765): We should be able to support all flags in the
@@ -141,7 +145,9 @@ class CanBeHandledVisitor final : private RegExpVisitor {
   }
 
   void* VisitCapture(RegExpCapture* node, void*) override {
+    open_captures_.push_back(node);
     node->body()->Accept(this, nullptr);
+    open_captures_.pop_back();
     return nullptr;
   }
 
@@ -151,15 +157,42 @@ class CanBeHandledVisitor final : private RegExpVisitor {
   }
 
   void* VisitLookaround(RegExpLookaround* node, void*) override {
-    // TODO(mbid, v8:10765): This will be hard to support, but not impossible I
-    // think.  See product automata.
-    result_ = false;
+    // Every lookaround is run as a separate automaton over the whole input,
+    // see the definition of START_LOOKAROUND.  The automata only tell where
+    // a lookaround holds, so captures in positive lookarounds, whose values
+    // would be visible after the lookaround, are not supported.  Captures in
+    // negative lookarounds are always undefined.
+    static constexpr int kMaxLookaroundCount = 16;
+    if (++lookaround_count_ > kMaxLookaroundCount ||
+        (node->is_positive() && node->capture_count() > 0)) {
+      result_ = false;
+      return nullptr;
+    }
+
+    // The body of the lookaround is compiled only once, into the automaton.
+    int before_replication_factor = replication_factor_;
+    replication_factor_ = 1;
+    ++lookaround_depth_;
+    node->body()->Accept(this, nullptr);
+    --lookaround_depth_;
+    replication_factor_ = before_replication_factor;
     return nullptr;
   }
 
   void* VisitBackReference(RegExpBackReference* node, void*) override {
-    // This can't be implemented without backtracking.
-    result_ = false;
+    // Back references are matched by threads that remember the captured
+    // substrings, which takes linear time only as long as the interpreter
+    // finds few different captures per input position, see
+    // --experimental-regexp-engine-backreference-memo-size.  Beyond that it
+    // falls back to backtracking, so regexps with the linear flag don't
+    // support them.  The automata of lookarounds don't track captures, and
+    // within its own capture group, whose begin register is already set
+    // there, a back reference would have to match the empty string.
+    if ((flags_ & JSRegExp::kLinear) != 0 || lookaround_depth_ > 0 ||
+        std::find(open_captures_.begin(), open_captures_.end(),
+                  node->capture()) != open_captures_.end()) {
+      result_ = false;
+    }
     return nullptr;
   }
 
@@ -169,6 +202,14 @@ class CanBeHandledVisitor final : private RegExpVisitor {
   // See comment in `VisitQuantifier`:
   int replication_factor_ = 1;
 
+  // See comment in `VisitLookaround`:
+  int lookaround_count_ = 0;
+
+  // See comment in `VisitBackReference`:
+  const JSRegExp::Flags flags_;
+  int lookaround_depth_ = 0;
+  std::vector<RegExpCapture*> open_captures_;
+
   bool result_ = true;
 };
 
@@ -249,6 +290,27 @@ class BytecodeAssembler {
     code_.Add(RegExpInstruction::SetRegisterToCp(register_index), zone_);
   }
 
+  void ConsumeBackReference(int32_t register_index) {
+    code_.Add(RegExpInstruction::ConsumeBackReference(register_index), zone_);
+  }
+
+  void ReadLookaroundTable(int index, bool is_positive, bool is_ahead) {
+    code_.Add(
+        RegExpInstruction::ReadLookaroundTable(index, is_positive, is_ahead),
+        zone_);
+  }
+
+  void StartLookaround(int index, bool is_positive, bool is_ahead) {
+    code_.Add(RegExpInstruction::StartLookaround(index, is_positive, is_ahead),
+              zone_);
+  }
+
+  void WriteLookaroundTable(int index, bool is_positive, bool is_ahead) {
+    code_.Add(
+        RegExpInstruction::WriteLookaroundTable(index, is_positive, is_ahead),
+        zone_);
+  }
+
   void Bind(Label& target) {
     DCHECK_EQ(target.state_, Label::UNBOUND);
 
@@ -313,11 +375,50 @@ class CompileVisitor : private RegExpVisitor {
     compiler.assembler_.SetRegisterToCp(1);
     compiler.assembler_.Accept();
 
+    // Lookarounds found while compiling the automaton of another lookaround
+    // are appended to `lookarounds_`.
+    for (size_t i = 0; i < compiler.lookarounds_.size(); ++i) {
+      compiler.CompileLookaroundAutomaton(static_cast<int>(i));
+    }
+
     return std::move(compiler.assembler_).IntoCode();
   }
 
  private:
-  explicit CompileVisitor(Zone* zone) : zone_(zone), assembler_(zone) {}
+  explicit CompileVisitor(Zone* zone)
+      : zone_(zone), assembler_(zone), lookarounds_(zone) {}
+
+  // Emit the automaton of the lookaround with the given index, see the
+  // definition of START_LOOKAROUND.
+  void CompileLookaroundAutomaton(int index) {
+    RegExpLookaround* node = lookarounds_[index];
+    const bool is_ahead = node->type() == RegExpLookaround::LOOKAHEAD;
+    assembler_.StartLookaround(index, node->is_positive(), is_ahead);
+
+    // A lookbehind body may start and a lookahead body may end anywhere in
+    // the input.
+    CompileGreedyStar([&]() { assembler_.ConsumeAnyChar(); });
+
+    // The automaton tracks neither registers nor priorities, and the one of a
+    // lookahead runs backwards over the input.
+    is_lookaround_automaton_ = true;
+    is_reversed_ = is_ahead;
+    node->body()->Accept(this, nullptr);
+    is_reversed_ = false;
+
+    assembler_.WriteLookaroundTable(index, node->is_positive(), is_ahead);
+  }
+
+  // Returns the index of the automaton of a lookaround.  Lookarounds in the
+  // body of a quantifier are visited once per replication of the body.
+  int LookaroundIndex(RegExpLookaround* node) {
+    auto it = std::find(lookarounds_.begin(), lookarounds_.end(), node);
+    if (it != lookarounds_.end()) {
+      return static_cast<int>(it - lookarounds_.begin());
+    }
+    lookarounds_.push_back(node);
+    return static_cast<int>(lookarounds_.size()) - 1;
+  }
 
   // Generate a disjunction of code fragments compiled by a function `alt_gen`.
   // `alt_gen` is called repeatedly with argument `int i = 0, 1, ..., alt_num -
@@ -375,8 +476,15 @@ class CompileVisitor : private RegExpVisitor {
   }
 
   void* VisitAlternative(RegExpAlternative* node, void*) override {
-    for (RegExpTree* child : *node->nodes()) {
-      child->Accept(this, nullptr);
+    ZoneList<RegExpTree*>& children = *node->nodes();
+    if (is_reversed_) {
+      for (int i = children.length() - 1; i >= 0; --i) {
+        children[i]->Accept(this, nullptr);
+      }
+    } else {
+      for (RegExpTree* child : children) {
+        child->Accept(this, nullptr);
+      }
     }
     return nullptr;
   }
@@ -419,14 +527,21 @@ class CompileVisitor : private RegExpVisitor {
   }
 
   void* VisitAtom(RegExpAtom* node, void*) override {
-    for (uc16 c : node->data()) {
-      assembler_.ConsumeRange(c, c);
+    Vector<const uc16> data = node->data();
+    if (is_reversed_) {
+      for (int i = data.length() - 1; i >= 0; --i) {
+        assembler_.ConsumeRange(data[i], data[i]);
+      }
+    } else {
+      for (uc16 c : data) {
+        assembler_.ConsumeRange(c, c);
+      }
     }
     return nullptr;
   }
 
   void ClearRegisters(Interval indices) {
-    if (indices.is_empty()) return;
+    if (indices.is_empty() || is_lookaround_automaton_) return;
     DCHECK_EQ(indices.from() % 2, 0);
     DCHECK_EQ(indices.to() % 2, 1);
     for (int i = indices.from(); i <= indices.to(); i += 2) {
@@ -587,6 +702,10 @@ class CompileVisitor : private RegExpVisitor {
   }
 
   void* VisitCapture(RegExpCapture* node, void*) override {
+    if (is_lookaround_automaton_) {
+      node->body()->Accept(this, nullptr);
+      return nullptr;
+    }
     int index = node->index();
     int start_register = RegExpCapture::StartRegister(index);
     int end_register = RegExpCapture::EndRegister(index);
@@ -602,19 +721,34 @@ class CompileVisitor : private RegExpVisitor {
   }
 
   void* VisitLookaround(RegExpLookaround* node, void*) override {
-    // TODO(mbid,v8:10765): Support this case.
-    UNREACHABLE();
+    // The body is compiled into the automaton of the lookaround, which is run
+    // before the program.
+    assembler_.ReadLookaroundTable(
+        LookaroundIndex(node), node->is_positive(),
+        node->type() == RegExpLookaround::LOOKAHEAD);
+    return nullptr;
   }
 
   void* VisitBackReference(RegExpBackReference* node, void*) override {
-    UNREACHABLE();
+    // Back references don't occur in lookarounds, see CanBeHandledVisitor.
+    DCHECK(!is_lookaround_automaton_);
+    assembler_.ConsumeBackReference(
+        RegExpCapture::StartRegister(node->index()));
+    return nullptr;
   }
 
   void* VisitEmpty(RegExpEmpty* node, void*) override { return nullptr; }
 
   void* VisitText(RegExpText* node, void*) override {
-    for (TextElement& text_el : *node->elements()) {
-      text_el.tree()->Accept(this, nullptr);
+    ZoneList<TextElement>& elements = *node->elements();
+    if (is_reversed_) {
+      for (int i = elements.length() - 1; i >= 0; --i) {
+        elements[i].tree()->Accept(this, nullptr);
+      }
+    } else {
+      for (TextElement& text_el : elements) {
+        text_el.tree()->Accept(this, nullptr);
+      }
     }
     return nullptr;
   }
@@ -622,6 +756,13 @@ class CompileVisitor : private RegExpVisitor {
  private:
   Zone* zone_;
   BytecodeAssembler assembler_;
+
+  // The lookarounds found so far, by index.
+  ZoneVector<RegExpLookaround*> lookarounds_;
+  // Whether we're compiling the automaton of a lookaround, and whether it
+  // consumes the input backwards.
+  bool is_lookaround_automaton_ = false;
+  bool is_reversed_ = false;
 };
 
 }  // namespace
@@ -15,8 +15,8 @@ namespace internal {
 class ExperimentalRegExpCompiler final : public AllStatic {
  public:
   // Checks whether a given RegExpTree can be compiled into an experimental
-  // bytecode program.  This mostly amounts to the absence of back references,
-  // but see the definition.
+  // bytecode program.  This mostly amounts to the absence of back references
+  // and of captures in positive lookarounds, but see the definition.
   // TODO(mbid,v8:10765): Currently more things are not handled, e.g. some
   // quantifiers and unicode.
   static bool CanBeHandled(RegExpTree* tree, JSRegExp::Flags flags,
@@ -0,0 +1,556 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/regexp/experimental/experimental-dfa-compiler.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "src/execution/isolate.h"
+#include "src/flags/flags.h"
+#include "src/objects/code-inl.h"
+#include "src/objects/fixed-array-inl.h"
+#include "src/regexp/experimental/experimental-dfa.h"
+#include "src/regexp/regexp-macro-assembler-arch.h"
+#include "src/utils/memcopy.h"
+#include "src/zone/zone-containers.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+// Registers of the generated code.  Only the match boundaries are output.
+constexpr int kMatchBeginRegister = 0;
+constexpr int kMatchEndRegister = 1;
+constexpr int kOutputRegisterCount = 2;
+// The position at which the search started.
+constexpr int kSearchStartRegister = 2;
+// 1 if the forward automaton found the end of a match, 0 otherwise.
+constexpr int kHasMatchRegister = 3;
+// The number of characters consumed since the last interrupt check.
+constexpr int kTicksRegister = 4;
+
+// Interrupts are handled as often as in the NfaInterpreter.
+constexpr int kTicksBetweenInterruptChecks = 64;
+
+// Up to this many character ranges are tested one after another, more are
+// split by binary search.
+constexpr int kMaxLinearDispatchRanges = 4;
+
+// A range of characters on which the current state has the same successor.
+struct DispatchRange {
+  uc16 from;
+  uc16 to;
+  Label* target;
+};
+
+class DfaCodeGenerator {
+ public:
+  DfaCodeGenerator(Isolate* isolate, Zone* zone,
+                   Vector<const RegExpInstruction> bytecode)
+      : isolate_(isolate),
+        zone_(zone),
+        bytecode_(bytecode),
+        class_starts_(zone),
+        forward_states_(zone),
+        predecessors_(bytecode.length(), ZoneVector<int>(zone), zone),
+        consume_range_pcs_(zone),
+        backward_states_(zone),
+        backward_live_pcs_(zone),
+        backward_indices_(zone) {}
+
+  // Computes both automata.  Returns false if one of them is too large.
+  bool ComputeAutomata() {
+    return ComputeForwardAutomaton() && ComputeBackwardAutomaton();
+  }
+
+  Handle<Code> Generate(Handle<String> source,
+                        NativeRegExpMacroAssembler::Mode mode);
+
+ private:
+  struct ForwardState {
+    // Whether a match ends when this state is entered.
+    bool is_match;
+    // Whether no thread is left, so that the search can stop.
+    bool is_final;
+    // Whether a match ends if the input ends in this state.
+    bool accepts_at_end;
+    // Successor state indices by character class.
+    ZoneVector<int> next;
+  };
+
+  struct BackwardState {
+    // Whether a match can begin at the current position.
+    bool is_begin;
+    // Whether a match can begin at the current position if it is the start
+    // of the input.
+    bool is_begin_at_start;
+    // Successor state indices by character class, -1 if no pc is live.
+    ZoneVector<int> next;
+  };
+
+  bool ComputeForwardAutomaton();
+  bool ComputeBackwardAutomaton();
+
+  // States of the backward automaton are the sets of pcs after the preamble
+  // from which ACCEPT can be reached at the end of the match, as computed by
+  // the NfaInterpreter's FindMatchBegin.
+  void ComputePredecessors();
+  // Adds all pcs from which one of `live_pcs` can be reached without
+  // consuming input to `live_pcs` and sorts them.
+  void AddLivePredecessors(ZoneVector<int>* live_pcs, bool at_start,
+                           bool at_end) const;
+  // Returns the index of the state for the sorted `live_pcs`, adding it if
+  // it is new, or -1 if `live_pcs` is empty.
+  int InternBackwardState(const ZoneVector<int>& live_pcs);
+
+  // Counts a consumed character, and handles interrupts every
+  // kTicksBetweenInterruptChecks characters.
+  void EmitInterruptCheck(RegExpMacroAssembler* masm);
+  // Jumps to the label of the successor for the class of the current
+  // character.
+  void EmitDispatch(RegExpMacroAssembler* masm, uc16 max_char,
+                    const ZoneVector<int>& next, std::vector<Label>* labels,
+                    Label* on_dead);
+  void EmitRangeDispatch(RegExpMacroAssembler* masm,
+                         const DispatchRange* begin, const DispatchRange* end);
+
+  RegExpMacroAssembler* NewMacroAssembler(
+      NativeRegExpMacroAssembler::Mode mode);
+
+  Isolate* const isolate_;
+  Zone* const zone_;
+  const Vector<const RegExpInstruction> bytecode_;
+  int match_begin_pc_ = -1;
+
+  // The first characters of the character classes of the LazyDfa.
+  ZoneVector<uc16> class_starts_;
+
+  ZoneVector<ForwardState> forward_states_;
+  // Indexed by whether the search starts at the beginning of the input.
+  int forward_start_[2] = {-1, -1};
+  // Whether there is an empty match at the end of the input, indexed by
+  // whether the input is empty.
+  bool empty_match_at_end_[2] = {false, false};
+
+  ZoneVector<ZoneVector<int>> predecessors_;
+  ZoneVector<int> consume_range_pcs_;
+  ZoneVector<BackwardState> backward_states_;
+  ZoneVector<ZoneVector<int>> backward_live_pcs_;
+  ZoneMap<ZoneVector<int>, int> backward_indices_;
+  // Indexed by whether the match ends at the end of the input.
+  int backward_start_[2] = {-1, -1};
+};
+
+bool DfaCodeGenerator::ComputeForwardAutomaton() {
+  LazyDfa dfa(bytecode_, isolate_->allocator());
+  dfa.Acquire(&bytecode_);
+  ZoneVector<LazyDfa::State*> states(zone_);
+  if (!dfa.ComputeAllStates(
+          FLAG_experimental_regexp_engine_max_native_dfa_states, &states)) {
+    dfa.Release();
+    return false;
+  }
+
+  for (int char_class = 0; char_class < dfa.class_count(); ++char_class) {
+    class_starts_.push_back(dfa.ClassStart(char_class));
+  }
+
+  ZoneUnorderedMap<LazyDfa::State*, int> indices(zone_);
+  for (size_t i = 0; i < states.size(); ++i) {
+    indices[states[i]] = static_cast<int>(i);
+  }
+  for (LazyDfa::State* state : states) {
+    ForwardState forward_state{state->is_match, state->pcs.empty(),
+                               dfa.AcceptsAtEnd(state, false),
+                               ZoneVector<int>(zone_)};
+    for (int char_class = 0; char_class < dfa.class_count(); ++char_class) {
+      forward_state.next.push_back(indices[state->next[char_class]]);
+    }
+    forward_states_.push_back(std::move(forward_state));
+  }
+
+  for (bool at_start : {false, true}) {
+    LazyDfa::State* start_state = dfa.StartState(at_start);
+    forward_start_[at_start] = indices[start_state];
+    empty_match_at_end_[at_start] =
+        start_state->is_match || dfa.AcceptsAtEnd(start_state, at_start);
+  }
+  dfa.Release();
+  return true;
+}
+
+bool DfaCodeGenerator::ComputeBackwardAutomaton() {
+  ComputePredecessors();
+
+  for (bool at_end : {false, true}) {
+    ZoneVector<int> live_pcs(zone_);
+    for (int pc = match_begin_pc_; pc != bytecode_.length(); ++pc) {
+      if (bytecode_[pc].opcode == RegExpInstruction::ACCEPT) {
+        live_pcs.push_back(pc);
+      }
+    }
+    AddLivePredecessors(&live_pcs, false, at_end);
+    backward_start_[at_end] = InternBackwardState(live_pcs);
+  }
+
+  const size_t max_state_count =
+      FLAG_experimental_regexp_engine_max_native_dfa_states;
+  for (size_t i = 0; i < backward_live_pcs_.size(); ++i) {
+    if (backward_live_pcs_.size() > max_state_count) return false;
+    // Interning can add live pc sets, so we can't hold a reference.
+    const ZoneVector<int> live_pcs = backward_live_pcs_[i];
+    ZoneVector<int> next(zone_);
+    for (uc16 input_char : class_starts_) {
+      ZoneVector<int> next_live_pcs(zone_);
+      for (int pc : consume_range_pcs_) {
+        RegExpInstruction::Uc16Range range =
+            bytecode_[pc].payload.consume_range;
+        if (input_char >= range.min && input_char <= range.max &&
+            std::binary_search(live_pcs.begin(), live_pcs.end(), pc + 1)) {
+          next_live_pcs.push_back(pc);
+        }
+      }
+      AddLivePredecessors(&next_live_pcs, false, false);
+      next.push_back(InternBackwardState(next_live_pcs));
+    }
+    backward_states_[i].next = std::move(next);
+  }
+  return backward_live_pcs_.size() <= max_state_count;
+}
+
+void DfaCodeGenerator::ComputePredecessors() {
+  for (int pc = 0; pc != bytecode_.length(); ++pc) {
+    RegExpInstruction inst = bytecode_[pc];
+    if (inst.opcode == RegExpInstruction::SET_REGISTER_TO_CP &&
+        inst.payload.register_index == 0) {
+      match_begin_pc_ = pc;
+      break;
+    }
+  }
+  DCHECK_NE(match_begin_pc_, -1);
+
+  for (int pc = match_begin_pc_; pc != bytecode_.length(); ++pc) {
+    RegExpInstruction inst = bytecode_[pc];
+    switch (inst.opcode) {
+      case RegExpInstruction::ACCEPT:
+        break;
+      case RegExpInstruction::CONSUME_RANGE:
+        consume_range_pcs_.push_back(pc);
+        break;
+      case RegExpInstruction::FORK:
+        predecessors_[inst.payload.pc].push_back(pc);
+        predecessors_[pc + 1].push_back(pc);
+        break;
+      case RegExpInstruction::JMP:
+        predecessors_[inst.payload.pc].push_back(pc);
+        break;
+      case RegExpInstruction::ASSERTION:
+      case RegExpInstruction::SET_REGISTER_TO_CP:
+      case RegExpInstruction::CLEAR_REGISTER:
+        predecessors_[pc + 1].push_back(pc);
+        break;
+      case RegExpInstruction::READ_LOOKAROUND_TABLE:
+      case RegExpInstruction::START_LOOKAROUND:
+      case RegExpInstruction::WRITE_LOOKAROUND_TABLE:
+      case RegExpInstruction::CONSUME_BACK_REFERENCE:
+        // Bytecode with lookarounds or back references isn't run on the
+        // LazyDfa.
+        UNREACHABLE();
+    }
+  }
+}
+
+void DfaCodeGenerator::AddLivePredecessors(ZoneVector<int>* live_pcs,
+                                           bool at_start, bool at_end) const {
+  ZoneVector<bool> is_live(bytecode_.length(), false, zone_);
+  for (int pc : *live_pcs) is_live[pc] = true;
+  for (size_t i = 0; i < live_pcs->size(); ++i) {
+    for (int predecessor : predecessors_[(*live_pcs)[i]]) {
+      if (is_live[predecessor]) continue;
+      RegExpInstruction inst = bytecode_[predecessor];
+      if (inst.opcode == RegExpInstruction::ASSERTION) {
+        const bool holds =
+            inst.payload.assertion_type == RegExpAssertion::START_OF_INPUT
+                ? at_start
+                : at_end;
+        if (!holds) continue;
+      }
+      is_live[predecessor] = true;
+      live_pcs->push_back(predecessor);
+    }
+  }
+  std::sort(live_pcs->begin(), live_pcs->end());
+}
+
+int DfaCodeGenerator::InternBackwardState(const ZoneVector<int>& live_pcs) {
+  if (live_pcs.empty()) return -1;
+  auto it = backward_indices_.find(live_pcs);
+  if (it != backward_indices_.end()) return it->second;
+
+  const int index = static_cast<int>(backward_states_.size());
+  backward_indices_.emplace(live_pcs, index);
+  backward_live_pcs_.push_back(live_pcs);
+
+  ZoneVector<int> live_pcs_at_start(live_pcs);
+  AddLivePredecessors(&live_pcs_at_start, true, false);
+  backward_states_.push_back(BackwardState{
+      std::binary_search(live_pcs.begin(), live_pcs.end(), match_begin_pc_),
+      std::binary_search(live_pcs_at_start.begin(), live_pcs_at_start.end(),
+                         match_begin_pc_),
+      ZoneVector<int>(zone_)});
+  return index;
+}
+
+RegExpMacroAssembler* DfaCodeGenerator::NewMacroAssembler(
+    NativeRegExpMacroAssembler::Mode mode) {
+#if V8_TARGET_ARCH_IA32
+  return new RegExpMacroAssemblerIA32(isolate_, zone_, mode,
+                                      kOutputRegisterCount);
+#elif V8_TARGET_ARCH_X64
+  return new RegExpMacroAssemblerX64(isolate_, zone_, mode,
+                                     kOutputRegisterCount);
+#elif V8_TARGET_ARCH_ARM
+  return new RegExpMacroAssemblerARM(isolate_, zone_, mode,
+                                     kOutputRegisterCount);
+#elif V8_TARGET_ARCH_ARM64
+  return new RegExpMacroAssemblerARM64(isolate_, zone_, mode,
+                                       kOutputRegisterCount);
+#elif V8_TARGET_ARCH_S390
+  return new RegExpMacroAssemblerS390(isolate_, zone_, mode,
+                                      kOutputRegisterCount);
+#elif V8_TARGET_ARCH_PPC || V8_TARGET_ARCH_PPC64
+  return new RegExpMacroAssemblerPPC(isolate_, zone_, mode,
+                                     kOutputRegisterCount);
+#elif V8_TARGET_ARCH_MIPS || V8_TARGET_ARCH_MIPS64
+  return new RegExpMacroAssemblerMIPS(isolate_, zone_, mode,
+                                      kOutputRegisterCount);
+#elif V8_TARGET_ARCH_RISCV64 || V8_TARGET_ARCH_RISCV
+  return new RegExpMacroAssemblerRISCV(isolate_, zone_, mode,
+                                       kOutputRegisterCount);
+#else
+#error "Unsupported architecture"
+#endif
+}
+
+void DfaCodeGenerator::EmitInterruptCheck(RegExpMacroAssembler* masm) {
+  Label no_check;
+  masm->AdvanceRegister(kTicksRegister, 1);
+  masm->IfRegisterLT(kTicksRegister, kTicksBetweenInterruptChecks,
+                     &no_check);
+  masm->SetRegister(kTicksRegister, 0);
+  // Backtracking checks for interrupts and stack overflow.
+  masm->PushBacktrack(&no_check);
+  masm->Backtrack();
+  masm->Bind(&no_check);
+}
+
+void DfaCodeGenerator::EmitDispatch(RegExpMacroAssembler* masm,
+                                    uc16 max_char,
+                                    const ZoneVector<int>& next,
+                                    std::vector<Label>* labels,
+                                    Label* on_dead) {
+  std::vector<DispatchRange> ranges;
+  for (size_t char_class = 0; char_class < class_starts_.size();
+       ++char_class) {
+    const uc16 from = class_starts_[char_class];
+    if (from > max_char) break;
+    const uc16 to = char_class + 1 < class_starts_.size()
+                        ? std::min<uc16>(class_starts_[char_class + 1] - 1,
+                                         max_char)
+                        : max_char;
+    Label* target = next[char_class] == -1 ? on_dead
+                                           : &(*labels)[next[char_class]];
+    if (!ranges.empty() && ranges.back().target == target) {
+      ranges.back().to = to;
+    } else {
+      ranges.push_back(DispatchRange{from, to, target});
+    }
+  }
+  EmitRangeDispatch(masm, ranges.data(), ranges.data() + ranges.size());
+}
+
+void DfaCodeGenerator::EmitRangeDispatch(RegExpMacroAssembler* masm,
+                                         const DispatchRange* begin,
+                                         const DispatchRange* end) {
+  DCHECK_LT(begin, end);
+  if (end - begin > kMaxLinearDispatchRanges) {
+    const DispatchRange* middle = begin + (end - begin) / 2;
+    Label lower;
+    masm->CheckCharacterLT(middle->from, &lower);
+    EmitRangeDispatch(masm, middle, end);
+    masm->Bind(&lower);
+    EmitRangeDispatch(masm, begin, middle);
+    return;
+  }
+
+  // The most common target is jumped to if no other range matches.
+  Label* default_target = begin->target;
+  int default_count = 0;
+  for (const DispatchRange* range = begin; range != end; ++range) {
+    const int count = static_cast<int>(
+        std::count_if(begin, end, [=](const DispatchRange& other) {
+          return other.target == range->target;
+        }));
+    if (count > default_count) {
+      default_target = range->target;
+      default_count = count;
+    }
+  }
+  for (const DispatchRange* range = begin; range != end; ++range) {
+    if (range->target == default_target) continue;
+    if (range->from == range->to) {
+      masm->CheckCharacter(range->from, range->target);
+    } else {
+      masm->CheckCharacterInRange(range->from, range->to, range->target);
+    }
+  }
+  masm->GoTo(default_target);
+}
+
+Handle<Code> DfaCodeGenerator::Generate(
+    Handle<String> source, NativeRegExpMacroAssembler::Mode mode) {
+  std::unique_ptr<RegExpMacroAssembler> masm(NewMacroAssembler(mode));
+  // The code restarts after each match until the output registers are full.
+  masm->set_global_mode(RegExpMacroAssembler::GLOBAL);
+  const uc16 max_char = mode == NativeRegExpMacroAssembler::LATIN1
+                            ? String::kMaxOneByteCharCode
+                            : String::kMaxUtf16CodeUnit;
+
+  std::vector<Label> forward_labels(forward_states_.size());
+  std::vector<Label> backward_labels(backward_states_.size());
+  Label forward_done, backward_done, empty_input, empty_match, fail;
+
+  masm->WriteCurrentPositionToRegister(kSearchStartRegister, 0);
+  masm->SetRegister(kHasMatchRegister, 0);
+  masm->SetRegister(kTicksRegister, 0);
+  masm->CheckPosition(0, &empty_input);
+  if (forward_start_[true] != forward_start_[false]) {
+    masm->CheckAtStart(0, &forward_labels[forward_start_[true]]);
+  }
+  masm->GoTo(&forward_labels[forward_start_[false]]);
+
+  // Find the end of the match by running the LazyDfa forwards, as in the
+  // NfaInterpreter's FindNextMatchEnd.  The last match end is recorded.
+  for (size_t i = 0; i < forward_states_.size(); ++i) {
+    const ForwardState& state = forward_states_[i];
+    masm->Bind(&forward_labels[i]);
+    if (state.is_match) {
+      masm->WriteCurrentPositionToRegister(kMatchEndRegister, 0);
+      masm->SetRegister(kHasMatchRegister, 1);
+    }
+    if (state.is_final) {
+      masm->GoTo(&forward_done);
+      continue;
+    }
+    EmitInterruptCheck(masm.get());
+    Label at_end;
+    masm->LoadCurrentCharacter(0,
+                               state.accepts_at_end ? &at_end : &forward_done);
+    masm->AdvanceCurrentPosition(1);
+    EmitDispatch(masm.get(), max_char, state.next, &forward_labels,
+                 &forward_done);
+    if (state.accepts_at_end) {
+      masm->Bind(&at_end);
+      masm->WriteCurrentPositionToRegister(kMatchEndRegister, 0);
+      masm->SetRegister(kHasMatchRegister, 1);
+      masm->GoTo(&forward_done);
+    }
+  }
+
+  masm->Bind(&forward_done);
+  masm->IfRegisterLT(kHasMatchRegister, 1, &fail);
+  masm->ReadCurrentPositionFromRegister(kMatchEndRegister);
+  if (backward_start_[true] != backward_start_[false]) {
+    masm->CheckPosition(0, &backward_labels[backward_start_[true]]);
+  }
+  masm->GoTo(&backward_labels[backward_start_[false]]);
+
+  // Find the beginning of the match by going backwards from its end, as in
+  // the NfaInterpreter's FindMatchBegin.  The last match begin is recorded,
+  // and the search start is never passed.
+  for (size_t i = 0; i < backward_states_.size(); ++i) {
+    const BackwardState& state = backward_states_[i];
+    masm->Bind(&backward_labels[i]);
+    if (state.is_begin) {
+      masm->WriteCurrentPositionToRegister(kMatchBeginRegister, 0);
+    }
+    Label at_search_start;
+    const bool begins_only_at_start =
+        state.is_begin_at_start && !state.is_begin;
+    masm->IfRegisterEqPos(
+        kSearchStartRegister,
+        begins_only_at_start ? &at_search_start : &backward_done);
+    EmitInterruptCheck(masm.get());
+    // The search start is before the current position, so there is a
+    // character to load.
+    masm->LoadCurrentCharacter(-1, nullptr, false);
+    masm->AdvanceCurrentPosition(-1);
+    EmitDispatch(masm.get(), max_char, state.next, &backward_labels,
+                 &backward_done);
+    if (begins_only_at_start) {
+      masm->Bind(&at_search_start);
+      masm->CheckNotAtStart(0, &backward_done);
+      masm->WriteCurrentPositionToRegister(kMatchBeginRegister, 0);
+      masm->GoTo(&backward_done);
+    }
+  }
+
+  masm->Bind(&backward_done);
+  // The search continues at the end of the match.
+  masm->ReadCurrentPositionFromRegister(kMatchEndRegister);
+  masm->Succeed();
+
+  // The search starts at the end of the input, where only an empty match
+  // can be found.
+  masm->Bind(&empty_input);
+  if (empty_match_at_end_[true] != empty_match_at_end_[false]) {
+    masm->CheckAtStart(0, empty_match_at_end_[true] ? &empty_match : &fail);
+  }
+  masm->GoTo(empty_match_at_end_[false] ? &empty_match : &fail);
+  masm->Bind(&empty_match);
+  masm->WriteCurrentPositionToRegister(kMatchBeginRegister, 0);
+  masm->WriteCurrentPositionToRegister(kMatchEndRegister, 0);
+  masm->Succeed();
+
+  masm->Bind(&fail);
+  masm->Fail();
+
+  Handle<Code> code = Handle<Code>::cast(masm->GetCode(source));
+  isolate_->IncreaseTotalRegexpCodeGenerated(code);
+  return code;
+}
+
+}  // namespace
+
+// static
+bool ExperimentalRegExpDfaCompiler::Compile(Isolate* isolate,
+                                            Handle<String> source,
+                                            Handle<ByteArray> bytecode,
+                                            Handle<Code>* latin1_code,
+                                            Handle<Code>* uc16_code) {
+  DCHECK(!FLAG_jitless);
+  Zone zone(isolate->allocator(), ZONE_NAME);
+
+  // Code generation allocates on the heap, which can move the bytecode.
+  const int length =
+      bytecode->length() / static_cast<int>(sizeof(RegExpInstruction));
+  RegExpInstruction* instructions = zone.NewArray<RegExpInstruction>(length);
+  MemCopy(instructions, bytecode->GetDataStartAddress(),
+          length * sizeof(RegExpInstruction));
+  Vector<const RegExpInstruction> instruction_vector(instructions, length);
+  if (!LazyDfa::CanRun(instruction_vector)) return false;
+
+  DfaCodeGenerator generator(isolate, &zone, instruction_vector);
+  if (!generator.ComputeAutomata()) return false;
+
+  *latin1_code = generator.Generate(source, NativeRegExpMacroAssembler::LATIN1);
+  *uc16_code = generator.Generate(source, NativeRegExpMacroAssembler::UC16);
+  return true;
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,43 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_REGEXP_EXPERIMENTAL_EXPERIMENTAL_DFA_COMPILER_H_
+#define V8_REGEXP_EXPERIMENTAL_EXPERIMENTAL_DFA_COMPILER_H_
+
+#include "src/handles/handles.h"
+#include "src/utils/allocation.h"
+
+namespace v8 {
+namespace internal {
+
+class ByteArray;
+class Code;
+class Isolate;
+class String;
+
+// Compiles experimental regexp bytecode to native code through the irregexp
+// macro assemblers.  The code runs the LazyDfa of the bytecode to find the
+// end of the next match, and then an automaton on the reversed input to find
+// its beginning, which is what the NfaInterpreter does on the LazyDfa.  Both
+// automata are computed completely at compile time.  The code doesn't track
+// capture groups, so it is only used for regexps without them.
+//
+// The generated code follows the calling convention of irregexp code in
+// global mode, so it is installed in the code slots of the regexp and called
+// like compiled irregexp code, both from the RegExpExecInternal builtin and
+// from the runtime.
+class ExperimentalRegExpDfaCompiler final : public AllStatic {
+ public:
+  // Returns false if the bytecode can't be run on the LazyDfa or if one of
+  // the automata has more than
+  // --experimental-regexp-engine-max-native-dfa-states states.
+  static bool Compile(Isolate* isolate, Handle<String> source,
+                      Handle<ByteArray> bytecode, Handle<Code>* latin1_code,
+                      Handle<Code>* uc16_code);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_REGEXP_EXPERIMENTAL_EXPERIMENTAL_DFA_COMPILER_H_
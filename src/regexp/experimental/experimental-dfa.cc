@@ -0,0 +1,255 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/regexp/experimental/experimental-dfa.h"
+
+#include "src/base/functional.h"
+#include "src/flags/flags.h"
+#include "src/utils/ostreams.h"
+#include "src/zone/zone-list-inl.h"
+
+namespace v8 {
+namespace internal {
+
+// static
+bool LazyDfa::CanRun(Vector<const RegExpInstruction> bytecode) {
+  for (RegExpInstruction inst : bytecode) {
+    if (inst.opcode == RegExpInstruction::READ_LOOKAROUND_TABLE ||
+        inst.opcode == RegExpInstruction::CONSUME_BACK_REFERENCE) {
+      return false;
+    }
+    if (inst.opcode == RegExpInstruction::ASSERTION &&
+        inst.payload.assertion_type != RegExpAssertion::START_OF_INPUT &&
+        inst.payload.assertion_type != RegExpAssertion::END_OF_INPUT) {
+      return false;
+    }
+  }
+  return true;
+}
+
+LazyDfa::LazyDfa(Vector<const RegExpInstruction> bytecode,
+                 AccountingAllocator* allocator)
+    : cache_zone_(allocator, ZONE_NAME),
+      zone_(allocator, ZONE_NAME),
+      class_starts_(&zone_),
+      one_byte_classes_(zone_.NewArray<int>(kOneByteClassCount),
+                        kOneByteClassCount),
+      pc_epoch_(zone_.NewArray<int>(bytecode.length()), bytecode.length()),
+      pending_(0, &zone_),
+      blocked_(0, &zone_) {
+  DCHECK(CanRun(bytecode));
+  std::fill(pc_epoch_.begin(), pc_epoch_.end(), -1);
+  ComputeCharacterClasses(bytecode);
+  states_.emplace(&cache_zone_);
+}
+
+LazyDfa::State* LazyDfa::StartState(bool at_start) {
+  if (start_states_[at_start] != nullptr) return start_states_[at_start];
+
+  NewEpoch();
+  const bool is_match = AddThreadClosure(0, at_start, false);
+  State* state = LookupState(is_match);
+  if (state == nullptr) {
+    if (IsCacheFull()) ResetCache();
+    state = NewState(is_match);
+  }
+  start_states_[at_start] = state;
+  return state;
+}
+
+bool LazyDfa::AcceptsAtEnd(State* state, bool at_start) {
+  NewEpoch();
+  for (int pc : state->pcs) {
+    if (Instruction(pc).opcode == RegExpInstruction::ASSERTION &&
+        AddThreadClosure(pc + 1, at_start, true)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LazyDfa::ComputeAllStates(size_t max_state_count,
+                               ZoneVector<State*>* states) {
+  // A new state is added to `states_` exactly when it is computed first.
+  DCHECK(states_->empty());
+  DCHECK(states->empty());
+  for (bool at_start : {true, false}) {
+    State* state = StartState(at_start);
+    if (states_->size() > states->size()) states->push_back(state);
+  }
+  for (size_t i = 0; i < states->size(); ++i) {
+    State* state = (*states)[i];
+    for (int char_class = 0; char_class < class_count(); ++char_class) {
+      if (states->size() > max_state_count || IsCacheFull()) return false;
+      // The cache isn't reset, because it is not full.
+      State* next = ComputeNext(state, char_class);
+      DCHECK_EQ(next, state->next[char_class]);
+      if (states_->size() > states->size()) states->push_back(next);
+    }
+  }
+  return states->size() <= max_state_count;
+}
+
+size_t LazyDfa::StateHash::operator()(const State* state) const {
+  return base::hash_combine(
+      base::hash_range(state->pcs.begin(), state->pcs.end()), state->is_match);
+}
+
+// Splits the characters into classes such that every CONSUME_RANGE
+// instruction either consumes all or none of the characters of a class.
+void LazyDfa::ComputeCharacterClasses(
+    Vector<const RegExpInstruction> bytecode) {
+  class_starts_.push_back(0);
+  for (RegExpInstruction inst : bytecode) {
+    if (inst.opcode != RegExpInstruction::CONSUME_RANGE) continue;
+    RegExpInstruction::Uc16Range range = inst.payload.consume_range;
+    // The empty range is used to encode failure.
+    if (range.min > range.max) continue;
+    class_starts_.push_back(range.min);
+    if (range.max != String::kMaxUtf16CodeUnit) {
+      class_starts_.push_back(range.max + 1);
+    }
+  }
+  std::sort(class_starts_.begin(), class_starts_.end());
+  class_starts_.erase(std::unique(class_starts_.begin(), class_starts_.end()),
+                      class_starts_.end());
+
+  int char_class = 0;
+  for (int c = 0; c < kOneByteClassCount; ++c) {
+    if (char_class + 1 < static_cast<int>(class_starts_.size()) &&
+        class_starts_[char_class + 1] == c) {
+      ++char_class;
+    }
+    one_byte_classes_[c] = char_class;
+  }
+}
+
+LazyDfa::State* LazyDfa::ComputeNext(State* state, int char_class) {
+  // All characters of a class behave the same, so we can compute the
+  // transition for the first one.
+  const uc16 input_char = class_starts_[char_class];
+  NewEpoch();
+  bool is_match = false;
+  for (int pc : state->pcs) {
+    RegExpInstruction inst = Instruction(pc);
+    if (inst.opcode != RegExpInstruction::CONSUME_RANGE) {
+      // END_OF_INPUT doesn't hold if there is more input.
+      DCHECK_EQ(inst.opcode, RegExpInstruction::ASSERTION);
+      continue;
+    }
+    RegExpInstruction::Uc16Range range = inst.payload.consume_range;
+    if (input_char < range.min || input_char > range.max) continue;
+    if (AddThreadClosure(pc + 1, false, false)) {
+      // Threads with lower priority are discarded.
+      is_match = true;
+      break;
+    }
+  }
+
+  State* next = LookupState(is_match);
+  if (next == nullptr) {
+    if (IsCacheFull()) {
+      if (steps_since_reset_ < kMinStepsPerState * states_->size()) {
+        if (FLAG_trace_experimental_regexp_engine) {
+          StdoutStream{} << "Lazy DFA gave up after " << cache_resets_
+                         << " cache resets" << std::endl;
+        }
+        // Later searches may be on input that suits the automaton better.
+        ResetCache();
+        return nullptr;
+      }
+      // `state` is discarded, so we can't record the transition.
+      ResetCache();
+      return NewState(is_match);
+    }
+    next = NewState(is_match);
+  }
+  state->next[char_class] = next;
+  return next;
+}
+
+bool LazyDfa::AddThreadClosure(int pc, bool at_start, bool at_end) {
+  DCHECK(pending_.is_empty());
+  pending_.Add(pc, &zone_);
+  while (!pending_.is_empty()) {
+    pc = pending_.RemoveLast();
+    while (pc_epoch_[pc] != epoch_) {
+      pc_epoch_[pc] = epoch_;
+      RegExpInstruction inst = Instruction(pc);
+      if (inst.opcode == RegExpInstruction::CONSUME_RANGE) {
+        if (!at_end) blocked_.Add(pc, &zone_);
+        break;
+      } else if (inst.opcode == RegExpInstruction::ASSERTION) {
+        if (inst.payload.assertion_type == RegExpAssertion::START_OF_INPUT) {
+          if (!at_start) break;
+        } else {
+          DCHECK_EQ(inst.payload.assertion_type,
+                    RegExpAssertion::END_OF_INPUT);
+          if (!at_end) {
+            blocked_.Add(pc, &zone_);
+            break;
+          }
+        }
+        ++pc;
+      } else if (inst.opcode == RegExpInstruction::FORK) {
+        pending_.Add(inst.payload.pc, &zone_);
+        ++pc;
+      } else if (inst.opcode == RegExpInstruction::JMP) {
+        pc = inst.payload.pc;
+      } else if (inst.opcode == RegExpInstruction::ACCEPT) {
+        pending_.Rewind(0);
+        return true;
+      } else {
+        DCHECK(inst.opcode == RegExpInstruction::SET_REGISTER_TO_CP ||
+               inst.opcode == RegExpInstruction::CLEAR_REGISTER);
+        ++pc;
+      }
+    }
+  }
+  return false;
+}
+
+void LazyDfa::NewEpoch() {
+  // The automaton outlives searches, so the epoch can wrap around.
+  if (epoch_ == kMaxInt) {
+    std::fill(pc_epoch_.begin(), pc_epoch_.end(), -1);
+    epoch_ = 0;
+  }
+  ++epoch_;
+  blocked_.Rewind(0);
+}
+
+LazyDfa::State* LazyDfa::LookupState(bool is_match) {
+  State key{blocked_.ToConstVector(), is_match, nullptr};
+  auto it = states_->find(&key);
+  return it == states_->end() ? nullptr : *it;
+}
+
+LazyDfa::State* LazyDfa::NewState(bool is_match) {
+  int* pcs = cache_zone_.NewArray<int>(blocked_.length());
+  std::copy(blocked_.begin(), blocked_.end(), pcs);
+  State** next = cache_zone_.NewArray<State*>(class_starts_.size());
+  std::fill(next, next + class_starts_.size(), nullptr);
+  State* state = cache_zone_.New<State>(
+      State{Vector<const int>(pcs, blocked_.length()), is_match, next});
+  states_->insert(state);
+  return state;
+}
+
+bool LazyDfa::IsCacheFull() const {
+  return cache_zone_.allocation_size() >=
+         FLAG_experimental_regexp_engine_dfa_cache_size * KB;
+}
+
+void LazyDfa::ResetCache() {
+  states_.reset();
+  cache_zone_.ReleaseMemory();
+  states_.emplace(&cache_zone_);
+  start_states_[false] = start_states_[true] = nullptr;
+  steps_since_reset_ = 0;
+  ++cache_resets_;
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,213 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_REGEXP_EXPERIMENTAL_EXPERIMENTAL_DFA_H_
+#define V8_REGEXP_EXPERIMENTAL_EXPERIMENTAL_DFA_H_
+
+#include <algorithm>
+
+#include "src/base/optional.h"
+#include "src/objects/string.h"
+#include "src/regexp/experimental/experimental-bytecode.h"
+#include "src/utils/vector.h"
+#include "src/zone/zone-containers.h"
+#include "src/zone/zone-list.h"
+#include "src/zone/zone.h"
+
+namespace v8 {
+namespace internal {
+
+class AccountingAllocator;
+
+// A deterministic finite automaton (dfa) that is constructed lazily from the
+// bytecode while it is run on the input, i.e. only the states and transitions
+// that are actually needed are computed.  The automaton does not track
+// registers, so it can only tell whether and where the next match ends.  It
+// is used by the NfaInterpreter to skip over input quickly, and compiled to
+// native code by the ExperimentalRegExpDfaCompiler.
+//
+// A state of the automaton is the list of pcs that the threads of the
+// NfaInterpreter are blocked on after consuming some input, sorted by
+// priority, together with whether a thread ACCEPTed at that point.  Apart
+// from registers this is all the state the NfaInterpreter keeps between two
+// input characters, and the successor list is computed exactly like the
+// NfaInterpreter does, including the removal of redundant threads and of
+// threads with lower priority than an ACCEPTing thread.  Thus the automaton
+// reports a match at the same position as the NfaInterpreter.
+//
+// Assertions depend on the input position and can't be evaluated when a
+// state is computed in general.  START_OF_INPUT only holds before any input
+// has been consumed and is resolved when the start state is computed.
+// END_OF_INPUT is treated like a blocked thread that is discarded on the next
+// input character and resumed once the input is exhausted.  Bytecode with
+// other assertions or with lookarounds is not run on the automaton.
+//
+// The memory used for states is bounded by
+// --experimental-regexp-engine-dfa-cache-size.  If the budget is exhausted,
+// all states are discarded and construction starts over.  If this happens
+// too often, the automaton gives up and the caller should continue on the
+// NfaInterpreter.
+//
+// The automaton only depends on the bytecode, so it is kept in the isolate's
+// ExperimentalRegExpDfaCache and its states are reused by later searches with
+// the same bytecode.  A search acquires the automaton for its duration.
+class LazyDfa {
+ public:
+  struct State {
+    // The pcs of the CONSUME_RANGE and END_OF_INPUT instructions that threads
+    // are blocked on, sorted from high to low priority.
+    Vector<const int> pcs;
+    // Whether a thread ACCEPTed when this state was entered.
+    bool is_match;
+    // Successor states by character class, nullptr if not computed yet.
+    State** next;
+  };
+
+  // Returns whether `bytecode` only contains assertions that the automaton
+  // can handle, and neither lookarounds nor back references.
+  static bool CanRun(Vector<const RegExpInstruction> bytecode);
+
+  LazyDfa(Vector<const RegExpInstruction> bytecode,
+          AccountingAllocator* allocator);
+  LazyDfa(const LazyDfa&) = delete;
+  LazyDfa& operator=(const LazyDfa&) = delete;
+
+  bool in_use() const { return bytecode_ != nullptr; }
+
+  // Starts a search on `bytecode`, which must be equal to the bytecode the
+  // automaton was built for.  `bytecode` is referenced and not copied,
+  // because its backing store can move during garbage collection.
+  void Acquire(const Vector<const RegExpInstruction>* bytecode) {
+    DCHECK(!in_use());
+    DCHECK_EQ(bytecode->length(), pc_epoch_.length());
+    bytecode_ = bytecode;
+  }
+
+  // Ends the search, after which the automaton can be acquired again.
+  void Release() {
+    DCHECK(in_use());
+    bytecode_ = nullptr;
+  }
+
+  // Returns the state before any input is consumed.  `at_start` is whether
+  // the search starts at the beginning of the input.
+  State* StartState(bool at_start);
+
+  // Returns the successor of `state` after consuming `input_char`, or nullptr
+  // if the automaton gave up because the cache had to be reset too often.
+  V8_INLINE State* Next(State* state, uc16 input_char) {
+    ++steps_since_reset_;
+    const int char_class = CharacterClass(input_char);
+    State* next = state->next[char_class];
+    if (next != nullptr) return next;
+    return ComputeNext(state, char_class);
+  }
+
+  // Returns whether a thread of `state` ACCEPTs if the input ends after the
+  // characters consumed to reach `state`.  `at_start` is whether no input
+  // was consumed at all.
+  bool AcceptsAtEnd(State* state, bool at_start);
+
+  // Computes the start states, all states reachable from them and all their
+  // transitions, and appends the states to `states`, the start states first.
+  // Returns false, in which case the automaton should not be used any more,
+  // if there are more than `max_state_count` states or they don't fit into
+  // the memory budget.
+  bool ComputeAllStates(size_t max_state_count, ZoneVector<State*>* states);
+
+  // The input characters are split into classes such that every
+  // CONSUME_RANGE instruction either consumes all or none of the characters
+  // of a class.  Class `i` consists of the characters from ClassStart(i) to
+  // ClassStart(i + 1) - 1, the last one extends to the largest code unit.
+  int class_count() const { return static_cast<int>(class_starts_.size()); }
+  uc16 ClassStart(int char_class) const {
+    return static_cast<uc16>(class_starts_[char_class]);
+  }
+
+ private:
+  // If the cache is reset before this many characters per state have been
+  // consumed, the automaton is not worth its construction cost.
+  static constexpr size_t kMinStepsPerState = 10;
+  static constexpr int kOneByteClassCount = String::kMaxOneByteCharCode + 1;
+
+  struct StateHash {
+    size_t operator()(const State* state) const;
+  };
+
+  struct StateEqual {
+    bool operator()(const State* lhs, const State* rhs) const {
+      return lhs->is_match == rhs->is_match && lhs->pcs == rhs->pcs;
+    }
+  };
+
+  // Transitions are computed per class instead of per character.
+  void ComputeCharacterClasses(Vector<const RegExpInstruction> bytecode);
+
+  V8_INLINE int CharacterClass(uc16 c) const {
+    if (c < kOneByteClassCount) return one_byte_classes_[c];
+    return static_cast<int>(std::upper_bound(class_starts_.begin(),
+                                             class_starts_.end(), c) -
+                            class_starts_.begin()) -
+           1;
+  }
+
+  State* ComputeNext(State* state, int char_class);
+
+  // Runs a thread starting at `pc` until it blocks, and appends the pcs it
+  // blocks on to `blocked_`, in the same order in which the NfaInterpreter
+  // adds them to its blocked threads.  Pcs that were already visited in the
+  // current epoch are skipped.  Returns whether a thread ACCEPTed, in which
+  // case the remaining threads are discarded.
+  bool AddThreadClosure(int pc, bool at_start, bool at_end);
+
+  // Starts the computation of a new set of blocked threads.
+  void NewEpoch();
+
+  // Returns the cached state for `blocked_` and `is_match` if there is one.
+  State* LookupState(bool is_match);
+
+  // Adds a state for `blocked_` and `is_match` to the cache.
+  State* NewState(bool is_match);
+
+  bool IsCacheFull() const;
+  void ResetCache();
+
+  RegExpInstruction Instruction(int pc) const {
+    DCHECK(in_use());
+    return (*bytecode_)[pc];
+  }
+
+  // The bytecode of the current search, nullptr if there is none.
+  const Vector<const RegExpInstruction>* bytecode_ = nullptr;
+
+  // All states and their transitions are allocated in `cache_zone_`.
+  Zone cache_zone_;
+  base::Optional<ZoneUnorderedSet<State*, StateHash, StateEqual>> states_;
+  State* start_states_[2] = {nullptr, nullptr};
+  size_t steps_since_reset_ = 0;
+  int cache_resets_ = 0;
+
+  // Everything else is allocated in `zone_`.
+  Zone zone_;
+
+  // The sorted first characters of the character classes.
+  ZoneVector<int> class_starts_;
+  // The character class of every one-byte character.
+  Vector<int> one_byte_classes_;
+
+  // pc_epoch_[pc] == epoch_ iff pc was visited during the computation of the
+  // current set of blocked threads.
+  Vector<int> pc_epoch_;
+  int epoch_ = 0;
+
+  // Pcs of forked threads that still need to run.
+  ZoneList<int> pending_;
+  // The pcs of blocked threads, sorted from high to low priority.
+  ZoneList<int> blocked_;
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_REGEXP_EXPERIMENTAL_EXPERIMENTAL_DFA_H_
@@ -4,13 +4,20 @@
 
 #include "src/regexp/experimental/experimental-interpreter.h"
 
+#include "src/base/bits.h"
+#include "src/base/functional.h"
 #include "src/base/optional.h"
 #include "src/common/assert-scope.h"
+#include "src/execution/isolate.h"
+#include "src/flags/flags.h"
 #include "src/objects/fixed-array-inl.h"
 #include "src/objects/string-inl.h"
+#include "src/regexp/experimental/experimental-dfa.h"
 #include "src/regexp/experimental/experimental.h"
+#include "src/regexp/regexp-prefilter.h"
 #include "src/strings/char-predicates-inl.h"
 #include "src/zone/zone-allocator.h"
+#include "src/zone/zone-containers.h"
 #include "src/zone/zone-list-inl.h"
 
 namespace v8 {
@@ -133,14 +140,42 @@ class NfaInterpreter {
   // the search continues with the threads with higher priority.  If no threads
   // with high priority are left, we return the match that was produced by the
   // ACCEPTing thread with highest priority.
+  //
+  // Maintaining registers for every thread is expensive, so if possible the
+  // end of the next match is found by a LazyDfa first.  The beginning of the
+  // match is then the first position from which the part of the bytecode
+  // after the /.*?/ preamble matches up to the match end, which is found by
+  // running the bytecode backwards from the match end without priorities.
+  // Threads with registers are only run if there are capture groups, and
+  // only from the beginning of the match.
+  //
+  // Whether a lookaround holds at an input position is looked up in a table
+  // with an entry per input position.  The tables are filled before the
+  // search by running the automata of the lookarounds over the whole input,
+  // see the definition of START_LOOKAROUND.  This takes time linear in the
+  // length of the input per lookaround, and a bit of memory per lookaround and
+  // input position.  The tables are kept in the isolate's
+  // ExperimentalRegExpLookaroundCache, so that further searches in the same
+  // input, e.g. from an exec loop, don't fill them again.
+  //
+  // Threads that run into a back reference consume the captured substring
+  // one character per input position.  Since threads at the same pc may have
+  // captured different substrings, they are only discarded as redundant if
+  // they agree on the captures of all back references as well, see
+  // `IsStateProcessed`.  The number of such states per input position is
+  // bounded by --experimental-regexp-engine-backreference-memo-size, which
+  // keeps the search linear in the length of the input.  If a search needs
+  // more, it gives up and the caller runs the regexp on irregexp instead.
  public:
   NfaInterpreter(Isolate* isolate, RegExp::CallOrigin call_origin,
-                 ByteArray bytecode, int register_count_per_match, String input,
+                 ByteArray bytecode, Object prefilter,
+                 int register_count_per_match, String input,
                  int32_t input_index, Zone* zone)
       : isolate_(isolate),
         call_origin_(call_origin),
         bytecode_object_(bytecode),
         bytecode_(ToInstructionVector(bytecode, no_gc_)),
+        prefilter_object_(prefilter),
         register_count_per_match_(register_count_per_match),
         input_object_(input),
         input_(ToCharacterVector<Character>(input, no_gc_)),
@@ -151,12 +186,53 @@ class NfaInterpreter {
         blocked_threads_(0, zone),
         register_array_allocator_(zone),
         best_match_registers_(base::nullopt),
+        match_begin_pc_(FindMatchBeginPc(bytecode_)),
+        predecessor_offsets_(zone),
+        predecessors_(zone),
+        consume_range_pcs_(zone),
+        pc_live_input_index_(zone),
+        live_pcs_(0, zone),
+        lookaround_start_pcs_(zone),
+        lookaround_pending_pcs_(0, zone),
+        lookaround_blocked_pcs_(0, zone),
+        lookaround_next_blocked_pcs_(0, zone),
+        back_reference_registers_(zone),
+        memo_input_index_(zone),
+        memo_keys_(zone),
+        memo_key_(zone),
         zone_(zone) {
     DCHECK(!bytecode_.empty());
     DCHECK_GE(input_index_, 0);
     DCHECK_LE(input_index_, input_.length());
 
     std::fill(pc_last_input_index_.begin(), pc_last_input_index_.end(), -1);
+
+    for (int pc = 0; pc != bytecode_.length(); ++pc) {
+      if (bytecode_[pc].opcode == RegExpInstruction::START_LOOKAROUND) {
+        DCHECK_EQ(static_cast<int>(bytecode_[pc].payload.lookaround.index),
+                  static_cast<int>(lookaround_start_pcs_.size()));
+        lookaround_start_pcs_.push_back(pc);
+      } else if (bytecode_[pc].opcode ==
+                     RegExpInstruction::CONSUME_BACK_REFERENCE &&
+                 std::find(back_reference_registers_.begin(),
+                           back_reference_registers_.end(),
+                           bytecode_[pc].payload.register_index) ==
+                     back_reference_registers_.end()) {
+        back_reference_registers_.push_back(
+            bytecode_[pc].payload.register_index);
+      }
+    }
+
+    if (FLAG_experimental_regexp_engine_lazy_dfa &&
+        LazyDfa::CanRun(bytecode_)) {
+      dfa_ = isolate->experimental_regexp_dfa_cache()->Lookup(
+          bytecode_, isolate->allocator());
+      dfa_->Acquire(&bytecode_);
+    }
+  }
+
+  ~NfaInterpreter() {
+    if (dfa_ != nullptr) dfa_->Release();
   }
 
   // Finds matches and writes their concatenated capture registers to
@@ -167,6 +243,11 @@ class NfaInterpreter {
   int FindMatches(int32_t* output_registers, int output_register_count) {
     const int max_match_num = output_register_count / register_count_per_match_;
 
+    if (!lookaround_start_pcs_.empty()) {
+      int err_code = ComputeLookaroundTables();
+      if (err_code != RegExp::kInternalRegExpSuccess) return err_code;
+    }
+
     int match_num = 0;
     while (match_num != max_match_num) {
       int err_code = FindNextMatch();
@@ -216,6 +297,9 @@ class NfaInterpreter {
     // `register_count_per_match_`.  Should be deallocated with
     // `register_array_allocator_`.
     int* register_array_begin;
+    // The number of characters of the capture that this thread has consumed
+    // if it is at a CONSUME_BACK_REFERENCE instruction, and 0 otherwise.
+    int back_reference_offset = 0;
   };
 
   // Handles pending interrupts if there are any.  Returns
@@ -239,6 +323,7 @@ class NfaInterpreter {
       HandleScope handles(isolate_);
       Handle<ByteArray> bytecode_handle(bytecode_object_, isolate_);
       Handle<String> input_handle(input_object_, isolate_);
+      Handle<Object> prefilter_handle(prefilter_object_, isolate_);
 
       if (check.JsHasOverflowed()) {
         // We abort the interpreter now anyway, so gc can't invalidate any
@@ -276,6 +361,7 @@ class NfaInterpreter {
         bytecode_ = ToInstructionVector(bytecode_object_, no_gc_);
         input_object_ = *input_handle;
         input_ = ToCharacterVector<Character>(input_object_, no_gc_);
+        prefilter_object_ = *prefilter_handle;
       }
     }
     return RegExp::kInternalRegExpSuccess;
@@ -295,22 +381,354 @@ class NfaInterpreter {
   // execution could finish regularly (with or without a match) and an error
   // code due to interrupt otherwise.
   int FindNextMatch() {
-    DCHECK(active_threads_.is_empty());
-    // TODO(mbid,v8:10765): Can we get around resetting `pc_last_input_index_`
-    // here? As long as
-    //
-    //   pc_last_input_index_[pc] < input_index_
-    //
-    // for all possible program counters pc that are reachable without input
-    // from pc = 0 and
-    //
-    //   pc_last_input_index_[k] <= input_index_
-    //
-    // for all k > 0 hold I think everything should be fine.  Maybe we can do
-    // something about this in `SetInputIndex`.
+    if (prefilter_object_.IsByteArray()) {
+      // Matches can only start where one of the leading literals occurs.
+      int candidate = RegExpPrefilter::FindCandidate(
+          ByteArray::cast(prefilter_object_), input_, input_index_);
+      if (candidate == -1) {
+        DiscardThreadsAndMatch();
+        return RegExp::kInternalRegExpSuccess;
+      }
+      SetInputIndex(candidate);
+    }
+
+    if (dfa_ == nullptr) return RunThreads(0);
+
+    int match_end;
+    int err_code = FindNextMatchEnd(&match_end);
+    if (err_code != RegExp::kInternalRegExpSuccess) return err_code;
+    if (dfa_ == nullptr) {
+      // The automaton gave up, so we search the same range with threads.
+      return RunThreads(0);
+    }
+
+    if (match_end == -1) {
+      DiscardThreadsAndMatch();
+      return RegExp::kInternalRegExpSuccess;
+    }
+
+    int match_begin;
+    err_code = FindMatchBegin(match_end, &match_begin);
+    if (err_code != RegExp::kInternalRegExpSuccess) return err_code;
+
+    if (register_count_per_match_ == JSRegExp::RegistersForCaptureCount(0)) {
+      // There are no capture groups, so the match boundaries are all we need.
+      DiscardThreadsAndMatch();
+      int* registers = NewRegisterArrayUninitialized();
+      registers[0] = match_begin;
+      registers[1] = match_end;
+      best_match_registers_ = Vector<int>(registers, register_count_per_match_);
+      return RegExp::kInternalRegExpSuccess;
+    }
+
+    // Threads starting at `match_begin` after the preamble find the same
+    // match as threads starting at the current input index, because
+    // threads that start earlier don't match.
+    SetInputIndex(match_begin);
+    err_code = RunThreads(match_begin_pc_);
+    if (err_code != RegExp::kInternalRegExpSuccess) return err_code;
+    DCHECK(FoundMatch());
+    DCHECK_EQ((*best_match_registers_)[0], match_begin);
+    DCHECK_EQ((*best_match_registers_)[1], match_end);
+    return RegExp::kInternalRegExpSuccess;
+  }
+
+  // Runs the LazyDfa from the current `input_index_` to find the end of the
+  // next match, which is written to `match_end`, or -1 if there is no match.
+  // Resets `dfa_` if it gave up, in which case `match_end` is undefined.
+  // Returns an error code as `FindNextMatch`.
+  int FindNextMatchEnd(int* match_end) {
+    *match_end = -1;
+    int input_index = input_index_;
+    LazyDfa::State* state = dfa_->StartState(input_index == 0);
+    if (state->is_match) *match_end = input_index;
+
+    // As in `RunThreads`, we stop if the input is exhausted or no threads are
+    // left that could still produce a better match.
+    while (input_index != input_.length() && !state->pcs.empty()) {
+      uc16 input_char = input_[input_index];
+      ++input_index;
+
+      static constexpr int kTicksBetweenInterruptHandling = 64;
+      if (input_index % kTicksBetweenInterruptHandling == 0) {
+        int err_code = HandleInterrupts();
+        if (err_code != RegExp::kInternalRegExpSuccess) return err_code;
+      }
+
+      state = dfa_->Next(state, input_char);
+      if (state == nullptr) {
+        dfa_->Release();
+        dfa_.reset();
+        return RegExp::kInternalRegExpSuccess;
+      }
+      if (state->is_match) *match_end = input_index;
+    }
+
+    if (input_index == input_.length() &&
+        dfa_->AcceptsAtEnd(state, input_index == 0)) {
+      *match_end = input_index;
+    }
+    return RegExp::kInternalRegExpSuccess;
+  }
+
+  // Finds the beginning of the next match given its end, and writes it to
+  // `match_begin`.  This is the smallest input index at least `input_index_`
+  // from which the bytecode after the preamble can reach ACCEPT at
+  // `match_end`.  We compute the set of pcs from which ACCEPT can be reached
+  // for each input index, going backwards from `match_end`.  Returns an error
+  // code as `FindNextMatch`.
+  int FindMatchBegin(int match_end, int* match_begin) {
+    if (predecessor_offsets_.empty()) ComputePredecessors();
+    std::fill(pc_live_input_index_.begin(), pc_live_input_index_.end(), -1);
+
+    *match_begin = -1;
+    DCHECK(live_pcs_.is_empty());
+    for (int pc = match_begin_pc_; pc != bytecode_.length(); ++pc) {
+      if (bytecode_[pc].opcode == RegExpInstruction::ACCEPT) {
+        live_pcs_.Add(pc, zone_);
+      }
+    }
+
+    int input_index = match_end;
+    while (true) {
+      MarkLivePcs(input_index);
+      if (pc_live_input_index_[match_begin_pc_] == input_index) {
+        *match_begin = input_index;
+      }
+      if (input_index == input_index_) break;
+
+      uc16 input_char = input_[input_index - 1];
+      for (int pc : consume_range_pcs_) {
+        RegExpInstruction::Uc16Range range =
+            bytecode_[pc].payload.consume_range;
+        if (input_char >= range.min && input_char <= range.max &&
+            pc_live_input_index_[pc + 1] == input_index) {
+          live_pcs_.Add(pc, zone_);
+        }
+      }
+      if (live_pcs_.is_empty()) break;
+      --input_index;
+
+      static constexpr int kTicksBetweenInterruptHandling = 64;
+      if (input_index % kTicksBetweenInterruptHandling == 0) {
+        int err_code = HandleInterrupts();
+        if (err_code != RegExp::kInternalRegExpSuccess) return err_code;
+      }
+    }
+
+    DCHECK_GE(*match_begin, input_index_);
+    DCHECK_LE(*match_begin, match_end);
+    return RegExp::kInternalRegExpSuccess;
+  }
+
+  // Marks `live_pcs_` and all pcs from which one of them can be reached
+  // without consuming input as live at `input_index`.  Clears `live_pcs_`.
+  void MarkLivePcs(int input_index) {
+    while (!live_pcs_.is_empty()) {
+      int pc = live_pcs_.RemoveLast();
+      if (pc_live_input_index_[pc] == input_index) continue;
+      pc_live_input_index_[pc] = input_index;
+
+      for (int i = predecessor_offsets_[pc]; i != predecessor_offsets_[pc + 1];
+           ++i) {
+        int predecessor = predecessors_[i];
+        RegExpInstruction inst = bytecode_[predecessor];
+        if (inst.opcode == RegExpInstruction::ASSERTION &&
+            !SatisfiesAssertion(inst.payload.assertion_type, input_,
+                                input_index)) {
+          continue;
+        }
+        live_pcs_.Add(predecessor, zone_);
+      }
+    }
+  }
+
+  // Computes for each pc after the preamble the pcs from which it can be
+  // reached without consuming input, as well as the list of CONSUME_RANGE
+  // pcs after the preamble.
+  void ComputePredecessors() {
+    const int length = bytecode_.length();
+    ZoneVector<std::pair<int, int>> edges(zone_);
+    for (int pc = match_begin_pc_; pc != length; ++pc) {
+      RegExpInstruction inst = bytecode_[pc];
+      switch (inst.opcode) {
+        case RegExpInstruction::ACCEPT:
+          break;
+        case RegExpInstruction::CONSUME_RANGE:
+          consume_range_pcs_.push_back(pc);
+          break;
+        case RegExpInstruction::FORK:
+          edges.emplace_back(inst.payload.pc, pc);
+          edges.emplace_back(pc + 1, pc);
+          break;
+        case RegExpInstruction::JMP:
+          edges.emplace_back(inst.payload.pc, pc);
+          break;
+        case RegExpInstruction::ASSERTION:
+        case RegExpInstruction::SET_REGISTER_TO_CP:
+        case RegExpInstruction::CLEAR_REGISTER:
+          edges.emplace_back(pc + 1, pc);
+          break;
+        case RegExpInstruction::READ_LOOKAROUND_TABLE:
+        case RegExpInstruction::START_LOOKAROUND:
+        case RegExpInstruction::WRITE_LOOKAROUND_TABLE:
+        case RegExpInstruction::CONSUME_BACK_REFERENCE:
+          // Bytecode with lookarounds or back references isn't run on the
+          // LazyDfa.
+          UNREACHABLE();
+      }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    predecessor_offsets_.resize(length + 1);
+    predecessors_.reserve(edges.size());
+    size_t i = 0;
+    for (int pc = 0; pc != length; ++pc) {
+      predecessor_offsets_[pc] = static_cast<int>(predecessors_.size());
+      for (; i != edges.size() && edges[i].first == pc; ++i) {
+        DCHECK_GE(pc, match_begin_pc_);
+        predecessors_.push_back(edges[i].second);
+      }
+    }
+    predecessor_offsets_[length] = static_cast<int>(predecessors_.size());
+    pc_live_input_index_.resize(length);
+  }
+
+  // Returns the pc at which threads begin to match after skipping input in
+  // the /.*?/ preamble, i.e. the pc that sets the match begin register.
+  static int FindMatchBeginPc(Vector<const RegExpInstruction> bytecode) {
+    for (int pc = 0; pc != bytecode.length(); ++pc) {
+      RegExpInstruction inst = bytecode[pc];
+      if (inst.opcode == RegExpInstruction::SET_REGISTER_TO_CP &&
+          inst.payload.register_index == 0) {
+        return pc;
+      }
+    }
+    UNREACHABLE();
+  }
+
+  // Fills the lookaround tables, from the highest index down, because the
+  // automaton of a lookaround only reads the tables of lookarounds with a
+  // higher index.  Tables computed for the same bytecode and input before
+  // are reused.  Returns an error code as `FindNextMatch`.
+  int ComputeLookaroundTables() {
+    ExperimentalRegExpLookaroundCache* cache =
+        isolate_->experimental_regexp_lookaround_cache();
+    lookaround_tables_ =
+        cache->Lookup(isolate_->heap(), bytecode_object_, input_object_);
+    if (lookaround_tables_ != nullptr) return RegExp::kInternalRegExpSuccess;
+
+    const int lookaround_count = static_cast<int>(lookaround_start_pcs_.size());
+    lookaround_tables_ = std::make_shared<ExperimentalRegExpLookaroundTables>(
+        lookaround_count, input_.length());
+    for (int index = lookaround_count - 1; index >= 0; --index) {
+      int err_code = RunLookaroundAutomaton(index);
+      if (err_code != RegExp::kInternalRegExpSuccess) return err_code;
+    }
+
+    // Interrupts may have moved the bytecode and the input, so the entry is
+    // keyed by their current addresses.
+    cache->Update(isolate_->heap(), bytecode_object_, input_object_,
+                  lookaround_tables_);
+    return RegExp::kInternalRegExpSuccess;
+  }
+
+  // Runs the automaton of the lookaround with the given index over the whole
+  // input, forwards for lookbehinds and backwards for lookaheads, and
+  // records the input positions at which it reaches WRITE_LOOKAROUND_TABLE.
+  // Returns an error code as `FindNextMatch`.
+  int RunLookaroundAutomaton(int index) {
+    const int start_pc = lookaround_start_pcs_[index];
+    const bool is_ahead = bytecode_[start_pc].payload.lookaround.is_ahead;
+    const int end_position = is_ahead ? 0 : input_.length();
+    int position = is_ahead ? input_.length() : 0;
+
+    // `pc_last_input_index_` is reset before threads are run, so we can use it
+    // to record the position at which a pc was last visited.
     std::fill(pc_last_input_index_.begin(), pc_last_input_index_.end(), -1);
+    ZoneList<int>* blocked_pcs = &lookaround_blocked_pcs_;
+    ZoneList<int>* next_blocked_pcs = &lookaround_next_blocked_pcs_;
+    blocked_pcs->Rewind(0);
+    AddLookaroundThread(start_pc + 1, position, index, blocked_pcs);
 
-    // Clean up left-over data from a previous call to FindNextMatch.
+    int steps = 0;
+    while (position != end_position) {
+      uc16 input_char = is_ahead ? input_[position - 1] : input_[position];
+      position += is_ahead ? -1 : 1;
+
+      static constexpr int kTicksBetweenInterruptHandling = 64;
+      if (++steps % kTicksBetweenInterruptHandling == 0) {
+        int err_code = HandleInterrupts();
+        if (err_code != RegExp::kInternalRegExpSuccess) return err_code;
+      }
+
+      next_blocked_pcs->Rewind(0);
+      for (int pc : *blocked_pcs) {
+        RegExpInstruction::Uc16Range range =
+            bytecode_[pc].payload.consume_range;
+        if (input_char >= range.min && input_char <= range.max) {
+          AddLookaroundThread(pc + 1, position, index, next_blocked_pcs);
+        }
+      }
+      std::swap(blocked_pcs, next_blocked_pcs);
+    }
+    return RegExp::kInternalRegExpSuccess;
+  }
+
+  // Runs the threads of the automaton of the lookaround with the given index
+  // that start at `pc` until they block, and appends the pcs they block on
+  // to `blocked_pcs`.  Pcs that were already visited at `position` are
+  // skipped.
+  void AddLookaroundThread(int pc, int position, int index,
+                           ZoneList<int>* blocked_pcs) {
+    DCHECK(lookaround_pending_pcs_.is_empty());
+    lookaround_pending_pcs_.Add(pc, zone_);
+    while (!lookaround_pending_pcs_.is_empty()) {
+      pc = lookaround_pending_pcs_.RemoveLast();
+      while (pc_last_input_index_[pc] != position) {
+        pc_last_input_index_[pc] = position;
+        RegExpInstruction inst = bytecode_[pc];
+        if (inst.opcode == RegExpInstruction::CONSUME_RANGE) {
+          blocked_pcs->Add(pc, zone_);
+          break;
+        } else if (inst.opcode == RegExpInstruction::ASSERTION) {
+          if (!SatisfiesAssertion(inst.payload.assertion_type, input_,
+                                  position)) {
+            break;
+          }
+          ++pc;
+        } else if (inst.opcode == RegExpInstruction::READ_LOOKAROUND_TABLE) {
+          DCHECK_GT(inst.payload.lookaround.index, index);
+          if (!LookaroundHolds(inst.payload.lookaround, position)) break;
+          ++pc;
+        } else if (inst.opcode == RegExpInstruction::FORK) {
+          lookaround_pending_pcs_.Add(inst.payload.pc, zone_);
+          ++pc;
+        } else if (inst.opcode == RegExpInstruction::JMP) {
+          pc = inst.payload.pc;
+        } else if (inst.opcode == RegExpInstruction::WRITE_LOOKAROUND_TABLE) {
+          DCHECK_EQ(inst.payload.lookaround.index, index);
+          lookaround_tables_->Set(index, position);
+          break;
+        } else {
+          DCHECK(inst.opcode == RegExpInstruction::SET_REGISTER_TO_CP ||
+                 inst.opcode == RegExpInstruction::CLEAR_REGISTER);
+          ++pc;
+        }
+      }
+    }
+  }
+
+  // Whether a lookaround of a READ_LOOKAROUND_TABLE instruction holds at the
+  // given input position, taking into account whether it is negative.
+  bool LookaroundHolds(RegExpInstruction::LookaroundPayload lookaround,
+                       int position) {
+    return lookaround_tables_->Get(lookaround.index, position) ==
+           lookaround.is_positive;
+  }
+
+  // Frees the threads and the match of a previous search.
+  void DiscardThreadsAndMatch() {
     for (InterpreterThread t : blocked_threads_) {
       DestroyThread(t);
     }
@@ -325,13 +743,38 @@ class NfaInterpreter {
       FreeRegisterArray(best_match_registers_->begin());
       best_match_registers_ = base::nullopt;
     }
+  }
+
+  // Finds the next match like `FindNextMatch` by running threads starting at
+  // `start_pc` at the current `input_index_`.
+  int RunThreads(int start_pc) {
+    DCHECK(active_threads_.is_empty());
+    // TODO(mbid,v8:10765): Can we get around resetting `pc_last_input_index_`
+    // here? As long as
+    //
+    //   pc_last_input_index_[pc] < input_index_
+    //
+    // for all possible program counters pc that are reachable without input
+    // from pc = 0 and
+    //
+    //   pc_last_input_index_[k] <= input_index_
+    //
+    // for all k > 0 hold I think everything should be fine.  Maybe we can do
+    // something about this in `SetInputIndex`.
+    std::fill(pc_last_input_index_.begin(), pc_last_input_index_.end(), -1);
 
-    // All threads start at bytecode 0.
+    // Clean up left-over data from a previous call to FindNextMatch.
+    DiscardThreadsAndMatch();
+    if (!back_reference_registers_.empty()) ResetMemo();
+
+    // All threads start at `start_pc`.
     active_threads_.Add(
-        InterpreterThread{0, NewRegisterArray(kUndefinedRegisterValue)}, zone_);
+        InterpreterThread{start_pc, NewRegisterArray(kUndefinedRegisterValue)},
+        zone_);
     // Run the initial thread, potentially forking new threads, until every
     // thread is blocked without further input.
     RunActiveThreads();
+    if (memo_exhausted_) return RegExp::kInternalRegExpFallbackToIrregexp;
 
     // We stop if one of the following conditions hold:
     // - We have exhausted the entire input.
@@ -345,6 +788,7 @@ class NfaInterpreter {
       DCHECK(active_threads_.is_empty());
       uc16 input_char = input_[input_index_];
       ++input_index_;
+      memo_size_ = 0;
 
       static constexpr int kTicksBetweenInterruptHandling = 64;
       if (input_index_ % kTicksBetweenInterruptHandling == 0) {
@@ -357,21 +801,27 @@ class NfaInterpreter {
 
       // Run all threads until they block or accept.
       RunActiveThreads();
+      if (memo_exhausted_) return RegExp::kInternalRegExpFallbackToIrregexp;
     }
 
     return RegExp::kInternalRegExpSuccess;
   }
 
-  // Run an active thread `t` until it executes a CONSUME_RANGE or ACCEPT
-  // instruction, or its PC value was already processed.
-  // - If processing of `t` can't continue because of CONSUME_RANGE, it is
-  //   pushed on `blocked_threads_`.
+  // Run an active thread `t` until it executes a CONSUME_RANGE,
+  // CONSUME_BACK_REFERENCE or ACCEPT instruction, or its state was already
+  // processed.
+  // - If processing of `t` can't continue because of CONSUME_RANGE or
+  //   CONSUME_BACK_REFERENCE, it is pushed on `blocked_threads_`.
   // - If `t` executes ACCEPT, set `best_match` according to `t.match_begin` and
   //   the current input index. All remaining `active_threads_` are discarded.
   void RunActiveThread(InterpreterThread t) {
     while (true) {
-      if (IsPcProcessed(t.pc)) return;
-      MarkPcProcessed(t.pc);
+      if (back_reference_registers_.empty()) {
+        if (IsPcProcessed(t.pc)) return;
+        MarkPcProcessed(t.pc);
+      } else if (IsStateProcessed(t)) {
+        return;
+      }
 
       RegExpInstruction inst = bytecode_[t.pc];
       switch (inst.opcode) {
@@ -379,6 +829,17 @@ class NfaInterpreter {
           blocked_threads_.Add(t, zone_);
           return;
         }
+        case RegExpInstruction::CONSUME_BACK_REFERENCE:
+          // An empty capture is matched right away.  Otherwise the thread
+          // blocks until it has consumed the whole capture, see
+          // `ConsumeInputChar`.
+          if (t.back_reference_offset == 0 &&
+              BackReferenceLength(t, inst.payload.register_index) == 0) {
+            ++t.pc;
+            break;
+          }
+          blocked_threads_.Add(t, zone_);
+          return;
         case RegExpInstruction::ASSERTION:
           if (!SatisfiesAssertion(inst.payload.assertion_type, input_,
                                   input_index_)) {
@@ -423,6 +884,17 @@ class NfaInterpreter {
               kUndefinedRegisterValue;
           ++t.pc;
           break;
+        case RegExpInstruction::READ_LOOKAROUND_TABLE:
+          if (!LookaroundHolds(inst.payload.lookaround, input_index_)) {
+            DestroyThread(t);
+            return;
+          }
+          ++t.pc;
+          break;
+        case RegExpInstruction::START_LOOKAROUND:
+        case RegExpInstruction::WRITE_LOOKAROUND_TABLE:
+          // The automata of lookarounds come after the final ACCEPT.
+          UNREACHABLE();
       }
     }
   }
@@ -445,11 +917,7 @@ class NfaInterpreter {
     // need to activate blocked threads in reverse order.
     for (int i = blocked_threads_.length() - 1; i >= 0; --i) {
       InterpreterThread t = blocked_threads_[i];
-      RegExpInstruction inst = bytecode_[t.pc];
-      DCHECK_EQ(inst.opcode, RegExpInstruction::CONSUME_RANGE);
-      RegExpInstruction::Uc16Range range = inst.payload.consume_range;
-      if (input_char >= range.min && input_char <= range.max) {
-        ++t.pc;
+      if (ConsumeInputChar(&t, input_char)) {
         active_threads_.Add(t, zone_);
       } else {
         DestroyThread(t);
@@ -458,6 +926,43 @@ class NfaInterpreter {
     blocked_threads_.DropAndClear();
   }
 
+  // Feeds `input_char` to a blocked thread `t`.  Returns false if `t` has to
+  // be aborted.  Otherwise `t` continues after the instruction it blocked on,
+  // unless it is still in the middle of a back reference.
+  bool ConsumeInputChar(InterpreterThread* t, uc16 input_char) {
+    RegExpInstruction inst = bytecode_[t->pc];
+    if (inst.opcode == RegExpInstruction::CONSUME_BACK_REFERENCE) {
+      const int register_index = inst.payload.register_index;
+      const int begin = GetRegisterArray(*t)[register_index];
+      if (input_[begin + t->back_reference_offset] != input_char) {
+        return false;
+      }
+      if (++t->back_reference_offset ==
+          BackReferenceLength(*t, register_index)) {
+        t->back_reference_offset = 0;
+        ++t->pc;
+      }
+      return true;
+    }
+
+    DCHECK_EQ(inst.opcode, RegExpInstruction::CONSUME_RANGE);
+    RegExpInstruction::Uc16Range range = inst.payload.consume_range;
+    if (input_char < range.min || input_char > range.max) return false;
+    ++t->pc;
+    return true;
+  }
+
+  // Returns the length of the capture whose begin register is
+  // `register_index`, or 0 if it is undefined.
+  int BackReferenceLength(InterpreterThread t, int register_index) {
+    Vector<int> registers = GetRegisterArray(t);
+    const int begin = registers[register_index];
+    if (begin == kUndefinedRegisterValue) return 0;
+    const int end = registers[register_index + 1];
+    DCHECK_LE(begin, end);
+    return end - begin;
+  }
+
   bool FoundMatch() const { return best_match_registers_.has_value(); }
 
   Vector<int> GetRegisterArray(InterpreterThread t) {
@@ -508,6 +1013,70 @@ class NfaInterpreter {
     pc_last_input_index_[pc] = input_index_;
   }
 
+  // With back references, the state of a thread that decides whether it
+  // matches consists of its pc, how far it is into a back reference and the
+  // captures that back references refer to.  Returns whether a thread in the
+  // same state as `t` was processed since the last increment of
+  // `input_index_`, and marks the state of `t` as processed otherwise.  If
+  // there is no room for another state, `memo_exhausted_` is set and all
+  // threads count as processed, so that they are aborted.
+  bool IsStateProcessed(InterpreterThread t) {
+    if (memo_exhausted_) return true;
+
+    Vector<int> registers = GetRegisterArray(t);
+    auto key_it = memo_key_.begin();
+    *key_it++ = t.pc;
+    *key_it++ = t.back_reference_offset;
+    for (int begin_register : back_reference_registers_) {
+      const int begin = registers[begin_register];
+      // The end register of an undefined capture is meaningless.
+      *key_it++ = begin;
+      *key_it++ = begin == kUndefinedRegisterValue
+                      ? kUndefinedRegisterValue
+                      : registers[begin_register + 1];
+    }
+    DCHECK(key_it == memo_key_.end());
+
+    const size_t key_length = memo_key_.size();
+    const size_t mask = memo_input_index_.size() - 1;
+    size_t slot = base::hash_range(memo_key_.begin(), memo_key_.end()) & mask;
+    while (memo_input_index_[slot] == input_index_) {
+      if (std::equal(memo_key_.begin(), memo_key_.end(),
+                     memo_keys_.begin() + slot * key_length)) {
+        return true;
+      }
+      slot = (slot + 1) & mask;
+    }
+
+    if (memo_size_ == FLAG_experimental_regexp_engine_backreference_memo_size) {
+      memo_exhausted_ = true;
+      return true;
+    }
+    ++memo_size_;
+    memo_input_index_[slot] = input_index_;
+    std::copy(memo_key_.begin(), memo_key_.end(),
+              memo_keys_.begin() + slot * key_length);
+    return false;
+  }
+
+  // Empties the table of processed thread states, which is allocated on the
+  // first search.
+  void ResetMemo() {
+    if (memo_input_index_.empty()) {
+      // At most half of the slots are used, so that probing stays short.
+      const size_t capacity = base::bits::RoundUpToPowerOfTwo64(std::max(
+          2 * size_t{FLAG_experimental_regexp_engine_backreference_memo_size},
+          size_t{2}));
+      const size_t key_length = 2 + 2 * back_reference_registers_.size();
+      memo_input_index_.resize(capacity);
+      memo_keys_.resize(capacity * key_length);
+      memo_key_.resize(key_length);
+    }
+    std::fill(memo_input_index_.begin(), memo_input_index_.end(), -1);
+    memo_size_ = 0;
+    memo_exhausted_ = false;
+  }
+
   Isolate* const isolate_;
 
   const RegExp::CallOrigin call_origin_;
@@ -517,6 +1086,9 @@ class NfaInterpreter {
   ByteArray bytecode_object_;
   Vector<const RegExpInstruction> bytecode_;
 
+  // The RegExpPrefilter of the regexp, or a Smi if it has none.
+  Object prefilter_object_;
+
   // Number of registers used per thread.
   const int register_count_per_match_;
 
@@ -549,6 +1121,56 @@ class NfaInterpreter {
   // `register_array_allocator_`.
   base::Optional<Vector<int>> best_match_registers_;
 
+  // Finds the end of the next match if the bytecode can be run without
+  // registers.  Acquired for the lifetime of the interpreter, and reset if
+  // it gave up.  Shared with the dfa cache, which may drop it during an
+  // interrupt.
+  std::shared_ptr<LazyDfa> dfa_;
+
+  // The pc that sets the match begin register, i.e. the first pc after the
+  // preamble.
+  const int match_begin_pc_;
+
+  // The pcs from which pc k can be reached without consuming input are
+  // predecessors_[predecessor_offsets_[k]] to
+  // predecessors_[predecessor_offsets_[k + 1] - 1].  Only pcs after the
+  // preamble are considered.  Computed lazily by `ComputePredecessors`.
+  ZoneVector<int> predecessor_offsets_;
+  ZoneVector<int> predecessors_;
+  ZoneVector<int> consume_range_pcs_;
+
+  // pc_live_input_index_[k] records the last input index at which pc k was
+  // found to reach the end of the match in `FindMatchBegin`.
+  ZoneVector<int> pc_live_input_index_;
+  // Pcs that still need to be marked by `MarkLivePcs`.
+  ZoneList<int> live_pcs_;
+
+  // The pcs of the START_LOOKAROUND instructions, by lookaround index.
+  ZoneVector<int> lookaround_start_pcs_;
+  // For every lookaround, whether it holds at each input position, computed
+  // by `ComputeLookaroundTables`.  Shared with the lookaround cache, which may
+  // drop them during an interrupt.
+  std::shared_ptr<ExperimentalRegExpLookaroundTables> lookaround_tables_;
+  // Scratch lists for `RunLookaroundAutomaton`.
+  ZoneList<int> lookaround_pending_pcs_;
+  ZoneList<int> lookaround_blocked_pcs_;
+  ZoneList<int> lookaround_next_blocked_pcs_;
+
+  // The begin registers of the captures that back references refer to.
+  ZoneVector<int> back_reference_registers_;
+  // An open addressing hash table of the thread states processed at the
+  // current input index, see `IsStateProcessed`.  Slot k is used iff
+  // memo_input_index_[k] == input_index_, and then its key starts at
+  // memo_keys_[k * memo_key_.size()].  `memo_key_` holds the key that is
+  // looked up.  Only used if there are back references.
+  ZoneVector<int> memo_input_index_;
+  ZoneVector<int> memo_keys_;
+  ZoneVector<int> memo_key_;
+  // The number of used slots.
+  size_t memo_size_ = 0;
+  // Whether the search gave up because the table was full.
+  bool memo_exhausted_ = false;
+
   Zone* zone_;
 };
 
@@ -556,24 +1178,77 @@ class NfaInterpreter {
 
 int ExperimentalRegExpInterpreter::FindMatches(
     Isolate* isolate, RegExp::CallOrigin call_origin, ByteArray bytecode,
-    int register_count_per_match, String input, int start_index,
-    int32_t* output_registers, int output_register_count, Zone* zone) {
+    Object prefilter, int register_count_per_match, String input,
+    int start_index, int32_t* output_registers, int output_register_count,
+    Zone* zone) {
   DCHECK(input.IsFlat());
   DisallowGarbageCollection no_gc;
 
   if (input.GetFlatContent(no_gc).IsOneByte()) {
     NfaInterpreter<uint8_t> interpreter(isolate, call_origin, bytecode,
-                                        register_count_per_match, input,
-                                        start_index, zone);
+                                        prefilter, register_count_per_match,
+                                        input, start_index, zone);
     return interpreter.FindMatches(output_registers, output_register_count);
   } else {
     DCHECK(input.GetFlatContent(no_gc).IsTwoByte());
     NfaInterpreter<uc16> interpreter(isolate, call_origin, bytecode,
-                                     register_count_per_match, input,
-                                     start_index, zone);
+                                     prefilter, register_count_per_match,
+                                     input, start_index, zone);
     return interpreter.FindMatches(output_registers, output_register_count);
   }
 }
 
+std::shared_ptr<ExperimentalRegExpLookaroundTables>
+ExperimentalRegExpLookaroundCache::Lookup(Heap* heap, ByteArray bytecode,
+                                          String subject) const {
+  if (gc_count_ != heap->gc_count() || bytecode_ != bytecode.ptr() ||
+      subject_ != subject.ptr()) {
+    return nullptr;
+  }
+  return tables_;
+}
+
+void ExperimentalRegExpLookaroundCache::Update(
+    Heap* heap, ByteArray bytecode, String subject,
+    std::shared_ptr<ExperimentalRegExpLookaroundTables> tables) {
+  gc_count_ = heap->gc_count();
+  bytecode_ = bytecode.ptr();
+  subject_ = subject.ptr();
+  tables_ = std::move(tables);
+}
+
+void ExperimentalRegExpLookaroundCache::Clear() {
+  bytecode_ = kNullAddress;
+  subject_ = kNullAddress;
+  tables_.reset();
+}
+
+std::shared_ptr<LazyDfa> ExperimentalRegExpDfaCache::Lookup(
+    Vector<const RegExpInstruction> bytecode, AccountingAllocator* allocator) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(bytecode.begin());
+  const size_t size = bytecode.length() * sizeof(RegExpInstruction);
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->bytecode.size() != size ||
+        memcmp(it->bytecode.data(), bytes, size) != 0) {
+      continue;
+    }
+    // A search that handles an interrupt may run a nested search with the
+    // same bytecode, which gets an automaton of its own.
+    if (it->dfa->in_use()) {
+      return std::make_shared<LazyDfa>(bytecode, allocator);
+    }
+    std::rotate(entries_.begin(), it, it + 1);
+    return entries_.front().dfa;
+  }
+
+  if (entries_.size() == kSize) entries_.pop_back();
+  entries_.insert(entries_.begin(),
+                  Entry{std::vector<uint8_t>(bytes, bytes + size),
+                        std::make_shared<LazyDfa>(bytecode, allocator)});
+  return entries_.front().dfa;
+}
+
+void ExperimentalRegExpDfaCache::Clear() { entries_.clear(); }
+
 }  // namespace internal
 }  // namespace v8
@@ -5,6 +5,9 @@
 #ifndef V8_REGEXP_EXPERIMENTAL_EXPERIMENTAL_INTERPRETER_H_
 #define V8_REGEXP_EXPERIMENTAL_EXPERIMENTAL_INTERPRETER_H_
 
+#include <memory>
+#include <vector>
+
 #include "src/objects/fixed-array.h"
 #include "src/objects/string.h"
 #include "src/regexp/experimental/experimental-bytecode.h"
@@ -14,20 +17,115 @@
 namespace v8 {
 namespace internal {
 
+class AccountingAllocator;
+class Heap;
+class LazyDfa;
 class Zone;
 
 class ExperimentalRegExpInterpreter final : public AllStatic {
  public:
   // Executes a bytecode program in breadth-first NFA mode, without
-  // backtracking, to find matching substrings.  Trys to find up to
+  // backtracking, to find matching substrings.  Match boundaries are found
+  // with a lazily built DFA where possible.  Trys to find up to
   // `max_match_num` matches in `input`, starting at `start_index`.  Returns
   // the actual number of matches found.  The boundaries of matching subranges
   // are written to `matches_out`.  Provided in variants for one-byte and
-  // two-byte strings.
+  // two-byte strings.  `prefilter` is the regexp's RegExpPrefilter or a Smi
+  // if it has none.  Returns RegExp::kInternalRegExpFallbackToIrregexp if a
+  // search exceeds --experimental-regexp-engine-backreference-memo-size.
   static int FindMatches(Isolate* isolate, RegExp::CallOrigin call_origin,
-                         ByteArray bytecode, int capture_count, String input,
-                         int start_index, int32_t* output_registers,
-                         int output_register_count, Zone* zone);
+                         ByteArray bytecode, Object prefilter,
+                         int capture_count, String input, int start_index,
+                         int32_t* output_registers, int output_register_count,
+                         Zone* zone);
+};
+
+// Tells for every lookaround of a regexp and every position in a subject
+// whether the lookaround holds there, with one bit per lookaround and
+// position.  Negative lookarounds are recorded like positive ones.
+class ExperimentalRegExpLookaroundTables final {
+ public:
+  ExperimentalRegExpLookaroundTables(int lookaround_count, int input_length)
+      : table_size_(static_cast<size_t>(input_length) + 1),
+        bits_(lookaround_count * table_size_, false) {}
+
+  bool Get(int index, int position) const {
+    return bits_[Offset(index, position)];
+  }
+  void Set(int index, int position) { bits_[Offset(index, position)] = true; }
+
+ private:
+  size_t Offset(int index, int position) const {
+    DCHECK_LE(0, position);
+    DCHECK_LT(static_cast<size_t>(position), table_size_);
+    return index * table_size_ + position;
+  }
+
+  const size_t table_size_;
+  std::vector<bool> bits_;
+};
+
+// Holds the lookaround tables of the last regexp with lookarounds that the
+// experimental engine ran, for the subject it ran on.  Filling the tables
+// takes a pass over the whole subject per lookaround, which exec loops and
+// global regexps with more matches than fit into one batch would otherwise
+// repeat for every call.  The entry is keyed by the addresses of the bytecode
+// and the subject, so it is only valid until the next gc.
+class ExperimentalRegExpLookaroundCache final {
+ public:
+  ExperimentalRegExpLookaroundCache() = default;
+  ExperimentalRegExpLookaroundCache(const ExperimentalRegExpLookaroundCache&) =
+      delete;
+  ExperimentalRegExpLookaroundCache& operator=(
+      const ExperimentalRegExpLookaroundCache&) = delete;
+
+  // Returns the tables for `bytecode` and `subject`, or nullptr if they are
+  // not cached.
+  std::shared_ptr<ExperimentalRegExpLookaroundTables> Lookup(
+      Heap* heap, ByteArray bytecode, String subject) const;
+  void Update(Heap* heap, ByteArray bytecode, String subject,
+              std::shared_ptr<ExperimentalRegExpLookaroundTables> tables);
+
+  // Releases the cached tables (@ mark compact collection).
+  void Clear();
+
+ private:
+  int gc_count_ = 0;
+  Address bytecode_ = kNullAddress;
+  Address subject_ = kNullAddress;
+  std::shared_ptr<ExperimentalRegExpLookaroundTables> tables_;
+};
+
+// Holds the lazily built dfas of the regexps without lookarounds that the
+// experimental engine ran last, so that exec loops and repeated calls don't
+// build the same states again.  The entries are keyed by the contents of the
+// bytecode, which doesn't change when the bytecode is moved during gc, and
+// are shared by regexps that compile to the same bytecode.
+class ExperimentalRegExpDfaCache final {
+ public:
+  ExperimentalRegExpDfaCache() = default;
+  ExperimentalRegExpDfaCache(const ExperimentalRegExpDfaCache&) = delete;
+  ExperimentalRegExpDfaCache& operator=(const ExperimentalRegExpDfaCache&) =
+      delete;
+
+  // Returns a dfa for `bytecode` that is not in use by another search,
+  // preferably a cached one.
+  std::shared_ptr<LazyDfa> Lookup(Vector<const RegExpInstruction> bytecode,
+                                  AccountingAllocator* allocator);
+
+  // Releases the cached dfas (@ mark compact collection).
+  void Clear();
+
+ private:
+  // Each dfa takes up to --experimental-regexp-engine-dfa-cache-size KB.
+  static constexpr size_t kSize = 4;
+
+  struct Entry {
+    std::vector<uint8_t> bytecode;
+    std::shared_ptr<LazyDfa> dfa;
+  };
+  // Sorted from most to least recently used.
+  std::vector<Entry> entries_;
 };
 
 }  // namespace internal
@@ -4,10 +4,14 @@
 
 #include "src/regexp/experimental/experimental.h"
 
+#include "src/objects/code-inl.h"
 #include "src/objects/js-regexp-inl.h"
 #include "src/regexp/experimental/experimental-compiler.h"
+#include "src/regexp/experimental/experimental-dfa-compiler.h"
 #include "src/regexp/experimental/experimental-interpreter.h"
+#include "src/regexp/regexp-macro-assembler.h"
 #include "src/regexp/regexp-parser.h"
+#include "src/regexp/regexp-prefilter.h"
 #include "src/utils/ostreams.h"
 
 namespace v8 {
@@ -15,8 +19,7 @@ namespace internal {
 
 bool ExperimentalRegExp::CanBeHandled(RegExpTree* tree, JSRegExp::Flags flags,
                                       int capture_count) {
-  DCHECK(FLAG_enable_experimental_regexp_engine ||
-         FLAG_enable_experimental_regexp_engine_on_excessive_backtracks);
+  DCHECK(FLAG_enable_experimental_regexp_engine);
   return ExperimentalRegExpCompiler::CanBeHandled(tree, flags, capture_count);
 }
 
@@ -34,7 +37,8 @@ void ExperimentalRegExp::Initialize(Isolate* isolate, Handle<JSRegExp> re,
 }
 
 bool ExperimentalRegExp::IsCompiled(Handle<JSRegExp> re, Isolate* isolate) {
-  DCHECK(FLAG_enable_experimental_regexp_engine);
+  DCHECK(FLAG_enable_experimental_regexp_engine ||
+         FLAG_enable_experimental_regexp_engine_on_excessive_backtracks);
   DCHECK_EQ(re->TypeTag(), JSRegExp::EXPERIMENTAL);
 #ifdef VERIFY_HEAP
   re->JSRegExpVerify(isolate);
@@ -59,6 +63,7 @@ namespace {
 
 struct CompilationResult {
   Handle<ByteArray> bytecode;
+  Handle<Object> prefilter;
   Handle<FixedArray> capture_name_map;
 };
 
@@ -86,19 +91,40 @@ base::Optional<CompilationResult> CompileImpl(Isolate* isolate,
     return base::nullopt;
   }
 
+  // The prefilter has to be computed before the compiler rewrites the tree.
+  Handle<Object> prefilter =
+      RegExpPrefilter::New(isolate, parse_result.tree, flags, &zone);
   ZoneList<RegExpInstruction> bytecode =
       ExperimentalRegExpCompiler::Compile(parse_result.tree, flags, &zone);
 
   CompilationResult result;
   result.bytecode = VectorToByteArray(isolate, bytecode.ToVector());
+  result.prefilter = prefilter;
   result.capture_name_map = parse_result.capture_name_map;
   return result;
 }
 
+void InstallCompilationResult(Isolate* isolate, Handle<JSRegExp> re,
+                              const CompilationResult& compilation_result) {
+  re->SetDataAt(JSRegExp::kIrregexpLatin1BytecodeIndex,
+                *compilation_result.bytecode);
+  re->SetDataAt(JSRegExp::kIrregexpUC16BytecodeIndex,
+                *compilation_result.bytecode);
+
+  Handle<Code> trampoline = BUILTIN_CODE(isolate, RegExpExperimentalTrampoline);
+  re->SetDataAt(JSRegExp::kIrregexpLatin1CodeIndex, *trampoline);
+  re->SetDataAt(JSRegExp::kIrregexpUC16CodeIndex, *trampoline);
+
+  re->SetDataAt(JSRegExp::kIrregexpPrefilterIndex,
+                *compilation_result.prefilter);
+  re->SetCaptureNameMap(compilation_result.capture_name_map);
+}
+
 }  // namespace
 
 bool ExperimentalRegExp::Compile(Isolate* isolate, Handle<JSRegExp> re) {
-  DCHECK(FLAG_enable_experimental_regexp_engine);
+  DCHECK(FLAG_enable_experimental_regexp_engine ||
+         FLAG_enable_experimental_regexp_engine_on_excessive_backtracks);
   DCHECK_EQ(re->TypeTag(), JSRegExp::EXPERIMENTAL);
 #ifdef VERIFY_HEAP
   re->JSRegExpVerify(isolate);
@@ -116,17 +142,62 @@ bool ExperimentalRegExp::Compile(Isolate* isolate, Handle<JSRegExp> re) {
     return false;
   }
 
-  re->SetDataAt(JSRegExp::kIrregexpLatin1BytecodeIndex,
-                *compilation_result->bytecode);
-  re->SetDataAt(JSRegExp::kIrregexpUC16BytecodeIndex,
-                *compilation_result->bytecode);
+  InstallCompilationResult(isolate, re, *compilation_result);
+  return true;
+}
 
-  Handle<Code> trampoline = BUILTIN_CODE(isolate, RegExpExperimentalTrampoline);
-  re->SetDataAt(JSRegExp::kIrregexpLatin1CodeIndex, *trampoline);
-  re->SetDataAt(JSRegExp::kIrregexpUC16CodeIndex, *trampoline);
+namespace {
+
+bool HasNativeCode(JSRegExp re) {
+  Object code = re.DataAt(JSRegExp::kIrregexpLatin1CodeIndex);
+  return code.IsCode() && Code::cast(code).kind() == CodeKind::REGEXP;
+}
+
+// Replaces the trampolines of a regexp that is marked for tier-up by native
+// code compiled from its dfa.  Either way, the regexp doesn't tier up again.
+void TierUpIfMarked(Isolate* isolate, Handle<JSRegExp> re) {
+  if (!re->MarkedForTierUp()) return;
+
+  Handle<String> source(re->Pattern(), isolate);
+  Handle<ByteArray> bytecode(
+      ByteArray::cast(re->DataAt(JSRegExp::kIrregexpLatin1BytecodeIndex)),
+      isolate);
+  Handle<Code> latin1_code;
+  Handle<Code> uc16_code;
+  const bool success =
+      FLAG_experimental_regexp_engine_native_code &&
+      !FLAG_regexp_interpret_all &&
+      ExperimentalRegExpDfaCompiler::Compile(isolate, source, bytecode,
+                                             &latin1_code, &uc16_code);
+  if (FLAG_trace_regexp_tier_up) {
+    PrintF("JSRegExp object %p %s\n", reinterpret_cast<void*>(re->ptr()),
+           success ? "tiered up to native dfa code"
+                   : "stays on the experimental interpreter");
+  }
+  if (success) {
+    re->SetDataAt(JSRegExp::kIrregexpLatin1CodeIndex, *latin1_code);
+    re->SetDataAt(JSRegExp::kIrregexpUC16CodeIndex, *uc16_code);
+  }
+  re->SetDataAt(JSRegExp::kIrregexpTicksUntilTierUpIndex,
+                Smi::FromInt(JSRegExp::kUninitializedValue));
+}
+
+}  // namespace
 
-  re->SetCaptureNameMap(compilation_result->capture_name_map);
+bool ExperimentalRegExp::Prepare(Isolate* isolate, Handle<JSRegExp> re,
+                                 Handle<String> subject) {
+  DCHECK_EQ(re->TypeTag(), JSRegExp::EXPERIMENTAL);
+  if (!IsCompiled(re, isolate) && !Compile(isolate, re)) {
+    DCHECK(isolate->has_pending_exception());
+    return false;
+  }
 
+  // Very long subjects tier up right away, as in RegExpImpl::IrregexpExec.
+  if (re->CanTierUp() &&
+      subject->length() >= JSRegExp::kTierUpForSubjectLengthValue) {
+    re->MarkTierUpForNextExec();
+  }
+  TierUpIfMarked(isolate, re);
   return true;
 }
 
@@ -141,9 +212,9 @@ Vector<RegExpInstruction> AsInstructionSequence(ByteArray raw_bytes) {
 namespace {
 
 int32_t ExecRawImpl(Isolate* isolate, RegExp::CallOrigin call_origin,
-                    ByteArray bytecode, String subject, int capture_count,
-                    int32_t* output_registers, int32_t output_register_count,
-                    int32_t subject_index) {
+                    ByteArray bytecode, Object prefilter, String subject,
+                    int capture_count, int32_t* output_registers,
+                    int32_t output_register_count, int32_t subject_index) {
   DisallowGarbageCollection no_gc;
 
   int register_count_per_match =
@@ -154,8 +225,9 @@ int32_t ExecRawImpl(Isolate* isolate, RegExp::CallOrigin call_origin,
     DCHECK(subject.IsFlat());
     Zone zone(isolate->allocator(), ZONE_NAME);
     result = ExperimentalRegExpInterpreter::FindMatches(
-        isolate, call_origin, bytecode, register_count_per_match, subject,
-        subject_index, output_registers, output_register_count, &zone);
+        isolate, call_origin, bytecode, prefilter, register_count_per_match,
+        subject, subject_index, output_registers, output_register_count,
+        &zone);
   } while (result == RegExp::kInternalRegExpRetry &&
            call_origin == RegExp::kFromRuntime);
   return result;
@@ -170,7 +242,9 @@ int32_t ExperimentalRegExp::ExecRaw(Isolate* isolate,
                                     int32_t* output_registers,
                                     int32_t output_register_count,
                                     int32_t subject_index) {
-  DCHECK(FLAG_enable_experimental_regexp_engine);
+  DCHECK(FLAG_enable_experimental_regexp_engine ||
+         FLAG_enable_experimental_regexp_engine_on_excessive_backtracks);
+  DCHECK(!HasNativeCode(regexp));
   DisallowGarbageCollection no_gc;
 
   if (FLAG_trace_experimental_regexp_engine) {
@@ -178,10 +252,13 @@ int32_t ExperimentalRegExp::ExecRaw(Isolate* isolate,
     StdoutStream{} << "Executing experimental regexp " << source << std::endl;
   }
 
+  if (regexp.CanTierUp()) regexp.TierUpTick();
+
   ByteArray bytecode =
       ByteArray::cast(regexp.DataAt(JSRegExp::kIrregexpLatin1BytecodeIndex));
+  Object prefilter = regexp.DataAt(JSRegExp::kIrregexpPrefilterIndex);
 
-  return ExecRawImpl(isolate, call_origin, bytecode, subject,
+  return ExecRawImpl(isolate, call_origin, bytecode, prefilter, subject,
                      regexp.CaptureCount(), output_registers,
                      output_register_count, subject_index);
 }
@@ -204,9 +281,93 @@ int32_t ExperimentalRegExp::MatchForCallFromJs(
   String subject_string = String::cast(Object(subject));
 
   JSRegExp regexp_obj = JSRegExp::cast(Object(regexp));
+  // The runtime tiers the regexp up, see ExperimentalRegExp::Prepare.
+  if (regexp_obj.MarkedForTierUp()) return RegExp::kInternalRegExpRetry;
+
+  int32_t result =
+      ExecRaw(isolate, RegExp::kFromJs, regexp_obj, subject_string,
+              output_registers, output_register_count, start_position);
+  // The runtime falls back to irregexp, see ExecRawFromRuntime.
+  if (result == RegExp::kInternalRegExpFallbackToIrregexp) {
+    return RegExp::kInternalRegExpRetry;
+  }
+  return result;
+}
+
+namespace {
+
+// Returns a regexp with the pattern and flags of the experimental `regexp`
+// that runs on irregexp without a backtrack limit.  Its data is created on the
+// first fallback and kept in the data of `regexp`.
+Handle<JSRegExp> BacktrackingRegExp(Isolate* isolate, Handle<JSRegExp> regexp) {
+  DCHECK_EQ(regexp->TypeTag(), JSRegExp::EXPERIMENTAL);
+
+  Handle<JSRegExp> backtracking = JSRegExp::Copy(regexp);
+  Object data = regexp->DataAt(JSRegExp::kExperimentalIrregexpFallbackIndex);
+  if (data.IsFixedArray()) {
+    backtracking->set_data(FixedArray::cast(data));
+  } else {
+    isolate->factory()->SetRegExpIrregexpData(
+        backtracking, handle(regexp->Pattern(), isolate), regexp->GetFlags(),
+        regexp->CaptureCount(), JSRegExp::kNoBacktrackLimit);
+    backtracking->SetDataAt(
+        JSRegExp::kIrregexpExperimentalFallbackIndex,
+        Smi::FromInt(JSRegExp::kNoExperimentalFallbackValue));
+    regexp->SetDataAt(JSRegExp::kExperimentalIrregexpFallbackIndex,
+                      backtracking->data());
+  }
+  return backtracking;
+}
+
+}  // namespace
+
+int32_t ExperimentalRegExp::ExecRawFromRuntime(Isolate* isolate,
+                                               Handle<JSRegExp> regexp,
+                                               Handle<String> subject,
+                                               int32_t* output_registers,
+                                               int32_t output_register_count,
+                                               int32_t subject_index) {
+  DCHECK(IsCompiled(regexp, isolate));
+  DCHECK(subject->IsFlat());
+  if (!HasNativeCode(*regexp)) {
+    int32_t result;
+    {
+      DisallowGarbageCollection no_gc;
+      result = ExecRaw(isolate, RegExp::kFromRuntime, *regexp, *subject,
+                       output_registers, output_register_count, subject_index);
+    }
+    if (result != RegExp::kInternalRegExpFallbackToIrregexp) return result;
+
+    // The interpreter found too many different captures for back references
+    // at some input position.
+    if (FLAG_trace_experimental_regexp_engine) {
+      StdoutStream{} << "Falling back to irregexp for regexp "
+                     << regexp->Pattern() << std::endl;
+    }
+    return RegExp::IrregexpExecRaw(isolate, BacktrackingRegExp(isolate, regexp),
+                                   subject, subject_index, output_registers,
+                                   output_register_count);
+  }
+
+  // Skip positions at which none of the leading literals occurs.
+  Object prefilter = regexp->DataAt(JSRegExp::kIrregexpPrefilterIndex);
+  if (prefilter.IsByteArray()) {
+    subject_index = RegExpPrefilter::FindCandidate(ByteArray::cast(prefilter),
+                                                   *subject, subject_index);
+    if (subject_index == -1) return RegExp::kInternalRegExpFailure;
+  }
 
-  return ExecRaw(isolate, RegExp::kFromJs, regexp_obj, subject_string,
-                 output_registers, output_register_count, start_position);
+  int32_t result;
+  do {
+    // RETRY means that the subject changed its representation, which may
+    // select the code for the other one.
+    result = NativeRegExpMacroAssembler::Match(
+        regexp, subject, output_registers, output_register_count,
+        subject_index, isolate);
+  } while (result == NativeRegExpMacroAssembler::RETRY);
+  DCHECK_IMPLIES(result == NativeRegExpMacroAssembler::EXCEPTION,
+                 isolate->has_pending_exception());
+  return result;
 }
 
 MaybeHandle<Object> ExperimentalRegExp::Exec(
@@ -218,7 +379,7 @@ MaybeHandle<Object> ExperimentalRegExp::Exec(
   regexp->JSRegExpVerify(isolate);
 #endif
 
-  if (!IsCompiled(regexp, isolate) && !Compile(isolate, regexp)) {
+  if (!Prepare(isolate, regexp, subject)) {
     DCHECK(isolate->has_pending_exception());
     return MaybeHandle<Object>();
   }
@@ -240,8 +401,8 @@ MaybeHandle<Object> ExperimentalRegExp::Exec(
   }
 
   int num_matches =
-      ExecRaw(isolate, RegExp::kFromRuntime, *regexp, *subject,
-              output_registers, output_register_count, subject_index);
+      ExecRawFromRuntime(isolate, regexp, subject, output_registers,
+                         output_register_count, subject_index);
 
   if (num_matches > 0) {
     DCHECK_EQ(num_matches, 1);
@@ -256,6 +417,32 @@ MaybeHandle<Object> ExperimentalRegExp::Exec(
   }
 }
 
+namespace {
+
+// Returns a regexp with the pattern and flags of `regexp` that runs on the
+// experimental engine.  For an irregexp, its data is created on the first
+// fallback and kept in the data of `regexp`, so that later fallbacks reuse the
+// compiled bytecode and can tier up to native code.
+Handle<JSRegExp> FallbackRegExp(Isolate* isolate, Handle<JSRegExp> regexp) {
+  if (regexp->TypeTag() == JSRegExp::EXPERIMENTAL) return regexp;
+  DCHECK_EQ(regexp->TypeTag(), JSRegExp::IRREGEXP);
+
+  Handle<JSRegExp> fallback = JSRegExp::Copy(regexp);
+  Object data = regexp->DataAt(JSRegExp::kIrregexpExperimentalFallbackIndex);
+  if (data.IsFixedArray()) {
+    fallback->set_data(FixedArray::cast(data));
+  } else {
+    isolate->factory()->SetRegExpExperimentalData(
+        fallback, handle(regexp->Pattern(), isolate), regexp->GetFlags(),
+        regexp->CaptureCount());
+    regexp->SetDataAt(JSRegExp::kIrregexpExperimentalFallbackIndex,
+                      fallback->data());
+  }
+  return fallback;
+}
+
+}  // namespace
+
 int32_t ExperimentalRegExp::OneshotExecRaw(Isolate* isolate,
                                            Handle<JSRegExp> regexp,
                                            Handle<String> subject,
@@ -269,15 +456,13 @@ int32_t ExperimentalRegExp::OneshotExecRaw(Isolate* isolate,
                    << regexp->Pattern() << std::endl;
   }
 
-  base::Optional<CompilationResult> compilation_result =
-      CompileImpl(isolate, regexp);
-  if (!compilation_result.has_value()) return RegExp::kInternalRegExpException;
-
-  DisallowGarbageCollection no_gc;
-  return ExecRawImpl(isolate, RegExp::kFromRuntime,
-                     *compilation_result->bytecode, *subject,
-                     regexp->CaptureCount(), output_registers,
-                     output_register_count, subject_index);
+  Handle<JSRegExp> fallback = FallbackRegExp(isolate, regexp);
+  if (!Prepare(isolate, fallback, subject)) {
+    DCHECK(isolate->has_pending_exception());
+    return RegExp::kInternalRegExpException;
+  }
+  return ExecRawFromRuntime(isolate, fallback, subject, output_registers,
+                            output_register_count, subject_index);
 }
 
 MaybeHandle<Object> ExperimentalRegExp::OneshotExec(
@@ -27,6 +27,13 @@ class ExperimentalRegExp final : public AllStatic {
   static bool IsCompiled(Handle<JSRegExp> re, Isolate* isolate);
   V8_WARN_UNUSED_RESULT
   static bool Compile(Isolate* isolate, Handle<JSRegExp> re);
+  // Compiles the regexp if necessary, and tiers it up to native code if it
+  // is marked for tier-up.  Like irregexps, regexps are marked after
+  // --regexp-tier-up-ticks executions or for long subjects.  Returns false if
+  // an exception is pending.
+  V8_WARN_UNUSED_RESULT
+  static bool Prepare(Isolate* isolate, Handle<JSRegExp> re,
+                      Handle<String> subject);
 
   // Execution:
   static int32_t MatchForCallFromJs(Address subject, int32_t start_position,
@@ -43,9 +50,19 @@ class ExperimentalRegExp final : public AllStatic {
                          JSRegExp regexp, String subject,
                          int32_t* output_registers,
                          int32_t output_register_count, int32_t subject_index);
+  // Runs a prepared regexp on native code if it has tiered up and on the
+  // interpreter otherwise.  If the interpreter gives up on back references,
+  // the regexp runs on irregexp without a backtrack limit instead.  Returns
+  // the number of matches or an error code.
+  static int32_t ExecRawFromRuntime(Isolate* isolate, Handle<JSRegExp> regexp,
+                                    Handle<String> subject,
+                                    int32_t* output_registers,
+                                    int32_t output_register_count,
+                                    int32_t subject_index);
 
   // Compile and execute a regexp with the experimental engine, regardless of
-  // its type tag.  The regexp itself is not changed (apart from lastIndex).
+  // its type tag.  The type tag of the regexp is not changed, but the
+  // experimental data is kept in its data array for later executions.
   static MaybeHandle<Object> OneshotExec(
       Isolate* isolate, Handle<JSRegExp> regexp, Handle<String> subject,
       int index, Handle<RegExpMatchInfo> last_match_info);
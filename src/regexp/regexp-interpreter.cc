@@ -14,6 +14,7 @@
 #include "src/regexp/regexp-bytecodes.h"
 #include "src/regexp/regexp-macro-assembler.h"
 #include "src/regexp/regexp-stack.h"  // For kMaximumStackSize.
+#include "src/regexp/regexp-stats.h"
 #include "src/regexp/regexp.h"
 #include "src/strings/unicode.h"
 #include "src/utils/utils.h"
@@ -224,6 +225,12 @@ IrregexpInterpreter::Result MaybeThrowStackOverflow(
   }
 }
 
+void RecordBacktracks(Isolate* isolate, uint32_t backtrack_count) {
+  if (V8_UNLIKELY(isolate->regexp_stats() != nullptr)) {
+    isolate->regexp_stats()->RecordBacktracks(backtrack_count);
+  }
+}
+
 template <typename Char>
 void UpdateCodeAndSubjectReferences(
     Isolate* isolate, Handle<ByteArray> code_array,
@@ -521,6 +528,7 @@ IrregexpInterpreter::Result RawMatch(
     BYTECODE(POP_BT) {
       STATIC_ASSERT(JSRegExp::kNoBacktrackLimit == 0);
       if (++backtrack_count == backtrack_limit) {
+        RecordBacktracks(isolate, backtrack_count);
         int return_code = LoadPacked24Signed(insn);
         return static_cast<IrregexpInterpreter::Result>(return_code);
       }
@@ -541,11 +549,13 @@ IrregexpInterpreter::Result RawMatch(
     BYTECODE(FAIL) {
       isolate->counters()->regexp_backtracks()->AddSample(
           static_cast<int>(backtrack_count));
+      RecordBacktracks(isolate, backtrack_count);
       return IrregexpInterpreter::FAILURE;
     }
     BYTECODE(SUCCEED) {
       isolate->counters()->regexp_backtracks()->AddSample(
           static_cast<int>(backtrack_count));
+      RecordBacktracks(isolate, backtrack_count);
       registers.CopyToOutputRegisters();
       return IrregexpInterpreter::SUCCESS;
     }
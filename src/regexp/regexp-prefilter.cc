@@ -0,0 +1,482 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/regexp/regexp-prefilter.h"
+
+#include "src/base/bits.h"
+#include "src/flags/flags.h"
+#include "src/heap/factory.h"
+#include "src/objects/objects-inl.h"
+#include "src/regexp/regexp-ast.h"
+#include "src/strings/char-predicates-inl.h"
+#include "src/strings/string-search.h"
+#include "src/strings/unicode.h"
+#include "src/zone/zone-list-inl.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+// Number of leading character positions that have a table.
+constexpr int kTableCount = 3;
+
+// Character classes with more characters than this are not expanded into
+// literals.
+constexpr int kMaxClassSize = 4;
+
+STATIC_ASSERT(RegExpPrefilter::kMaxLiterals <= kBitsPerByte);
+
+// The layout of the prefilter ByteArray.
+struct PrefilterData {
+  uint8_t literal_count;
+  uint8_t min_length;
+  bool ignore_case;
+  // Whether all literals start with `literals[0][0]`, which is then searched
+  // for with memchr.
+  bool has_common_first_char;
+  uint8_t literal_lengths[RegExpPrefilter::kMaxLiterals];
+  uc16 literals[RegExpPrefilter::kMaxLiterals]
+               [RegExpPrefilter::kMaxLiteralLength];
+  // Bit i of `tables[j][c]` is set if literal i has a character with lowest
+  // byte c at position j, or is shorter than j + 1.
+  uint8_t tables[kTableCount][256];
+};
+
+inline uc16 FoldCase(uc16 c) { return static_cast<uc16>(ToAsciiLower(c)); }
+
+// A prefix of all matches of a subtree.  A complete prefix spans the whole
+// match, so that the prefixes of what follows the subtree can be appended.
+struct Prefix {
+  Vector<const uc16> chars;
+  bool complete;
+};
+
+using PrefixSet = ZoneList<Prefix>;
+
+// Computes a set of prefixes one of which every match starts with.  Visit
+// functions return a PrefixSet*, or nullptr if no small set of non-empty
+// prefixes is known.
+class PrefixVisitor final : private RegExpVisitor {
+ public:
+  static PrefixSet* Compute(RegExpTree* tree, JSRegExp::Flags flags,
+                            Zone* zone) {
+    PrefixVisitor visitor(flags, zone);
+    return static_cast<PrefixSet*>(tree->Accept(&visitor, nullptr));
+  }
+
+ private:
+  PrefixVisitor(JSRegExp::Flags flags, Zone* zone)
+      : ignore_case_((flags & JSRegExp::kIgnoreCase) != 0), zone_(zone) {}
+
+  void* VisitDisjunction(RegExpDisjunction* node, void*) override {
+    PrefixSet* result = new (zone_) PrefixSet(kInitialSize, zone_);
+    for (RegExpTree* alternative : *node->alternatives()) {
+      PrefixSet* prefixes = Visit(alternative);
+      if (prefixes == nullptr) return nullptr;
+      for (const Prefix& prefix : *prefixes) Add(result, prefix);
+      if (!Shrink(result)) return nullptr;
+    }
+    return result;
+  }
+
+  void* VisitAlternative(RegExpAlternative* node, void*) override {
+    PrefixSet* result = EmptyPrefix();
+    for (RegExpTree* child : *node->nodes()) {
+      if (!IsAnyComplete(result)) break;
+      PrefixSet* prefixes = Visit(child);
+      if (prefixes == nullptr) {
+        MarkIncomplete(result);
+        break;
+      }
+      result = Concatenate(result, prefixes);
+    }
+    return result;
+  }
+
+  void* VisitText(RegExpText* node, void*) override {
+    PrefixSet* result = EmptyPrefix();
+    for (const TextElement& element : *node->elements()) {
+      if (!IsAnyComplete(result)) break;
+      PrefixSet* prefixes = Visit(element.tree());
+      if (prefixes == nullptr) {
+        MarkIncomplete(result);
+        break;
+      }
+      result = Concatenate(result, prefixes);
+    }
+    return result;
+  }
+
+  void* VisitAtom(RegExpAtom* node, void*) override {
+    if (node->ignore_case() != ignore_case_) return nullptr;
+    Vector<const uc16> data = node->data();
+    if (data.empty()) return EmptyPrefix();
+    const int length =
+        std::min(data.length(), int{RegExpPrefilter::kMaxLiteralLength});
+    uc16* chars = zone_->NewArray<uc16>(length);
+    for (int i = 0; i < length; i++) {
+      if (!Fold(data[i], &chars[i])) return nullptr;
+    }
+    PrefixSet* result = new (zone_) PrefixSet(1, zone_);
+    Add(result, {Vector<const uc16>(chars, length), length == data.length()});
+    return result;
+  }
+
+  void* VisitCharacterClass(RegExpCharacterClass* node, void*) override {
+    if (node->is_negated()) return nullptr;
+    if (((node->flags() & JSRegExp::kIgnoreCase) != 0) != ignore_case_) {
+      return nullptr;
+    }
+    ZoneList<CharacterRange>* ranges = node->ranges(zone_);
+    int size = 0;
+    for (const CharacterRange& range : *ranges) {
+      size += range.to() - range.from() + 1;
+      if (size > kMaxClassSize) return nullptr;
+    }
+    PrefixSet* result = new (zone_) PrefixSet(size, zone_);
+    for (const CharacterRange& range : *ranges) {
+      for (uc32 c = range.from(); c <= range.to(); c++) {
+        if (c > String::kMaxUtf16CodeUnit) return nullptr;
+        uc16* chars = zone_->NewArray<uc16>(1);
+        if (!Fold(static_cast<uc16>(c), chars)) return nullptr;
+        Add(result, {Vector<const uc16>(chars, 1), true});
+      }
+    }
+    // The empty class never matches, so it has no prefixes at all.
+    return result;
+  }
+
+  void* VisitQuantifier(RegExpQuantifier* node, void*) override {
+    if (node->max() == 0) return EmptyPrefix();
+    PrefixSet* prefixes = Visit(node->body());
+    if (prefixes == nullptr) return nullptr;
+    // Only a body that occurs at most once ends where the quantifier ends.
+    if (node->max() != 1) MarkIncomplete(prefixes);
+    if (node->min() != 0) return prefixes;
+    PrefixSet* result = EmptyPrefix();
+    for (const Prefix& prefix : *prefixes) Add(result, prefix);
+    if (!Shrink(result)) return nullptr;
+    return result;
+  }
+
+  void* VisitCapture(RegExpCapture* node, void*) override {
+    return node->body()->Accept(this, nullptr);
+  }
+
+  void* VisitGroup(RegExpGroup* node, void*) override {
+    return node->body()->Accept(this, nullptr);
+  }
+
+  // Assertions and lookarounds don't consume input.
+  void* VisitAssertion(RegExpAssertion* node, void*) override {
+    return EmptyPrefix();
+  }
+
+  void* VisitLookaround(RegExpLookaround* node, void*) override {
+    return EmptyPrefix();
+  }
+
+  void* VisitBackReference(RegExpBackReference* node, void*) override {
+    return nullptr;
+  }
+
+  void* VisitEmpty(RegExpEmpty* node, void*) override { return EmptyPrefix(); }
+
+  PrefixSet* Visit(RegExpTree* tree) {
+    return static_cast<PrefixSet*>(tree->Accept(this, nullptr));
+  }
+
+  // Only ASCII letters are folded.  Other characters with case equivalents
+  // would need the full canonicalization of the irregexp compiler.
+  bool Fold(uc16 c, uc16* folded) {
+    if (ignore_case_ && c >= 0x80) return false;
+    *folded = ignore_case_ ? FoldCase(c) : c;
+    return true;
+  }
+
+  PrefixSet* EmptyPrefix() {
+    PrefixSet* result = new (zone_) PrefixSet(1, zone_);
+    result->Add({Vector<const uc16>(), true}, zone_);
+    return result;
+  }
+
+  static bool IsAnyComplete(PrefixSet* set) {
+    for (const Prefix& prefix : *set) {
+      if (prefix.complete) return true;
+    }
+    return false;
+  }
+
+  static void MarkIncomplete(PrefixSet* set) {
+    for (Prefix& prefix : *set) prefix.complete = false;
+  }
+
+  // Adds `prefix` to `set` unless it is already contained.  An incomplete
+  // prefix subsumes a complete one with the same characters.
+  void Add(PrefixSet* set, Prefix prefix) {
+    for (Prefix& other : *set) {
+      if (other.chars == prefix.chars) {
+        other.complete = other.complete && prefix.complete;
+        return;
+      }
+    }
+    set->Add(prefix, zone_);
+  }
+
+  // Appends each prefix of `tails` to each complete prefix of `heads`.  If
+  // the result can't be shrunk to the limits, the heads alone are returned,
+  // since the matches start with them as well.
+  PrefixSet* Concatenate(PrefixSet* heads, PrefixSet* tails) {
+    PrefixSet* result = new (zone_) PrefixSet(kInitialSize, zone_);
+    for (const Prefix& head : *heads) {
+      if (!head.complete) {
+        Add(result, head);
+        continue;
+      }
+      for (const Prefix& tail : *tails) {
+        int length = head.chars.length() + tail.chars.length();
+        bool complete = tail.complete;
+        if (length > RegExpPrefilter::kMaxLiteralLength) {
+          length = RegExpPrefilter::kMaxLiteralLength;
+          complete = false;
+        }
+        uc16* chars = zone_->NewArray<uc16>(length);
+        for (int i = 0; i < length; i++) {
+          chars[i] = i < head.chars.length()
+                         ? head.chars[i]
+                         : tail.chars[i - head.chars.length()];
+        }
+        Add(result, {Vector<const uc16>(chars, length), complete});
+      }
+    }
+    if (!Shrink(result)) {
+      MarkIncomplete(heads);
+      return heads;
+    }
+    return result;
+  }
+
+  // Shortens the longest prefixes until the set has at most kMaxLiterals
+  // elements.  Returns false if that isn't possible.
+  bool Shrink(PrefixSet* set) {
+    while (set->length() > RegExpPrefilter::kMaxLiterals) {
+      int max_length = 0;
+      for (const Prefix& prefix : *set) {
+        max_length = std::max(max_length, prefix.chars.length());
+      }
+      if (max_length <= 1) return false;
+      PrefixSet shrunk(set->length(), zone_);
+      for (const Prefix& prefix : *set) {
+        if (prefix.chars.length() == max_length) {
+          Add(&shrunk, {prefix.chars.SubVector(0, max_length - 1), false});
+        } else {
+          Add(&shrunk, prefix);
+        }
+      }
+      set->Rewind(0);
+      set->AddAll(shrunk, zone_);
+    }
+    return true;
+  }
+
+  static constexpr int kInitialSize = 4;
+
+  const bool ignore_case_;
+  Zone* zone_;
+};
+
+template <typename Char>
+bool MatchesLiteral(const PrefilterData* data, int literal,
+                    Vector<const Char> subject, int index) {
+  int length = data->literal_lengths[literal];
+  if (index + length > subject.length()) return false;
+  const uc16* chars = data->literals[literal];
+  for (int i = 0; i < length; i++) {
+    uc16 c = subject[index + i];
+    if (data->ignore_case) c = FoldCase(c);
+    if (c != chars[i]) return false;
+  }
+  return true;
+}
+
+template <typename Char>
+bool MatchesAnyLiteral(const PrefilterData* data, Vector<const Char> subject,
+                       int index) {
+  for (int i = 0; i < data->literal_count; i++) {
+    if (MatchesLiteral(data, i, subject, index)) return true;
+  }
+  return false;
+}
+
+template <typename Char>
+int FindCandidateImpl(const PrefilterData* data, Vector<const Char> subject,
+                      int index) {
+  const int last_index = subject.length() - data->min_length;
+
+  if (data->has_common_first_char) {
+    uc16 first_char = data->literals[0][0];
+    if (sizeof(Char) == 1 && first_char > String::kMaxOneByteCharCode) {
+      return -1;
+    }
+    Vector<const uc16> pattern(data->literals[0], data->min_length);
+    while (index <= last_index) {
+      index = FindFirstCharacter(pattern, subject, index);
+      if (index == -1) return -1;
+      if (MatchesAnyLiteral(data, subject, index)) return index;
+      index++;
+    }
+    return -1;
+  }
+
+  const int table_count = std::min(kTableCount, int{data->min_length});
+  for (; index <= last_index; index++) {
+    uint8_t literals = data->tables[0][subject[index] & 0xFF];
+    if (literals == 0) continue;
+    for (int j = 1; j < table_count; j++) {
+      literals &= data->tables[j][subject[index + j] & 0xFF];
+    }
+    while (literals != 0) {
+      int literal = base::bits::CountTrailingZeros(literals);
+      if (MatchesLiteral(data, literal, subject, index)) return index;
+      literals &= literals - 1;
+    }
+  }
+  return -1;
+}
+
+const PrefilterData* GetPrefilterData(ByteArray prefilter) {
+  DCHECK_EQ(prefilter.length(), sizeof(PrefilterData));
+  return reinterpret_cast<const PrefilterData*>(
+      prefilter.GetDataStartAddress());
+}
+
+}  // namespace
+
+// static
+ZoneList<Vector<const uc16>>* RegExpPrefilter::ExtractLiterals(
+    RegExpTree* tree, JSRegExp::Flags flags, Zone* zone) {
+  if ((flags & JSRegExp::kSticky) != 0) return nullptr;
+  // Unicode case folding maps some non-ASCII characters to ASCII letters.
+  const bool is_unicode = (flags & JSRegExp::kUnicode) != 0;
+  if (is_unicode && (flags & JSRegExp::kIgnoreCase) != 0) return nullptr;
+
+  PrefixSet* prefixes = PrefixVisitor::Compute(tree, flags, zone);
+  if (prefixes == nullptr || prefixes->is_empty()) return nullptr;
+
+  ZoneList<Vector<const uc16>>* literals =
+      new (zone) ZoneList<Vector<const uc16>>(prefixes->length(), zone);
+  for (const Prefix& prefix : *prefixes) {
+    if (prefix.chars.empty()) return nullptr;
+    // In unicode mode, a match that starts with a surrogate pair may be found
+    // by stepping back from the trail surrogate at the start index.
+    if (is_unicode && (unibrow::Utf16::IsLeadSurrogate(prefix.chars[0]) ||
+                       unibrow::Utf16::IsTrailSurrogate(prefix.chars[0]))) {
+      return nullptr;
+    }
+    literals->Add(prefix.chars, zone);
+  }
+  return literals;
+}
+
+// static
+Handle<Object> RegExpPrefilter::New(Isolate* isolate, RegExpTree* tree,
+                                    JSRegExp::Flags flags, Zone* zone) {
+  Handle<Object> uninitialized =
+      handle(Smi::FromInt(JSRegExp::kUninitializedValue), isolate);
+  if (!FLAG_regexp_prefilter) return uninitialized;
+
+  ZoneList<Vector<const uc16>>* literals =
+      ExtractLiterals(tree, flags, zone);
+  if (literals == nullptr) return uninitialized;
+
+  Handle<ByteArray> prefilter = isolate->factory()->NewByteArray(
+      sizeof(PrefilterData), AllocationType::kOld);
+  DisallowGarbageCollection no_gc;
+  PrefilterData* data =
+      reinterpret_cast<PrefilterData*>(prefilter->GetDataStartAddress());
+  memset(data, 0, sizeof(PrefilterData));
+
+  data->literal_count = literals->length();
+  data->min_length = kMaxLiteralLength;
+  data->ignore_case = (flags & JSRegExp::kIgnoreCase) != 0;
+  data->has_common_first_char = true;
+  for (int i = 0; i < literals->length(); i++) {
+    Vector<const uc16> literal = literals->at(i);
+    DCHECK(!literal.empty());
+    DCHECK_LE(literal.length(), kMaxLiteralLength);
+    data->literal_lengths[i] = literal.length();
+    data->min_length = std::min(int{data->min_length}, literal.length());
+    std::copy(literal.begin(), literal.end(), data->literals[i]);
+
+    // Folded letters match both cases, memchr only finds one of them.
+    if (literal[0] != data->literals[0][0] ||
+        (data->ignore_case && IsAsciiLower(literal[0]))) {
+      data->has_common_first_char = false;
+    }
+
+    const uint8_t bit = 1 << i;
+    for (int j = 0; j < kTableCount; j++) {
+      if (j >= literal.length()) {
+        for (int c = 0; c < 256; c++) data->tables[j][c] |= bit;
+        continue;
+      }
+      uc16 c = literal[j];
+      data->tables[j][c & 0xFF] |= bit;
+      if (data->ignore_case && IsAsciiLower(c)) {
+        data->tables[j][ToAsciiUpper(c)] |= bit;
+      }
+    }
+  }
+  return prefilter;
+}
+
+// static
+int RegExpPrefilter::FindCandidate(ByteArray prefilter,
+                                   Vector<const uint8_t> subject, int index) {
+  return FindCandidateImpl(GetPrefilterData(prefilter), subject, index);
+}
+
+// static
+int RegExpPrefilter::FindCandidate(ByteArray prefilter,
+                                   Vector<const uc16> subject, int index) {
+  return FindCandidateImpl(GetPrefilterData(prefilter), subject, index);
+}
+
+// static
+int RegExpPrefilter::FindCandidate(ByteArray prefilter, String subject,
+                                   int index) {
+  DisallowGarbageCollection no_gc;
+  String::FlatContent content = subject.GetFlatContent(no_gc);
+  DCHECK(content.IsFlat());
+  if (content.IsOneByte()) {
+    return FindCandidate(prefilter, content.ToOneByteVector(), index);
+  }
+  return FindCandidate(prefilter, content.ToUC16Vector(), index);
+}
+
+// static
+int RegExpPrefilter::FindCandidateForCallFromJs(Address prefilter,
+                                                Address input_start,
+                                                Address input_end,
+                                                int is_one_byte) {
+  DisallowGarbageCollection no_gc;
+  ByteArray prefilter_array = ByteArray::cast(Object(prefilter));
+  if (is_one_byte) {
+    return FindCandidate(
+        prefilter_array,
+        Vector<const uint8_t>(reinterpret_cast<const uint8_t*>(input_start),
+                              static_cast<int>(input_end - input_start)),
+        0);
+  }
+  return FindCandidate(
+      prefilter_array,
+      Vector<const uc16>(reinterpret_cast<const uc16*>(input_start),
+                         static_cast<int>((input_end - input_start) /
+                                          sizeof(uc16))),
+      0);
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,67 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_REGEXP_REGEXP_PREFILTER_H_
+#define V8_REGEXP_REGEXP_PREFILTER_H_
+
+#include "src/objects/js-regexp.h"
+#include "src/utils/vector.h"
+#include "src/zone/zone-list.h"
+
+namespace v8 {
+namespace internal {
+
+class RegExpTree;
+
+// A prefilter for regexps all of whose matches start with one of a small set
+// of literals, e.g. /(GET|POST|PUT) \/api/ or /error: \d+/i.  Before the
+// matcher runs, the prefilter skips to the next position at which one of the
+// literals occurs, so that neither irregexp nor the experimental engine are
+// started at positions which cannot begin a match.
+//
+// The literals are searched with memchr if they share their first character.
+// Otherwise a Teddy-style table per leading character position holds a bit
+// for each literal that has the character at that position; candidates are
+// the positions at which the tables of the leading characters intersect, and
+// only the literals in the intersection are compared.
+//
+// The prefilter is stored as a ByteArray in the regexp data, see
+// JSRegExp::kIrregexpPrefilterIndex.
+class RegExpPrefilter final : public AllStatic {
+ public:
+  static constexpr int kMaxLiterals = 8;
+  static constexpr int kMaxLiteralLength = 8;
+
+  // Returns the literals one of which every match of `tree` starts with, or
+  // nullptr if there is no such set within the limits above.  Under the
+  // ignore case flag, ASCII letters are folded to lower case.  Sticky regexps
+  // never get literals, since they only match at lastIndex anyway.
+  V8_EXPORT_PRIVATE static ZoneList<Vector<const uc16>>* ExtractLiterals(
+      RegExpTree* tree, JSRegExp::Flags flags, Zone* zone);
+
+  // Returns the prefilter for a parsed regexp, or the uninitialized sentinel
+  // if it doesn't have a set of leading literals.
+  static Handle<Object> New(Isolate* isolate, RegExpTree* tree,
+                            JSRegExp::Flags flags, Zone* zone);
+
+  // Returns the first index at or after `index` at which a match can start,
+  // or -1 if there is none.  `subject` has to be flat.
+  V8_EXPORT_PRIVATE static int FindCandidate(ByteArray prefilter,
+                                             String subject, int index);
+  static int FindCandidate(ByteArray prefilter, Vector<const uint8_t> subject,
+                           int index);
+  static int FindCandidate(ByteArray prefilter, Vector<const uc16> subject,
+                           int index);
+
+  // Called from RegExpExecInternal before the regexp code.  Returns the
+  // offset in characters from `input_start` of the first position at which a
+  // match can start, or -1 if there is none.
+  static int FindCandidateForCallFromJs(Address prefilter, Address input_start,
+                                        Address input_end, int is_one_byte);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_REGEXP_REGEXP_PREFILTER_H_
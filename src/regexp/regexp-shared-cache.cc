@@ -0,0 +1,111 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/regexp/regexp-shared-cache.h"
+
+#include "src/base/functional.h"
+#include "src/base/lazy-instance.h"
+#include "src/flags/flags.h"
+#include "src/objects/js-regexp-inl.h"
+#include "src/objects/string-inl.h"
+
+namespace v8 {
+namespace internal {
+
+namespace {
+
+DEFINE_LAZY_LEAKY_OBJECT_GETTER(RegExpSharedCache, GetSharedCache)
+
+}  // namespace
+
+size_t RegExpSharedCache::Entry::Size() const {
+  size_t size = sizeof(Entry) + bytecode.size() + prefilter.size();
+  for (const auto& capture_name : capture_names) {
+    size += sizeof(capture_name) + capture_name.first.size() * sizeof(uc16);
+  }
+  return size;
+}
+
+// static
+RegExpSharedCache* RegExpSharedCache::Get() { return GetSharedCache(); }
+
+std::shared_ptr<const RegExpSharedCache::Entry> RegExpSharedCache::Lookup(
+    JSRegExp regexp, bool is_one_byte, uint32_t backtrack_limit) {
+  Key key = KeyFor(regexp, is_one_byte, backtrack_limit);
+  base::MutexGuard guard(&mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) return nullptr;
+  // Move the entry to the front.
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->second;
+}
+
+void RegExpSharedCache::Insert(JSRegExp regexp, bool is_one_byte,
+                               uint32_t backtrack_limit,
+                               std::shared_ptr<const Entry> entry) {
+  Key key = KeyFor(regexp, is_one_byte, backtrack_limit);
+  const size_t entry_size = SizeOf(key, *entry);
+  const size_t max_size = FLAG_regexp_shared_cache_size * KB;
+  if (entry_size > max_size) return;
+
+  base::MutexGuard guard(&mutex_);
+  // Another isolate may have compiled the same regexp in the meantime.
+  if (index_.count(key) != 0) return;
+  EvictUntilSize(max_size - entry_size);
+  entries_.emplace_front(std::move(key), std::move(entry));
+  index_.emplace(entries_.front().first, entries_.begin());
+  size_ += entry_size;
+}
+
+size_t RegExpSharedCache::size() {
+  base::MutexGuard guard(&mutex_);
+  return size_;
+}
+
+void RegExpSharedCache::Clear() {
+  base::MutexGuard guard(&mutex_);
+  index_.clear();
+  entries_.clear();
+  size_ = 0;
+}
+
+size_t RegExpSharedCache::KeyHash::operator()(const Key& key) const {
+  return base::hash_combine(
+      base::hash_range(key.source.begin(), key.source.end()), key.flags,
+      key.is_one_byte, key.backtrack_limit);
+}
+
+// static
+RegExpSharedCache::Key RegExpSharedCache::KeyFor(JSRegExp regexp,
+                                                 bool is_one_byte,
+                                                 uint32_t backtrack_limit) {
+  DisallowGarbageCollection no_gc;
+  String source = regexp.Pattern();
+  Key key;
+  key.source.resize(source.length());
+  String::WriteToFlat(source, key.source.data(), 0, source.length());
+  key.flags = static_cast<int>(regexp.GetFlags());
+  key.is_one_byte = is_one_byte;
+  key.backtrack_limit = backtrack_limit;
+  return key;
+}
+
+// static
+size_t RegExpSharedCache::SizeOf(const Key& key, const Entry& entry) {
+  return sizeof(Key) + key.source.size() * sizeof(uc16) + entry.Size();
+}
+
+void RegExpSharedCache::EvictUntilSize(size_t max_size) {
+  while (size_ > max_size) {
+    DCHECK(!entries_.empty());
+    const auto& last = entries_.back();
+    size_ -= SizeOf(last.first, *last.second);
+    index_.erase(last.first);
+    // Isolates that are copying the entry keep it alive.
+    entries_.pop_back();
+  }
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,107 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_REGEXP_REGEXP_SHARED_CACHE_H_
+#define V8_REGEXP_REGEXP_SHARED_CACHE_H_
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "src/base/platform/mutex.h"
+#include "src/handles/handles.h"
+#include "src/objects/js-regexp.h"
+
+namespace v8 {
+namespace internal {
+
+// A process-wide cache of irregexp bytecode, shared by all isolates and
+// enabled with --regexp-shared-cache.  Processes that run many isolates with
+// the same regexps, e.g. a pool of workers, compile the bytecode of each
+// regexp once instead of once per isolate.
+//
+// Entries live outside of any heap and are immutable.  Isolates copy them
+// into their own heap on a hit, so an isolate never holds on to an entry.
+// Entries are reference counted so that an entry which is evicted while an
+// isolate copies it stays alive until the copy is done.  The size of the
+// cache is bounded by --regexp-shared-cache-size; the least recently used
+// entries are evicted first.
+//
+// Native code is not cached: it embeds absolute addresses and references to
+// objects of the isolate that compiled it.  Regexps that tier up compile
+// native code in every isolate.
+class V8_EXPORT_PRIVATE RegExpSharedCache final {
+ public:
+  // The parts of the compiled data of an irregexp regexp which aren't
+  // determined by its source and flags.
+  struct Entry {
+    std::vector<uint8_t> bytecode;
+    int register_count = 0;
+    // The backtrack limit after compilation, which may be lowered to fall
+    // back to the experimental engine.
+    uint32_t backtrack_limit = JSRegExp::kNoBacktrackLimit;
+    // The names and indices of the named capture groups, by index.
+    std::vector<std::pair<std::vector<uc16>, int>> capture_names;
+    // The prefilter, empty if there is none.
+    std::vector<uint8_t> prefilter;
+
+    size_t Size() const;
+  };
+
+  // Returns the process-wide cache.
+  static RegExpSharedCache* Get();
+
+  RegExpSharedCache() = default;
+  RegExpSharedCache(const RegExpSharedCache&) = delete;
+  RegExpSharedCache& operator=(const RegExpSharedCache&) = delete;
+
+  // Returns the entry for the bytecode of `regexp` for one- or two-byte
+  // subjects and the backtrack limit before compilation, or nullptr.
+  std::shared_ptr<const Entry> Lookup(JSRegExp regexp, bool is_one_byte,
+                                      uint32_t backtrack_limit);
+  // Adds an entry, unless it is larger than the cache.  An existing entry
+  // for the same regexp is kept.
+  void Insert(JSRegExp regexp, bool is_one_byte, uint32_t backtrack_limit,
+              std::shared_ptr<const Entry> entry);
+
+  // The size of all entries, in bytes.
+  size_t size();
+  void Clear();
+
+ private:
+  struct Key {
+    std::vector<uc16> source;
+    int flags;
+    bool is_one_byte;
+    uint32_t backtrack_limit;
+
+    bool operator==(const Key& other) const {
+      return flags == other.flags && is_one_byte == other.is_one_byte &&
+             backtrack_limit == other.backtrack_limit &&
+             source == other.source;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+  using List = std::list<std::pair<Key, std::shared_ptr<const Entry>>>;
+
+  static Key KeyFor(JSRegExp regexp, bool is_one_byte,
+                    uint32_t backtrack_limit);
+  static size_t SizeOf(const Key& key, const Entry& entry);
+  void EvictUntilSize(size_t max_size);
+
+  base::Mutex mutex_;
+  // The entries, most recently used first.
+  List entries_;
+  std::unordered_map<Key, List::iterator, KeyHash> index_;
+  size_t size_ = 0;
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_REGEXP_REGEXP_SHARED_CACHE_H_
@@ -0,0 +1,111 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/regexp/regexp-stats.h"
+
+#include <algorithm>
+
+#include "src/execution/isolate.h"
+#include "src/objects/js-regexp-inl.h"
+#include "src/objects/string-inl.h"
+
+namespace v8 {
+namespace internal {
+
+void RegExpStats::Scope::Enter(Isolate* isolate, Handle<JSRegExp> regexp) {
+  stats_ = isolate->regexp_stats();
+  DCHECK_NOT_NULL(stats_);
+  entry_index_ = stats_->LookupOrInsert(isolate, regexp);
+  Entry& entry = stats_->entries_[entry_index_];
+  entry.executions++;
+  entry.executions_per_engine[static_cast<int>(EngineFor(*regexp))]++;
+  outer_entry_index_ = stats_->current_entry_index_;
+  stats_->current_entry_index_ = entry_index_;
+  start_ = base::TimeTicks::Now();
+}
+
+void RegExpStats::Scope::Leave() {
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start_;
+  // The statistics may have been reset during the execution.
+  if (entry_index_ < static_cast<int>(stats_->entries_.size())) {
+    stats_->entries_[entry_index_].total_time += elapsed;
+  }
+  stats_->current_entry_index_ = outer_entry_index_;
+}
+
+void RegExpStats::RecordBacktracks(uint64_t backtracks) {
+  if (current_entry_index_ < 0 ||
+      current_entry_index_ >= static_cast<int>(entries_.size())) {
+    return;
+  }
+  entries_[current_entry_index_].backtracks += backtracks;
+}
+
+void RegExpStats::RecordBacktrackLimitFallback() {
+  if (current_entry_index_ < 0 ||
+      current_entry_index_ >= static_cast<int>(entries_.size())) {
+    return;
+  }
+  entries_[current_entry_index_].backtrack_limit_fallbacks++;
+}
+
+std::vector<RegExpStats::Entry> RegExpStats::SortedEntries() const {
+  std::vector<Entry> result(entries_);
+  std::stable_sort(result.begin(), result.end(),
+                   [](const Entry& a, const Entry& b) {
+                     return a.total_time > b.total_time;
+                   });
+  return result;
+}
+
+void RegExpStats::Reset() {
+  entries_.clear();
+  entry_indices_.clear();
+  current_entry_index_ = -1;
+}
+
+// static
+RegExpStats::Engine RegExpStats::EngineFor(JSRegExp regexp) {
+  switch (regexp.TypeTag()) {
+    case JSRegExp::ATOM:
+      return Engine::kAtom;
+    case JSRegExp::IRREGEXP:
+      return regexp.ShouldProduceBytecode() ? Engine::kBytecode
+                                            : Engine::kNativeCode;
+    case JSRegExp::EXPERIMENTAL:
+      return Engine::kExperimental;
+    case JSRegExp::NOT_COMPILED:
+      break;
+  }
+  UNREACHABLE();
+}
+
+int RegExpStats::LookupOrInsert(Isolate* isolate, Handle<JSRegExp> regexp) {
+  DisallowGarbageCollection no_gc;
+  String source = regexp->Pattern();
+  JSRegExp::Flags flags = regexp->GetFlags();
+  uint32_t hash = source.EnsureHash();
+
+  auto range = entry_indices_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry& entry = entries_[it->second];
+    if (entry.flags == flags &&
+        source.IsEqualTo(VectorOf(entry.source_chars), isolate)) {
+      return it->second;
+    }
+  }
+
+  Entry entry;
+  entry.source = source.ToCString().get();
+  entry.flags = flags;
+  entry.source_chars.resize(source.length());
+  String::WriteToFlat(source, entry.source_chars.data(), 0, source.length());
+  entries_.push_back(std::move(entry));
+  int index = static_cast<int>(entries_.size()) - 1;
+  entry_indices_.emplace(hash, index);
+  return index;
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,106 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_REGEXP_REGEXP_STATS_H_
+#define V8_REGEXP_REGEXP_STATS_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "src/base/platform/time.h"
+#include "src/flags/flags.h"
+#include "src/handles/handles.h"
+#include "src/objects/js-regexp.h"
+
+namespace v8 {
+namespace internal {
+
+// Execution statistics of the regexps of an isolate, collected with
+// --regexp-stats.  Regexps with the same source and flags share their
+// statistics, just like they share their compiled data through the
+// compilation cache.
+//
+// Executions are recorded in RegExp::Exec and RegExpGlobalCache, which all
+// executions go through while the flag is set, since RegExpExecInternal then
+// calls into the runtime instead of running the regexp code directly.  The
+// time of an execution includes compiling the regexp if needed.
+// An execution is a single run of an engine, not a match: global regexps
+// find their matches in batches, and each batch counts as one execution.  A
+// String.prototype.replace of a global atom regexp is a single execution.
+// Backtracks are only counted by the bytecode interpreter.  For native code,
+// only the executions that exceeded the backtrack limit and fell back to the
+// experimental engine are counted.
+class RegExpStats final {
+ public:
+  // The engine an execution was started on.
+  enum class Engine { kAtom, kBytecode, kNativeCode, kExperimental };
+  static constexpr int kEngineCount = 4;
+
+  struct Entry {
+    std::string source;  // UTF-8.
+    JSRegExp::Flags flags;
+    uint64_t executions = 0;  // Engine runs, see above.
+    uint64_t executions_per_engine[kEngineCount] = {};
+    base::TimeDelta total_time;
+    uint64_t backtracks = 0;
+    uint64_t backtrack_limit_fallbacks = 0;
+
+    // The UTF-16 code units of the source, to tell apart sources with the
+    // same hash.
+    std::vector<uc16> source_chars;
+  };
+
+  // Records an execution of a regexp between construction and destruction.
+  // Does nothing if --regexp-stats isn't set.
+  class V8_NODISCARD Scope final {
+   public:
+    Scope(Isolate* isolate, Handle<JSRegExp> regexp) {
+      if (V8_UNLIKELY(FLAG_regexp_stats)) Enter(isolate, regexp);
+    }
+    ~Scope() {
+      if (V8_UNLIKELY(stats_ != nullptr)) Leave();
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    void Enter(Isolate* isolate, Handle<JSRegExp> regexp);
+    void Leave();
+
+    RegExpStats* stats_ = nullptr;
+    int entry_index_ = -1;
+    int outer_entry_index_ = -1;
+    base::TimeTicks start_;
+  };
+
+  RegExpStats() = default;
+  RegExpStats(const RegExpStats&) = delete;
+  RegExpStats& operator=(const RegExpStats&) = delete;
+
+  // Adds to the statistics of the regexp whose execution is being recorded,
+  // if any.
+  void RecordBacktracks(uint64_t backtracks);
+  void RecordBacktrackLimitFallback();
+
+  // Returns the entries ordered by total time, most first.
+  std::vector<Entry> SortedEntries() const;
+  void Reset();
+
+ private:
+  static Engine EngineFor(JSRegExp regexp);
+  int LookupOrInsert(Isolate* isolate, Handle<JSRegExp> regexp);
+
+  std::vector<Entry> entries_;
+  // Indices into `entries_` by the hash of the source.
+  std::unordered_multimap<uint32_t, int> entry_indices_;
+  // The entry of the execution being recorded, or -1.
+  int current_entry_index_ = -1;
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_REGEXP_REGEXP_STATS_H_
@@ -17,6 +17,9 @@
 #include "src/regexp/regexp-macro-assembler-arch.h"
 #include "src/regexp/regexp-macro-assembler-tracer.h"
 #include "src/regexp/regexp-parser.h"
+#include "src/regexp/regexp-prefilter.h"
+#include "src/regexp/regexp-shared-cache.h"
+#include "src/regexp/regexp-stats.h"
 #include "src/regexp/regexp-utils.h"
 #include "src/strings/string-search.h"
 #include "src/utils/ostreams.h"
@@ -80,6 +83,15 @@ class RegExpImpl final : public AllStatic {
 
   static bool CompileIrregexp(Isolate* isolate, Handle<JSRegExp> re,
                               Handle<String> sample_subject, bool is_one_byte);
+  // Installs bytecode from the shared cache, see RegExpSharedCache.  Returns
+  // false if there is no entry.
+  static bool CompileIrregexpFromSharedCache(Isolate* isolate,
+                                             Handle<JSRegExp> re,
+                                             bool is_one_byte,
+                                             uint32_t backtrack_limit);
+  static void AddIrregexpToSharedCache(Handle<JSRegExp> re, bool is_one_byte,
+                                       uint32_t backtrack_limit,
+                                       int register_count);
   static inline bool EnsureCompiledIrregexp(Isolate* isolate,
                                             Handle<JSRegExp> re,
                                             Handle<String> sample_subject,
@@ -256,8 +268,7 @@ bool RegExp::EnsureFullyCompiled(Isolate* isolate, Handle<JSRegExp> re,
       }
       return true;
     case JSRegExp::EXPERIMENTAL:
-      if (!ExperimentalRegExp::IsCompiled(re, isolate) &&
-          !ExperimentalRegExp::Compile(isolate, re)) {
+      if (!ExperimentalRegExp::Prepare(isolate, re, subject)) {
         DCHECK(isolate->has_pending_exception());
         return false;
       }
@@ -265,6 +276,89 @@ bool RegExp::EnsureFullyCompiled(Isolate* isolate, Handle<JSRegExp> re,
   }
 }
 
+// static
+MaybeHandle<FixedArray> RegExp::CopyDataForCodeCache(Isolate* isolate,
+                                                     Handle<FixedArray> data) {
+  const Smi uninitialized = Smi::FromInt(JSRegExp::kUninitializedValue);
+  const bool is_irregexp =
+      data->get(JSRegExp::kTagIndex) == Smi::FromInt(JSRegExp::IRREGEXP);
+  const bool is_experimental =
+      data->get(JSRegExp::kTagIndex) == Smi::FromInt(JSRegExp::EXPERIMENTAL);
+  // Atom regexps are cheap to compile.
+  if (!is_irregexp && !is_experimental) return MaybeHandle<FixedArray>();
+  DCHECK_EQ(data->length(), JSRegExp::kIrregexpDataSize);
+
+  bool has_bytecode = false;
+  bool has_native_code = false;
+  for (bool is_one_byte : {true, false}) {
+    if (data->get(JSRegExp::bytecode_index(is_one_byte)).IsByteArray()) {
+      has_bytecode = true;
+    } else if (data->get(JSRegExp::code_index(is_one_byte)) != uninitialized) {
+      has_native_code = true;
+    }
+  }
+  if (!has_bytecode && !has_native_code) return MaybeHandle<FixedArray>();
+
+  Handle<FixedArray> copy = isolate->factory()->CopyFixedArray(data);
+  copy->set(JSRegExp::kIrregexpLatin1CodeIndex, uninitialized);
+  copy->set(JSRegExp::kIrregexpUC16CodeIndex, uninitialized);
+  copy->set(JSRegExp::kIrregexpExperimentalFallbackIndex, uninitialized);
+  if (!is_irregexp &&
+      Code::cast(data->get(JSRegExp::kIrregexpLatin1CodeIndex)).kind() ==
+          CodeKind::REGEXP) {
+    // Experimental regexps keep their bytecode after tier-up, so they start
+    // on the interpreter and tier up again right away.
+    copy->set(JSRegExp::kIrregexpTicksUntilTierUpIndex, Smi::zero());
+  }
+  if (has_native_code) {
+    // Skip the interpreter when the regexp is used again.
+    DCHECK(is_irregexp);
+    copy->set(JSRegExp::kIrregexpLatin1BytecodeIndex, uninitialized);
+    copy->set(JSRegExp::kIrregexpUC16BytecodeIndex, uninitialized);
+    copy->set(JSRegExp::kIrregexpTicksUntilTierUpIndex, Smi::zero());
+  }
+  return copy;
+}
+
+// static
+void RegExp::AddDataFromCodeCache(Isolate* isolate, Handle<FixedArray> data) {
+  CHECK_EQ(data->length(), JSRegExp::kIrregexpDataSize);
+  const bool is_experimental =
+      data->get(JSRegExp::kTagIndex) == Smi::FromInt(JSRegExp::EXPERIMENTAL);
+  CHECK(is_experimental ||
+        data->get(JSRegExp::kTagIndex) == Smi::FromInt(JSRegExp::IRREGEXP));
+
+  Handle<String> source(String::cast(data->get(JSRegExp::kSourceIndex)),
+                        isolate);
+  JSRegExp::Flags flags(Smi::ToInt(data->get(JSRegExp::kFlagsIndex)));
+  CompilationCache* compilation_cache = isolate->compilation_cache();
+  // Regexps that were compiled in the meantime keep their own data.
+  if (!compilation_cache->LookupRegExp(source, flags).is_null()) return;
+
+  Handle<Code> trampoline =
+      is_experimental ? BUILTIN_CODE(isolate, RegExpExperimentalTrampoline)
+                      : BUILTIN_CODE(isolate, RegExpInterpreterTrampoline);
+  for (bool is_one_byte : {true, false}) {
+    if (data->get(JSRegExp::bytecode_index(is_one_byte)).IsByteArray()) {
+      data->set(JSRegExp::code_index(is_one_byte), *trampoline);
+    }
+  }
+  compilation_cache->PutRegExp(source, flags, data);
+}
+
+// static
+int RegExp::IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
+                            Handle<String> subject, int index, int32_t* output,
+                            int output_size) {
+  DCHECK_EQ(regexp->TypeTag(), JSRegExp::IRREGEXP);
+  if (RegExpImpl::IrregexpPrepare(isolate, regexp, subject) < 0) {
+    DCHECK(isolate->has_pending_exception());
+    return RE_EXCEPTION;
+  }
+  return RegExpImpl::IrregexpExecRaw(isolate, regexp, subject, index, output,
+                                     output_size);
+}
+
 // static
 MaybeHandle<Object> RegExp::ExperimentalOneshotExec(
     Isolate* isolate, Handle<JSRegExp> regexp, Handle<String> subject,
@@ -277,6 +371,7 @@ MaybeHandle<Object> RegExp::ExperimentalOneshotExec(
 MaybeHandle<Object> RegExp::Exec(Isolate* isolate, Handle<JSRegExp> regexp,
                                  Handle<String> subject, int index,
                                  Handle<RegExpMatchInfo> last_match_info) {
+  RegExpStats::Scope stats_scope(isolate, regexp);
   switch (regexp->TypeTag()) {
     case JSRegExp::NOT_COMPILED:
       UNREACHABLE();
@@ -455,6 +550,23 @@ bool RegExpImpl::CompileIrregexp(Isolate* isolate, Handle<JSRegExp> re,
 
   DCHECK(RegExpCodeIsValidForPreCompilation(re, is_one_byte));
 
+  // Irregexps that the experimental engine falls back to are compiled without
+  // a backtrack limit, see JSRegExp::kExperimentalIrregexpFallbackIndex.
+  const bool can_fallback_to_experimental =
+      re->DataAt(JSRegExp::kIrregexpExperimentalFallbackIndex) !=
+      Smi::FromInt(JSRegExp::kNoExperimentalFallbackValue);
+
+  // The bytecode may have been compiled by another isolate already.
+  const bool use_shared_cache = FLAG_regexp_shared_cache &&
+                                re->ShouldProduceBytecode() &&
+                                can_fallback_to_experimental;
+  const uint32_t initial_backtrack_limit = re->BacktrackLimit();
+  if (use_shared_cache &&
+      CompileIrregexpFromSharedCache(isolate, re, is_one_byte,
+                                     initial_backtrack_limit)) {
+    return true;
+  }
+
   JSRegExp::Flags flags = re->GetFlags();
 
   Handle<String> pattern(re->Pattern(), isolate);
@@ -468,6 +580,15 @@ bool RegExpImpl::CompileIrregexp(Isolate* isolate, Handle<JSRegExp> re,
     USE(RegExp::ThrowRegExpException(isolate, re, pattern, compile_data.error));
     return false;
   }
+  // The prefilter only depends on the pattern, so it is shared by the one- and
+  // two-byte code.  It has to be computed before the compiler rewrites the
+  // tree.
+  if (re->DataAt(JSRegExp::kIrregexpPrefilterIndex) ==
+      Smi::FromInt(JSRegExp::kUninitializedValue)) {
+    Handle<Object> prefilter =
+        RegExpPrefilter::New(isolate, compile_data.tree, flags, &zone);
+    re->SetDataAt(JSRegExp::kIrregexpPrefilterIndex, *prefilter);
+  }
   // The compilation target is a kBytecode if we're interpreting all regexp
   // objects, or if we're using the tier-up strategy but the tier-up hasn't
   // happened yet. The compilation target is a kNative if we're using the
@@ -476,6 +597,7 @@ bool RegExpImpl::CompileIrregexp(Isolate* isolate, Handle<JSRegExp> re,
   compile_data.compilation_target = re->ShouldProduceBytecode()
                                         ? RegExpCompilationTarget::kBytecode
                                         : RegExpCompilationTarget::kNative;
+  compile_data.can_fallback_to_experimental = can_fallback_to_experimental;
   uint32_t backtrack_limit = re->BacktrackLimit();
   const bool compilation_succeeded =
       Compile(isolate, &zone, &compile_data, flags, pattern, sample_subject,
@@ -511,6 +633,13 @@ bool RegExpImpl::CompileIrregexp(Isolate* isolate, Handle<JSRegExp> re,
   }
   data->set(JSRegExp::kIrregexpBacktrackLimit, Smi::FromInt(backtrack_limit));
 
+  if (use_shared_cache) {
+    DCHECK_EQ(compile_data.compilation_target,
+              RegExpCompilationTarget::kBytecode);
+    AddIrregexpToSharedCache(re, is_one_byte, initial_backtrack_limit,
+                             compile_data.register_count);
+  }
+
   if (FLAG_trace_regexp_tier_up) {
     PrintF("JSRegExp object %p %s size: %d\n",
            reinterpret_cast<void*>(re->ptr()),
@@ -523,6 +652,100 @@ bool RegExpImpl::CompileIrregexp(Isolate* isolate, Handle<JSRegExp> re,
   return true;
 }
 
+// static
+bool RegExpImpl::CompileIrregexpFromSharedCache(Isolate* isolate,
+                                                Handle<JSRegExp> re,
+                                                bool is_one_byte,
+                                                uint32_t backtrack_limit) {
+  // The entry stays alive while it is copied, even if it is evicted.
+  std::shared_ptr<const RegExpSharedCache::Entry> entry =
+      RegExpSharedCache::Get()->Lookup(*re, is_one_byte, backtrack_limit);
+  if (!entry) return false;
+
+  Factory* factory = isolate->factory();
+  const int bytecode_length = static_cast<int>(entry->bytecode.size());
+  Handle<ByteArray> bytecode = factory->NewByteArray(bytecode_length);
+  bytecode->copy_in(0, entry->bytecode.data(), bytecode_length);
+  isolate->IncreaseTotalRegexpCodeGenerated(bytecode);
+
+  Handle<FixedArray> capture_name_map;
+  if (!entry->capture_names.empty()) {
+    const int capture_name_count =
+        static_cast<int>(entry->capture_names.size());
+    capture_name_map = factory->NewFixedArray(capture_name_count * 2);
+    for (int i = 0; i < capture_name_count; i++) {
+      const auto& capture_name = entry->capture_names[i];
+      // See RegExpParser::CreateCaptureNameMap.
+      Handle<String> name =
+          factory->InternalizeString(VectorOf(capture_name.first));
+      capture_name_map->set(i * 2, *name);
+      capture_name_map->set(i * 2 + 1, Smi::FromInt(capture_name.second));
+    }
+  }
+
+  if (!entry->prefilter.empty() &&
+      re->DataAt(JSRegExp::kIrregexpPrefilterIndex) ==
+          Smi::FromInt(JSRegExp::kUninitializedValue)) {
+    const int prefilter_length = static_cast<int>(entry->prefilter.size());
+    Handle<ByteArray> prefilter =
+        factory->NewByteArray(prefilter_length, AllocationType::kOld);
+    prefilter->copy_in(0, entry->prefilter.data(), prefilter_length);
+    re->SetDataAt(JSRegExp::kIrregexpPrefilterIndex, *prefilter);
+  }
+
+  Handle<FixedArray> data(FixedArray::cast(re->data()), isolate);
+  data->set(JSRegExp::bytecode_index(is_one_byte), *bytecode);
+  data->set(JSRegExp::code_index(is_one_byte),
+            *BUILTIN_CODE(isolate, RegExpInterpreterTrampoline));
+  re->SetCaptureNameMap(capture_name_map);
+  if (entry->register_count > IrregexpMaxRegisterCount(*data)) {
+    SetIrregexpMaxRegisterCount(*data, entry->register_count);
+  }
+  data->set(JSRegExp::kIrregexpBacktrackLimit,
+            Smi::FromInt(entry->backtrack_limit));
+  return true;
+}
+
+// static
+void RegExpImpl::AddIrregexpToSharedCache(Handle<JSRegExp> re,
+                                          bool is_one_byte,
+                                          uint32_t backtrack_limit,
+                                          int register_count) {
+  DisallowGarbageCollection no_gc;
+  auto entry = std::make_shared<RegExpSharedCache::Entry>();
+
+  FixedArray data = FixedArray::cast(re->data());
+  ByteArray bytecode = IrregexpByteCode(data, is_one_byte);
+  entry->bytecode.assign(
+      bytecode.GetDataStartAddress(),
+      bytecode.GetDataStartAddress() + bytecode.length());
+  entry->register_count = register_count;
+  entry->backtrack_limit = re->BacktrackLimit();
+
+  Object capture_name_map = re->CaptureNameMap();
+  if (capture_name_map.IsFixedArray()) {
+    FixedArray map = FixedArray::cast(capture_name_map);
+    for (int i = 0; i < map.length(); i += 2) {
+      String name = String::cast(map.get(i));
+      std::vector<uc16> chars(name.length());
+      String::WriteToFlat(name, chars.data(), 0, name.length());
+      entry->capture_names.emplace_back(std::move(chars),
+                                        Smi::ToInt(map.get(i + 1)));
+    }
+  }
+
+  Object prefilter = re->DataAt(JSRegExp::kIrregexpPrefilterIndex);
+  if (prefilter.IsByteArray()) {
+    ByteArray prefilter_array = ByteArray::cast(prefilter);
+    entry->prefilter.assign(
+        prefilter_array.GetDataStartAddress(),
+        prefilter_array.GetDataStartAddress() + prefilter_array.length());
+  }
+
+  RegExpSharedCache::Get()->Insert(*re, is_one_byte, backtrack_limit,
+                                   std::move(entry));
+}
+
 int RegExpImpl::IrregexpMaxRegisterCount(FixedArray re) {
   return Smi::ToInt(re.get(JSRegExp::kIrregexpMaxRegisterCountIndex));
 }
@@ -578,6 +801,14 @@ int RegExpImpl::IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
   DCHECK_GE(output_size,
             JSRegExp::RegistersForCaptureCount(regexp->CaptureCount()));
 
+  // Skip positions at which none of the leading literals occurs.
+  Object prefilter = regexp->DataAt(JSRegExp::kIrregexpPrefilterIndex);
+  if (prefilter.IsByteArray()) {
+    index = RegExpPrefilter::FindCandidate(ByteArray::cast(prefilter),
+                                           *subject, index);
+    if (index == -1) return RegExp::RE_FAILURE;
+  }
+
   bool is_one_byte = String::IsOneByteRepresentationUnderneath(*subject);
 
   if (!regexp->ShouldProduceBytecode()) {
@@ -695,6 +926,9 @@ MaybeHandle<Object> RegExpImpl::IrregexpExec(
     return RegExp::SetLastMatchInfo(isolate, last_match_info, subject,
                                     capture_count, output_registers);
   } else if (res == RegExp::RE_FALLBACK_TO_EXPERIMENTAL) {
+    if (isolate->regexp_stats() != nullptr) {
+      isolate->regexp_stats()->RecordBacktrackLimitFallback();
+    }
     return ExperimentalRegExp::OneshotExec(isolate, regexp, subject,
                                            previous_index, last_match_info);
   } else if (res == RegExp::RE_EXCEPTION) {
@@ -861,6 +1095,7 @@ bool RegExpImpl::Compile(Isolate* isolate, Zone* zone, RegExpCompileData* data,
 
   macro_assembler->set_slow_safe(TooMuchRegExpCode(isolate, pattern));
   if (FLAG_enable_experimental_regexp_engine_on_excessive_backtracks &&
+      data->can_fallback_to_experimental &&
       ExperimentalRegExp::CanBeHandled(data->tree, flags,
                                        data->capture_count)) {
     if (backtrack_limit == JSRegExp::kNoBacktrackLimit) {
@@ -952,8 +1187,6 @@ RegExpGlobalCache::RegExpGlobalCache(Handle<JSRegExp> regexp,
       regexp_(regexp),
       subject_(subject),
       isolate_(isolate) {
-  DCHECK(IsGlobal(regexp->GetFlags()));
-
   switch (regexp_->TypeTag()) {
     case JSRegExp::NOT_COMPILED:
       UNREACHABLE();
@@ -972,9 +1205,10 @@ RegExpGlobalCache::RegExpGlobalCache(Handle<JSRegExp> regexp,
         num_matches_ = -1;  // Signal exception.
         return;
       }
-      if (regexp->ShouldProduceBytecode()) {
-        // Global loop in interpreted regexp is not implemented.  We choose the
-        // size of the offsets vector so that it can only store one match.
+      if (regexp->ShouldProduceBytecode() || !IsGlobal(regexp->GetFlags())) {
+        // Global loop in interpreted regexp is not implemented, and native code
+        // only has a global loop for global regexps.  We choose the size of
+        // the offsets vector so that it can only store one match.
         register_array_size_ = registers_per_match_;
         max_matches_ = 1;
       } else {
@@ -984,8 +1218,7 @@ RegExpGlobalCache::RegExpGlobalCache(Handle<JSRegExp> regexp,
       break;
     }
     case JSRegExp::EXPERIMENTAL: {
-      if (!ExperimentalRegExp::IsCompiled(regexp, isolate_) &&
-          !ExperimentalRegExp::Compile(isolate_, regexp)) {
+      if (!ExperimentalRegExp::Prepare(isolate_, regexp, subject)) {
         DCHECK(isolate->has_pending_exception());
         num_matches_ = -1;  // Signal exception.
         return;
@@ -1051,6 +1284,7 @@ int32_t* RegExpGlobalCache::FetchNext() {
         &register_array_[(current_match_index_ - 1) * registers_per_match_];
     int last_end_index = last_match[1];
 
+    RegExpStats::Scope stats_scope(isolate_, regexp_);
     switch (regexp_->TypeTag()) {
       case JSRegExp::NOT_COMPILED:
         UNREACHABLE();
@@ -1061,10 +1295,18 @@ int32_t* RegExpGlobalCache::FetchNext() {
         break;
       case JSRegExp::EXPERIMENTAL: {
         DCHECK(ExperimentalRegExp::IsCompiled(regexp_, isolate_));
-        DisallowGarbageCollection no_gc;
-        num_matches_ = ExperimentalRegExp::ExecRaw(
-            isolate_, RegExp::kFromRuntime, *regexp_, *subject_,
-            register_array_, register_array_size_, last_end_index);
+        int last_start_index = last_match[0];
+        if (last_start_index == last_end_index) {
+          // Zero-length match. Advance by one code point.
+          last_end_index = AdvanceZeroLength(last_end_index);
+        }
+        if (last_end_index > subject_->length()) {
+          num_matches_ = 0;  // Signal failed match.
+          return nullptr;
+        }
+        num_matches_ = ExperimentalRegExp::ExecRawFromRuntime(
+            isolate_, regexp_, subject_, register_array_, register_array_size_,
+            last_end_index);
         break;
       }
       case JSRegExp::IRREGEXP: {
@@ -1086,6 +1328,9 @@ int32_t* RegExpGlobalCache::FetchNext() {
 
     // Fall back to experimental engine if needed and possible.
     if (num_matches_ == RegExp::kInternalRegExpFallbackToExperimental) {
+      if (isolate_->regexp_stats() != nullptr) {
+        isolate_->regexp_stats()->RecordBacktrackLimitFallback();
+      }
       num_matches_ = ExperimentalRegExp::OneshotExecRaw(
           isolate_, regexp_, subject_, register_array_, register_array_size_,
           last_end_index);
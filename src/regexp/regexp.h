@@ -57,6 +57,11 @@ struct RegExpCompileData {
 
   // The compilation target (bytecode or native code).
   RegExpCompilationTarget compilation_target;
+
+  // Whether the generated code may fall back to the experimental engine on
+  // excessive backtracking.  False for the irregexp that the experimental
+  // engine itself falls back to.
+  bool can_fallback_to_experimental = true;
 };
 
 class RegExp final : public AllStatic {
@@ -81,6 +86,17 @@ class RegExp final : public AllStatic {
                                                         Handle<JSRegExp> re,
                                                         Handle<String> subject);
 
+  // Returns a copy of the data of a compiled regexp that can be stored in the
+  // code cache, or an empty handle if there is nothing worth storing.  Native
+  // code is not relocatable, so only bytecode is kept; regexps that tiered up
+  // to native code are restored marked for tier-up instead.
+  static MaybeHandle<FixedArray> CopyDataForCodeCache(Isolate* isolate,
+                                                      Handle<FixedArray> data);
+
+  // Makes regexp data restored from the code cache available to all regexps
+  // with the same source and flags through the compilation cache.
+  static void AddDataFromCodeCache(Isolate* isolate, Handle<FixedArray> data);
+
   enum CallOrigin : int {
     kFromRuntime = 0,
     kFromJs = 1,
@@ -92,6 +108,14 @@ class RegExp final : public AllStatic {
       Isolate* isolate, Handle<JSRegExp> regexp, Handle<String> subject,
       int index, Handle<RegExpMatchInfo> last_match_info);
 
+  // Compiles an IRREGEXP regexp if necessary and runs it on the subject.
+  // Returns the number of matches or an error code like
+  // ExperimentalRegExp::ExecRawFromRuntime.  Used by the experimental engine
+  // to fall back to irregexp.
+  static int IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
+                             Handle<String> subject, int index,
+                             int32_t* output, int output_size);
+
   V8_EXPORT_PRIVATE V8_WARN_UNUSED_RESULT static MaybeHandle<Object>
   ExperimentalOneshotExec(Isolate* isolate, Handle<JSRegExp> regexp,
                           Handle<String> subject, int index,
@@ -104,6 +128,10 @@ class RegExp final : public AllStatic {
   static constexpr int kInternalRegExpRetry = -2;
   static constexpr int kInternalRegExpFallbackToExperimental = -3;
   static constexpr int kInternalRegExpSmallestResult = -3;
+  // Only returned by the experimental interpreter, when it gives up on a
+  // regexp with back references.  Never returned by generated code.  See
+  // ExperimentalRegExp::ExecRawFromRuntime.
+  static constexpr int kInternalRegExpFallbackToIrregexp = -4;
 
   enum IrregexpResult : int32_t {
     RE_FAILURE = kInternalRegExpFailure,
@@ -145,6 +173,8 @@ class RegExp final : public AllStatic {
 // Uses a special global mode of irregexp-generated code to perform a global
 // search and return multiple results at once. As such, this is essentially an
 // iterator over multiple results (retrieved batch-wise in advance).
+// Non-global regexps are iterated over one match at a time, which @@split
+// relies on.
 class RegExpGlobalCache final {
  public:
   RegExpGlobalCache(Handle<JSRegExp> regexp, Handle<String> subject,
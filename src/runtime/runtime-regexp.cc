@@ -12,6 +12,7 @@
 #include "src/numbers/conversions-inl.h"
 #include "src/objects/js-array-inl.h"
 #include "src/objects/js-regexp-inl.h"
+#include "src/regexp/regexp-stats.h"
 #include "src/regexp/regexp-utils.h"
 #include "src/regexp/regexp.h"
 #include "src/runtime/runtime-utils.h"
@@ -75,14 +76,26 @@ class CompiledReplacement {
                Handle<String> replacement, int capture_count,
                int subject_length);
 
-  // Use Apply only if Compile returned false.
-  void Apply(ReplacementStringBuilder* builder, int match_from, int match_to,
-             int32_t* match);
+  // Use Length and Write only if Compile returned false.
 
-  // Number of distinct parts of the replacement pattern.
-  int parts() { return static_cast<int>(parts_.size()); }
+  // Returns the length of the replacement of the given match.
+  int64_t Length(int match_from, int match_to, const int32_t* match);
+
+  // Writes the replacement of the given match to |dest| and returns the
+  // position after it.
+  template <typename Char>
+  Char* Write(String subject, int match_from, int match_to,
+              const int32_t* match, Char* dest);
 
  private:
+  // Calls |add_subject_slice(from, to)| for the parts of the replacement of
+  // the given match that are copied from the subject and |add_string(string)|
+  // for the parts that come from the replacement pattern, in order.
+  template <typename AddSubjectSlice, typename AddString>
+  void Apply(int match_from, int match_to, const int32_t* match,
+             const AddSubjectSlice& add_subject_slice,
+             const AddString& add_string);
+
   enum PartType {
     SUBJECT_PREFIX = 1,
     SUBJECT_SUFFIX,
@@ -365,18 +378,21 @@ bool CompiledReplacement::Compile(Isolate* isolate, Handle<JSRegExp> regexp,
 }
 
 
-void CompiledReplacement::Apply(ReplacementStringBuilder* builder,
-                                int match_from, int match_to, int32_t* match) {
+template <typename AddSubjectSlice, typename AddString>
+void CompiledReplacement::Apply(int match_from, int match_to,
+                                const int32_t* match,
+                                const AddSubjectSlice& add_subject_slice,
+                                const AddString& add_string) {
   DCHECK_LT(0, parts_.size());
   for (ReplacementPart& part : parts_) {
     switch (part.tag) {
       case SUBJECT_PREFIX:
-        if (match_from > 0) builder->AddSubjectSlice(0, match_from);
+        if (match_from > 0) add_subject_slice(0, match_from);
         break;
       case SUBJECT_SUFFIX: {
         int subject_length = part.data;
         if (match_to < subject_length) {
-          builder->AddSubjectSlice(match_to, subject_length);
+          add_subject_slice(match_to, subject_length);
         }
         break;
       }
@@ -385,13 +401,13 @@ void CompiledReplacement::Apply(ReplacementStringBuilder* builder,
         int from = match[capture * 2];
         int to = match[capture * 2 + 1];
         if (from >= 0 && to > from) {
-          builder->AddSubjectSlice(from, to);
+          add_subject_slice(from, to);
         }
         break;
       }
       case REPLACEMENT_SUBSTRING:
       case REPLACEMENT_STRING:
-        builder->AddString(replacement_substrings_[part.data]);
+        add_string(*replacement_substrings_[part.data]);
         break;
       case EMPTY_REPLACEMENT:
         break;
@@ -401,6 +417,32 @@ void CompiledReplacement::Apply(ReplacementStringBuilder* builder,
   }
 }
 
+int64_t CompiledReplacement::Length(int match_from, int match_to,
+                                    const int32_t* match) {
+  int64_t length = 0;
+  Apply(
+      match_from, match_to, match,
+      [&](int from, int to) { length += to - from; },
+      [&](String string) { length += string.length(); });
+  return length;
+}
+
+template <typename Char>
+Char* CompiledReplacement::Write(String subject, int match_from, int match_to,
+                                 const int32_t* match, Char* dest) {
+  Apply(
+      match_from, match_to, match,
+      [&](int from, int to) {
+        String::WriteToFlat(subject, dest, from, to);
+        dest += to - from;
+      },
+      [&](String string) {
+        String::WriteToFlat(string, dest, 0, string.length());
+        dest += string.length();
+      });
+  return dest;
+}
+
 void FindOneByteStringIndices(Vector<const uint8_t> subject, uint8_t pattern,
                               std::vector<int>* indices, unsigned int limit) {
   DCHECK_LT(0, limit);
@@ -519,6 +561,22 @@ void TruncateRegexpIndicesList(Isolate* isolate) {
     indicies->shrink_to_fit();
   }
 }
+
+// Truncates the regexp indices list on every exit from the scope, including
+// early returns for exceptions and trivial results.
+class TruncateRegexpIndicesListScope {
+ public:
+  explicit TruncateRegexpIndicesListScope(Isolate* isolate)
+      : isolate_(isolate) {}
+  TruncateRegexpIndicesListScope(const TruncateRegexpIndicesListScope&) =
+      delete;
+  TruncateRegexpIndicesListScope& operator=(
+      const TruncateRegexpIndicesListScope&) = delete;
+  ~TruncateRegexpIndicesListScope() { TruncateRegexpIndicesList(isolate_); }
+
+ private:
+  Isolate* const isolate_;
+};
 }  // namespace
 
 template <typename ResultSeqString>
@@ -529,8 +587,10 @@ V8_WARN_UNUSED_RESULT static Object StringReplaceGlobalAtomRegExpWithString(
   DCHECK(replacement->IsFlat());
 
   std::vector<int>* indices = GetRewoundRegexpIndicesList(isolate);
+  TruncateRegexpIndicesListScope truncate_indices_scope(isolate);
 
   DCHECK_EQ(JSRegExp::ATOM, pattern_regexp->TypeTag());
+  RegExpStats::Scope stats_scope(isolate, pattern_regexp);
   String pattern =
       String::cast(pattern_regexp->DataAt(JSRegExp::kAtomPatternIndex));
   int subject_len = subject->length();
@@ -597,11 +657,44 @@ V8_WARN_UNUSED_RESULT static Object StringReplaceGlobalAtomRegExpWithString(
   int32_t match_indices[] = {indices->back(), indices->back() + pattern_len};
   RegExp::SetLastMatchInfo(isolate, last_match_info, subject, 0, match_indices);
 
-  TruncateRegexpIndicesList(isolate);
-
   return *result;
 }
 
+// Writes |subject| with the recorded |matches| replaced by |replacement| to
+// |dest|, which has room for the whole result.
+template <typename Char>
+void WriteGlobalReplacement(String subject, String replacement,
+                            bool simple_replace,
+                            CompiledReplacement* compiled_replacement,
+                            const std::vector<int>& matches,
+                            int registers_per_match, Char* dest) {
+  const int subject_length = subject.length();
+  const int replacement_length = replacement.length();
+  int prev = 0;
+  for (size_t i = 0; i < matches.size(); i += registers_per_match) {
+    const int32_t* match = &matches[i];
+    int start = match[0];
+    int end = match[1];
+
+    if (prev < start) {
+      String::WriteToFlat(subject, dest, prev, start);
+      dest += start - prev;
+    }
+
+    if (simple_replace) {
+      String::WriteToFlat(replacement, dest, 0, replacement_length);
+      dest += replacement_length;
+    } else {
+      dest = compiled_replacement->Write(subject, start, end, match, dest);
+    }
+    prev = end;
+  }
+
+  if (prev < subject_length) {
+    String::WriteToFlat(subject, dest, prev, subject_length);
+  }
+}
+
 V8_WARN_UNUSED_RESULT static Object StringReplaceGlobalRegExpWithString(
     Isolate* isolate, Handle<String> subject, Handle<JSRegExp> regexp,
     Handle<String> replacement, Handle<RegExpMatchInfo> last_match_info) {
@@ -643,42 +736,67 @@ V8_WARN_UNUSED_RESULT static Object StringReplaceGlobalRegExpWithString(
     return *subject;
   }
 
-  // Guessing the number of parts that the final result string is built
-  // from. Global regexps can match any number of times, so we guess
-  // conservatively.
-  int expected_parts = (compiled_replacement.parts() + 1) * 4 + 1;
-  ReplacementStringBuilder builder(isolate->heap(), subject, expected_parts);
-
-  int prev = 0;
+  // Record the matches first, so that the result can be allocated with its
+  // final length and encoding and written without intermediate parts.
+  std::vector<int>* matches = GetRewoundRegexpIndicesList(isolate);
+  TruncateRegexpIndicesListScope truncate_indices_scope(isolate);
+  const int registers_per_match =
+      simple_replace ? JSRegExp::RegistersForCaptureCount(0)
+                     : JSRegExp::RegistersForCaptureCount(capture_count);
+  const int replacement_length = replacement->length();
+  int64_t result_length = subject_length;
 
   do {
     int start = current_match[0];
     int end = current_match[1];
 
-    if (prev < start) {
-      builder.AddSubjectSlice(prev, start);
-    }
-
+    result_length -= end - start;
     if (simple_replace) {
-      builder.AddString(replacement);
+      result_length += replacement_length;
     } else {
-      compiled_replacement.Apply(&builder, start, end, current_match);
+      result_length += compiled_replacement.Length(start, end, current_match);
     }
-    prev = end;
+    matches->insert(matches->end(), current_match,
+                    current_match + registers_per_match);
 
     current_match = global_cache.FetchNext();
   } while (current_match != nullptr);
 
   if (global_cache.HasException()) return ReadOnlyRoots(isolate).exception();
 
-  if (prev < subject_length) {
-    builder.AddSubjectSlice(prev, subject_length);
-  }
-
   RegExp::SetLastMatchInfo(isolate, last_match_info, subject, capture_count,
                            global_cache.LastSuccessfulMatch());
 
-  RETURN_RESULT_OR_FAILURE(isolate, builder.ToString());
+  if (result_length > String::kMaxLength) {
+    THROW_NEW_ERROR_RETURN_FAILURE(isolate, NewInvalidStringLengthError());
+  }
+  if (result_length == 0) return ReadOnlyRoots(isolate).empty_string();
+
+  Handle<String> result;
+  if (subject->IsOneByteRepresentation() &&
+      replacement->IsOneByteRepresentation()) {
+    Handle<SeqOneByteString> seq_result =
+        isolate->factory()
+            ->NewRawOneByteString(static_cast<int>(result_length))
+            .ToHandleChecked();
+    DisallowGarbageCollection no_gc;
+    WriteGlobalReplacement(*subject, *replacement, simple_replace,
+                           &compiled_replacement, *matches,
+                           registers_per_match, seq_result->GetChars(no_gc));
+    result = seq_result;
+  } else {
+    Handle<SeqTwoByteString> seq_result =
+        isolate->factory()
+            ->NewRawTwoByteString(static_cast<int>(result_length))
+            .ToHandleChecked();
+    DisallowGarbageCollection no_gc;
+    WriteGlobalReplacement(*subject, *replacement, simple_replace,
+                           &compiled_replacement, *matches,
+                           registers_per_match, seq_result->GetChars(no_gc));
+    result = seq_result;
+  }
+
+  return *result;
 }
 
 template <typename ResultSeqString>
@@ -815,6 +933,7 @@ RUNTIME_FUNCTION(Runtime_StringSplit) {
   pattern = String::Flatten(isolate, pattern);
 
   std::vector<int>* indices = GetRewoundRegexpIndicesList(isolate);
+  TruncateRegexpIndicesListScope truncate_indices_scope(isolate);
 
   FindStringIndicesDispatch(isolate, *subject, *pattern, indices, limit);
 
@@ -856,8 +975,6 @@ RUNTIME_FUNCTION(Runtime_StringSplit) {
     }
   }
 
-  TruncateRegexpIndicesList(isolate);
-
   return *result;
 }
 
@@ -1094,7 +1211,7 @@ static Object SearchRegExpMultiple(Isolate* isolate, Handle<String> subject,
   // native code expects an array to store all the matches, and the bytecode
   // matches one at a time, so it's easier to tier-up to native code from the
   // start.
-  if (FLAG_regexp_tier_up && regexp->TypeTag() == JSRegExp::IRREGEXP) {
+  if (regexp->CanTierUp()) {
     regexp->MarkTierUpForNextExec();
     if (FLAG_trace_regexp_tier_up) {
       PrintF("Forcing tier-up of JSRegExp object %p in SearchRegExpMultiple\n",
@@ -1343,7 +1460,7 @@ V8_WARN_UNUSED_RESULT MaybeHandle<String> RegExpReplace(
     // native code expects an array to store all the matches, and the bytecode
     // matches one at a time, so it's easier to tier-up to native code from the
     // start.
-    if (FLAG_regexp_tier_up && regexp->TypeTag() == JSRegExp::IRREGEXP) {
+    if (regexp->CanTierUp()) {
       regexp->MarkTierUpForNextExec();
       if (FLAG_trace_regexp_tier_up) {
         PrintF("Forcing tier-up of JSRegExp object %p in RegExpReplace\n",
@@ -1554,6 +1671,117 @@ Handle<JSArray> NewJSArrayWithElements(Isolate* isolate,
 
 }  // namespace
 
+// Fast path for @@split, called by RegExpPrototypeSplitBody. {regexp} is an
+// unmodified, non-sticky JSRegExp, {subject} is a non-empty String and {limit}
+// is a positive Smi.
+RUNTIME_FUNCTION(Runtime_RegExpSplitUnmodified) {
+  HandleScope scope(isolate);
+  DCHECK_EQ(3, args.length());
+
+  CONVERT_ARG_HANDLE_CHECKED(JSRegExp, regexp, 0);
+  CONVERT_ARG_HANDLE_CHECKED(String, subject, 1);
+  CONVERT_SMI_ARG_CHECKED(limit, 2);
+
+  CHECK_LT(0, limit);
+  CHECK_EQ(0, regexp->GetFlags() & JSRegExp::kSticky);
+
+  subject = String::Flatten(isolate, subject);
+  const int subject_length = subject->length();
+  CHECK_LT(0, subject_length);
+  const bool unicode = (regexp->GetFlags() & JSRegExp::kUnicode) != 0;
+
+  // As for global replaces, tier up to native code from the start.
+  if (regexp->CanTierUp()) {
+    regexp->MarkTierUpForNextExec();
+  }
+
+  RegExpGlobalCache global_cache(regexp, subject, isolate);
+  if (global_cache.HasException()) return ReadOnlyRoots(isolate).exception();
+
+  const int capture_count = regexp->CaptureCount();
+
+  // Record the bounds of the parts of the result, with -1 for captures that
+  // didn't participate in the match, so that the result array can be
+  // allocated with its final length.  Matches are skipped in the same way as
+  // in the spec'd loop, which searches from {next_search_from} and splits at
+  // matches that don't end at {last_matched_until}.
+  std::vector<int>* parts = GetRewoundRegexpIndicesList(isolate);
+  TruncateRegexpIndicesListScope truncate_indices_scope(isolate);
+  int part_count = 0;
+  int32_t* current_match = nullptr;
+  bool matched = false;
+  int last_matched_until = 0;
+  int next_search_from = 0;
+
+  while (next_search_from < subject_length) {
+    current_match = global_cache.FetchNext();
+    if (current_match == nullptr) break;
+    matched = true;
+
+    const int match_from = current_match[0];
+    const int match_to = current_match[1];
+    if (match_from == subject_length) break;
+
+    if (match_to == last_matched_until) {
+      next_search_from = static_cast<int>(
+          RegExpUtils::AdvanceStringIndex(subject, match_to, unicode));
+      continue;
+    }
+
+    parts->push_back(last_matched_until);
+    parts->push_back(match_from);
+    part_count++;
+    for (int i = 1; i <= capture_count && part_count < limit; i++) {
+      parts->push_back(current_match[i * 2]);
+      parts->push_back(current_match[i * 2 + 1]);
+      part_count++;
+    }
+    if (part_count == limit) break;
+
+    last_matched_until = match_to;
+    next_search_from =
+        match_to > match_from
+            ? match_to
+            : static_cast<int>(
+                  RegExpUtils::AdvanceStringIndex(subject, match_to, unicode));
+  }
+
+  if (global_cache.HasException()) return ReadOnlyRoots(isolate).exception();
+
+  if (matched) {
+    // If the last search failed, the match before it is the last one.
+    int32_t* last_match = current_match != nullptr
+                              ? current_match
+                              : global_cache.LastSuccessfulMatch();
+    RegExp::SetLastMatchInfo(isolate, isolate->regexp_last_match_info(),
+                             subject, capture_count, last_match);
+  }
+
+  if (part_count < limit) {
+    parts->push_back(last_matched_until);
+    parts->push_back(subject_length);
+    part_count++;
+  }
+
+  // Captures that didn't participate in the match stay undefined.
+  Handle<FixedArray> elements = isolate->factory()->NewFixedArray(part_count);
+  if (part_count == 1 && parts->at(1) == subject_length) {
+    elements->set(0, *subject);
+  } else {
+    FOR_WITH_HANDLE_SCOPE(isolate, int, i = 0, i, i < part_count, i++, {
+      const int from = parts->at(i * 2);
+      const int to = parts->at(i * 2 + 1);
+      if (from != -1) {
+        Handle<String> substring =
+            isolate->factory()->NewSubString(subject, from, to);
+        elements->set(i, *substring);
+      }
+    });
+  }
+
+  return *isolate->factory()->NewJSArrayWithElements(elements);
+}
+
 // Slow path for:
 // ES#sec-regexp.prototype-@@replace
 // RegExp.prototype [ @@split ] ( string, limit )
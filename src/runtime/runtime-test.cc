@@ -1272,6 +1272,10 @@ RUNTIME_FUNCTION(Runtime_RegexpHasNativeCode) {
   bool result;
   if (regexp.TypeTag() == JSRegExp::IRREGEXP) {
     result = regexp.Code(is_latin1).IsCode();
+  } else if (regexp.TypeTag() == JSRegExp::EXPERIMENTAL) {
+    // Experimental regexps run on a trampoline builtin until they tier up.
+    Object code = regexp.Code(is_latin1);
+    result = code.IsCode() && Code::cast(code).kind() == CodeKind::REGEXP;
   } else {
     result = false;
   }
@@ -393,6 +393,7 @@ namespace internal {
   F(RegExpInitializeAndCompile, 3, 1)               \
   F(RegExpReplaceRT, 3, 1)                          \
   F(RegExpSplit, 3, 1)                              \
+  F(RegExpSplitUnmodified, 3, 1)                    \
   F(StringReplaceNonGlobalRegExpWithFunction, 3, 1) \
   F(StringSplit, 3, 1)
 
@@ -4,17 +4,22 @@
 
 #include "src/snapshot/code-serializer.h"
 
+#include <algorithm>
+
 #include "src/base/platform/platform.h"
+#include "src/codegen/compilation-cache.h"
 #include "src/codegen/macro-assembler.h"
 #include "src/common/globals.h"
 #include "src/debug/debug.h"
 #include "src/heap/heap-inl.h"
 #include "src/heap/local-factory-inl.h"
+#include "src/interpreter/bytecode-array-iterator.h"
 #include "src/logging/counters.h"
 #include "src/logging/log.h"
 #include "src/objects/objects-inl.h"
 #include "src/objects/slots.h"
 #include "src/objects/visitors.h"
+#include "src/regexp/regexp.h"
 #include "src/snapshot/object-deserializer.h"
 #include "src/snapshot/snapshot-utils.h"
 #include "src/snapshot/snapshot.h"
@@ -38,6 +43,63 @@ CodeSerializer::CodeSerializer(Isolate* isolate, uint32_t source_hash)
     : Serializer(isolate, Snapshot::kDefaultSerializerFlags),
       source_hash_(source_hash) {}
 
+namespace {
+
+// Collects the data of the compiled regexp literals of |script|.  Regexp
+// literals are only created when they are evaluated, so the data is found
+// through the compilation cache, keyed by the pattern and flags operands of
+// their CreateRegExpLiteral bytecodes.
+Handle<FixedArray> CollectRegExpData(Isolate* isolate, Handle<Script> script) {
+  if (!FLAG_serialize_regexp_data) {
+    return isolate->factory()->empty_fixed_array();
+  }
+
+  std::vector<Handle<FixedArray>> seen;
+  std::vector<Handle<FixedArray>> copies;
+  SharedFunctionInfo::ScriptIterator iter(isolate, *script);
+  for (SharedFunctionInfo info = iter.Next(); !info.is_null();
+       info = iter.Next()) {
+    if (!info.HasBytecodeArray()) continue;
+    Handle<BytecodeArray> bytecode(info.GetBytecodeArray(), isolate);
+    for (interpreter::BytecodeArrayIterator it(bytecode); !it.done();
+         it.Advance()) {
+      if (it.current_bytecode() !=
+          interpreter::Bytecode::kCreateRegExpLiteral) {
+        continue;
+      }
+      Handle<String> pattern =
+          Handle<String>::cast(it.GetConstantForIndexOperand(0, isolate));
+      JSRegExp::Flags flags(it.GetFlagOperand(2));
+      Handle<FixedArray> data;
+      if (!isolate->compilation_cache()
+               ->LookupRegExp(pattern, flags)
+               .ToHandle(&data)) {
+        continue;
+      }
+      if (std::any_of(seen.begin(), seen.end(),
+                      [&](Handle<FixedArray> other) {
+                        return *other == *data;
+                      })) {
+        continue;
+      }
+      seen.push_back(data);
+      Handle<FixedArray> copy;
+      if (RegExp::CopyDataForCodeCache(isolate, data).ToHandle(&copy)) {
+        copies.push_back(copy);
+      }
+    }
+  }
+
+  Handle<FixedArray> result =
+      isolate->factory()->NewFixedArray(static_cast<int>(copies.size()));
+  for (size_t i = 0; i < copies.size(); i++) {
+    result->set(static_cast<int>(i), *copies[i]);
+  }
+  return result;
+}
+
+}  // namespace
+
 // static
 ScriptCompiler::CachedData* CodeSerializer::Serialize(
     Handle<SharedFunctionInfo> info) {
@@ -63,11 +125,12 @@ ScriptCompiler::CachedData* CodeSerializer::Serialize(
   // Serialize code object.
   Handle<String> source(String::cast(script->source()), isolate);
   HandleScope scope(isolate);
+  Handle<FixedArray> regexp_data = CollectRegExpData(isolate, script);
   CodeSerializer cs(isolate, SerializedCodeData::SourceHash(
                                  source, script->origin_options()));
   DisallowGarbageCollection no_gc;
   cs.reference_map()->AddAttachedReference(*source);
-  ScriptData* script_data = cs.SerializeSharedFunctionInfo(info);
+  ScriptData* script_data = cs.SerializeSharedFunctionInfo(info, regexp_data);
 
   if (FLAG_profile_deserialization) {
     double ms = timer.Elapsed().InMillisecondsF();
@@ -85,11 +148,13 @@ ScriptCompiler::CachedData* CodeSerializer::Serialize(
 }
 
 ScriptData* CodeSerializer::SerializeSharedFunctionInfo(
-    Handle<SharedFunctionInfo> info) {
+    Handle<SharedFunctionInfo> info, Handle<FixedArray> regexp_data) {
   DisallowGarbageCollection no_gc;
 
   VisitRootPointer(Root::kHandleScope, nullptr,
                    FullObjectSlot(info.location()));
+  VisitRootPointer(Root::kHandleScope, nullptr,
+                   FullObjectSlot(regexp_data.location()));
   SerializeDeferredObjects();
   Pad();
 
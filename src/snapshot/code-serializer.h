@@ -51,7 +51,10 @@ class CodeSerializer : public Serializer {
   V8_EXPORT_PRIVATE static ScriptCompiler::CachedData* Serialize(
       Handle<SharedFunctionInfo> info);
 
-  ScriptData* SerializeSharedFunctionInfo(Handle<SharedFunctionInfo> info);
+  // Serializes |info| followed by |regexp_data|, the data of the compiled
+  // regexp literals of its script, see RegExp::CopyDataForCodeCache.
+  ScriptData* SerializeSharedFunctionInfo(Handle<SharedFunctionInfo> info,
+                                          Handle<FixedArray> regexp_data);
 
   V8_WARN_UNUSED_RESULT static MaybeHandle<SharedFunctionInfo> Deserialize(
       Isolate* isolate, ScriptData* cached_data, Handle<String> source,
@@ -10,6 +10,7 @@
 #include "src/objects/allocation-site-inl.h"
 #include "src/objects/objects.h"
 #include "src/objects/slots.h"
+#include "src/regexp/regexp.h"
 #include "src/snapshot/code-serializer.h"
 
 namespace v8 {
@@ -45,8 +46,10 @@ MaybeHandle<HeapObject> ObjectDeserializer::Deserialize() {
   DCHECK(deserializing_user_code());
   HandleScope scope(isolate());
   Handle<HeapObject> result;
+  Handle<HeapObject> regexp_data;
   {
     result = ReadObject();
+    regexp_data = ReadObject();
     DeserializeDeferredObjects();
     CHECK(new_code_objects().empty());
     LinkAllocationSites();
@@ -56,6 +59,7 @@ MaybeHandle<HeapObject> ObjectDeserializer::Deserialize() {
 
   Rehash();
   CommitPostProcessedObjects();
+  CommitRegExpData(Handle<FixedArray>::cast(regexp_data));
   return scope.CloseAndEscape(result);
 }
 
@@ -80,6 +84,15 @@ void ObjectDeserializer::CommitPostProcessedObjects() {
   }
 }
 
+void ObjectDeserializer::CommitRegExpData(Handle<FixedArray> regexp_data) {
+  // The regexp literals of the script pick up their data from the compilation
+  // cache when they are evaluated.
+  for (int i = 0; i < regexp_data->length(); i++) {
+    Handle<FixedArray> data(FixedArray::cast(regexp_data->get(i)), isolate());
+    RegExp::AddDataFromCodeCache(isolate(), data);
+  }
+}
+
 void ObjectDeserializer::LinkAllocationSites() {
   DisallowGarbageCollection no_gc;
   Heap* heap = isolate()->heap();
@@ -30,6 +30,7 @@ class ObjectDeserializer final : public Deserializer {
 
   void LinkAllocationSites();
   void CommitPostProcessedObjects();
+  void CommitRegExpData(Handle<FixedArray> regexp_data);
 };
 
 }  // namespace internal
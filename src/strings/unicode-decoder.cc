@@ -4,12 +4,141 @@
 
 #include "src/strings/unicode-decoder.h"
 
+#include "src/base/memory.h"
 #include "src/strings/unicode-inl.h"
 #include "src/utils/memcopy.h"
 
 namespace v8 {
 namespace internal {
 
+namespace {
+
+// Returns whether the kUtf8BlockSize bytes at `chars` are all ASCII.  The
+// words of the block are or-ed together, which compilers vectorize.
+V8_INLINE bool IsAsciiBlock(const uint8_t* chars) {
+  STATIC_ASSERT(kUtf8BlockSize % kUIntptrSize == 0);
+  DCHECK_EQ(unibrow::Utf8::kMaxOneByteChar, 0x7F);
+  const uintptr_t non_one_byte_mask = kUintptrAllBitsSet / 0xFF * 0x80;
+  uintptr_t bits = 0;
+  for (int i = 0; i < kUtf8BlockSize; i += kUIntptrSize) {
+    bits |= base::ReadUnalignedValue<uintptr_t>(
+        reinterpret_cast<Address>(chars + i));
+  }
+  return (bits & non_one_byte_mask) == 0;
+}
+
+V8_INLINE bool IsContinuationByte(uint8_t c) { return (c & 0xC0) == 0x80; }
+
+// Decodes the two- to four-byte sequence at `cursor` into `c` and returns its
+// length, or returns 0 if there is no complete, well-formed sequence at
+// `cursor`.  The ranges are those of table 3-7 of the Unicode standard, which
+// the DFA accepts as well.
+V8_INLINE int DecodeMultiByteSequence(const uint8_t* cursor,
+                                      const uint8_t* end, unibrow::uchar* c) {
+  const uint8_t lead = cursor[0];
+  const ptrdiff_t available = end - cursor;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    if (available < 2 || !IsContinuationByte(cursor[1])) return 0;
+    *c = ((lead & 0x1F) << 6) | (cursor[1] & 0x3F);
+    return 2;
+  }
+  if (lead >= 0xE0 && lead <= 0xEF) {
+    if (available < 3 || !IsContinuationByte(cursor[1]) ||
+        !IsContinuationByte(cursor[2])) {
+      return 0;
+    }
+    // Overlong encodings and surrogates.
+    if (lead == 0xE0 && cursor[1] < 0xA0) return 0;
+    if (lead == 0xED && cursor[1] > 0x9F) return 0;
+    *c = ((lead & 0x0F) << 12) | ((cursor[1] & 0x3F) << 6) |
+         (cursor[2] & 0x3F);
+    return 3;
+  }
+  if (lead >= 0xF0 && lead <= 0xF4) {
+    if (available < 4 || !IsContinuationByte(cursor[1]) ||
+        !IsContinuationByte(cursor[2]) || !IsContinuationByte(cursor[3])) {
+      return 0;
+    }
+    // Overlong encodings and code points above U+10FFFF.
+    if (lead == 0xF0 && cursor[1] < 0x90) return 0;
+    if (lead == 0xF4 && cursor[1] > 0x8F) return 0;
+    *c = ((lead & 0x07) << 18) | ((cursor[1] & 0x3F) << 12) |
+         ((cursor[2] & 0x3F) << 6) | (cursor[3] & 0x3F);
+    return 4;
+  }
+  return 0;
+}
+
+}  // namespace
+
+const uint8_t* ScanWellFormedUtf8(const uint8_t* start, const uint8_t* end,
+                                  int* utf16_length, bool* is_one_byte) {
+  const uint8_t* cursor = start;
+  while (cursor < end) {
+    const uint8_t* ascii_start = cursor;
+    while (end - cursor >= kUtf8BlockSize && IsAsciiBlock(cursor)) {
+      cursor += kUtf8BlockSize;
+    }
+    while (cursor < end && *cursor <= unibrow::Utf8::kMaxOneByteChar) {
+      ++cursor;
+    }
+    *utf16_length += static_cast<int>(cursor - ascii_start);
+    if (cursor == end) break;
+
+    unibrow::uchar c;
+    int length = DecodeMultiByteSequence(cursor, end, &c);
+    if (length == 0) break;
+    cursor += length;
+    (*utf16_length)++;
+    if (c > unibrow::Utf16::kMaxNonSurrogateCharCode) (*utf16_length)++;
+    if (c > unibrow::Latin1::kMaxChar) *is_one_byte = false;
+  }
+  return cursor;
+}
+
+template <typename Char>
+void TranscodeWellFormedUtf8(const uint8_t** cursor_ptr, const uint8_t* end,
+                             Char** out_ptr, const Char* out_end) {
+  const uint8_t* cursor = *cursor_ptr;
+  Char* out = *out_ptr;
+  while (cursor < end) {
+    while (end - cursor >= kUtf8BlockSize && out_end - out >= kUtf8BlockSize &&
+           IsAsciiBlock(cursor)) {
+      CopyChars(out, cursor, kUtf8BlockSize);
+      cursor += kUtf8BlockSize;
+      out += kUtf8BlockSize;
+    }
+    while (cursor < end && out < out_end &&
+           *cursor <= unibrow::Utf8::kMaxOneByteChar) {
+      *(out++) = *(cursor++);
+    }
+    if (cursor == end || out == out_end) break;
+
+    unibrow::uchar c;
+    int length = DecodeMultiByteSequence(cursor, end, &c);
+    if (length == 0) break;
+    if (sizeof(Char) == 1 || c <= unibrow::Utf16::kMaxNonSurrogateCharCode) {
+      DCHECK(sizeof(Char) == 2 || c <= unibrow::Latin1::kMaxChar);
+      *(out++) = static_cast<Char>(c);
+    } else {
+      if (out_end - out < 2) break;
+      *(out++) = unibrow::Utf16::LeadSurrogate(c);
+      *(out++) = unibrow::Utf16::TrailSurrogate(c);
+    }
+    cursor += length;
+  }
+  *cursor_ptr = cursor;
+  *out_ptr = out;
+}
+
+template V8_EXPORT_PRIVATE void TranscodeWellFormedUtf8(
+    const uint8_t** cursor, const uint8_t* end, uint8_t** out,
+    const uint8_t* out_end);
+
+template V8_EXPORT_PRIVATE void TranscodeWellFormedUtf8(
+    const uint8_t** cursor, const uint8_t* end, uint16_t** out,
+    const uint16_t* out_end);
+
 Utf8Decoder::Utf8Decoder(const Vector<const uint8_t>& chars)
     : encoding_(Encoding::kAscii),
       non_ascii_start_(NonAsciiStart(chars.begin(), chars.length())),
@@ -24,6 +153,10 @@ Utf8Decoder::Utf8Decoder(const Vector<const uint8_t>& chars)
   unibrow::Utf8::State state = unibrow::Utf8::State::kAccept;
 
   while (cursor < end) {
+    if (state == unibrow::Utf8::State::kAccept) {
+      cursor = ScanWellFormedUtf8(cursor, end, &utf16_length_, &is_one_byte);
+      if (cursor == end) break;
+    }
     unibrow::uchar t =
         unibrow::Utf8::ValueOfIncremental(&cursor, &state, &incomplete_char);
     if (t != unibrow::Utf8::kIncomplete) {
@@ -44,6 +177,7 @@ Utf8Decoder::Utf8Decoder(const Vector<const uint8_t>& chars)
 
 template <typename Char>
 void Utf8Decoder::Decode(Char* out, const Vector<const uint8_t>& data) {
+  const Char* out_end = out + utf16_length_;
   CopyChars(out, data.begin(), non_ascii_start_);
 
   out += non_ascii_start_;
@@ -55,6 +189,10 @@ void Utf8Decoder::Decode(Char* out, const Vector<const uint8_t>& data) {
   const uint8_t* end = data.begin() + data.length();
 
   while (cursor < end) {
+    if (state == unibrow::Utf8::State::kAccept) {
+      TranscodeWellFormedUtf8(&cursor, end, &out, out_end);
+      if (cursor == end) break;
+    }
     unibrow::uchar t =
         unibrow::Utf8::ValueOfIncremental(&cursor, &state, &incomplete_char);
     if (t != unibrow::Utf8::kIncomplete) {
@@ -48,6 +48,32 @@ inline int NonAsciiStart(const uint8_t* chars, int length) {
   return static_cast<int>(chars - start);
 }
 
+// Fast paths for well-formed UTF-8, used by Utf8Decoder and the UTF-8
+// scanner character stream.  They check ASCII a block of kUtf8BlockSize bytes
+// at a time and decode two- to four-byte sequences without going through the
+// DFA of unibrow::Utf8.  They stop before the first invalid or incomplete
+// sequence, which callers then hand to unibrow::Utf8::ValueOfIncremental, so
+// that invalid input is replaced exactly as before.
+static constexpr int kUtf8BlockSize = 32;
+
+// Returns the end of the longest prefix of [start, end) that consists of
+// complete, well-formed sequences.  Adds the number of UTF-16 code units of
+// the prefix to `utf16_length`, and clears `is_one_byte` if the prefix
+// contains characters outside of Latin-1.
+V8_EXPORT_PRIVATE const uint8_t* ScanWellFormedUtf8(const uint8_t* start,
+                                                    const uint8_t* end,
+                                                    int* utf16_length,
+                                                    bool* is_one_byte);
+
+// Transcodes the longest prefix of [*cursor, end) that consists of complete,
+// well-formed sequences to `*out`, stopping early before a character that
+// doesn't fit before `out_end`.  Advances `cursor` and `out` past the
+// transcoded characters.  A Latin-1 `out` requires a Latin-1 input.
+template <typename Char>
+V8_EXPORT_PRIVATE void TranscodeWellFormedUtf8(const uint8_t** cursor,
+                                               const uint8_t* end, Char** out,
+                                               const Char* out_end);
+
 class V8_EXPORT_PRIVATE Utf8Decoder final {
  public:
   enum class Encoding : uint8_t { kAscii, kLatin1, kUtf16 };
@@ -124,7 +124,8 @@ inline MemOperand GetMemOp(LiftoffAssembler* assm,
   if (offset.is_valid()) {
     if (offset_imm == 0) return MemOperand(addr.X(), offset.W(), UXTW);
     Register tmp = temps->AcquireW();
-    // TODO(clemensb): Do a 64-bit addition if memory64 is used.
+    // Memory64 accesses add the index to the memory start before, so the
+    // offset register always holds a 32-bit index here.
     DCHECK_GE(kMaxUInt32, offset_imm);
     assm->Add(tmp, offset.W(), offset_imm);
     return MemOperand(addr.X(), tmp, UXTW);
@@ -15,7 +15,9 @@
 #include "src/utils/ostreams.h"
 #include "src/wasm/baseline/liftoff-register.h"
 #include "src/wasm/function-body-decoder-impl.h"
+#include "src/wasm/object-access.h"
 #include "src/wasm/wasm-linkage.h"
+#include "src/wasm/wasm-objects.h"
 #include "src/wasm/wasm-opcodes.h"
 
 namespace v8 {
@@ -441,6 +443,12 @@ void LiftoffAssembler::CacheState::InitMerge(const CacheState& source,
   DCHECK_GE(source.stack_height(), stack_base);
   stack_state.resize_no_init(target_height);
 
+  // Keep the cached memory start in its register. No value of the source state
+  // lives in that register, so it does not conflict with the regions below.
+  if (source.cached_mem_start != no_reg) {
+    SetMemStartCacheRegister(source.cached_mem_start);
+  }
+
   const VarState* source_begin = source.stack_state.data();
   VarState* target_begin = stack_state.data();
 
@@ -545,7 +553,15 @@ int LiftoffAssembler::GetTotalFrameSlotCountForGC() const {
 
 namespace {
 
-AssemblerOptions DefaultLiftoffOptions() { return AssemblerOptions{}; }
+// Liftoff code is serialized (unless it is compiled for debugging), so like
+// {WasmAssemblerOptions} in TurboFan, record the relocation information of
+// external references, and do not access them relative to the root array.
+AssemblerOptions DefaultLiftoffOptions() {
+  AssemblerOptions options;
+  options.record_reloc_info_for_serialization = true;
+  options.enable_root_array_delta_access = false;
+  return options;
+}
 
 }  // namespace
 
@@ -653,7 +669,7 @@ void LiftoffAssembler::MaterializeMergedConstants(uint32_t arity) {
   }
 }
 
-void LiftoffAssembler::MergeFullStackWith(const CacheState& target,
+void LiftoffAssembler::MergeFullStackWith(CacheState& target,
                                           const CacheState& source) {
   DCHECK_EQ(source.stack_height(), target.stack_height());
   // TODO(clemensb): Reuse the same StackTransferRecipe object to save some
@@ -662,10 +678,16 @@ void LiftoffAssembler::MergeFullStackWith(const CacheState& target,
   for (uint32_t i = 0, e = source.stack_height(); i < e; ++i) {
     transfers.TransferStackSlot(target.stack_state[i], source.stack_state[i]);
   }
+
+  // Full stack merging is only done for forward jumps, so the code at the
+  // target does not rely on the cached memory start yet.
+  if (source.cached_mem_start != target.cached_mem_start) {
+    target.ClearCachedMemStartRegister();
+  }
 }
 
-void LiftoffAssembler::MergeStackWith(const CacheState& target,
-                                      uint32_t arity) {
+void LiftoffAssembler::MergeStackWith(CacheState& target, uint32_t arity,
+                                      JumpDirection jump_direction) {
   // Before: ----------------|----- (discarded) ----|--- arity ---|
   //                         ^target_stack_height   ^stack_base   ^stack_height
   // After:  ----|-- arity --|
@@ -686,6 +708,30 @@ void LiftoffAssembler::MergeStackWith(const CacheState& target,
     transfers.TransferStackSlot(target.stack_state[target_stack_base + i],
                                 cache_state_.stack_state[stack_base + i]);
   }
+
+  // The code after a loop header was already generated and relies on the
+  // cached memory start of the loop state. Forward jump targets can just drop
+  // the cached register.
+  Register target_mem_start = target.cached_mem_start;
+  Register mem_start = cache_state_.cached_mem_start;
+  bool reload_mem_start = false;
+  if (target_mem_start != no_reg && target_mem_start != mem_start) {
+    if (jump_direction == kForwardJump) {
+      target.ClearCachedMemStartRegister();
+    } else if (mem_start != no_reg) {
+      transfers.MoveRegister(LiftoffRegister(target_mem_start),
+                             LiftoffRegister(mem_start), kWasmIntPtr);
+    } else {
+      reload_mem_start = true;
+    }
+  }
+  transfers.Execute();
+  if (reload_mem_start) {
+    LoadFromInstance(
+        target_mem_start,
+        ObjectAccess::ToTagged(WasmInstanceObject::kMemoryStartOffset),
+        kSystemPointerSize);
+  }
 }
 
 void LiftoffAssembler::Spill(VarState* slot) {
@@ -815,6 +861,9 @@ void LiftoffAssembler::PrepareCall(const FunctionSig* sig,
   // Input 0 is the call target.
   constexpr size_t kInputShift = 1;
 
+  // The callee can grow the memory, and clobbers all registers anyway.
+  cache_state_.ClearCachedMemStartRegister();
+
   // Spill all cache slots which are not being used as parameters.
   for (VarState* it = cache_state_.stack_state.end() - 1 - num_params;
        it >= cache_state_.stack_state.begin() &&
@@ -1046,9 +1095,17 @@ bool LiftoffAssembler::ValidateCacheState() const {
     }
     used_regs.set(reg);
   }
+  bool mem_start_valid = true;
+  if (cache_state_.cached_mem_start != no_reg) {
+    LiftoffRegister reg(cache_state_.cached_mem_start);
+    // The register must not be used for any value.
+    mem_start_valid = register_use_count[reg.liftoff_code()] == 0;
+    ++register_use_count[reg.liftoff_code()];
+    used_regs.set(reg);
+  }
   bool valid = memcmp(register_use_count, cache_state_.register_use_count,
                       sizeof(register_use_count)) == 0 &&
-               used_regs == cache_state_.used_registers;
+               used_regs == cache_state_.used_registers && mem_start_valid;
   if (valid) return true;
   std::ostringstream os;
   os << "Error in LiftoffAssembler::ValidateCacheState().\n";
@@ -1063,6 +1120,13 @@ bool LiftoffAssembler::ValidateCacheState() const {
 
 LiftoffRegister LiftoffAssembler::SpillOneRegister(LiftoffRegList candidates,
                                                    LiftoffRegList pinned) {
+  // Before spilling a value, try to drop the cached memory start.
+  Register mem_start = cache_state_.cached_mem_start;
+  if (mem_start != no_reg &&
+      candidates.MaskOut(pinned).has(LiftoffRegister(mem_start))) {
+    cache_state_.ClearCachedMemStartRegister();
+    return LiftoffRegister(mem_start);
+  }
   // Spill one cached value to free a register.
   LiftoffRegister spill_reg = cache_state_.GetNextSpillReg(candidates, pinned);
   SpillRegister(spill_reg);
@@ -1116,6 +1180,12 @@ LiftoffRegister LiftoffAssembler::SpillAdjacentFpRegisters(
 }
 
 void LiftoffAssembler::SpillRegister(LiftoffRegister reg) {
+  if (cache_state_.cached_mem_start != no_reg &&
+      reg == LiftoffRegister(cache_state_.cached_mem_start)) {
+    // The memory start can be reloaded from the instance, no need to spill.
+    cache_state_.ClearCachedMemStartRegister();
+    return;
+  }
   int remaining_uses = cache_state_.get_use_count(reg);
   DCHECK_LT(0, remaining_uses);
   for (uint32_t idx = cache_state_.stack_height() - 1;; --idx) {
@@ -191,6 +191,9 @@ class LiftoffAssembler : public TurboAssembler {
     LiftoffRegList used_registers;
     uint32_t register_use_count[kAfterMaxLiftoffRegCode] = {0};
     LiftoffRegList last_spilled_regs;
+    // The register which holds the start of the memory, or {no_reg}. It is not
+    // part of the value stack, and is counted as used exactly once.
+    Register cached_mem_start = no_reg;
 
     bool has_unused_register(RegClass rc, LiftoffRegList pinned = {}) const {
       if (kNeedI64RegPair && rc == kGpRegPair) {
@@ -291,6 +294,22 @@ class LiftoffAssembler : public TurboAssembler {
     void reset_used_registers() {
       used_registers = {};
       memset(register_use_count, 0, sizeof(register_use_count));
+      cached_mem_start = no_reg;
+    }
+
+    void SetMemStartCacheRegister(Register reg) {
+      DCHECK_EQ(no_reg, cached_mem_start);
+      DCHECK(is_free(LiftoffRegister(reg)));
+      cached_mem_start = reg;
+      inc_used(LiftoffRegister(reg));
+    }
+
+    // Drops the cached memory start. The register content stays unchanged.
+    void ClearCachedMemStartRegister() {
+      if (cached_mem_start == no_reg) return;
+      DCHECK_EQ(1, get_use_count(LiftoffRegister(cached_mem_start)));
+      clear_used(LiftoffRegister(cached_mem_start));
+      cached_mem_start = no_reg;
     }
 
     LiftoffRegister GetNextSpillReg(LiftoffRegList candidates,
@@ -435,8 +454,12 @@ class LiftoffAssembler : public TurboAssembler {
 
   void MaterializeMergedConstants(uint32_t arity);
 
-  void MergeFullStackWith(const CacheState& target, const CacheState& source);
-  void MergeStackWith(const CacheState& target, uint32_t arity);
+  enum JumpDirection : bool { kForwardJump, kBackwardJump };
+
+  // Merges {source} into {target}, which must be the state of a forward jump
+  // target.
+  void MergeFullStackWith(CacheState& target, const CacheState& source);
+  void MergeStackWith(CacheState& target, uint32_t arity, JumpDirection);
 
   void Spill(VarState* slot);
   void SpillLocals();
@@ -4,6 +4,7 @@
 
 #include "src/wasm/baseline/liftoff-compiler.h"
 
+#include "src/base/bits.h"
 #include "src/base/optional.h"
 #include "src/base/platform/wrappers.h"
 #include "src/codegen/assembler-inl.h"
@@ -316,6 +317,9 @@ class LiftoffCompiler {
     LiftoffRegList regs_to_save;
     OutOfLineSafepointInfo* safepoint_info;
     uint32_t pc;  // for trap handler.
+    // Cached memory start to reload after the stack check (which might grow
+    // the memory).
+    Register cached_mem_start;
     // These two pointers will only be used for debug code:
     SpilledRegistersForInspection* spilled_registers;
     DebugSideTableBuilder::EntryBuilder* debug_sidetable_entry_builder;
@@ -335,13 +339,14 @@ class LiftoffCompiler {
           {},                            // regs_to_save
           safepoint_info,                // safepoint_info
           pc,                            // pc
+          no_reg,                        // cached_mem_start
           spilled_registers,             // spilled_registers
           debug_sidetable_entry_builder  // debug_side_table_entry_builder
       };
     }
     static OutOfLineCode StackCheck(
         WasmCodePosition pos, LiftoffRegList regs_to_save,
-        SpilledRegistersForInspection* spilled_regs,
+        Register cached_mem_start, SpilledRegistersForInspection* spilled_regs,
         OutOfLineSafepointInfo* safepoint_info,
         DebugSideTableBuilder::EntryBuilder* debug_sidetable_entry_builder) {
       return {
@@ -352,6 +357,7 @@ class LiftoffCompiler {
           regs_to_save,                  // regs_to_save
           safepoint_info,                // safepoint_info
           0,                             // pc
+          cached_mem_start,              // cached_mem_start
           spilled_regs,                  // spilled_registers
           debug_sidetable_entry_builder  // debug_side_table_entry_builder
       };
@@ -482,6 +488,11 @@ class LiftoffCompiler {
       StdoutStream{} << "hint: add --trace-wasm-decoder to also see the wasm "
                         "instructions being decoded\n";
     }
+    // Memory64 indexes do not fit in a single register on 32-bit platforms.
+    if (kSystemPointerSize == 4 && env_->module->is_memory64) {
+      unsupported(decoder, kMemory64, "memory64 on 32-bit platform");
+      return;
+    }
     int num_locals = decoder->num_locals();
     __ set_num_locals(num_locals);
     for (int i = 0; i < num_locals; ++i) {
@@ -541,7 +552,8 @@ class LiftoffCompiler {
       spilled_regs = GetSpilledRegistersForInspection();
     }
     out_of_line_code_.push_back(OutOfLineCode::StackCheck(
-        position, regs_to_save, spilled_regs, safepoint_info,
+        position, regs_to_save, __ cache_state()->cached_mem_start,
+        spilled_regs, safepoint_info,
         RegisterDebugSideTableEntry(DebugSideTableBuilder::kAssumeSpilling)));
     OutOfLineCode& ool = out_of_line_code_.back();
     LOAD_INSTANCE_FIELD(limit_address, StackLimitAddress, kSystemPointerSize);
@@ -677,7 +689,8 @@ class LiftoffCompiler {
     // is never a position of any instruction in the function.
     StackCheck(0);
 
-    if (FLAG_wasm_dynamic_tiering) {
+    // Debugging code is never tiered up, so it does not need call counters.
+    if (FLAG_wasm_dynamic_tiering && !for_debugging_) {
       // TODO(arobin): Avoid spilling registers unconditionally.
       __ SpillAllRegisters();
       DEBUG_CODE_COMMENT("dynamic tiering");
@@ -704,7 +717,11 @@ class LiftoffCompiler {
       __ Store(array_address.gp(), no_reg, offset, new_number_of_calls,
                StoreType::kI32Store, pinned);
 
-      // Emit the runtime call if necessary.
+      // Request tier-up when the number of calls reaches the tiering budget,
+      // and again at every power of two after that until the function is
+      // tiered up. Each request queues the function with its call count as
+      // priority, so functions which keep getting called while waiting for
+      // TurboFan move ahead of the others.
       Label no_tierup;
       // Check if the number of calls is a power of 2.
       __ emit_i32_and(old_number_of_calls.gp(), old_number_of_calls.gp(),
@@ -712,6 +729,12 @@ class LiftoffCompiler {
       // Unary "unequal" means "different from zero".
       __ emit_cond_jump(kUnequal, &no_tierup, kWasmI32,
                         old_number_of_calls.gp());
+      LiftoffRegister budget = old_number_of_calls;
+      uint32_t tiering_budget = base::bits::RoundUpToPowerOfTwo32(
+          static_cast<uint32_t>(std::max(1, FLAG_wasm_tiering_budget)));
+      __ LoadConstant(budget, WasmValue(static_cast<int32_t>(tiering_budget)));
+      __ emit_cond_jump(kUnsignedLessThan, &no_tierup, kWasmI32,
+                        new_number_of_calls.gp(), budget.gp());
       TierUpFunction(decoder);
       __ bind(&no_tierup);
     }
@@ -799,6 +822,10 @@ class LiftoffCompiler {
     DCHECK_EQ(ool->continuation.get()->is_bound(), is_stack_check);
     if (!ool->regs_to_save.is_empty()) __ PopRegisters(ool->regs_to_save);
     if (is_stack_check) {
+      if (ool->cached_mem_start != no_reg) {
+        LOAD_INSTANCE_FIELD(ool->cached_mem_start, MemoryStart,
+                            kSystemPointerSize);
+      }
       if (V8_UNLIKELY(ool->spilled_registers != nullptr)) {
         DCHECK(for_debugging_);
         for (auto& entry : ool->spilled_registers->entries) {
@@ -2049,7 +2076,9 @@ class LiftoffCompiler {
                                     target->br_merge()->arity,
                                     target->stack_depth);
     }
-    __ MergeStackWith(target->label_state, target->br_merge()->arity);
+    __ MergeStackWith(target->label_state, target->br_merge()->arity,
+                      target->is_loop() ? LiftoffAssembler::kBackwardJump
+                                        : LiftoffAssembler::kForwardJump);
     __ jmp(target->label.get());
   }
 
@@ -2229,8 +2258,26 @@ class LiftoffCompiler {
         !base::IsInBounds<uintptr_t>(offset, access_size,
                                      env_->max_memory_size);
 
-    if (!force_check && !statically_oob &&
-        (!FLAG_wasm_bounds_checks || env_->use_trap_handler)) {
+    if (!force_check && !statically_oob && !FLAG_wasm_bounds_checks) {
+      return false;
+    }
+
+    const bool is_memory64 = env_->module->is_memory64;
+    // The guard regions cover a 32-bit index plus a 32-bit offset. If the
+    // memory can never grow beyond 4 GiB, a memory64 index which does not fit
+    // in 32 bits is always out of bounds, and everything else is left to the
+    // trap handler. Larger memories are checked explicitly below.
+    const bool index_covered_by_guard_regions =
+        !is_memory64 || (env_->max_memory_size <= uint64_t{kMaxUInt32} + 1 &&
+                         offset <= kMaxUInt32);
+    if (!force_check && !statically_oob && env_->use_trap_handler &&
+        index_covered_by_guard_regions) {
+      if (!is_memory64) return false;
+      Label* trap_label = AddOutOfLineTrap(
+          decoder->position(), WasmCode::kThrowWasmTrapMemOutOfBounds);
+      LiftoffRegister high_word = __ GetUnusedRegister(kGpReg, pinned);
+      __ emit_i64_shri(high_word, LiftoffRegister(index), 32);
+      __ emit_cond_jump(kUnequal, trap_label, kWasmI64, high_word.gp());
       return false;
     }
 
@@ -2269,7 +2316,7 @@ class LiftoffCompiler {
     LiftoffRegister effective_size_reg = end_offset_reg;
     __ emit_ptrsize_sub(effective_size_reg.gp(), mem_size, end_offset_reg.gp());
 
-    __ emit_u32_to_intptr(index, index);
+    if (!is_memory64) __ emit_u32_to_intptr(index, index);
 
     __ emit_cond_jump(kUnsignedGreaterEqual, trap_label,
                       LiftoffAssembler::kWasmIntPtr, index,
@@ -2312,10 +2359,16 @@ class LiftoffCompiler {
     // Get one register for computing the effective offset (offset + index).
     LiftoffRegister effective_offset =
         pinned.set(__ GetUnusedRegister(kGpReg, pinned));
-    // TODO(clemensb): Do a 64-bit addition here if memory64 is used.
-    DCHECK_GE(kMaxUInt32, offset);
-    __ LoadConstant(effective_offset, WasmValue(static_cast<uint32_t>(offset)));
-    __ emit_i32_add(effective_offset.gp(), effective_offset.gp(), index);
+    const bool is_memory64 = env_->module->is_memory64;
+    if (is_memory64) {
+      __ LoadConstant(effective_offset, WasmValue::ForUintPtr(offset));
+      __ emit_ptrsize_add(effective_offset.gp(), effective_offset.gp(), index);
+    } else {
+      DCHECK_GE(kMaxUInt32, offset);
+      __ LoadConstant(effective_offset,
+                      WasmValue(static_cast<uint32_t>(offset)));
+      __ emit_i32_add(effective_offset.gp(), effective_offset.gp(), index);
+    }
 
     // Get a register to hold the stack slot for MemoryTracingInfo.
     LiftoffRegister info = pinned.set(__ GetUnusedRegister(kGpReg, pinned));
@@ -2327,7 +2380,7 @@ class LiftoffCompiler {
     LiftoffRegister data = effective_offset;
 
     // Now store all information into the MemoryTracingInfo struct.
-    if (kSystemPointerSize == 8) {
+    if (kSystemPointerSize == 8 && !is_memory64) {
       // Zero-extend the effective offset to u64.
       CHECK(__ emit_type_conversion(kExprI64UConvertI32, data, effective_offset,
                                     nullptr));
@@ -2359,26 +2412,65 @@ class LiftoffCompiler {
     __ DeallocateStackSlot(sizeof(MemoryTracingInfo));
   }
 
+  // Returns a register holding the start of the memory. The register is kept
+  // as a cache across instructions (and merges) until it is needed for
+  // something else, or the memory might have moved (calls, stack checks).
+  Register GetMemoryStart(LiftoffRegList pinned) {
+    Register mem_start = __ cache_state()->cached_mem_start;
+    if (mem_start != no_reg) return mem_start;
+    mem_start = __ GetUnusedRegister(kGpReg, pinned).gp();
+    LOAD_INSTANCE_FIELD(mem_start, MemoryStart, kSystemPointerSize);
+    // Debug code can call into JS (which can grow the memory) at every
+    // breakable position, so do not cache the memory start there.
+    if (V8_LIKELY(!for_debugging_)) {
+      __ cache_state()->SetMemStartCacheRegister(mem_start);
+    }
+    return mem_start;
+  }
+
+  // Returns the base register for a memory access, and sets {*offset_reg} to
+  // the register to be added to it. Memory64 indexes are added to the memory
+  // start here, since some assemblers only use the lower 32 bits of the offset
+  // register of a memory operand.
+  Register GetMemoryAccessBase(Register* offset_reg, LiftoffRegList* pinned) {
+    Register mem_start = pinned->set(GetMemoryStart(*pinned));
+    if (!env_->module->is_memory64) return mem_start;
+    Register base = pinned->set(__ GetUnusedRegister(kGpReg, *pinned)).gp();
+    __ emit_ptrsize_add(base, mem_start, *offset_reg);
+    *offset_reg = no_reg;
+    return base;
+  }
+
   Register AddMemoryMasking(Register index, uintptr_t* offset,
                             LiftoffRegList* pinned) {
     if (!FLAG_untrusted_code_mitigations || env_->use_trap_handler) {
       return index;
     }
     DEBUG_CODE_COMMENT("mask memory index");
+    const bool is_memory64 = env_->module->is_memory64;
+    ValueType index_type = is_memory64 ? kWasmI64 : kWasmI32;
     // Make sure that we can overwrite {index}.
     if (__ cache_state()->is_used(LiftoffRegister(index))) {
       Register old_index = index;
       pinned->clear(LiftoffRegister(old_index));
       index = pinned->set(__ GetUnusedRegister(kGpReg, *pinned)).gp();
-      // TODO(clemensb): Use kWasmI64 if memory64 is used.
-      if (index != old_index) __ Move(index, old_index, kWasmI32);
+      if (index != old_index) __ Move(index, old_index, index_type);
     }
     Register tmp = __ GetUnusedRegister(kGpReg, *pinned).gp();
-    // TODO(clemensb): Use 64-bit operations if memory64 is used.
-    DCHECK_GE(kMaxUInt32, *offset);
-    if (*offset) __ emit_i32_addi(index, index, static_cast<uint32_t>(*offset));
     LOAD_INSTANCE_FIELD(tmp, MemoryMask, kSystemPointerSize);
-    __ emit_i32_and(index, index, tmp);
+    if (is_memory64) {
+      LiftoffRegister index_reg(index);
+      if (*offset) {
+        __ emit_i64_addi(index_reg, index_reg, static_cast<int64_t>(*offset));
+      }
+      __ emit_i64_and(index_reg, index_reg, LiftoffRegister(tmp));
+    } else {
+      DCHECK_GE(kMaxUInt32, *offset);
+      if (*offset) {
+        __ emit_i32_addi(index, index, static_cast<uint32_t>(*offset));
+      }
+      __ emit_i32_and(index, index, tmp);
+    }
     *offset = 0;
     return index;
   }
@@ -2404,12 +2496,13 @@ class LiftoffCompiler {
     uintptr_t offset = imm.offset;
     index = AddMemoryMasking(index, &offset, &pinned);
     DEBUG_CODE_COMMENT("load from memory");
-    Register addr = pinned.set(__ GetUnusedRegister(kGpReg, pinned)).gp();
-    LOAD_INSTANCE_FIELD(addr, MemoryStart, kSystemPointerSize);
+    Register offset_reg = index;
+    Register addr = GetMemoryAccessBase(&offset_reg, &pinned);
     RegClass rc = reg_class_for(value_type);
     LiftoffRegister value = pinned.set(__ GetUnusedRegister(rc, pinned));
     uint32_t protected_load_pc = 0;
-    __ Load(value, addr, index, offset, type, pinned, &protected_load_pc, true);
+    __ Load(value, addr, offset_reg, offset, type, pinned, &protected_load_pc,
+            true);
     if (env_->use_trap_handler) {
       AddOutOfLineTrap(decoder->position(),
                        WasmCode::kThrowWasmTrapMemOutOfBounds,
@@ -2449,11 +2542,11 @@ class LiftoffCompiler {
     uintptr_t offset = imm.offset;
     index = AddMemoryMasking(index, &offset, &pinned);
     DEBUG_CODE_COMMENT("load with transformation");
-    Register addr = __ GetUnusedRegister(kGpReg, pinned).gp();
-    LOAD_INSTANCE_FIELD(addr, MemoryStart, kSystemPointerSize);
-    LiftoffRegister value = __ GetUnusedRegister(reg_class_for(kS128), {});
+    Register offset_reg = index;
+    Register addr = GetMemoryAccessBase(&offset_reg, &pinned);
+    LiftoffRegister value = __ GetUnusedRegister(reg_class_for(kS128), pinned);
     uint32_t protected_load_pc = 0;
-    __ LoadTransform(value, addr, index, offset, type, transform,
+    __ LoadTransform(value, addr, offset_reg, offset, type, transform,
                      &protected_load_pc);
 
     if (env_->use_trap_handler) {
@@ -2495,12 +2588,12 @@ class LiftoffCompiler {
     uintptr_t offset = imm.offset;
     index = AddMemoryMasking(index, &offset, &pinned);
     DEBUG_CODE_COMMENT("store to memory");
-    Register addr = pinned.set(__ GetUnusedRegister(kGpReg, pinned)).gp();
-    LOAD_INSTANCE_FIELD(addr, MemoryStart, kSystemPointerSize);
+    Register offset_reg = index;
+    Register addr = GetMemoryAccessBase(&offset_reg, &pinned);
     uint32_t protected_store_pc = 0;
     LiftoffRegList outer_pinned;
     if (FLAG_trace_wasm_memory) outer_pinned.set(index);
-    __ Store(addr, index, offset, value, type, outer_pinned,
+    __ Store(addr, offset_reg, offset, value, type, outer_pinned,
              &protected_store_pc, true);
     if (env_->use_trap_handler) {
       AddOutOfLineTrap(decoder->position(),
@@ -2523,7 +2616,9 @@ class LiftoffCompiler {
     Register mem_size = __ GetUnusedRegister(kGpReg, {}).gp();
     LOAD_INSTANCE_FIELD(mem_size, MemorySize, kSystemPointerSize);
     __ emit_ptrsize_shri(mem_size, mem_size, kWasmPageSizeLog2);
-    __ PushRegister(kWasmI32, LiftoffRegister(mem_size));
+    // On 64-bit platforms, the page count is zero-extended already.
+    ValueType result_type = env_->module->is_memory64 ? kWasmI64 : kWasmI32;
+    __ PushRegister(result_type, LiftoffRegister(mem_size));
   }
 
   void MemoryGrow(FullDecoder* decoder, const Value& value, Value* result_val) {
@@ -2543,6 +2638,16 @@ class LiftoffCompiler {
     DCHECK_EQ(1, descriptor.GetRegisterParameterCount());
     DCHECK_EQ(kWasmI32.machine_type(), descriptor.GetParameterType(0));
 
+    // The runtime stub takes a 32-bit delta. Growing a memory64 memory by 2^32
+    // pages or more always fails.
+    const bool is_memory64 = env_->module->is_memory64;
+    Label done, grow_failed;
+    if (is_memory64) {
+      LiftoffRegister high_word = __ GetUnusedRegister(kGpReg, pinned);
+      __ emit_i64_shri(high_word, input, 32);
+      __ emit_cond_jump(kUnequal, &grow_failed, kWasmI64, high_word.gp());
+    }
+
     Register param_reg = descriptor.GetRegisterParameter(0);
     if (input.gp() != param_reg) __ Move(param_reg, input.gp(), kWasmI32);
 
@@ -2554,7 +2659,17 @@ class LiftoffCompiler {
       __ Move(result.gp(), kReturnRegister0, kWasmI32);
     }
 
-    __ PushRegister(kWasmI32, result);
+    if (is_memory64) {
+      // Sign-extend the result, so that -1 stays -1.
+      CHECK(__ emit_type_conversion(kExprI64SConvertI32, result, result,
+                                    nullptr));
+      __ emit_jump(&done);
+      __ bind(&grow_failed);
+      __ LoadConstant(result, WasmValue(int64_t{-1}));
+      __ bind(&done);
+    }
+
+    __ PushRegister(is_memory64 ? kWasmI64 : kWasmI32, result);
   }
 
   DebugSideTableBuilder::EntryBuilder* RegisterDebugSideTableEntry(
@@ -3561,6 +3676,10 @@ class LiftoffCompiler {
 
   void AtomicOp(FullDecoder* decoder, WasmOpcode opcode, Vector<Value> args,
                 const MemoryAccessImmediate<validate>& imm, Value* result) {
+    if (env_->module->is_memory64) {
+      unsupported(decoder, kMemory64, "memory64 atomics");
+      return;
+    }
     switch (opcode) {
 #define ATOMIC_STORE_OP(name, type)                \
   case wasm::kExpr##name:                          \
@@ -3615,6 +3734,20 @@ class LiftoffCompiler {
 
   void AtomicFence(FullDecoder* decoder) { __ AtomicFence(); }
 
+  // Returns a register holding the memory offset or size in {reg} as a
+  // {uintptr_t}, for passing it to a C function. 32-bit values get
+  // zero-extended into a new register if {reg} is still in use.
+  LiftoffRegister MemoryValueToUintPtr(LiftoffRegister reg,
+                                       LiftoffRegList* pinned) {
+    if (kSystemPointerSize == 4 || env_->module->is_memory64) return reg;
+    LiftoffRegister dst = reg;
+    if (__ cache_state()->is_used(reg)) {
+      dst = pinned->set(__ GetUnusedRegister(kGpReg, *pinned));
+    }
+    __ emit_u32_to_intptr(dst.gp(), reg.gp());
+    return dst;
+  }
+
   void MemoryInit(FullDecoder* decoder,
                   const MemoryInitImmediate<validate>& imm, const Value&,
                   const Value&, const Value&) {
@@ -3622,6 +3755,7 @@ class LiftoffCompiler {
     LiftoffRegister size = pinned.set(__ PopToRegister());
     LiftoffRegister src = pinned.set(__ PopToRegister(pinned));
     LiftoffRegister dst = pinned.set(__ PopToRegister(pinned));
+    dst = MemoryValueToUintPtr(dst, &pinned);
 
     Register instance = pinned.set(__ GetUnusedRegister(kGpReg, pinned)).gp();
     __ FillInstanceInto(instance);
@@ -3631,7 +3765,7 @@ class LiftoffCompiler {
     __ LoadConstant(segment_index, WasmValue(imm.data_segment_index));
 
     ExternalReference ext_ref = ExternalReference::wasm_memory_init();
-    ValueType sig_reps[] = {kWasmI32, kPointerValueType, kWasmI32,
+    ValueType sig_reps[] = {kWasmI32, kPointerValueType, kPointerValueType,
                             kWasmI32, kWasmI32,          kWasmI32};
     FunctionSig sig(1, 5, sig_reps);
     LiftoffRegister args[] = {LiftoffRegister(instance), dst, src,
@@ -3672,11 +3806,14 @@ class LiftoffCompiler {
     LiftoffRegister size = pinned.set(__ PopToRegister());
     LiftoffRegister src = pinned.set(__ PopToRegister(pinned));
     LiftoffRegister dst = pinned.set(__ PopToRegister(pinned));
+    size = MemoryValueToUintPtr(size, &pinned);
+    src = MemoryValueToUintPtr(src, &pinned);
+    dst = MemoryValueToUintPtr(dst, &pinned);
     Register instance = pinned.set(__ GetUnusedRegister(kGpReg, pinned)).gp();
     __ FillInstanceInto(instance);
     ExternalReference ext_ref = ExternalReference::wasm_memory_copy();
-    ValueType sig_reps[] = {kWasmI32, kPointerValueType, kWasmI32, kWasmI32,
-                            kWasmI32};
+    ValueType sig_reps[] = {kWasmI32, kPointerValueType, kPointerValueType,
+                            kPointerValueType, kPointerValueType};
     FunctionSig sig(1, 4, sig_reps);
     LiftoffRegister args[] = {LiftoffRegister(instance), dst, src, size};
     // We don't need the instance anymore after the call. We can use the
@@ -3695,11 +3832,13 @@ class LiftoffCompiler {
     LiftoffRegister size = pinned.set(__ PopToRegister());
     LiftoffRegister value = pinned.set(__ PopToRegister(pinned));
     LiftoffRegister dst = pinned.set(__ PopToRegister(pinned));
+    size = MemoryValueToUintPtr(size, &pinned);
+    dst = MemoryValueToUintPtr(dst, &pinned);
     Register instance = pinned.set(__ GetUnusedRegister(kGpReg, pinned)).gp();
     __ FillInstanceInto(instance);
     ExternalReference ext_ref = ExternalReference::wasm_memory_fill();
-    ValueType sig_reps[] = {kWasmI32, kPointerValueType, kWasmI32, kWasmI32,
-                            kWasmI32};
+    ValueType sig_reps[] = {kWasmI32, kPointerValueType, kPointerValueType,
+                            kWasmI32, kPointerValueType};
     FunctionSig sig(1, 4, sig_reps);
     LiftoffRegister args[] = {LiftoffRegister(instance), dst, value, size};
     // We don't need the instance anymore after the call. We can use the
@@ -46,6 +46,7 @@ enum LiftoffBailoutReason : int8_t {
   kBulkMemory = 11,
   kNonTrappingFloatToInt = 12,
   kGC = 13,
+  kMemory64 = 14,
   // A little gap, for forward compatibility.
   // Any other reason (use rarely; introduce new reasons if this spikes).
   kOtherReason = 20,
@@ -2049,6 +2049,8 @@ void LiftoffAssembler::emit_cond_jump(LiftoffCondition liftoff_cond,
       default:
         UNREACHABLE();
     }
+  } else if (type == kWasmI64) {
+    testq(lhs, lhs);
   } else {
     DCHECK_EQ(type, kWasmI32);
     testl(lhs, lhs);
@@ -64,7 +64,7 @@ struct CompilationEnv {
   const LowerSimd lower_simd;
 
   static constexpr uint32_t kMaxMemoryPagesAtRuntime =
-      std::min(kV8MaxWasmMemoryPages,
+      std::min(std::max(kV8MaxWasmMemoryPages, kV8MaxWasmMemory64Pages),
                std::numeric_limits<uintptr_t>::max() / kWasmPageSize);
 
   constexpr CompilationEnv(const WasmModule* module,
@@ -81,12 +81,17 @@ struct CompilationEnv {
                                  module ? module->initial_pages : 0) *
                         uint64_t{kWasmPageSize}),
         max_memory_size(static_cast<uintptr_t>(
-            std::min(kMaxMemoryPagesAtRuntime,
-                     module && module->has_maximum_pages ? module->maximum_pages
-                                                         : max_mem_pages()) *
+            std::min(kMaxMemoryPagesAtRuntime, MaxMemoryPages(module)) *
             uint64_t{kWasmPageSize})),
         enabled_features(enabled_features),
         lower_simd(lower_simd) {}
+
+ private:
+  static uint32_t MaxMemoryPages(const WasmModule* module) {
+    if (module && module->has_maximum_pages) return module->maximum_pages;
+    if (module && module->is_memory64) return max_mem64_pages();
+    return max_mem_pages();
+  }
 };
 
 // The wire bytes are either owned by the StreamingDecoder, or (after streaming)
@@ -126,7 +131,11 @@ class V8_EXPORT_PRIVATE CompilationState {
 
   void AddCallback(callback_t);
 
-  void InitializeAfterDeserialization();
+  // Set up compilation progress for a deserialized module. Functions in
+  // {lazy_functions} were serialized without code, functions in
+  // {liftoff_functions} still need to tier up.
+  void InitializeAfterDeserialization(Vector<const int> lazy_functions,
+                                      Vector<const int> liftoff_functions);
 
   // Wait until top tier compilation finished, or compilation failed.
   void WaitForTopTierFinished();
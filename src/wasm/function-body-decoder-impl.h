@@ -3010,8 +3010,9 @@ class WasmFullDecoder : public WasmDecoder<validate> {
       this->DecodeError("grow_memory is not supported for asmjs modules");
       return 0;
     }
-    Value value = Pop(0, kWasmI32);
-    Value* result = Push(kWasmI32);
+    ValueType mem_type = this->module_->is_memory64 ? kWasmI64 : kWasmI32;
+    Value value = Pop(0, mem_type);
+    Value* result = Push(mem_type);
     CALL_INTERFACE_IF_REACHABLE(MemoryGrow, value, result);
     return 1 + imm.length;
   }
@@ -3019,7 +3020,8 @@ class WasmFullDecoder : public WasmDecoder<validate> {
   DECODE(MemorySize) {
     if (!CheckHasMemory()) return 0;
     MemoryIndexImmediate<validate> imm(this, this->pc_ + 1);
-    Value* result = Push(kWasmI32);
+    ValueType result_type = this->module_->is_memory64 ? kWasmI64 : kWasmI32;
+    Value* result = Push(result_type);
     CALL_INTERFACE_IF_REACHABLE(CurrentMemoryPages, result);
     return 1 + imm.length;
   }
@@ -3438,7 +3440,8 @@ class WasmFullDecoder : public WasmDecoder<validate> {
         this, this->pc_ + opcode_length + mem_imm.length);
     if (!this->Validate(this->pc_ + opcode_length, opcode, lane_imm)) return 0;
     Value v128 = Pop(1, kWasmS128);
-    Value index = Pop(0, kWasmI32);
+    ValueType index_type = this->module_->is_memory64 ? kWasmI64 : kWasmI32;
+    Value index = Pop(0, index_type);
 
     Value* result = Push(kWasmS128);
     CALL_INTERFACE_IF_REACHABLE(LoadLane, type, v128, index, mem_imm,
@@ -3455,7 +3458,8 @@ class WasmFullDecoder : public WasmDecoder<validate> {
         this, this->pc_ + opcode_length + mem_imm.length);
     if (!this->Validate(this->pc_ + opcode_length, opcode, lane_imm)) return 0;
     Value v128 = Pop(1, kWasmS128);
-    Value index = Pop(0, kWasmI32);
+    ValueType index_type = this->module_->is_memory64 ? kWasmI64 : kWasmI32;
+    Value index = Pop(0, index_type);
 
     CALL_INTERFACE_IF_REACHABLE(StoreLane, type, mem_imm, index, v128,
                                 lane_imm.lane);
@@ -4195,10 +4199,13 @@ class WasmFullDecoder : public WasmDecoder<validate> {
     MemoryAccessImmediate<validate> imm(
         this, this->pc_ + opcode_length,
         ElementSizeLog2Of(memtype.representation()));
-    // TODO(10949): Fix this for memory64 (index type should be kWasmI64
-    // then).
-    CHECK(!this->module_->is_memory64);
-    ArgVector args = PopArgs(sig);
+    // The first argument is the memory index, which is an i64 for memory64.
+    ValueType arg_types[3];
+    size_t num_args = sig->parameter_count();
+    DCHECK_GE(arraysize(arg_types), num_args);
+    std::copy(sig->parameters().begin(), sig->parameters().end(), arg_types);
+    if (this->module_->is_memory64) arg_types[0] = kWasmI64;
+    ArgVector args = PopArgs(0, VectorOf(arg_types, num_args));
     Value* result = ret_type == kWasmStmt ? nullptr : Push(GetReturnType(sig));
     CALL_INTERFACE_IF_REACHABLE(AtomicOp, opcode, VectorOf(args), imm, result);
     return opcode_length + imm.length;
@@ -4225,9 +4232,10 @@ class WasmFullDecoder : public WasmDecoder<validate> {
       case kExprMemoryInit: {
         MemoryInitImmediate<validate> imm(this, this->pc_ + opcode_length);
         if (!this->Validate(this->pc_ + opcode_length, imm)) return 0;
+        ValueType mem_type = this->module_->is_memory64 ? kWasmI64 : kWasmI32;
         Value size = Pop(2, sig->GetParam(2));
         Value src = Pop(1, sig->GetParam(1));
-        Value dst = Pop(0, sig->GetParam(0));
+        Value dst = Pop(0, mem_type);
         CALL_INTERFACE_IF_REACHABLE(MemoryInit, imm, dst, src, size);
         return opcode_length + imm.length;
       }
@@ -4240,18 +4248,20 @@ class WasmFullDecoder : public WasmDecoder<validate> {
       case kExprMemoryCopy: {
         MemoryCopyImmediate<validate> imm(this, this->pc_ + opcode_length);
         if (!this->Validate(this->pc_ + opcode_length, imm)) return 0;
-        Value size = Pop(2, sig->GetParam(2));
-        Value src = Pop(1, sig->GetParam(1));
-        Value dst = Pop(0, sig->GetParam(0));
+        ValueType mem_type = this->module_->is_memory64 ? kWasmI64 : kWasmI32;
+        Value size = Pop(2, mem_type);
+        Value src = Pop(1, mem_type);
+        Value dst = Pop(0, mem_type);
         CALL_INTERFACE_IF_REACHABLE(MemoryCopy, imm, dst, src, size);
         return opcode_length + imm.length;
       }
       case kExprMemoryFill: {
         MemoryIndexImmediate<validate> imm(this, this->pc_ + opcode_length);
         if (!this->Validate(this->pc_ + opcode_length, imm)) return 0;
-        Value size = Pop(2, sig->GetParam(2));
+        ValueType mem_type = this->module_->is_memory64 ? kWasmI64 : kWasmI32;
+        Value size = Pop(2, mem_type);
         Value value = Pop(1, sig->GetParam(1));
-        Value dst = Pop(0, sig->GetParam(0));
+        Value dst = Pop(0, mem_type);
         CALL_INTERFACE_IF_REACHABLE(MemoryFill, imm, dst, value, size);
         return opcode_length + imm.length;
       }
@@ -14,6 +14,8 @@
 #include "src/utils/ostreams.h"
 #include "src/wasm/baseline/liftoff-compiler.h"
 #include "src/wasm/wasm-code-manager.h"
+#include "src/wasm/wasm-engine.h"
+#include "src/wasm/wasm-function-code-cache.h"
 
 namespace v8 {
 namespace internal {
@@ -121,13 +123,13 @@ ExecutionTier WasmCompilationUnit::GetBaselineExecutionTier(
 WasmCompilationResult WasmCompilationUnit::ExecuteCompilation(
     WasmEngine* engine, CompilationEnv* env,
     const std::shared_ptr<WireBytesStorage>& wire_bytes_storage,
-    Counters* counters, WasmFeatures* detected) {
+    Counters* counters, WasmFeatures* detected, ValidatedBody validated_body) {
   WasmCompilationResult result;
   if (func_index_ < static_cast<int>(env->module->num_imported_functions)) {
     result = ExecuteImportWrapperCompilation(engine, env);
   } else {
     result = ExecuteFunctionCompilation(engine, env, wire_bytes_storage,
-                                        counters, detected);
+                                        counters, detected, validated_body);
   }
 
   if (result.succeeded() && counters) {
@@ -158,7 +160,7 @@ WasmCompilationResult WasmCompilationUnit::ExecuteImportWrapperCompilation(
 WasmCompilationResult WasmCompilationUnit::ExecuteFunctionCompilation(
     WasmEngine* wasm_engine, CompilationEnv* env,
     const std::shared_ptr<WireBytesStorage>& wire_bytes_storage,
-    Counters* counters, WasmFeatures* detected) {
+    Counters* counters, WasmFeatures* detected, ValidatedBody validated_body) {
   auto* func = &env->module->functions[func_index_];
   Vector<const uint8_t> code = wire_bytes_storage->GetCode(func->code);
   wasm::FunctionBody func_body{func->sig, func->code.offset(), code.begin(),
@@ -203,11 +205,35 @@ WasmCompilationResult WasmCompilationUnit::ExecuteFunctionCompilation(
       // function to avoid compiling it twice with TurboFan.
       V8_FALLTHROUGH;
 
-    case ExecutionTier::kTurbofan:
+    case ExecutionTier::kTurbofan: {
+      // Reuse code of an identical function from another module if possible.
+      // Only valid bodies can be keyed. Bodies which have not been validated
+      // yet are validated by TurboFan, and added to the cache afterwards.
+      WasmFunctionCodeCache* cache = wasm_engine->function_code_cache();
+      const bool use_cache = FLAG_wasm_function_code_cache &&
+                             for_debugging_ == kNoDebugging &&
+                             WasmFunctionCodeCache::CanCache(env);
+      base::Optional<WasmFunctionCodeCache::Key> cache_key;
+      if (use_cache && validated_body == kBodyValidated) {
+        cache_key = cache->ComputeKey(env, func_body);
+        result = cache->Lookup(*cache_key, func_body);
+        if (result.succeeded()) {
+          if (FLAG_trace_wasm_compiler) {
+            PrintF("Reusing cached TurboFan code for wasm function %d\n",
+                   func_index_);
+          }
+          break;
+        }
+      }
       result = compiler::ExecuteTurbofanWasmCompilation(
           wasm_engine, env, func_body, func_index_, counters, detected);
       result.for_debugging = for_debugging_;
+      if (use_cache && result.succeeded()) {
+        if (!cache_key) cache_key = cache->ComputeKey(env, func_body);
+        cache->Insert(*cache_key, func_body, result);
+      }
       break;
+    }
   }
 
   return result;
@@ -73,6 +73,11 @@ struct WasmCompilationResult {
   ForDebugging for_debugging = kNoDebugging;
 };
 
+// Whether the body of a function is known to be valid before it gets compiled,
+// e.g. because the function has been compiled before. Only such bodies are
+// looked up in the {WasmFunctionCodeCache}.
+enum ValidatedBody : bool { kBodyNotValidated = false, kBodyValidated = true };
+
 class V8_EXPORT_PRIVATE WasmCompilationUnit final {
  public:
   static ExecutionTier GetBaselineExecutionTier(const WasmModule*);
@@ -82,7 +87,8 @@ class V8_EXPORT_PRIVATE WasmCompilationUnit final {
 
   WasmCompilationResult ExecuteCompilation(
       WasmEngine*, CompilationEnv*, const std::shared_ptr<WireBytesStorage>&,
-      Counters*, WasmFeatures* detected);
+      Counters*, WasmFeatures* detected,
+      ValidatedBody validated_body = kBodyNotValidated);
 
   ExecutionTier tier() const { return tier_; }
   int func_index() const { return func_index_; }
@@ -95,7 +101,7 @@ class V8_EXPORT_PRIVATE WasmCompilationUnit final {
   WasmCompilationResult ExecuteFunctionCompilation(
       WasmEngine* wasm_engine, CompilationEnv* env,
       const std::shared_ptr<WireBytesStorage>& wire_bytes_storage,
-      Counters* counters, WasmFeatures* detected);
+      Counters* counters, WasmFeatures* detected, ValidatedBody validated_body);
 
   WasmCompilationResult ExecuteImportWrapperCompilation(WasmEngine* engine,
                                                         CompilationEnv* env);
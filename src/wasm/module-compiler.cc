@@ -551,8 +551,10 @@ class CompilationStateImpl {
                                      int num_export_wrappers);
 
   // Initialize the compilation progress after deserialization. This is needed
-  // for recompilation (e.g. for tier down) to work later.
-  void InitializeCompilationProgressAfterDeserialization();
+  // for recompilation (e.g. for tier down) to work later. Functions which were
+  // deserialized with Liftoff code get tiered up.
+  void InitializeCompilationProgressAfterDeserialization(
+      Vector<const int> lazy_functions, Vector<const int> liftoff_functions);
 
   // Initialize recompilation of the whole module: Setup compilation progress
   // for recompilation and add the respective compilation units. The callback is
@@ -576,6 +578,11 @@ class CompilationStateImpl {
   void AddTopTierCompilationUnit(WasmCompilationUnit);
   void AddTopTierPriorityCompilationUnit(WasmCompilationUnit, size_t);
 
+  // Queue a TurboFan unit for a function which got hot in Liftoff code, with
+  // its call count as priority. Finished batches of dynamically tiered up
+  // functions are reported to the metrics recorder of {isolate}.
+  void AddDynamicTierUpUnit(Isolate* isolate, int func_index, size_t priority);
+
   CompilationUnitQueues::Queue* GetQueueForCompileTask(int task_id);
 
   base::Optional<WasmCompilationUnit> GetNextCompilationUnit(
@@ -723,6 +730,13 @@ class CompilationStateImpl {
   int outstanding_recompilation_functions_ = 0;
   TieringState tiering_state_ = kTieredUp;
 
+  // Dynamic tier-up requests which are queued but not finished yet. They are
+  // reported as one {WasmModuleTieredUp} event once all of them finished.
+  int outstanding_dynamic_tier_up_functions_ = 0;
+  base::TimeTicks dynamic_tier_up_start_;
+  std::shared_ptr<metrics::Recorder> dynamic_tier_up_recorder_;
+  v8::metrics::Recorder::ContextId dynamic_tier_up_context_id_;
+
   // End of fields protected by {callbacks_mutex_}.
   //////////////////////////////////////////////////////////////////////////////
 
@@ -736,6 +750,7 @@ class CompilationStateImpl {
   using RequiredTopTierField = base::BitField8<ExecutionTier, 2, 2>;
   using ReachedTierField = base::BitField8<ExecutionTier, 4, 2>;
   using MissingRecompilationField = base::BitField8<bool, 6, 1>;
+  using TierUpRequestedField = base::BitField8<bool, 7, 1>;
 };
 
 CompilationStateImpl* Impl(CompilationState* compilation_state) {
@@ -811,8 +826,10 @@ void CompilationState::WaitForTopTierFinished() {
 
 void CompilationState::SetHighPriority() { Impl(this)->SetHighPriority(); }
 
-void CompilationState::InitializeAfterDeserialization() {
-  Impl(this)->InitializeCompilationProgressAfterDeserialization();
+void CompilationState::InitializeAfterDeserialization(
+    Vector<const int> lazy_functions, Vector<const int> liftoff_functions) {
+  Impl(this)->InitializeCompilationProgressAfterDeserialization(
+      lazy_functions, liftoff_functions);
 }
 
 bool CompilationState::failed() const { return Impl(this)->failed(); }
@@ -907,8 +924,10 @@ ExecutionTierPair GetRequestedExecutionTiers(
 
     case CompileMode::kTiering:
 
-      // Default tiering behaviour.
-      result.top_tier = ExecutionTier::kTurbofan;
+      // Default tiering behaviour. With dynamic tiering, functions are only
+      // compiled with TurboFan once they became hot (see {TriggerTierUp}).
+      result.top_tier = FLAG_wasm_dynamic_tiering ? result.baseline_tier
+                                                  : ExecutionTier::kTurbofan;
 
       // Check if compilation hints override default tiering behaviour.
       if (enabled_features.has_compilation_hints()) {
@@ -1037,7 +1056,6 @@ void SetCompileError(ErrorThrower* thrower, ModuleWireBytes wire_bytes,
 
 DecodeResult ValidateSingleFunction(const WasmModule* module, int func_index,
                                     Vector<const uint8_t> code,
-                                    Counters* counters,
                                     AccountingAllocator* allocator,
                                     WasmFeatures enabled_features) {
   const WasmFunction* func = &module->functions[func_index];
@@ -1048,39 +1066,206 @@ DecodeResult ValidateSingleFunction(const WasmModule* module, int func_index,
   return VerifyWasmCode(allocator, enabled_features, module, &detected, body);
 }
 
+// Non-owning wire bytes storage. The bytes must outlive all users.
+class ModuleWireBytesStorage final : public WireBytesStorage {
+ public:
+  explicit ModuleWireBytesStorage(ModuleWireBytes wire_bytes)
+      : wire_bytes_(wire_bytes) {}
+
+  Vector<const uint8_t> GetCode(WireBytesRef ref) const final {
+    return wire_bytes_.module_bytes().SubVector(ref.offset(), ref.end_offset());
+  }
+
+ private:
+  const ModuleWireBytes wire_bytes_;
+};
+
+// Validates function bodies on background threads. Functions can be added
+// while validation is already running, e.g. whenever the streaming decoder
+// delivered another function of the code section. Like sequential validation,
+// it reports the error of the invalid function with the lowest index.
+class ParallelFunctionValidator {
+ public:
+  ParallelFunctionValidator(std::shared_ptr<const WasmModule> module,
+                            std::shared_ptr<WireBytesStorage> wire_bytes,
+                            const WasmFeatures& enabled_features,
+                            AccountingAllocator* allocator)
+      : state_(std::make_shared<State>(std::move(module),
+                                       std::move(wire_bytes), enabled_features,
+                                       allocator)) {}
+
+  ParallelFunctionValidator(const ParallelFunctionValidator&) = delete;
+  ParallelFunctionValidator& operator=(const ParallelFunctionValidator&) =
+      delete;
+
+  ~ParallelFunctionValidator() {
+    // Workers access the wire bytes, which might not be owned by {state_}.
+    if (job_handle_ && job_handle_->IsValid()) job_handle_->Cancel();
+  }
+
+  // Adds a function for validation. Its code must be available from the wire
+  // bytes storage.
+  void AddFunction(int func_index) {
+    DCHECK(!finished_);
+    {
+      base::MutexGuard guard(&state_->mutex);
+      state_->functions.push_back(func_index);
+    }
+    if (!job_handle_ || !job_handle_->IsValid()) {
+      job_handle_ = V8::GetCurrentPlatform()->PostJob(
+          TaskPriority::kUserVisible, std::make_unique<ValidationJob>(state_));
+    } else {
+      job_handle_->NotifyConcurrencyIncrease();
+    }
+  }
+
+  // Waits until all added functions are validated, contributing on the current
+  // thread. Returns false if any function failed validation.
+  bool Finish() {
+    DCHECK(!finished_);
+    finished_ = true;
+    if (job_handle_ && job_handle_->IsValid()) job_handle_->Join();
+    return !failed();
+  }
+
+  bool failed() const {
+    base::MutexGuard guard(&state_->mutex);
+    return state_->error_func_index >= 0;
+  }
+
+  int error_func_index() const {
+    DCHECK(finished_);
+    return state_->error_func_index;
+  }
+
+  const WasmError& error() const {
+    DCHECK(finished_);
+    return state_->error;
+  }
+
+ private:
+  struct State {
+    State(std::shared_ptr<const WasmModule> module,
+          std::shared_ptr<WireBytesStorage> wire_bytes,
+          const WasmFeatures& enabled_features, AccountingAllocator* allocator)
+        : module(std::move(module)),
+          wire_bytes(std::move(wire_bytes)),
+          enabled_features(enabled_features),
+          allocator(allocator) {}
+
+    // Returns false if there is nothing left to do. Functions are handed out
+    // in the order they were added, so after a failure only functions with
+    // higher indexes are skipped.
+    bool GetNextFunction(int* func_index) {
+      base::MutexGuard guard(&mutex);
+      if (error_func_index >= 0) return false;
+      if (next_function == functions.size()) return false;
+      *func_index = functions[next_function++];
+      return true;
+    }
+
+    size_t NumOutstandingFunctions() const {
+      base::MutexGuard guard(&mutex);
+      if (error_func_index >= 0) return 0;
+      return functions.size() - next_function;
+    }
+
+    void Validate(int func_index) {
+      const WasmFunction* func = &module->functions[func_index];
+      DecodeResult result =
+          ValidateSingleFunction(module.get(), func_index,
+                                 wire_bytes->GetCode(func->code), allocator,
+                                 enabled_features);
+      if (result.ok()) return;
+      base::MutexGuard guard(&mutex);
+      if (error_func_index >= 0 && error_func_index < func_index) return;
+      error_func_index = func_index;
+      error = result.error();
+    }
+
+    const std::shared_ptr<const WasmModule> module;
+    const std::shared_ptr<WireBytesStorage> wire_bytes;
+    const WasmFeatures enabled_features;
+    AccountingAllocator* const allocator;
+
+    mutable base::Mutex mutex;
+    // Protected by {mutex}:
+    std::vector<int> functions;
+    size_t next_function = 0;
+    int error_func_index = -1;
+    WasmError error;
+  };
+
+  class ValidationJob final : public JobTask {
+   public:
+    explicit ValidationJob(std::shared_ptr<State> state)
+        : state_(std::move(state)) {}
+
+    void Run(JobDelegate* delegate) override {
+      TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("v8.wasm.detailed"),
+                   "wasm.ValidateFunctions");
+      int func_index;
+      while (!delegate->ShouldYield() && state_->GetNextFunction(&func_index)) {
+        state_->Validate(func_index);
+      }
+    }
+
+    size_t GetMaxConcurrency(size_t worker_count) const override {
+      size_t flag_limit =
+          static_cast<size_t>(std::max(1, FLAG_wasm_num_compilation_tasks));
+      return std::min(flag_limit,
+                      worker_count + state_->NumOutstandingFunctions());
+    }
+
+   private:
+    const std::shared_ptr<State> state_;
+  };
+
+  const std::shared_ptr<State> state_;
+  std::unique_ptr<JobHandle> job_handle_;
+  bool finished_ = false;
+};
+
+bool IsLazilyValidatedFunction(const WasmModule* module,
+                               const WasmFeatures& enabled_features,
+                               int func_index, bool lazy_module) {
+  CompileStrategy strategy =
+      GetCompileStrategy(module, enabled_features, func_index, lazy_module);
+  return strategy == CompileStrategy::kLazy ||
+         strategy == CompileStrategy::kLazyBaselineEagerTopTier;
+}
+
 enum OnlyLazyFunctions : bool {
   kAllFunctions = false,
   kOnlyLazyFunctions = true,
 };
 
-void ValidateSequentially(
-    const WasmModule* module, NativeModule* native_module, Counters* counters,
-    AccountingAllocator* allocator, ErrorThrower* thrower, bool lazy_module,
-    OnlyLazyFunctions only_lazy_functions = kAllFunctions) {
+void ValidateFunctions(NativeModule* native_module,
+                       AccountingAllocator* allocator, ErrorThrower* thrower,
+                       bool lazy_module,
+                       OnlyLazyFunctions only_lazy_functions = kAllFunctions) {
   DCHECK(!thrower->error());
+  const WasmModule* module = native_module->module();
+  ModuleWireBytes wire_bytes{native_module->wire_bytes()};
   uint32_t start = module->num_imported_functions;
   uint32_t end = start + module->num_declared_functions;
   auto enabled_features = native_module->enabled_features();
+  ParallelFunctionValidator validator(
+      native_module->shared_module(),
+      std::make_shared<ModuleWireBytesStorage>(wire_bytes), enabled_features,
+      allocator);
   for (uint32_t func_index = start; func_index < end; func_index++) {
     // Skip non-lazy functions if requested.
-    if (only_lazy_functions) {
-      CompileStrategy strategy =
-          GetCompileStrategy(module, enabled_features, func_index, lazy_module);
-      if (strategy != CompileStrategy::kLazy &&
-          strategy != CompileStrategy::kLazyBaselineEagerTopTier) {
-        continue;
-      }
-    }
-
-    ModuleWireBytes wire_bytes{native_module->wire_bytes()};
-    const WasmFunction* func = &module->functions[func_index];
-    Vector<const uint8_t> code = wire_bytes.GetFunctionBytes(func);
-    DecodeResult result = ValidateSingleFunction(
-        module, func_index, code, counters, allocator, enabled_features);
-    if (result.failed()) {
-      SetCompileError(thrower, wire_bytes, func, module, result.error());
+    if (only_lazy_functions &&
+        !IsLazilyValidatedFunction(module, enabled_features, func_index,
+                                   lazy_module)) {
+      continue;
     }
+    validator.AddFunction(func_index);
   }
+  if (validator.Finish()) return;
+  const WasmFunction* func = &module->functions[validator.error_func_index()];
+  SetCompileError(thrower, wire_bytes, func, module, validator.error());
 }
 
 bool IsLazyModule(const WasmModule* module) {
@@ -1112,9 +1297,13 @@ bool CompileLazy(Isolate* isolate, Handle<WasmModuleObject> module_object,
   WasmCompilationUnit baseline_unit{func_index, tiers.baseline_tier,
                                     kNoDebugging};
   CompilationEnv env = native_module->CreateCompilationEnv();
+  // Without {--wasm-lazy-validation}, lazy functions are validated before the
+  // module starts executing.
+  ValidatedBody validated_body =
+      FLAG_wasm_lazy_validation ? kBodyNotValidated : kBodyValidated;
   WasmCompilationResult result = baseline_unit.ExecuteCompilation(
       isolate->wasm_engine(), &env, compilation_state->GetWireBytesStorage(),
-      counters, compilation_state->detected_features());
+      counters, compilation_state->detected_features(), validated_body);
 
   // During lazy compilation, we can only get compilation errors when
   // {--wasm-lazy-validation} is enabled. Otherwise, the module was fully
@@ -1125,9 +1314,10 @@ bool CompileLazy(Isolate* isolate, Handle<WasmModuleObject> module_object,
     ErrorThrower thrower(isolate, nullptr);
     Vector<const uint8_t> code =
         compilation_state->GetWireBytesStorage()->GetCode(func->code);
-    DecodeResult decode_result = ValidateSingleFunction(
-        module, func_index, code, counters, isolate->wasm_engine()->allocator(),
-        enabled_features);
+    DecodeResult decode_result =
+        ValidateSingleFunction(module, func_index, code,
+                               isolate->wasm_engine()->allocator(),
+                               enabled_features);
     CHECK(decode_result.failed());
     SetCompileError(&thrower, ModuleWireBytes(native_module->wire_bytes()),
                     func, module, decode_result.error());
@@ -1145,9 +1335,12 @@ bool CompileLazy(Isolate* isolate, Handle<WasmModuleObject> module_object,
 
   counters->wasm_lazily_compiled_functions()->Increment();
 
+  // Functions which are tiered up eagerly already have a top tier unit. Also
+  // tier up eagerly compiled functions, which end up here if they were
+  // serialized without code.
   const bool lazy_module = IsLazyModule(module);
-  if (GetCompileStrategy(module, enabled_features, func_index, lazy_module) ==
-          CompileStrategy::kLazy &&
+  if (GetCompileStrategy(module, enabled_features, func_index, lazy_module) !=
+          CompileStrategy::kLazyBaselineEagerTopTier &&
       tiers.baseline_tier < tiers.top_tier) {
     WasmCompilationUnit tiering_unit{func_index, tiers.top_tier, kNoDebugging};
     compilation_state->AddTopTierCompilationUnit(tiering_unit);
@@ -1158,10 +1351,11 @@ bool CompileLazy(Isolate* isolate, Handle<WasmModuleObject> module_object,
 
 void TriggerTierUp(Isolate* isolate, NativeModule* native_module,
                    int func_index) {
+  // Do not tier up while debugging; the Liftoff code is needed for stepping.
+  if (native_module->IsTieredDown()) return;
+
   CompilationStateImpl* compilation_state =
       Impl(native_module->compilation_state());
-  WasmCompilationUnit tiering_unit{func_index, ExecutionTier::kTurbofan,
-                                   kNoDebugging};
 
   uint32_t* call_array = native_module->num_liftoff_function_calls_array();
   int offset =
@@ -1169,7 +1363,8 @@ void TriggerTierUp(Isolate* isolate, NativeModule* native_module,
 
   size_t priority =
       base::Relaxed_Load(reinterpret_cast<int*>(&call_array[offset]));
-  compilation_state->AddTopTierPriorityCompilationUnit(tiering_unit, priority);
+  TRACE_COMPILE("Tier up function #%d (%zu calls)\n", func_index, priority);
+  compilation_state->AddDynamicTierUpUnit(isolate, func_index, priority);
 }
 
 namespace {
@@ -1227,6 +1422,20 @@ const char* GetCompilationEventName(const WasmCompilationUnit& unit,
   }
   return "wasm.OtherCompilation";
 }
+
+// A function which already has code has a valid body. This is only computed
+// for TurboFan units, which are the only ones using the validation state.
+ValidatedBody IsBodyValidated(NativeModule* native_module,
+                              const WasmCompilationUnit& unit) {
+  if (!FLAG_wasm_function_code_cache) return kBodyNotValidated;
+  if (unit.tier() != ExecutionTier::kTurbofan) return kBodyNotValidated;
+  if (unit.func_index() <
+      static_cast<int>(native_module->num_imported_functions())) {
+    return kBodyNotValidated;
+  }
+  return native_module->HasCode(unit.func_index()) ? kBodyValidated
+                                                   : kBodyNotValidated;
+}
 }  // namespace
 
 // Run by the {BackgroundCompileJob} (on any thread).
@@ -1255,6 +1464,7 @@ CompilationExecutionResult ExecuteCompilationUnits(
   DCHECK_LE(0, task_id);
   CompilationUnitQueues::Queue* queue;
   base::Optional<WasmCompilationUnit> unit;
+  ValidatedBody validated_body = kBodyNotValidated;
 
   WasmFeatures detected_features = WasmFeatures::None();
 
@@ -1270,6 +1480,7 @@ CompilationExecutionResult ExecuteCompilationUnits(
     unit = compile_scope.compilation_state()->GetNextCompilationUnit(
         queue, baseline_only);
     if (!unit) return kNoMoreUnits;
+    validated_body = IsBodyValidated(compile_scope.native_module(), *unit);
   }
   TRACE_COMPILE("ExecuteCompilationUnits (task id %d)\n", task_id);
 
@@ -1281,7 +1492,8 @@ CompilationExecutionResult ExecuteCompilationUnits(
     while (unit->tier() == current_tier) {
       // (asynchronous): Execute the compilation.
       WasmCompilationResult result = unit->ExecuteCompilation(
-          wasm_engine, &env.value(), wire_bytes, counters, &detected_features);
+          wasm_engine, &env.value(), wire_bytes, counters, &detected_features,
+          validated_body);
       results_to_publish.emplace_back(std::move(result));
 
       bool yield = delegate && delegate->ShouldYield();
@@ -1325,6 +1537,7 @@ CompilationExecutionResult ExecuteCompilationUnits(
         compile_scope.compilation_state()->SchedulePublishCompilationResults(
             std::move(unpublished_code));
       }
+      validated_body = IsBodyValidated(compile_scope.native_module(), *unit);
     }
   }
   UNREACHABLE();
@@ -1479,7 +1692,10 @@ class CompilationTimeCallback {
       };
       metrics_recorder_->DelayMainThreadEvent(event, context_id_);
     }
-    if (event == CompilationEvent::kFinishedTopTierCompilation) {
+    // With dynamic tiering, top tier compilation finishes together with
+    // baseline compilation; tier-up is reported per batch of hot functions.
+    if (event == CompilationEvent::kFinishedTopTierCompilation &&
+        !FLAG_wasm_dynamic_tiering) {
       TimedHistogram* histogram = async_counters_->wasm_tier_up_module_time();
       histogram->AddSample(static_cast<int>(duration.InMicroseconds()));
 
@@ -1529,9 +1745,8 @@ void CompileNativeModule(Isolate* isolate,
     // Validate wasm modules for lazy compilation if requested. Never validate
     // asm.js modules as these are valid by construction (additionally a CHECK
     // will catch this during lazy compilation).
-    ValidateSequentially(wasm_module, native_module.get(), isolate->counters(),
-                         isolate->allocator(), thrower, lazy_module,
-                         kOnlyLazyFunctions);
+    ValidateFunctions(native_module.get(), isolate->allocator(), thrower,
+                      lazy_module, kOnlyLazyFunctions);
     // On error: Return and leave the module in an unexecutable state.
     if (thrower->error()) return;
   }
@@ -1554,8 +1769,8 @@ void CompileNativeModule(Isolate* isolate,
 
   if (compilation_state->failed()) {
     DCHECK_IMPLIES(lazy_module, !FLAG_wasm_lazy_validation);
-    ValidateSequentially(wasm_module, native_module.get(), isolate->counters(),
-                         isolate->allocator(), thrower, lazy_module);
+    ValidateFunctions(native_module.get(), isolate->allocator(), thrower,
+                      lazy_module);
     CHECK(thrower->error());
     return;
   }
@@ -1574,8 +1789,8 @@ void CompileNativeModule(Isolate* isolate,
 
   if (compilation_state->failed()) {
     DCHECK_IMPLIES(lazy_module, !FLAG_wasm_lazy_validation);
-    ValidateSequentially(wasm_module, native_module.get(), isolate->counters(),
-                         isolate->allocator(), thrower, lazy_module);
+    ValidateFunctions(native_module.get(), isolate->allocator(), thrower,
+                      lazy_module);
     CHECK(thrower->error());
   } else if (FLAG_predictable) {
     compilation_state->FinalizeJSToWasmWrappers(
@@ -1785,6 +2000,8 @@ class AsyncStreamingProcessor final : public StreamingProcessor {
   AsyncCompileJob* job_;
   WasmEngine* wasm_engine_;
   std::unique_ptr<CompilationUnitBuilder> compilation_unit_builder_;
+  // Validates lazily compiled functions while the stream is still running.
+  std::unique_ptr<ParallelFunctionValidator> validator_;
   int num_functions_ = 0;
   bool prefix_cache_hit_ = false;
   bool before_code_section_ = true;
@@ -1960,9 +2177,8 @@ void AsyncCompileJob::AsyncCompileFailed() {
   ErrorThrower thrower(isolate_, api_method_name_);
   DCHECK_EQ(native_module_->module()->origin, kWasmOrigin);
   const bool lazy_module = wasm_lazy_compilation_;
-  ValidateSequentially(native_module_->module(), native_module_.get(),
-                       isolate_->counters(), isolate_->allocator(), &thrower,
-                       lazy_module);
+  ValidateFunctions(native_module_.get(), isolate_->allocator(), &thrower,
+                    lazy_module);
   DCHECK(thrower.error());
   // {job} keeps the {this} pointer alive.
   std::shared_ptr<AsyncCompileJob> job =
@@ -2196,30 +2412,19 @@ class AsyncCompileJob::DecodeModule : public AsyncCompileJob::CompileStep {
         DCHECK_EQ(module->origin, kWasmOrigin);
         const bool lazy_module = job->wasm_lazy_compilation_;
         if (MayCompriseLazyFunctions(module, enabled_features, lazy_module)) {
-          auto allocator = job->isolate()->wasm_engine()->allocator();
+          ParallelFunctionValidator validator(
+              result.value(),
+              std::make_shared<ModuleWireBytesStorage>(job->wire_bytes_),
+              enabled_features, job->isolate()->wasm_engine()->allocator());
           int start = module->num_imported_functions;
           int end = start + module->num_declared_functions;
-
           for (int func_index = start; func_index < end; func_index++) {
-            const WasmFunction* func = &module->functions[func_index];
-            Vector<const uint8_t> code =
-                job->wire_bytes_.GetFunctionBytes(func);
-
-            CompileStrategy strategy = GetCompileStrategy(
-                module, enabled_features, func_index, lazy_module);
-            bool validate_lazily_compiled_function =
-                strategy == CompileStrategy::kLazy ||
-                strategy == CompileStrategy::kLazyBaselineEagerTopTier;
-            if (validate_lazily_compiled_function) {
-              DecodeResult function_result =
-                  ValidateSingleFunction(module, func_index, code, counters_,
-                                         allocator, enabled_features);
-              if (function_result.failed()) {
-                result = ModuleResult(function_result.error());
-                break;
-              }
+            if (IsLazilyValidatedFunction(module, enabled_features, func_index,
+                                          lazy_module)) {
+              validator.AddFunction(func_index);
             }
           }
+          if (!validator.Finish()) result = ModuleResult(validator.error());
         }
       }
     }
@@ -2513,6 +2718,16 @@ bool AsyncStreamingProcessor::ProcessCodeSectionHeader(
   decoder_.set_code_section(code_section_start,
                             static_cast<uint32_t>(code_section_length));
 
+  DCHECK_EQ(kWasmOrigin, decoder_.module()->origin);
+  const bool lazy_module = job_->wasm_lazy_compilation_;
+  if (!FLAG_wasm_lazy_validation &&
+      MayCompriseLazyFunctions(decoder_.module(), job_->enabled_features_,
+                               lazy_module)) {
+    validator_ = std::make_unique<ParallelFunctionValidator>(
+        decoder_.shared_module(), wire_bytes_storage, job_->enabled_features_,
+        allocator_);
+  }
+
   prefix_hash_ = base::hash_combine(prefix_hash_,
                                     static_cast<uint32_t>(code_section_length));
   if (!wasm_engine_->GetStreamingCompilationOwnership(prefix_hash_)) {
@@ -2525,7 +2740,6 @@ bool AsyncStreamingProcessor::ProcessCodeSectionHeader(
   // task.
   int num_imported_functions =
       static_cast<int>(decoder_.module()->num_imported_functions);
-  DCHECK_EQ(kWasmOrigin, decoder_.module()->origin);
   const bool uses_liftoff = FLAG_liftoff;
   size_t code_size_estimate =
       wasm::WasmCodeManager::EstimateNativeModuleCodeSize(
@@ -2537,7 +2751,6 @@ bool AsyncStreamingProcessor::ProcessCodeSectionHeader(
   auto* compilation_state = Impl(job_->native_module_->compilation_state());
   compilation_state->SetWireBytesStorage(std::move(wire_bytes_storage));
   DCHECK_EQ(job_->native_module_->module()->origin, kWasmOrigin);
-  const bool lazy_module = job_->wasm_lazy_compilation_;
 
   // Set outstanding_finishers_ to 2, because both the AsyncCompileJob and the
   // AsyncStreamingProcessor have to finish.
@@ -2573,21 +2786,17 @@ bool AsyncStreamingProcessor::ProcessFunctionBody(Vector<const uint8_t> bytes,
   const bool lazy_module = job_->wasm_lazy_compilation_;
   CompileStrategy strategy =
       GetCompileStrategy(module, enabled_features, func_index, lazy_module);
-  bool validate_lazily_compiled_function =
-      !FLAG_wasm_lazy_validation &&
-      (strategy == CompileStrategy::kLazy ||
-       strategy == CompileStrategy::kLazyBaselineEagerTopTier);
-  if (validate_lazily_compiled_function) {
-    // The native module does not own the wire bytes until {SetWireBytes} is
-    // called in {OnFinishedStream}. Validation must use {bytes} parameter.
-    DecodeResult result =
-        ValidateSingleFunction(module, func_index, bytes, async_counters_.get(),
-                               allocator_, enabled_features);
-
-    if (result.failed()) {
-      FinishAsyncCompileJobWithError(result.error());
+  if (validator_ && (strategy == CompileStrategy::kLazy ||
+                     strategy == CompileStrategy::kLazyBaselineEagerTopTier)) {
+    // Report errors of previously added functions as early as possible.
+    if (validator_->failed()) {
+      validator_->Finish();
+      FinishAsyncCompileJobWithError(validator_->error());
       return false;
     }
+    // The code is available from the wire bytes storage of the code section,
+    // which is kept alive by the validator.
+    validator_->AddFunction(func_index);
   }
 
   // Don't compile yet if we might have a cache hit.
@@ -2626,6 +2835,11 @@ void AsyncStreamingProcessor::OnFinishedChunk() {
 void AsyncStreamingProcessor::OnFinishedStream(OwnedVector<uint8_t> bytes) {
   TRACE_STREAMING("Finish stream...\n");
   DCHECK_EQ(NativeModuleCache::PrefixHash(bytes.as_vector()), prefix_hash_);
+  // Wait for the validation of the remaining functions.
+  if (validator_ && !validator_->Finish()) {
+    FinishAsyncCompileJobWithError(validator_->error());
+    return;
+  }
   ModuleResult result = decoder_.FinishDecoding(false);
   if (result.failed()) {
     FinishAsyncCompileJobWithError(result.error());
@@ -2832,19 +3046,56 @@ void CompilationStateImpl::InitializeCompilationProgress(
   TriggerCallbacks();
 }
 
-void CompilationStateImpl::InitializeCompilationProgressAfterDeserialization() {
+void CompilationStateImpl::InitializeCompilationProgressAfterDeserialization(
+    Vector<const int> lazy_functions, Vector<const int> liftoff_functions) {
   auto* module = native_module_->module();
-  base::MutexGuard guard(&callbacks_mutex_);
-  DCHECK(compilation_progress_.empty());
-  constexpr uint8_t kProgressAfterDeserialization =
-      RequiredBaselineTierField::encode(ExecutionTier::kTurbofan) |
-      RequiredTopTierField::encode(ExecutionTier::kTurbofan) |
-      ReachedTierField::encode(ExecutionTier::kTurbofan);
-  finished_events_.Add(CompilationEvent::kFinishedExportWrappers);
-  finished_events_.Add(CompilationEvent::kFinishedBaselineCompilation);
-  finished_events_.Add(CompilationEvent::kFinishedTopTierCompilation);
-  compilation_progress_.assign(module->num_declared_functions,
-                               kProgressAfterDeserialization);
+  auto enabled_features = native_module_->enabled_features();
+  std::vector<WasmCompilationUnit> top_tier_units;
+  {
+    base::MutexGuard guard(&callbacks_mutex_);
+    DCHECK(compilation_progress_.empty());
+    constexpr uint8_t kProgressAfterDeserialization =
+        RequiredBaselineTierField::encode(ExecutionTier::kTurbofan) |
+        RequiredTopTierField::encode(ExecutionTier::kTurbofan) |
+        ReachedTierField::encode(ExecutionTier::kTurbofan);
+    finished_events_.Add(CompilationEvent::kFinishedExportWrappers);
+    finished_events_.Add(CompilationEvent::kFinishedBaselineCompilation);
+    compilation_progress_.assign(module->num_declared_functions,
+                                 kProgressAfterDeserialization);
+
+    // Lazy functions do not contribute to the compilation progress, like in
+    // lazy modules.
+    constexpr uint8_t kProgressForLazyFunction =
+        RequiredBaselineTierField::encode(ExecutionTier::kNone) |
+        RequiredTopTierField::encode(ExecutionTier::kNone) |
+        ReachedTierField::encode(ExecutionTier::kNone);
+    for (int func_index : lazy_functions) {
+      compilation_progress_[declared_function_index(module, func_index)] =
+          kProgressForLazyFunction;
+    }
+
+    // Liftoff code gets tiered up like after baseline compilation: right away,
+    // or once it got hot with dynamic tiering.
+    for (int func_index : liftoff_functions) {
+      ExecutionTierPair requested_tiers = GetRequestedExecutionTiers(
+          module, compile_mode(), enabled_features, func_index);
+      ExecutionTier top_tier =
+          std::max(ExecutionTier::kLiftoff, requested_tiers.top_tier);
+      compilation_progress_[declared_function_index(module, func_index)] =
+          RequiredBaselineTierField::encode(ExecutionTier::kLiftoff) |
+          RequiredTopTierField::encode(top_tier) |
+          ReachedTierField::encode(ExecutionTier::kLiftoff);
+      if (top_tier == ExecutionTier::kLiftoff) continue;
+      outstanding_top_tier_functions_++;
+      top_tier_units.emplace_back(func_index, top_tier, kNoDebugging);
+    }
+    if (outstanding_top_tier_functions_ == 0) {
+      finished_events_.Add(CompilationEvent::kFinishedTopTierCompilation);
+    }
+  }
+  if (!top_tier_units.empty()) {
+    AddCompilationUnits({}, VectorOf(top_tier_units), {});
+  }
 }
 
 void CompilationStateImpl::InitializeRecompilation(
@@ -2978,6 +3229,41 @@ void CompilationStateImpl::AddTopTierPriorityCompilationUnit(
   ScheduleCompileJobForNewUnits();
 }
 
+void CompilationStateImpl::AddDynamicTierUpUnit(Isolate* isolate,
+                                                int func_index,
+                                                size_t priority) {
+  {
+    base::MutexGuard guard(&callbacks_mutex_);
+    DCHECK_EQ(compilation_progress_.size(),
+              native_module_->module()->num_declared_functions);
+    int slot_index =
+        declared_function_index(native_module_->module(), func_index);
+    uint8_t function_progress = compilation_progress_[slot_index];
+    // Skip functions which are already available in TurboFan code.
+    if (ReachedTierField::decode(function_progress) ==
+        ExecutionTier::kTurbofan) {
+      return;
+    }
+    // A function which is requested again while it is still queued is queued
+    // once more with its higher call count. The queue compiles the first of
+    // the copies to come out and drops the others.
+    if (!TierUpRequestedField::decode(function_progress)) {
+      compilation_progress_[slot_index] =
+          TierUpRequestedField::update(function_progress, true);
+      if (outstanding_dynamic_tier_up_functions_++ == 0) {
+        // First function of a new batch.
+        dynamic_tier_up_start_ = base::TimeTicks::Now();
+        dynamic_tier_up_recorder_ = isolate->metrics_recorder();
+        dynamic_tier_up_context_id_ =
+            isolate->GetOrRegisterRecorderContextId(isolate->native_context());
+      }
+    }
+  }
+  AddTopTierPriorityCompilationUnit(
+      WasmCompilationUnit{func_index, ExecutionTier::kTurbofan, kNoDebugging},
+      priority);
+}
+
 std::shared_ptr<JSToWasmWrapperCompilationUnit>
 CompilationStateImpl::GetNextJSToWasmWrapperCompilationUnit() {
   int wrapper_id =
@@ -3031,7 +3317,8 @@ void CompilationStateImpl::OnFinishedUnits(Vector<WasmCode*> code_vector) {
   // Compilation progress was not set up in these cases.
   if (outstanding_baseline_units_ == 0 && outstanding_export_wrappers_ == 0 &&
       outstanding_top_tier_functions_ == 0 &&
-      outstanding_recompilation_functions_ == 0) {
+      outstanding_recompilation_functions_ == 0 &&
+      outstanding_dynamic_tier_up_functions_ == 0) {
     return;
   }
 
@@ -3084,6 +3371,26 @@ void CompilationStateImpl::OnFinishedUnits(Vector<WasmCode*> code_vector) {
         outstanding_top_tier_functions_--;
       }
 
+      if (V8_UNLIKELY(TierUpRequestedField::decode(function_progress)) &&
+          code->tier() == ExecutionTier::kTurbofan) {
+        DCHECK_LT(0, outstanding_dynamic_tier_up_functions_);
+        compilation_progress_[slot_index] =
+            TierUpRequestedField::update(function_progress, false);
+        if (--outstanding_dynamic_tier_up_functions_ == 0 &&
+            base::TimeTicks::IsHighResolution()) {
+          // All requested functions of this batch are available in TurboFan
+          // code now.
+          v8::metrics::WasmModuleTieredUp event{
+              FLAG_wasm_lazy_compilation,            // lazy
+              native_module_->turbofan_code_size(),  // code_size_in_bytes
+              (base::TimeTicks::Now() - dynamic_tier_up_start_)
+                  .InMicroseconds()  // wall_clock_duration_in_us
+          };
+          dynamic_tier_up_recorder_->DelayMainThreadEvent(
+              event, dynamic_tier_up_context_id_);
+        }
+      }
+
       if (V8_UNLIKELY(MissingRecompilationField::decode(function_progress))) {
         DCHECK_LT(0, outstanding_recompilation_functions_);
         // If tiering up, accept any TurboFan code. For tiering down, look at
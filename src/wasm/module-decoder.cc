@@ -638,9 +638,11 @@ class ModuleDecoderImpl : public Decoder {
           if (!AddMemory(module_.get())) break;
           uint8_t flags = validate_memory_flags(&module_->has_shared_memory,
                                                 &module_->is_memory64);
-          consume_resizable_limits("memory", "pages", max_mem_pages(),
+          uint32_t max_pages =
+              module_->is_memory64 ? max_mem64_pages() : max_mem_pages();
+          consume_resizable_limits("memory", "pages", max_pages,
                                    &module_->initial_pages,
-                                   &module_->has_maximum_pages, max_mem_pages(),
+                                   &module_->has_maximum_pages, max_pages,
                                    &module_->maximum_pages, flags);
           break;
         }
@@ -739,9 +741,11 @@ class ModuleDecoderImpl : public Decoder {
       if (!AddMemory(module_.get())) break;
       uint8_t flags = validate_memory_flags(&module_->has_shared_memory,
                                             &module_->is_memory64);
-      consume_resizable_limits("memory", "pages", max_mem_pages(),
+      uint32_t max_pages =
+          module_->is_memory64 ? max_mem64_pages() : max_mem_pages();
+      consume_resizable_limits("memory", "pages", max_pages,
                                &module_->initial_pages,
-                               &module_->has_maximum_pages, max_mem_pages(),
+                               &module_->has_maximum_pages, max_pages,
                                &module_->maximum_pages, flags);
     }
   }
@@ -2109,10 +2113,11 @@ class ModuleDecoderImpl : public Decoder {
 
     // We know now that the flag is valid. Time to read the rest.
     size_t num_globals = module_.get()->globals.size();
+    ValueType offset_type = module_->is_memory64 ? kWasmI64 : kWasmI32;
     if (flag == SegmentFlags::kActiveNoIndex) {
       *is_active = true;
       *index = 0;
-      *offset = consume_init_expr(module_.get(), kWasmI32, num_globals);
+      *offset = consume_init_expr(module_.get(), offset_type, num_globals);
       return;
     }
     if (flag == SegmentFlags::kPassive) {
@@ -2122,7 +2127,7 @@ class ModuleDecoderImpl : public Decoder {
     if (flag == SegmentFlags::kActiveWithIndex) {
       *is_active = true;
       *index = consume_u32v("memory index");
-      *offset = consume_init_expr(module_.get(), kWasmI32, num_globals);
+      *offset = consume_init_expr(module_.get(), offset_type, num_globals);
     }
   }
 
@@ -51,6 +51,24 @@ uint32_t EvalUint32InitExpr(Handle<WasmInstanceObject> instance,
   }
 }
 
+uint64_t EvalUint64InitExpr(Handle<WasmInstanceObject> instance,
+                            const WasmInitExpr& expr) {
+  switch (expr.kind()) {
+    case WasmInitExpr::kI64Const:
+      return expr.immediate().i64_const;
+    case WasmInitExpr::kGlobalGet: {
+      uint32_t offset =
+          instance->module()->globals[expr.immediate().index].offset;
+      auto raw_addr = reinterpret_cast<Address>(
+                          instance->untagged_globals_buffer().backing_store()) +
+                      offset;
+      return ReadLittleEndianValue<uint64_t>(raw_addr);
+    }
+    default:
+      UNREACHABLE();
+  }
+}
+
 namespace {
 
 byte* raw_buffer_ptr(MaybeHandle<JSArrayBuffer> buffer, int offset) {
@@ -859,6 +877,12 @@ MaybeHandle<Object> InstanceBuilder::LookupImportAsm(
 void InstanceBuilder::LoadDataSegments(Handle<WasmInstanceObject> instance) {
   Vector<const uint8_t> wire_bytes =
       module_object_->native_module()->wire_bytes();
+  // Memory64 memories can be larger than 4 GiB, so compute with 64 bits.
+  auto eval_dest_offset = [&](const WasmDataSegment& segment) -> uint64_t {
+    return module_->is_memory64
+               ? EvalUint64InitExpr(instance, segment.dest_addr)
+               : EvalUint32InitExpr(instance, segment.dest_addr);
+  };
   for (const WasmDataSegment& segment : module_->data_segments) {
     uint32_t size = segment.source.length();
 
@@ -866,10 +890,9 @@ void InstanceBuilder::LoadDataSegments(Handle<WasmInstanceObject> instance) {
       // Passive segments are not copied during instantiation.
       if (!segment.active) continue;
 
-      uint32_t dest_offset = EvalUint32InitExpr(instance, segment.dest_addr);
-      bool ok = base::ClampToBounds(
-          dest_offset, &size, static_cast<uint32_t>(instance->memory_size()));
-      if (!ok) {
+      uint64_t dest_offset = eval_dest_offset(segment);
+      if (!base::IsInBounds<uint64_t>(dest_offset, size,
+                                      instance->memory_size())) {
         thrower_->RuntimeError("data segment is out of bounds");
         return;
       }
@@ -882,7 +905,7 @@ void InstanceBuilder::LoadDataSegments(Handle<WasmInstanceObject> instance) {
       // Segments of size == 0 are just nops.
       if (size == 0) continue;
 
-      uint32_t dest_offset = EvalUint32InitExpr(instance, segment.dest_addr);
+      uint64_t dest_offset = eval_dest_offset(segment);
       DCHECK(base::IsInBounds<uint64_t>(dest_offset, size,
                                         instance->memory_size()));
       byte* dest = instance->memory_start() + dest_offset;
@@ -1079,6 +1102,22 @@ bool InstanceBuilder::ProcessImportedFunction(
       entry.SetWasmToJs(isolate_, js_receiver, wasm_code);
       break;
     }
+    case compiler::WasmImportCallKind::kWasmToJSFastApi: {
+      // The wrapper embeds the address of the C function, hence it is compiled
+      // for this import and not cached.
+      NativeModule* native_module = instance->module_object().native_module();
+      WasmCodeRefScope code_ref_scope;
+      WasmCode* wasm_code = compiler::CompileWasmJSFastCallWrapper(
+          isolate_->wasm_engine(), native_module, expected_sig, js_receiver);
+      isolate_->counters()->wasm_generated_code_size()->Increment(
+          wasm_code->instructions().length());
+      isolate_->counters()->wasm_reloc_size()->Increment(
+          wasm_code->reloc_info().length());
+
+      ImportedFunctionEntry entry(instance, func_index);
+      entry.SetWasmToJs(isolate_, js_receiver, wasm_code);
+      break;
+    }
     default: {
       // The imported function is a callable.
 
@@ -1452,7 +1491,8 @@ void InstanceBuilder::CompileImportWrappers(
     compiler::WasmImportCallKind kind = resolved.first;
     if (kind == compiler::WasmImportCallKind::kWasmToWasm ||
         kind == compiler::WasmImportCallKind::kLinkError ||
-        kind == compiler::WasmImportCallKind::kWasmToCapi) {
+        kind == compiler::WasmImportCallKind::kWasmToCapi ||
+        kind == compiler::WasmImportCallKind::kWasmToJSFastApi) {
       continue;
     }
 
@@ -1700,9 +1740,11 @@ void InstanceBuilder::InitGlobals(Handle<WasmInstanceObject> instance) {
 // Allocate memory for a module instance as a new JSArrayBuffer.
 bool InstanceBuilder::AllocateMemory() {
   uint32_t initial_pages = module_->initial_pages;
+  uint32_t engine_max_pages =
+      module_->is_memory64 ? max_mem64_pages() : max_mem_pages();
   uint32_t maximum_pages =
-      module_->has_maximum_pages ? module_->maximum_pages : max_mem_pages();
-  if (initial_pages > max_mem_pages()) {
+      module_->has_maximum_pages ? module_->maximum_pages : engine_max_pages;
+  if (initial_pages > engine_max_pages) {
     thrower_->RangeError("Out of memory: wasm memory too large");
     return false;
   }
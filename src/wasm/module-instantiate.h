@@ -41,6 +41,9 @@ bool LoadElemSegment(Isolate* isolate, Handle<WasmInstanceObject> instance,
 uint32_t EvalUint32InitExpr(Handle<WasmInstanceObject> instance,
                             const WasmInitExpr& expr);
 
+uint64_t EvalUint64InitExpr(Handle<WasmInstanceObject> instance,
+                            const WasmInitExpr& expr);
+
 }  // namespace wasm
 }  // namespace internal
 }  // namespace v8
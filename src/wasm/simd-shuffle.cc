@@ -58,6 +58,18 @@ bool SimdShuffle::TryMatchIdentity(const uint8_t* shuffle) {
   return true;
 }
 
+bool SimdShuffle::TryMatch64x2Shuffle(const uint8_t* shuffle,
+                                      uint8_t* shuffle64x2) {
+  for (int i = 0; i < 2; ++i) {
+    if (shuffle[i * 8] % 8 != 0) return false;
+    for (int j = 1; j < 8; ++j) {
+      if (shuffle[i * 8 + j] - shuffle[i * 8 + j - 1] != 1) return false;
+    }
+    shuffle64x2[i] = shuffle[i * 8] / 8;
+  }
+  return true;
+}
+
 bool SimdShuffle::TryMatch32x4Shuffle(const uint8_t* shuffle,
                                       uint8_t* shuffle32x4) {
   for (int i = 0; i < 4; ++i) {
@@ -106,6 +118,11 @@ bool SimdShuffle::TryMatchBlend(const uint8_t* shuffle) {
   return true;
 }
 
+bool SimdShuffle::TryMatchShufps(const uint8_t* shuffle32x4) {
+  return shuffle32x4[0] < 4 && shuffle32x4[1] < 4 && shuffle32x4[2] >= 4 &&
+         shuffle32x4[3] >= 4;
+}
+
 uint8_t SimdShuffle::PackShuffle4(uint8_t* shuffle) {
   return (shuffle[0] & 3) | ((shuffle[1] & 3) << 2) | ((shuffle[2] & 3) << 4) |
          ((shuffle[3] & 3) << 6);
@@ -51,6 +51,11 @@ class V8_EXPORT_PRIVATE SimdShuffle {
     return true;
   }
 
+  // Tries to match an 8x16 byte shuffle to an equivalent 64x2 shuffle. If
+  // successful, it writes the 64x2 shuffle word indices. E.g.
+  // [0 1 2 3 4 5 6 7 24 25 26 27 28 29 30 31] == [0 3]
+  static bool TryMatch64x2Shuffle(const uint8_t* shuffle, uint8_t* shuffle64x2);
+
   // Tries to match an 8x16 byte shuffle to an equivalent 32x4 shuffle. If
   // successful, it writes the 32x4 shuffle word indices. E.g.
   // [0 1 2 3 8 9 10 11 4 5 6 7 12 13 14 15] == [0 2 1 3]
@@ -73,6 +78,11 @@ class V8_EXPORT_PRIVATE SimdShuffle {
   // shuffle should be canonicalized.
   static bool TryMatchBlend(const uint8_t* shuffle);
 
+  // Tries to match a 32x4 shuffle to one which takes its two low lanes from
+  // the first input and its two high lanes from the second, in any order.
+  // E.g. [1 0 7 4]. The shuffle should be canonicalized.
+  static bool TryMatchShufps(const uint8_t* shuffle32x4);
+
   // Packs a 4 lane shuffle into a single imm8 suitable for use by pshufd,
   // pshuflw, and pshufhw.
   static uint8_t PackShuffle4(uint8_t* shuffle);
@@ -4,6 +4,7 @@
 
 #include "src/wasm/wasm-code-manager.h"
 
+#include <algorithm>
 #include <iomanip>
 
 #include "src/base/build_config.h"
@@ -147,6 +148,16 @@ base::AddressRegion DisjointAllocationPool::AllocateInRegion(
   return {};
 }
 
+bool DisjointAllocationPool::Overlaps(base::AddressRegion region) const {
+  if (region.is_empty()) return false;
+  // Only the last region starting before the end of {region} can overlap with
+  // it, since all regions are disjoint and sorted.
+  auto it = regions_.lower_bound(base::AddressRegion{region.end(), 0});
+  if (it == regions_.begin()) return false;
+  --it;
+  return it->end() > region.begin();
+}
+
 Address WasmCode::constant_pool() const {
   if (FLAG_enable_embedded_constant_pool) {
     if (constant_pool_offset_ < code_comments_offset_) {
@@ -633,7 +644,6 @@ Vector<byte> WasmCodeAllocator::AllocateForCodeInRegion(
   DCHECK(locked_lock.is_locked());
   DCHECK_EQ(code_manager_, native_module->engine()->code_manager());
   DCHECK_LT(0, size);
-  v8::PageAllocator* page_allocator = GetPlatformPageAllocator();
   size = RoundUp<kCodeAlignment>(size);
   base::AddressRegion code_space =
       free_code_space_.AllocateInRegion(size, region);
@@ -668,18 +678,42 @@ Vector<byte> WasmCodeAllocator::AllocateForCodeInRegion(
     async_counters_->wasm_module_num_code_spaces()->AddSample(
         static_cast<int>(owned_code_space_.size()));
   }
-  const Address commit_page_size = page_allocator->CommitPageSize();
-  Address commit_start = RoundUp(code_space.begin(), commit_page_size);
+  return CommitAllocatedCodeSpaceLocked(code_space);
+}
+
+Vector<byte> WasmCodeAllocator::TryAllocateForCodeInRegion(
+    size_t size, base::AddressRegion region) {
+  DCHECK_LT(0, size);
+  base::MutexGuard lock(&mutex_);
+  size = RoundUp<kCodeAlignment>(size);
+  base::AddressRegion code_space =
+      free_code_space_.AllocateInRegion(size, region);
+  if (code_space.is_empty()) return {};
+  return CommitAllocatedCodeSpaceLocked(code_space);
+}
+
+Vector<byte> WasmCodeAllocator::CommitAllocatedCodeSpaceLocked(
+    base::AddressRegion code_space) {
+  // The caller must hold the {mutex_}, thus we fail to lock it here.
+  DCHECK(!mutex_.TryLock());
+  const Address commit_page_size = GetPlatformPageAllocator()->CommitPageSize();
+  // Exactly the pages overlapping with {allocated_code_space_} are committed.
+  // Since {code_space} was free before, only the first and the last page of
+  // the allocation can already be committed.
+  Address commit_start = RoundDown(code_space.begin(), commit_page_size);
   Address commit_end = RoundUp(code_space.end(), commit_page_size);
-  // {commit_start} will be either code_space.start or the start of the next
-  // page. {commit_end} will be the start of the page after the one in which
-  // the allocation ends.
-  // We start from an aligned start, and we know we allocated vmem in
-  // page multiples.
-  // We just need to commit what's not committed. The page in which we
-  // start is already committed (or we start at the beginning of a page).
-  // The end needs to be committed all through the end of the page.
+  if (allocated_code_space_.Overlaps({commit_start, commit_page_size})) {
+    commit_start += commit_page_size;
+  }
+  if (commit_start < commit_end &&
+      allocated_code_space_.Overlaps(
+          {commit_end - commit_page_size, commit_page_size})) {
+    commit_end -= commit_page_size;
+  }
   if (commit_start < commit_end) {
+    // Wait until concurrent decommits of these pages are done, see
+    // {FreeCode}.
+    base::MutexGuard commit_guard(&commit_mutex_);
     for (base::AddressRegion split_range : SplitRangeByReservationsIfNeeded(
              {commit_start, commit_end - commit_start}, owned_code_space_)) {
       code_manager_->Commit(split_range);
@@ -693,7 +727,7 @@ Vector<byte> WasmCodeAllocator::AllocateForCodeInRegion(
   generated_code_size_.fetch_add(code_space.size(), std::memory_order_relaxed);
 
   TRACE_HEAP("Code alloc for %p: 0x%" PRIxPTR ",+%zu\n", this,
-             code_space.begin(), size);
+             code_space.begin(), code_space.size());
   return {reinterpret_cast<byte*>(code_space.begin()), code_space.size()};
 }
 
@@ -727,8 +761,10 @@ bool WasmCodeAllocator::SetExecutable(bool executable) {
     for (auto& region : allocated_code_space_.regions()) {
       // allocated_code_space_ is fine-grained, so we need to
       // page-align it.
-      size_t region_size = RoundUp(region.size(), commit_page_size);
-      if (!SetPermissions(page_allocator, region.begin(), region_size,
+      Address region_start = RoundDown(region.begin(), commit_page_size);
+      size_t region_size =
+          RoundUp(region.end(), commit_page_size) - region_start;
+      if (!SetPermissions(page_allocator, region_start, region_size,
                           permission)) {
         return false;
       }
@@ -741,50 +777,70 @@ bool WasmCodeAllocator::SetExecutable(bool executable) {
   return true;
 }
 
-void WasmCodeAllocator::FreeCode(Vector<WasmCode* const> codes) {
-  // Zap code area and collect freed code regions.
-  DisjointAllocationPool freed_regions;
+void WasmCodeAllocator::FreeCode(const DisjointAllocationPool& freed_regions) {
+  // Zap code area.
   size_t code_size = 0;
   CODE_SPACE_WRITE_SCOPE
-  for (WasmCode* code : codes) {
-    ZapCode(code->instruction_start(), code->instructions().size());
-    FlushInstructionCache(code->instruction_start(),
-                          code->instructions().size());
-    code_size += code->instructions().size();
-    freed_regions.Merge(base::AddressRegion{code->instruction_start(),
-                                            code->instructions().size()});
+  for (auto region : freed_regions.regions()) {
+    ZapCode(region.begin(), region.size());
+    FlushInstructionCache(region.begin(), region.size());
+    code_size += region.size();
   }
   freed_code_size_.fetch_add(code_size);
 
-  // Merge {freed_regions} into {freed_code_space_} and put all ranges of full
-  // pages to decommit into {regions_to_decommit} (decommitting is expensive,
-  // so try to merge regions before decommitting).
+  // Remove {freed_regions} from {allocated_code_space_} and put all ranges of
+  // pages which do not hold any code any more into {regions_to_decommit}
+  // (decommitting is expensive, so try to merge regions before decommitting).
   DisjointAllocationPool regions_to_decommit;
+  std::vector<base::AddressRegion> ranges_to_decommit;
   PageAllocator* allocator = GetPlatformPageAllocator();
   size_t commit_page_size = allocator->CommitPageSize();
+  // The pages are decommitted while holding only {commit_mutex_}, such that
+  // allocations can continue in the meantime. An allocation which needs to
+  // commit one of these pages again waits for {commit_mutex_}, so it commits
+  // the page after it was decommitted here.
+  base::Optional<base::MutexGuard> commit_guard;
   {
     base::MutexGuard guard(&mutex_);
     for (auto region : freed_regions.regions()) {
-      auto merged_region = freed_code_space_.Merge(region);
-      Address discard_start =
-          std::max(RoundUp(merged_region.begin(), commit_page_size),
-                   RoundDown(region.begin(), commit_page_size));
-      Address discard_end =
-          std::min(RoundDown(merged_region.end(), commit_page_size),
-                   RoundUp(region.end(), commit_page_size));
+      base::AddressRegion removed =
+          allocated_code_space_.AllocateInRegion(region.size(), region);
+      DCHECK_EQ(region, removed);
+      USE(removed);
+      // Only the first and the last page can still hold other code.
+      Address discard_start = RoundDown(region.begin(), commit_page_size);
+      Address discard_end = RoundUp(region.end(), commit_page_size);
+      if (allocated_code_space_.Overlaps({discard_start, commit_page_size})) {
+        discard_start += commit_page_size;
+      }
+      if (discard_start < discard_end &&
+          allocated_code_space_.Overlaps(
+              {discard_end - commit_page_size, commit_page_size})) {
+        discard_end -= commit_page_size;
+      }
       if (discard_start >= discard_end) continue;
       regions_to_decommit.Merge({discard_start, discard_end - discard_start});
     }
-  }
 
-  for (auto region : regions_to_decommit.regions()) {
-    size_t old_committed = committed_code_space_.fetch_sub(region.size());
-    DCHECK_GE(old_committed, region.size());
-    USE(old_committed);
-    for (base::AddressRegion split_range :
-         SplitRangeByReservationsIfNeeded(region, owned_code_space_)) {
-      code_manager_->Decommit(split_range);
+    for (auto region : regions_to_decommit.regions()) {
+      size_t old_committed = committed_code_space_.fetch_sub(region.size());
+      DCHECK_GE(old_committed, region.size());
+      USE(old_committed);
+      for (base::AddressRegion split_range :
+           SplitRangeByReservationsIfNeeded(region, owned_code_space_)) {
+        ranges_to_decommit.push_back(split_range);
+      }
     }
+
+    // The freed code is not executing anywhere any more, so its space can be
+    // reused for new code.
+    for (auto region : freed_regions.regions()) free_code_space_.Merge(region);
+
+    if (!ranges_to_decommit.empty()) commit_guard.emplace(&commit_mutex_);
+  }
+
+  for (base::AddressRegion range : ranges_to_decommit) {
+    code_manager_->Decommit(range);
   }
 }
 
@@ -821,13 +877,12 @@ NativeModule::NativeModule(WasmEngine* engine, const WasmFeatures& enabled,
   if (module_->num_declared_functions > 0) {
     code_table_ =
         std::make_unique<WasmCode*[]>(module_->num_declared_functions);
+    // Call counters start at zero; Liftoff code requests tier-up once a
+    // counter reaches {FLAG_wasm_tiering_budget}.
     num_liftoff_function_calls_ =
         std::make_unique<uint32_t[]>(module_->num_declared_functions);
-
-    // Start counter at 4 to avoid runtime calls for smaller numbers.
-    constexpr int kCounterStart = 4;
     std::fill_n(num_liftoff_function_calls_.get(),
-                module_->num_declared_functions, kCounterStart);
+                module_->num_declared_functions, 0);
   }
   code_allocator_.Init(this);
 }
@@ -866,6 +921,7 @@ void NativeModule::LogWasmCodes(Isolate* isolate, int script_id) {
   // will also include import wrappers.
   WasmCodeRefScope code_ref_scope;
   base::MutexGuard lock(&allocation_mutex_);
+  if (!new_owned_code_.empty()) TransferNewOwnedCodeLocked();
   for (auto& owned_entry : owned_code_) {
     owned_entry.second->LogCode(isolate, script_id);
   }
@@ -1072,9 +1128,11 @@ std::unique_ptr<WasmCode> NativeModule::AddCodeWithCodeSpace(
   // Flush the i-cache after relocation.
   FlushInstructionCache(dst_code_bytes.begin(), dst_code_bytes.size());
 
-  // Liftoff code will not be relocated or serialized, thus do not store any
-  // relocation information.
-  if (tier == ExecutionTier::kLiftoff) reloc_info = {};
+  // Code for debugging will not be relocated or serialized, thus do not store
+  // any relocation information. All other code is assembled with options that
+  // record the relocation information needed for serialization (see
+  // {WasmAssemblerOptions} and {DefaultLiftoffOptions}).
+  if (for_debugging != kNoDebugging) reloc_info = {};
 
   std::unique_ptr<WasmCode> code{new WasmCode{
       this, index, dst_code_bytes, stack_slots, tagged_parameter_slots,
@@ -1087,6 +1145,59 @@ std::unique_ptr<WasmCode> NativeModule::AddCodeWithCodeSpace(
   return code;
 }
 
+std::unique_ptr<WasmCode> NativeModule::RelocateCode(
+    WasmCode* code, Vector<uint8_t> dst_code_bytes) {
+  DCHECK_EQ(kNoDebugging, code->for_debugging());
+  DCHECK_LE(code->instructions().size(), dst_code_bytes.size());
+  CODE_SPACE_WRITE_SCOPE
+  base::Memcpy(dst_code_bytes.begin(), code->instructions().begin(),
+               code->instructions().size());
+
+  // Calls to wasm functions and runtime stubs keep their targets, since the
+  // jump tables of the code space are still in reach. Only pc-relative
+  // encodings and internal references need to be adjusted.
+  intptr_t delta = dst_code_bytes.begin() - code->instructions().begin();
+  int mode_mask = RelocInfo::ModeMask(RelocInfo::WASM_CALL) |
+                  RelocInfo::ModeMask(RelocInfo::WASM_STUB_CALL) |
+                  RelocInfo::ModeMask(RelocInfo::INTERNAL_REFERENCE) |
+                  RelocInfo::ModeMask(RelocInfo::INTERNAL_REFERENCE_ENCODED);
+  RelocIterator orig_it(code->instructions(), code->reloc_info(),
+                        code->constant_pool(), mode_mask);
+  for (RelocIterator it(dst_code_bytes, code->reloc_info(),
+                        reinterpret_cast<Address>(dst_code_bytes.begin()) +
+                            code->constant_pool_offset(),
+                        mode_mask);
+       !it.done(); it.next(), orig_it.next()) {
+    RelocInfo::Mode mode = it.rinfo()->rmode();
+    if (RelocInfo::IsWasmCall(mode)) {
+      it.rinfo()->set_wasm_call_address(orig_it.rinfo()->wasm_call_address(),
+                                        SKIP_ICACHE_FLUSH);
+    } else if (RelocInfo::IsWasmStubCall(mode)) {
+      it.rinfo()->set_wasm_stub_call_address(
+          orig_it.rinfo()->wasm_stub_call_address(), SKIP_ICACHE_FLUSH);
+    } else {
+      Address target = orig_it.rinfo()->target_internal_reference() + delta;
+      Assembler::deserialization_set_target_internal_reference_at(
+          it.rinfo()->pc(), target, mode);
+    }
+  }
+
+  // Flush the i-cache after relocation.
+  FlushInstructionCache(dst_code_bytes.begin(), dst_code_bytes.size());
+
+  std::unique_ptr<WasmCode> new_code{new WasmCode{
+      this, static_cast<int>(code->index()), dst_code_bytes,
+      code->stack_slots(), code->tagged_parameter_slots(),
+      code->safepoint_table_offset(), code->handler_table_offset(),
+      code->constant_pool_offset(), code->code_comments_offset(),
+      code->unpadded_binary_size(), code->protected_instructions_data(),
+      code->reloc_info(), code->source_positions(), code->kind(), code->tier(),
+      kNoDebugging}};
+  new_code->Validate();
+
+  return new_code;
+}
+
 WasmCode* NativeModule::PublishCode(std::unique_ptr<WasmCode> code) {
   TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("v8.wasm.detailed"),
                "wasm.PublishCode");
@@ -1171,10 +1282,35 @@ WasmCode* NativeModule::PublishCodeLocked(std::unique_ptr<WasmCode> code) {
   }
   WasmCodeRefScope::AddRef(code.get());
   WasmCode* result = code.get();
-  owned_code_.emplace(result->instruction_start(), std::move(code));
+  new_owned_code_.emplace_back(std::move(code));
   return result;
 }
 
+void NativeModule::TransferNewOwnedCodeLocked() const {
+  // The caller holds the allocation mutex.
+  DCHECK(!allocation_mutex_.TryLock());
+  DCHECK(!new_owned_code_.empty());
+  // Sort the {new_owned_code_} vector reversed, such that the position of the
+  // previously inserted element can be used as a hint for the next element. If
+  // elements in {new_owned_code_} are adjacent, this will guarantee
+  // constant-time insertion into the map.
+  std::sort(new_owned_code_.begin(), new_owned_code_.end(),
+            [](const std::unique_ptr<WasmCode>& a,
+               const std::unique_ptr<WasmCode>& b) {
+              return a->instruction_start() > b->instruction_start();
+            });
+  auto insertion_hint = owned_code_.end();
+  for (auto& code : new_owned_code_) {
+    DCHECK_EQ(0, owned_code_.count(code->instruction_start()));
+    // Check plausibility of the insertion hint.
+    DCHECK(insertion_hint == owned_code_.end() ||
+           insertion_hint->first > code->instruction_start());
+    insertion_hint = owned_code_.emplace_hint(
+        insertion_hint, code->instruction_start(), std::move(code));
+  }
+  new_owned_code_.clear();
+}
+
 std::unique_ptr<WasmCode> NativeModule::AllocateDeserializedCode(
     int index, Vector<const byte> instructions, int stack_slots,
     int tagged_parameter_slots, int safepoint_table_offset,
@@ -1439,6 +1575,7 @@ void NativeModule::SetWireBytes(OwnedVector<const uint8_t> wire_bytes) {
 
 WasmCode* NativeModule::Lookup(Address pc) const {
   base::MutexGuard lock(&allocation_mutex_);
+  if (!new_owned_code_.empty()) TransferNewOwnedCodeLocked();
   auto iter = owned_code_.upper_bound(pc);
   if (iter == owned_code_.begin()) return nullptr;
   --iter;
@@ -1568,8 +1705,9 @@ NativeModule::~NativeModule() {
   compilation_state_->CancelCompilation();
   engine_->FreeNativeModule(this);
   // Free the import wrapper cache before releasing the {WasmCode} objects in
-  // {owned_code_}. The destructor of {WasmImportWrapperCache} still needs to
-  // decrease reference counts on the {WasmCode} objects.
+  // {owned_code_} and {new_owned_code_}. The destructor of
+  // {WasmImportWrapperCache} still needs to decrease reference counts on the
+  // {WasmCode} objects.
   import_wrapper_cache_.reset();
 }
 
@@ -1969,14 +2107,18 @@ std::vector<int> NativeModule::FindFunctionsToRecompile(
 }
 
 void NativeModule::FreeCode(Vector<WasmCode* const> codes) {
-  // Free the code space.
-  code_allocator_.FreeCode(codes);
+  DisjointAllocationPool freed_regions;
+  for (WasmCode* code : codes) {
+    freed_regions.Merge(base::AddressRegionOf(code->instructions()));
+  }
 
   DebugInfo* debug_info = nullptr;
   {
     base::MutexGuard guard(&allocation_mutex_);
     debug_info = debug_info_.get();
     // Free the {WasmCode} objects. This will also unregister trap handler data.
+    // This needs to happen before the code space can be reused.
+    if (!new_owned_code_.empty()) TransferNewOwnedCodeLocked();
     for (WasmCode* code : codes) {
       DCHECK_EQ(1, owned_code_.count(code->instruction_start()));
       owned_code_.erase(code->instruction_start());
@@ -1985,6 +2127,96 @@ void NativeModule::FreeCode(Vector<WasmCode* const> codes) {
   // Remove debug side tables for all removed code objects, after releasing our
   // lock. This is to avoid lock order inversion.
   if (debug_info) debug_info->RemoveDebugSideTables(codes);
+
+  // Free the code space.
+  code_allocator_.FreeCode(freed_regions);
+}
+
+size_t NativeModule::CompactCode() {
+  TRACE_EVENT0("v8.wasm", "wasm.CompactCode");
+  size_t committed = committed_code_space();
+  size_t live = generated_code_size() - freed_code_size();
+  if (committed <= live ||
+      (committed - live) * 100 <
+          committed * size_t{FLAG_wasm_code_compaction_threshold}) {
+    return 0;
+  }
+
+  WasmCodeRefScope code_ref_scope;
+  // Collect the current code of all functions, and the code spaces they live
+  // in. Code for debugging has no relocation information and is referenced
+  // from the {DebugInfo}, thus it never gets moved.
+  std::vector<WasmCode*> candidates;
+  std::vector<base::AddressRegion> code_spaces;
+  {
+    base::MutexGuard guard(&allocation_mutex_);
+    if (tiering_state_ == kTieredDown) return 0;
+    for (uint32_t i = 0; i < module_->num_declared_functions; ++i) {
+      WasmCode* code = code_table_[i];
+      // Debugging code can still be installed after tiering up again.
+      if (code == nullptr || code->for_debugging()) continue;
+      WasmCodeRefScope::AddRef(code);
+      candidates.push_back(code);
+    }
+    for (auto& code_space_data : code_space_data_) {
+      code_spaces.push_back(code_space_data.region);
+    }
+  }
+  // Handle code in the order of addresses, such that code at low addresses
+  // fills the gaps first.
+  std::sort(candidates.begin(), candidates.end(),
+            [](WasmCode* a, WasmCode* b) {
+              return a->instruction_start() < b->instruction_start();
+            });
+
+  const size_t commit_page_size = GetPlatformPageAllocator()->CommitPageSize();
+  std::vector<WasmCode*> relocated_code;
+  size_t relocated_size = 0;
+  for (WasmCode* code : candidates) {
+    auto code_space = std::find_if(
+        code_spaces.begin(), code_spaces.end(),
+        [code](base::AddressRegion region) {
+          return region.contains(code->instruction_start());
+        });
+    DCHECK_NE(code_spaces.end(), code_space);
+    // Only move code to a lower page, moving within the same page would not
+    // release any memory.
+    Address gap_end = RoundDown(code->instruction_start(), commit_page_size);
+    if (gap_end <= code_space->begin()) continue;
+    Vector<uint8_t> dst_code_bytes = code_allocator_.TryAllocateForCodeInRegion(
+        code->instructions().size(),
+        {code_space->begin(), gap_end - code_space->begin()});
+    if (dst_code_bytes.empty()) continue;
+    std::unique_ptr<WasmCode> new_code = RelocateCode(code, dst_code_bytes);
+
+    base::MutexGuard guard(&allocation_mutex_);
+    uint32_t slot_idx = declared_function_index(module(), code->index());
+    // The function might have been tiered up or down concurrently.
+    bool install =
+        code_table_[slot_idx] == code && tiering_state_ == kTieredUp;
+    if (install) {
+      new_code->RegisterTrapHandlerData();
+      code_table_[slot_idx] = new_code.get();
+      PatchJumpTablesLocked(slot_idx, new_code->instruction_start());
+      // The old code is added to the current {WasmCodeRefScope}, hence the ref
+      // count cannot drop to zero here. It gets freed by the next code GC.
+      CHECK(!code->DecRef());
+      relocated_code.push_back(new_code.get());
+      relocated_size += new_code->instructions().size();
+    }
+    WasmCodeRefScope::AddRef(new_code.get());
+    WasmCode* new_code_ptr = new_code.get();
+    new_owned_code_.emplace_back(std::move(new_code));
+    // If the copy was not installed, drop the reference held by the code table
+    // such that it gets freed again.
+    if (!install) CHECK(!new_code_ptr->DecRef());
+  }
+  engine_->LogCode(VectorOf(relocated_code));
+  return relocated_size;
+}
+
+size_t NativeModule::GetNumberOfCodeSpaces() const {
+  return code_allocator_.GetNumCodeSpaces();
 }
 
 size_t NativeModule::GetNumberOfCodeSpacesForTesting() const {
@@ -107,6 +107,9 @@ class V8_EXPORT_PRIVATE DisjointAllocationPool final {
   // empty pool on failure.
   base::AddressRegion AllocateInRegion(size_t size, base::AddressRegion);
 
+  // Check whether any region of this pool overlaps with the given region.
+  bool Overlaps(base::AddressRegion) const;
+
   bool IsEmpty() const { return regions_.empty(); }
 
   const auto& regions() const { return regions_; }
@@ -423,12 +426,18 @@ class WasmCodeAllocator {
                                        base::AddressRegion,
                                        const WasmCodeAllocator::OptionalLock&);
 
+  // Allocate code space within a specific region, without reserving new code
+  // space. Returns an empty vector if there is no free gap which is big enough.
+  Vector<byte> TryAllocateForCodeInRegion(size_t size, base::AddressRegion);
+
   // Sets permissions of all owned code space to executable, or read-write (if
   // {executable} is false). Returns true on success.
   V8_EXPORT_PRIVATE bool SetExecutable(bool executable);
 
-  // Free memory pages of all given code objects. Used for wasm code GC.
-  void FreeCode(Vector<WasmCode* const>);
+  // Free the given code regions, such that they can be reused by later
+  // allocations. Pages which do not hold any code any more are decommitted.
+  // Used for wasm code GC.
+  void FreeCode(const DisjointAllocationPool& freed_regions);
 
   // Retrieve the number of separately reserved code spaces.
   size_t GetNumCodeSpaces() const;
@@ -439,6 +448,11 @@ class WasmCodeAllocator {
   static constexpr base::AddressRegion kUnrestrictedRegion{
       kNullAddress, std::numeric_limits<size_t>::max()};
 
+  // Commit all pages of the freshly allocated {code_space} which are not
+  // committed yet, and account for the allocation. Hold the {mutex_} when
+  // calling this method.
+  Vector<byte> CommitAllocatedCodeSpaceLocked(base::AddressRegion code_space);
+
   // The engine-wide wasm code manager.
   WasmCodeManager* const code_manager_;
 
@@ -451,15 +465,18 @@ class WasmCodeAllocator {
   // {owned_code_space_}).
   DisjointAllocationPool free_code_space_;
   // Code space that was allocated for code (subset of {owned_code_space_}).
+  // Exactly the pages overlapping with this pool are committed.
   DisjointAllocationPool allocated_code_space_;
-  // Code space that was allocated before but is dead now. Full pages within
-  // this region are discarded. It's still a subset of {owned_code_space_}.
-  DisjointAllocationPool freed_code_space_;
   std::vector<VirtualMemory> owned_code_space_;
 
   // End of fields protected by {mutex_}.
   //////////////////////////////////////////////////////////////////////////////
 
+  // Held while committing or decommitting code pages. {FreeCode} decommits
+  // pages while holding only this mutex; allocations take it while holding
+  // {mutex_}, so the order is {mutex_} before {commit_mutex_}.
+  base::Mutex commit_mutex_;
+
   std::atomic<size_t> committed_code_space_{0};
   std::atomic<size_t> generated_code_size_{0};
   std::atomic<size_t> freed_code_size_{0};
@@ -600,6 +617,7 @@ class V8_EXPORT_PRIVATE NativeModule final {
   size_t generated_code_size() const {
     return code_allocator_.generated_code_size();
   }
+  size_t freed_code_size() const { return code_allocator_.freed_code_size(); }
   size_t liftoff_bailout_count() const { return liftoff_bailout_count_.load(); }
   size_t liftoff_code_size() const { return liftoff_code_size_.load(); }
   size_t turbofan_code_size() const { return turbofan_code_size_.load(); }
@@ -658,6 +676,17 @@ class V8_EXPORT_PRIVATE NativeModule final {
   // its accounting.
   void FreeCode(Vector<WasmCode* const>);
 
+  // Move the current code of functions into free gaps at lower addresses of
+  // the same code space, and patch the jump tables to point to the moved code.
+  // The old code objects are released and get freed by wasm code GC once they
+  // are not executing anywhere any more. Does nothing if the module is tiered
+  // down or if less than {FLAG_wasm_code_compaction_threshold} percent of the
+  // committed code space is unused. Returns the size of the moved code.
+  size_t CompactCode();
+
+  // Retrieve the number of separately reserved code spaces.
+  size_t GetNumberOfCodeSpaces() const;
+
   // Retrieve the number of separately reserved code spaces for this module.
   size_t GetNumberOfCodeSpacesForTesting() const;
 
@@ -698,6 +727,11 @@ class V8_EXPORT_PRIVATE NativeModule final {
       ExecutionTier tier, ForDebugging for_debugging,
       Vector<uint8_t> code_space, const JumpTablesRef& jump_tables_ref);
 
+  // Copy {code} to {dst_code_bytes}, which must be in the same code space,
+  // and adjust its relocation information to the new location.
+  std::unique_ptr<WasmCode> RelocateCode(WasmCode* code,
+                                         Vector<uint8_t> dst_code_bytes);
+
   WasmCode* CreateEmptyJumpTableInRegion(
       int jump_table_size, base::AddressRegion,
       const WasmCodeAllocator::OptionalLock&);
@@ -718,6 +752,10 @@ class V8_EXPORT_PRIVATE NativeModule final {
   // Hold the {allocation_mutex_} when calling {PublishCodeLocked}.
   WasmCode* PublishCodeLocked(std::unique_ptr<WasmCode>);
 
+  // Transfer owned code from {new_owned_code_} to {owned_code_}. Hold the
+  // {allocation_mutex_} when calling this method.
+  void TransferNewOwnedCodeLocked() const;
+
   // {WasmCodeAllocator} manages all code reservations and allocations for this
   // {NativeModule}.
   WasmCodeAllocator code_allocator_;
@@ -766,9 +804,16 @@ class V8_EXPORT_PRIVATE NativeModule final {
   //////////////////////////////////////////////////////////////////////////////
   // Protected by {allocation_mutex_}:
 
-  // Holds all allocated code objects. For lookup based on pc, the key is the
-  // instruction start address of the value.
-  std::map<Address, std::unique_ptr<WasmCode>> owned_code_;
+  // Holds allocated code objects for fast lookup and deletion. For lookup based
+  // on pc, the key is the instruction start address of the value. Filled
+  // lazily from {new_owned_code_} (below).
+  mutable std::map<Address, std::unique_ptr<WasmCode>> owned_code_;
+
+  // Holds owned code which is not inserted into {owned_code_} yet. It will be
+  // inserted on demand, which is much cheaper than inserting individual code
+  // objects into the map. All new code objects (including relocated copies of
+  // existing code) are added here.
+  mutable std::vector<std::unique_ptr<WasmCode>> new_owned_code_;
 
   // Table of the latest code object per function, updated on initial
   // compilation and tier up. The number of entries is
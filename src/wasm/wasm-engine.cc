@@ -12,6 +12,7 @@
 #include "src/execution/frames.h"
 #include "src/execution/v8threads.h"
 #include "src/logging/counters.h"
+#include "src/logging/metrics.h"
 #include "src/objects/heap-number.h"
 #include "src/objects/js-promise.h"
 #include "src/objects/objects-inl.h"
@@ -1201,6 +1202,56 @@ class SampleTopTierCodeSizeTask : public CancelableTask {
 };
 }  // namespace
 
+namespace {
+// Compacts the code space of a module after code GC freed some of its code
+// (if enabled), and reports the code space usage to the metrics recorders of
+// all isolates using the module. Only one task is posted per module and code
+// GC, to one of these isolates, so the module is compacted only once.
+class WasmCodeSpaceTask : public CancelableTask {
+ public:
+  WasmCodeSpaceTask(Isolate* isolate, std::weak_ptr<NativeModule> native_module)
+      : CancelableTask(isolate), native_module_(std::move(native_module)) {}
+
+  void RunInternal() override {
+    std::shared_ptr<NativeModule> native_module = native_module_.lock();
+    if (!native_module) return;
+    size_t relocated_size = 0;
+    if (FLAG_wasm_code_compaction) {
+      NativeModuleModificationScope modification_scope(native_module.get());
+      relocated_size = native_module->CompactCode();
+    }
+    native_module->engine()->ReportCodeSpaceUsageInAllIsolates(
+        native_module.get(), relocated_size);
+  }
+
+ private:
+  const std::weak_ptr<NativeModule> native_module_;
+};
+}  // namespace
+
+void WasmEngine::ReportCodeSpaceUsageInAllIsolates(
+    NativeModule* native_module, size_t relocated_code_size) {
+  size_t committed = native_module->committed_code_space();
+  size_t freed = native_module->freed_code_size();
+  size_t live = native_module->generated_code_size() - freed;
+  v8::metrics::WasmModuleCodeSpaceUsage event{
+      native_module->GetNumberOfCodeSpaces(),   // code_space_count
+      committed,                                // committed_code_space
+      live,                                     // live_code_size
+      freed,                                    // freed_code_size
+      committed > live ? committed - live : 0,  // fragmented_code_space
+      relocated_code_size                       // relocated_code_size
+  };
+  base::MutexGuard lock(&mutex_);
+  auto it = native_modules_.find(native_module);
+  if (it == native_modules_.end()) return;
+  // Isolates stay registered (and alive) while we hold the {mutex_}. The
+  // recorders accept events from any thread.
+  for (Isolate* isolate : it->second->isolates) {
+    isolate->metrics_recorder()->AddThreadSafeEvent(event);
+  }
+}
+
 void WasmEngine::SampleTopTierCodeSizeInAllIsolates(
     const std::shared_ptr<NativeModule>& native_module) {
   base::MutexGuard lock(&mutex_);
@@ -1411,6 +1462,18 @@ void WasmEngine::PotentiallyFinishCurrentGC() {
 
   FreeDeadCodeLocked(dead_code);
 
+  // Let all modules which freed code compact their code space if enabled, and
+  // report their code space usage. The task runs on any one isolate using the
+  // module, and reports to all of them.
+  for (auto& dead_code_entry : dead_code) {
+    NativeModuleInfo* info = native_modules_[dead_code_entry.first].get();
+    if (info->isolates.empty()) continue;
+    Isolate* isolate = *info->isolates.begin();
+    DCHECK_EQ(1, isolates_.count(isolate));
+    isolates_[isolate]->foreground_task_runner->PostTask(
+        std::make_unique<WasmCodeSpaceTask>(isolate, info->weak_ptr));
+  }
+
   TRACE_CODE_GC("Found %zu dead code objects, freed %zu.\n",
                 current_gc_info_->dead_code.size(), num_freed);
   USE(num_freed);
@@ -1448,6 +1511,13 @@ uint32_t max_mem_pages() {
   return std::min(uint32_t{kV8MaxWasmMemoryPages}, FLAG_wasm_max_mem_pages);
 }
 
+// {max_mem64_pages} is declared in wasm-limits.h.
+uint32_t max_mem64_pages() {
+  STATIC_ASSERT(kV8MaxWasmMemory64Pages <= kMaxUInt32);
+  return std::min(uint32_t{kV8MaxWasmMemory64Pages},
+                  FLAG_wasm_max_mem64_pages);
+}
+
 // {max_table_init_entries} is declared in wasm-limits.h.
 uint32_t max_table_init_entries() {
   return std::min(uint32_t{kV8MaxWasmTableInitEntries},
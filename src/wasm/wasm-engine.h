@@ -16,6 +16,7 @@
 #include "src/tasks/cancelable-task.h"
 #include "src/tasks/operations-barrier.h"
 #include "src/wasm/wasm-code-manager.h"
+#include "src/wasm/wasm-function-code-cache.h"
 #include "src/wasm/wasm-tier.h"
 #include "src/zone/accounting-allocator.h"
 
@@ -216,6 +217,10 @@ class V8_EXPORT_PRIVATE WasmEngine {
 
   AccountingAllocator* allocator() { return &allocator_; }
 
+  // TurboFan code of individual functions, shared across all modules of this
+  // engine (see --wasm-function-code-cache).
+  WasmFunctionCodeCache* function_code_cache() { return &function_code_cache_; }
+
   // Compilation statistics for TurboFan compilations.
   CompilationStatistics* GetOrCreateTurboStatistics();
 
@@ -313,6 +318,12 @@ class V8_EXPORT_PRIVATE WasmEngine {
   // This will spawn foreground tasks that do *not* keep the NativeModule alive.
   void SampleTopTierCodeSizeInAllIsolates(const std::shared_ptr<NativeModule>&);
 
+  // Report the code space usage of the given {NativeModule} to the metrics
+  // recorders of all isolates that have access to it. {relocated_code_size} is
+  // the size of code moved by the last compaction, if any.
+  void ReportCodeSpaceUsageInAllIsolates(NativeModule*,
+                                         size_t relocated_code_size);
+
   // Called by each Isolate to report its live code for a GC cycle. First
   // version reports an externally determined set of live code (might be empty),
   // second version gets live code from the execution stack of that isolate.
@@ -372,6 +383,7 @@ class V8_EXPORT_PRIVATE WasmEngine {
 
   WasmCodeManager code_manager_;
   AccountingAllocator allocator_;
+  WasmFunctionCodeCache function_code_cache_{&allocator_};
 
 #ifdef V8_ENABLE_WASM_GDB_REMOTE_DEBUGGING
   // Implements a GDB-remote stub for WebAssembly debugging.
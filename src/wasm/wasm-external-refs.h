@@ -95,6 +95,8 @@ V8_EXPORT_PRIVATE void f32x4_trunc_wrapper(Address data);
 
 V8_EXPORT_PRIVATE void f32x4_nearest_int_wrapper(Address data);
 
+// Memory offsets and sizes are passed as {uintptr_t}, since memory64 memories
+// can be larger than 4 GiB.
 // The return type is {int32_t} instead of {bool} to enforce the compiler to
 // zero-extend the result in the return register.
 int32_t memory_init_wrapper(Address data);
@@ -0,0 +1,309 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/wasm/wasm-function-code-cache.h"
+
+#include "src/base/functional.h"
+#include "src/base/platform/wrappers.h"
+#include "src/codegen/assembler-inl.h"
+#include "src/codegen/reloc-info.h"
+#include "src/codegen/source-position-table.h"
+#include "src/wasm/compilation-environment.h"
+#include "src/wasm/function-body-decoder-impl.h"
+#include "src/wasm/function-body-decoder.h"
+#include "src/wasm/wasm-module.h"
+#include "src/zone/zone.h"
+
+namespace v8 {
+namespace internal {
+namespace wasm {
+
+namespace {
+
+class KeyBuilder {
+ public:
+  void Add(uint32_t value) {
+    for (int i = 0; i < 4; ++i) bytes_.push_back((value >> (8 * i)) & 0xff);
+  }
+
+  void Add(uint64_t value) {
+    Add(static_cast<uint32_t>(value));
+    Add(static_cast<uint32_t>(value >> 32));
+  }
+
+  void AddType(ValueType type) { Add(type.raw_bit_field()); }
+
+  void AddSignature(const FunctionSig* sig) {
+    Add(static_cast<uint32_t>(sig->parameter_count()));
+    Add(static_cast<uint32_t>(sig->return_count()));
+    for (ValueType type : sig->all()) AddType(type);
+  }
+
+  void AddBytes(const byte* start, const byte* end) {
+    Add(static_cast<uint32_t>(end - start));
+    bytes_.insert(bytes_.end(), start, end);
+  }
+
+  std::vector<uint8_t> Release() { return std::move(bytes_); }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+// Adds the module-level declarations referenced from {body} to {key}. The body
+// must be valid.
+void AddReferencedDeclarations(Zone* zone, const WasmModule* module,
+                               const WasmFeatures& enabled,
+                               const FunctionBody& body, KeyBuilder* key) {
+  bool uses_table_instructions = false;
+  BodyLocalDecls decls(zone);
+  BytecodeIterator it(body.start, body.end, &decls);
+  for (; it.has_next(); it.next()) {
+    WasmOpcode opcode = it.current();
+    switch (opcode) {
+      case kExprBlock:
+      case kExprLoop:
+      case kExprIf:
+      case kExprTry: {
+        BlockTypeImmediate<Decoder::kNoValidation> imm(enabled, &it,
+                                                       it.pc() + 1, module);
+        if (imm.type != kWasmBottom) break;
+        key->Add(static_cast<uint32_t>(opcode));
+        key->AddSignature(module->signature(imm.sig_index));
+        break;
+      }
+      case kExprCallFunction:
+      case kExprReturnCall: {
+        CallFunctionImmediate<Decoder::kNoValidation> imm(&it, it.pc() + 1);
+        key->Add(static_cast<uint32_t>(opcode));
+        key->Add(uint32_t{imm.index < module->num_imported_functions});
+        key->AddSignature(module->functions[imm.index].sig);
+        break;
+      }
+      case kExprCallIndirect:
+      case kExprReturnCallIndirect: {
+        CallIndirectImmediate<Decoder::kNoValidation> imm(enabled, &it,
+                                                          it.pc() + 1);
+        key->Add(static_cast<uint32_t>(opcode));
+        key->AddSignature(module->signature(imm.sig_index));
+        key->Add(module->canonicalized_type_ids[imm.sig_index]);
+        key->AddType(module->tables[imm.table_index].type);
+        break;
+      }
+      case kExprGlobalGet:
+      case kExprGlobalSet: {
+        GlobalIndexImmediate<Decoder::kNoValidation> imm(&it, it.pc() + 1);
+        const WasmGlobal& global = module->globals[imm.index];
+        key->Add(static_cast<uint32_t>(opcode));
+        key->AddType(global.type);
+        key->Add(uint32_t{global.mutability});
+        key->Add(uint32_t{global.imported});
+        key->Add(global.offset);
+        break;
+      }
+      case kExprTableGet:
+      case kExprTableSet: {
+        TableIndexImmediate<Decoder::kNoValidation> imm(&it, it.pc() + 1);
+        key->Add(static_cast<uint32_t>(opcode));
+        key->AddType(module->tables[imm.index].type);
+        break;
+      }
+      case kExprThrow:
+      case kExprCatch: {
+        ExceptionIndexImmediate<Decoder::kNoValidation> imm(&it, it.pc() + 1);
+        key->Add(static_cast<uint32_t>(opcode));
+        key->AddSignature(module->exceptions[imm.index].sig);
+        break;
+      }
+      case kNumericPrefix:
+        switch (it.prefixed_opcode()) {
+          case kExprTableInit:
+          case kExprTableCopy:
+          case kExprTableGrow:
+          case kExprTableSize:
+          case kExprTableFill:
+            uses_table_instructions = true;
+            break;
+          default:
+            break;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  // Table instructions behind the numeric prefix are rare, so do not bother
+  // decoding their table indexes.
+  if (uses_table_instructions) {
+    key->Add(static_cast<uint32_t>(module->tables.size()));
+    for (const WasmTable& table : module->tables) key->AddType(table.type);
+  }
+}
+
+// Copies the instructions and relocation information of {desc} to {buffer},
+// which must hold {desc.instr_size + desc.reloc_size} bytes. Internal
+// references are adjusted to the new location. Calls to wasm functions and
+// runtime stubs are still encoded as tags and stay untouched.
+CodeDesc CopyCodeDesc(const CodeDesc& desc, byte* buffer) {
+  CodeDesc copy = desc;
+  copy.buffer = buffer;
+  copy.buffer_size = desc.instr_size + desc.reloc_size;
+  copy.reloc_offset = desc.instr_size;
+  copy.origin = nullptr;
+  base::Memcpy(buffer, desc.buffer, desc.instr_size);
+  base::Memcpy(buffer + desc.instr_size,
+               desc.buffer + desc.buffer_size - desc.reloc_size,
+               desc.reloc_size);
+
+  intptr_t delta = buffer - desc.buffer;
+  Vector<byte> instructions{buffer, static_cast<size_t>(desc.instr_size)};
+  Vector<const byte> reloc_info{buffer + desc.instr_size,
+                                static_cast<size_t>(desc.reloc_size)};
+  Address constant_pool_start =
+      reinterpret_cast<Address>(buffer) + desc.constant_pool_offset;
+  for (RelocIterator it(instructions, reloc_info, constant_pool_start,
+                        RelocInfo::kApplyMask);
+       !it.done(); it.next()) {
+    RelocInfo::Mode mode = it.rinfo()->rmode();
+    if (RelocInfo::IsWasmCall(mode) || RelocInfo::IsWasmStubCall(mode)) {
+      continue;
+    }
+    it.rinfo()->apply(delta);
+  }
+  return copy;
+}
+
+// Wasm source positions are offsets into the module bytes. Shift them by
+// {delta} so that they are relative to another function start.
+OwnedVector<byte> RebaseSourcePositions(AccountingAllocator* allocator,
+                                        Vector<const byte> table, int delta) {
+  if (table.empty()) return {};
+  Zone zone(allocator, ZONE_NAME);
+  SourcePositionTableBuilder builder(&zone);
+  for (SourcePositionTableIterator it(
+           table, SourcePositionTableIterator::kAll,
+           SourcePositionTableIterator::kDontSkipFunctionEntry);
+       !it.done(); it.Advance()) {
+    SourcePosition position = it.source_position();
+    if (position.IsJavaScript() &&
+        position.ScriptOffset() != kNoSourcePosition) {
+      position = SourcePosition(position.ScriptOffset() + delta,
+                                position.InliningId());
+    }
+    builder.AddPosition(it.code_offset(), position, it.is_statement());
+  }
+  return builder.ToSourcePositionTableVector();
+}
+
+}  // namespace
+
+// static
+bool WasmFunctionCodeCache::CanCache(const CompilationEnv* env) {
+  if (env->module->origin != kWasmOrigin) return false;
+  // Value types of these proposals refer to module-specific type indexes.
+  const WasmFeatures& enabled = env->enabled_features;
+  return !enabled.has_gc() && !enabled.has_typed_funcref();
+}
+
+WasmFunctionCodeCache::Key WasmFunctionCodeCache::ComputeKey(
+    const CompilationEnv* env, const FunctionBody& body) {
+  DCHECK(CanCache(env));
+  const WasmModule* module = env->module;
+  const WasmFeatures& enabled = env->enabled_features;
+
+  // Immediates are decoded without validation below, which is why the body
+  // must have been validated before.
+  KeyBuilder key;
+  key.AddBytes(body.start, body.end);
+  key.AddSignature(body.sig);
+  key.Add(static_cast<uint64_t>(enabled.ToIntegral()));
+  key.Add(static_cast<uint32_t>(env->use_trap_handler));
+  key.Add(static_cast<uint32_t>(env->runtime_exception_support));
+  key.Add(static_cast<uint32_t>(env->lower_simd));
+  key.Add(uint64_t{env->min_memory_size});
+  key.Add(uint64_t{env->max_memory_size});
+  key.Add(uint32_t{module->has_memory});
+  key.Add(uint32_t{module->is_memory64});
+  key.Add(uint32_t{module->has_shared_memory});
+
+  Zone zone(allocator_, ZONE_NAME);
+  AddReferencedDeclarations(&zone, module, enabled, body, &key);
+
+  std::vector<uint8_t> bytes = key.Release();
+  size_t hash = base::hash_range(bytes.begin(), bytes.end());
+  return Key{std::move(bytes), hash};
+}
+
+WasmCompilationResult WasmFunctionCodeCache::Lookup(const Key& key,
+                                                    const FunctionBody& body) {
+  base::MutexGuard guard(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) return {};
+  const Entry& entry = it->second;
+  ++num_hits_;
+
+  WasmCompilationResult result;
+  result.instr_buffer = std::make_unique<uint8_t[]>(entry.desc.buffer_size);
+  result.code_desc = CopyCodeDesc(entry.desc, result.instr_buffer.get());
+  result.frame_slot_count = entry.frame_slot_count;
+  result.tagged_parameter_slots = entry.tagged_parameter_slots;
+  result.source_positions =
+      RebaseSourcePositions(allocator_, entry.source_positions.as_vector(),
+                            static_cast<int>(body.offset));
+  result.protected_instructions_data =
+      OwnedVector<byte>::Of(entry.protected_instructions_data.as_vector());
+  result.result_tier = ExecutionTier::kTurbofan;
+  return result;
+}
+
+void WasmFunctionCodeCache::Insert(const Key& key, const FunctionBody& body,
+                                   const WasmCompilationResult& result) {
+  DCHECK(result.succeeded());
+  DCHECK_EQ(ExecutionTier::kTurbofan, result.result_tier);
+  const CodeDesc& desc = result.code_desc;
+  // Unwinding info lives outside of the instruction buffer.
+  if (desc.unwinding_info_size != 0) return;
+
+  size_t entry_size = desc.instr_size + desc.reloc_size +
+                      result.source_positions.size() +
+                      result.protected_instructions_data.size();
+  base::MutexGuard guard(&mutex_);
+  if (entries_.count(key)) return;
+  if (size_in_bytes_ + entry_size >
+      size_t{FLAG_wasm_function_code_cache_max_size} * MB) {
+    return;
+  }
+
+  Entry entry;
+  entry.buffer = std::make_unique<uint8_t[]>(desc.instr_size + desc.reloc_size);
+  entry.desc = CopyCodeDesc(desc, entry.buffer.get());
+  entry.frame_slot_count = result.frame_slot_count;
+  entry.tagged_parameter_slots = result.tagged_parameter_slots;
+  entry.source_positions =
+      RebaseSourcePositions(allocator_, result.source_positions.as_vector(),
+                            -static_cast<int>(body.offset));
+  entry.protected_instructions_data =
+      OwnedVector<byte>::Of(result.protected_instructions_data.as_vector());
+  entries_.emplace(key, std::move(entry));
+  size_in_bytes_ += entry_size;
+}
+
+size_t WasmFunctionCodeCache::num_entries() const {
+  base::MutexGuard guard(&mutex_);
+  return entries_.size();
+}
+
+size_t WasmFunctionCodeCache::size_in_bytes() const {
+  base::MutexGuard guard(&mutex_);
+  return size_in_bytes_;
+}
+
+size_t WasmFunctionCodeCache::num_hits() const {
+  base::MutexGuard guard(&mutex_);
+  return num_hits_;
+}
+
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
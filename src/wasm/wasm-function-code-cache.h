@@ -0,0 +1,106 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_WASM_WASM_FUNCTION_CODE_CACHE_H_
+#define V8_WASM_WASM_FUNCTION_CODE_CACHE_H_
+
+#include <unordered_map>
+#include <vector>
+
+#include "src/base/platform/mutex.h"
+#include "src/codegen/code-desc.h"
+#include "src/utils/vector.h"
+#include "src/wasm/function-compiler.h"
+
+namespace v8 {
+namespace internal {
+
+class AccountingAllocator;
+
+namespace wasm {
+
+struct CompilationEnv;
+struct FunctionBody;
+
+// Process-wide cache of TurboFan code for individual wasm functions. Modules
+// which contain identical functions (e.g. because they link the same library)
+// only compile them once. An entry is keyed by everything the generated code
+// depends on: the function body, its signature, the compilation environment,
+// and the module-level declarations (callee signatures, globals, tables, ...)
+// which are referenced from the body.
+// The cached code is not position-dependent: calls to other wasm functions and
+// runtime stubs are still encoded as tags, which get resolved when the code is
+// added to a {NativeModule}.
+class V8_EXPORT_PRIVATE WasmFunctionCodeCache {
+ public:
+  class Key {
+   public:
+    bool operator==(const Key& other) const { return bytes_ == other.bytes_; }
+    size_t hash() const { return hash_; }
+
+   private:
+    friend class WasmFunctionCodeCache;
+    Key(std::vector<uint8_t> bytes, size_t hash)
+        : bytes_(std::move(bytes)), hash_(hash) {}
+
+    std::vector<uint8_t> bytes_;
+    size_t hash_;
+  };
+
+  explicit WasmFunctionCodeCache(AccountingAllocator* allocator)
+      : allocator_(allocator) {}
+  WasmFunctionCodeCache(const WasmFunctionCodeCache&) = delete;
+  WasmFunctionCodeCache& operator=(const WasmFunctionCodeCache&) = delete;
+
+  // Returns whether functions compiled in {env} can be cached at all.
+  static bool CanCache(const CompilationEnv* env);
+
+  // Computes the cache key for the given function. The body must be valid,
+  // it is not validated again. The key consists of the body bytes, the
+  // signature, the enabled features, the compilation environment and the
+  // module-level declarations referenced from the body.
+  Key ComputeKey(const CompilationEnv* env, const FunctionBody& body);
+
+  // Returns a copy of the cached code for {key}, or a failed result if there
+  // is no such entry. Source positions are adjusted to the offset of {body}.
+  WasmCompilationResult Lookup(const Key& key, const FunctionBody& body);
+
+  // Stores a copy of the TurboFan code in {result}. Does nothing if an entry
+  // for {key} exists already or the cache is full.
+  void Insert(const Key& key, const FunctionBody& body,
+              const WasmCompilationResult& result);
+
+  size_t num_entries() const;
+  size_t size_in_bytes() const;
+  // The number of successful {Lookup}s.
+  size_t num_hits() const;
+
+ private:
+  struct Entry {
+    CodeDesc desc;
+    std::unique_ptr<uint8_t[]> buffer;
+    uint32_t frame_slot_count;
+    uint32_t tagged_parameter_slots;
+    // Source positions relative to the start of the function body.
+    OwnedVector<byte> source_positions;
+    OwnedVector<byte> protected_instructions_data;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const { return key.hash(); }
+  };
+
+  AccountingAllocator* const allocator_;
+
+  mutable base::Mutex mutex_;
+  std::unordered_map<Key, Entry, KeyHash> entries_;
+  size_t size_in_bytes_ = 0;
+  size_t num_hits_ = 0;
+};
+
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_WASM_WASM_FUNCTION_CODE_CACHE_H_
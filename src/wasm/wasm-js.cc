@@ -1736,9 +1736,12 @@ void WebAssemblyMemoryGrow(const v8::FunctionCallbackInfo<v8::Value>& args) {
     return;
   }
 
-  uint64_t max_size64 = receiver->maximum_pages();
-  if (max_size64 > uint64_t{i::wasm::max_mem_pages()}) {
-    max_size64 = i::wasm::max_mem_pages();
+  // Mirror the limits of {WasmMemoryObject::Grow}: Memory64 memories always
+  // have a maximum, which may exceed the limit of 32-bit memories.
+  uint64_t max_size64 = i::wasm::max_mem_pages();
+  if (receiver->has_maximum_pages()) {
+    max_size64 = std::min(uint64_t{i::wasm::max_any_mem_pages()},
+                          static_cast<uint64_t>(receiver->maximum_pages()));
   }
   i::Handle<i::JSArrayBuffer> old_buffer(receiver->array_buffer(), i_isolate);
 
@@ -5,6 +5,7 @@
 #ifndef V8_WASM_WASM_LIMITS_H_
 #define V8_WASM_WASM_LIMITS_H_
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -34,6 +35,9 @@ constexpr size_t kV8MaxWasmDataSegments = 100000;
 // Don't use this limit directly; use {max_mem_pages()} instead to take the
 // spec'ed limit as well as command line flag into account.
 constexpr size_t kV8MaxWasmMemoryPages = 65536;  // = 4 GiB
+// Memory64 memories can grow beyond 4 GiB. Don't use this limit directly; use
+// {max_mem64_pages()} instead to take the command line flag into account.
+constexpr size_t kV8MaxWasmMemory64Pages = 262144;  // = 16 GiB
 constexpr size_t kV8MaxWasmStringSize = 100000;
 constexpr size_t kV8MaxWasmModuleSize = 1024 * 1024 * 1024;  // = 1 GiB
 constexpr size_t kV8MaxWasmFunctionSize = 7654321;
@@ -69,6 +73,7 @@ constexpr uint64_t kWasmMaxHeapOffset =
 // TODO(wasm): Make this size_t for wasm64. Currently the --wasm-max-mem-pages
 // flag is only uint32_t.
 V8_EXPORT_PRIVATE uint32_t max_mem_pages();
+V8_EXPORT_PRIVATE uint32_t max_mem64_pages();
 uint32_t max_table_init_entries();
 size_t max_module_size();
 
@@ -76,6 +81,15 @@ inline uint64_t max_mem_bytes() {
   return uint64_t{max_mem_pages()} * kWasmPageSize;
 }
 
+inline uint64_t max_mem64_bytes() {
+  return uint64_t{max_mem64_pages()} * kWasmPageSize;
+}
+
+// The maximum number of pages of any memory, 32-bit or 64-bit.
+inline uint32_t max_any_mem_pages() {
+  return std::max(max_mem_pages(), max_mem64_pages());
+}
+
 }  // namespace wasm
 }  // namespace internal
 }  // namespace v8
@@ -915,16 +915,19 @@ int32_t WasmMemoryObject::Grow(Isolate* isolate,
   // therefore this memory cannot be grown.
   if (old_buffer->is_asmjs_memory()) return -1;
 
-  // Checks for maximum memory size.
+  // Checks for maximum memory size. Memory64 memories always have a maximum
+  // (see {InstanceBuilder::AllocateMemory}), which can exceed the limit of
+  // 32-bit memories.
   uint32_t maximum_pages = wasm::max_mem_pages();
   if (memory_object->has_maximum_pages()) {
-    maximum_pages = std::min(
-        maximum_pages, static_cast<uint32_t>(memory_object->maximum_pages()));
+    maximum_pages =
+        std::min(wasm::max_any_mem_pages(),
+                 static_cast<uint32_t>(memory_object->maximum_pages()));
   }
   size_t old_size = old_buffer->byte_length();
   DCHECK_EQ(0, old_size % wasm::kWasmPageSize);
   size_t old_pages = old_size / wasm::kWasmPageSize;
-  CHECK_GE(wasm::max_mem_pages(), old_pages);
+  CHECK_GE(wasm::max_any_mem_pages(), old_pages);
   if (pages > maximum_pages - old_pages) return -1;
   std::shared_ptr<BackingStore> backing_store = old_buffer->GetBackingStore();
   if (!backing_store) return -1;
@@ -1212,7 +1215,8 @@ bool WasmInstanceObject::EnsureIndirectFunctionTableWithMinimumSize(
 }
 
 void WasmInstanceObject::SetRawMemory(byte* mem_start, size_t mem_size) {
-  CHECK_LE(mem_size, wasm::max_mem_bytes());
+  CHECK_LE(mem_size,
+           std::max(wasm::max_mem_bytes(), wasm::max_mem64_bytes()));
 #if V8_HOST_ARCH_64_BIT
   uint64_t mem_mask64 = base::bits::RoundUpToPowerOfTwo64(mem_size) - 1;
   set_memory_start(mem_start);
@@ -1509,6 +1513,10 @@ void WasmInstanceObject::ImportWasmJSFunctionIntoTable(
     compiler::WasmImportCallKind kind = resolved.first;
     callable = resolved.second;  // Update to ultimate target.
     DCHECK_NE(compiler::WasmImportCallKind::kLinkError, kind);
+    // Fast API call wrappers embed their target, use the generic wrapper here.
+    if (kind == compiler::WasmImportCallKind::kWasmToJSFastApi) {
+      kind = compiler::WasmImportCallKind::kUseCallBuiltin;
+    }
     wasm::CompilationEnv env = native_module->CreateCompilationEnv();
     // {expected_arity} should only be used if kind != kJSFunctionArityMismatch.
     int expected_arity = -1;
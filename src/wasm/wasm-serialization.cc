@@ -4,6 +4,8 @@
 
 #include "src/wasm/wasm-serialization.h"
 
+#include "src/base/functional.h"
+#include "src/base/memory.h"
 #include "src/base/platform/wrappers.h"
 #include "src/codegen/assembler-inl.h"
 #include "src/codegen/external-reference-table.h"
@@ -126,6 +128,7 @@ void WriteHeader(Writer* writer) {
   writer->Write(Version::Hash());
   writer->Write(static_cast<uint32_t>(CpuFeatures::SupportedFeatures()));
   writer->Write(FlagList::Hash());
+  writer->Write(WasmSerializer::kFormatVersion);
   DCHECK_EQ(WasmSerializer::kHeaderSize, writer->bytes_written());
 }
 
@@ -188,7 +191,26 @@ uint32_t GetWasmCalleeTag(RelocInfo* rinfo) {
 
 constexpr size_t kHeaderSize =
     sizeof(uint32_t) +  // total wasm function count
-    sizeof(uint32_t);   // imported functions (index of first wasm function)
+    sizeof(uint32_t) +  // imported functions (index of first wasm function)
+    sizeof(uint64_t);   // hash of the wire bytes
+
+// Hashes all of the wire bytes, such that serialized code is never combined
+// with (or installed for) a module with the same function counts but
+// different code. Unlike the {NativeModuleCache} hash, this does not
+// degenerate to the length for large modules.
+uint64_t WireBytesHash(Vector<const byte> wire_bytes) {
+  size_t hash = base::hash_value(wire_bytes.size());
+  const byte* pos = wire_bytes.begin();
+  for (; pos + sizeof(uint64_t) <= wire_bytes.end(); pos += sizeof(uint64_t)) {
+    uint64_t word =
+        base::ReadUnalignedValue<uint64_t>(reinterpret_cast<Address>(pos));
+    hash = base::hash_combine(hash, base::hash_value(word));
+  }
+  for (; pos < wire_bytes.end(); ++pos) {
+    hash = base::hash_combine(hash, base::hash_value(*pos));
+  }
+  return static_cast<uint64_t>(hash);
+}
 
 constexpr size_t kCodeHeaderSize = sizeof(bool) +  // whether code is present
                                    sizeof(int) +   // offset of constant pool
@@ -272,41 +294,110 @@ class ExternalReferenceList {
 static_assert(std::is_trivially_destructible<ExternalReferenceList>::value,
               "static destructors not allowed");
 
+// Code for debugging can contain breakpoints and does not keep its relocation
+// information. All other Liftoff and TurboFan code can be serialized.
+bool IsSerializable(const WasmCode* code) {
+  return code != nullptr && code->for_debugging() == kNoDebugging;
+}
+
+// Splits the serialized functions in {data} into the code of the individual
+// functions. Returns false if {data} is not a valid serialization of a module
+// with the function counts and the wire bytes of {native_module}.
+bool ReadPreviousCode(const NativeModule* native_module,
+                      Vector<const byte> data,
+                      std::vector<WasmSerializer::PreviousCode>* result) {
+  if (!IsSupportedVersion(data)) return false;
+  Reader reader(data + WasmSerializer::kHeaderSize);
+  if (reader.current_size() < kHeaderSize) return false;
+  uint32_t num_functions = reader.Read<uint32_t>();
+  uint32_t num_imported_functions = reader.Read<uint32_t>();
+  uint64_t wire_bytes_hash = reader.Read<uint64_t>();
+  if (num_functions != native_module->num_functions() ||
+      num_imported_functions != native_module->num_imported_functions() ||
+      wire_bytes_hash != WireBytesHash(native_module->wire_bytes())) {
+    return false;
+  }
+  result->clear();
+  for (uint32_t i = num_imported_functions; i < num_functions; ++i) {
+    const byte* start = reader.current_location();
+    if (reader.current_size() < sizeof(bool)) return false;
+    if (!reader.Read<bool>()) {
+      result->emplace_back();
+      continue;
+    }
+    if (reader.current_size() < kCodeHeaderSize - sizeof(bool)) return false;
+    // Skip the offsets, the binary size and the slot counts.
+    reader.Skip(7 * sizeof(int));
+    size_t payload_size = 0;
+    // Code, reloc info, source positions and protected instructions.
+    for (int j = 0; j < 4; ++j) {
+      int size = reader.Read<int>();
+      if (size < 0) return false;
+      payload_size += size;
+    }
+    reader.Skip(sizeof(WasmCode::Kind));
+    ExecutionTier tier = reader.Read<ExecutionTier>();
+    if (reader.current_size() < payload_size) return false;
+    reader.Skip(payload_size);
+    size_t entry_size = reader.current_location() - start;
+    result->push_back({tier, {start, entry_size}});
+  }
+  return reader.current_size() == 0;
+}
+
 }  // namespace
 
 class V8_EXPORT_PRIVATE NativeModuleSerializer {
  public:
-  NativeModuleSerializer(const NativeModule*, Vector<WasmCode* const>);
+  NativeModuleSerializer(const NativeModule*, Vector<WasmCode* const>,
+                         Vector<const WasmSerializer::PreviousCode>);
   NativeModuleSerializer(const NativeModuleSerializer&) = delete;
   NativeModuleSerializer& operator=(const NativeModuleSerializer&) = delete;
 
   size_t Measure() const;
-  bool Write(Writer* writer);
+  void Write(Writer* writer);
 
  private:
   size_t MeasureCode(const WasmCode*) const;
   void WriteHeader(Writer*);
-  bool WriteCode(const WasmCode*, Writer*);
+  void WriteCode(const WasmCode*, Writer*);
+  // Returns the previously serialized code to write instead of {code}, or an
+  // empty vector if {code} is at least as good.
+  Vector<const byte> PreviousCodeFor(size_t slot_index,
+                                     const WasmCode* code) const;
 
   const NativeModule* const native_module_;
   Vector<WasmCode* const> code_table_;
+  Vector<const WasmSerializer::PreviousCode> previous_code_;
   bool write_called_;
 };
 
 NativeModuleSerializer::NativeModuleSerializer(
-    const NativeModule* module, Vector<WasmCode* const> code_table)
-    : native_module_(module), code_table_(code_table), write_called_(false) {
+    const NativeModule* module, Vector<WasmCode* const> code_table,
+    Vector<const WasmSerializer::PreviousCode> previous_code)
+    : native_module_(module),
+      code_table_(code_table),
+      previous_code_(previous_code),
+      write_called_(false) {
   DCHECK_NOT_NULL(native_module_);
+  DCHECK_IMPLIES(!previous_code_.empty(),
+                 previous_code_.size() == code_table_.size());
   // TODO(mtrofin): persist the export wrappers. Ideally, we'd only persist
   // the unique ones, i.e. the cache.
 }
 
+Vector<const byte> NativeModuleSerializer::PreviousCodeFor(
+    size_t slot_index, const WasmCode* code) const {
+  if (previous_code_.empty()) return {};
+  const WasmSerializer::PreviousCode& previous = previous_code_[slot_index];
+  if (previous.bytes.empty()) return {};
+  if (IsSerializable(code) && code->tier() >= previous.tier) return {};
+  return previous.bytes;
+}
+
 size_t NativeModuleSerializer::MeasureCode(const WasmCode* code) const {
-  if (code == nullptr) return sizeof(bool);
+  if (!IsSerializable(code)) return sizeof(bool);
   DCHECK_EQ(WasmCode::kFunction, code->kind());
-  if (FLAG_wasm_lazy_compilation && code->tier() != ExecutionTier::kTurbofan) {
-    return sizeof(bool);
-  }
   return kCodeHeaderSize + code->instructions().size() +
          code->reloc_info().size() + code->source_positions().size() +
          code->protected_instructions_data().size();
@@ -314,8 +405,9 @@ size_t NativeModuleSerializer::MeasureCode(const WasmCode* code) const {
 
 size_t NativeModuleSerializer::Measure() const {
   size_t size = kHeaderSize;
-  for (WasmCode* code : code_table_) {
-    size += MeasureCode(code);
+  for (size_t i = 0; i < code_table_.size(); ++i) {
+    Vector<const byte> previous = PreviousCodeFor(i, code_table_[i]);
+    size += previous.empty() ? MeasureCode(code_table_[i]) : previous.size();
   }
   return size;
 }
@@ -326,24 +418,17 @@ void NativeModuleSerializer::WriteHeader(Writer* writer) {
 
   writer->Write(native_module_->num_functions());
   writer->Write(native_module_->num_imported_functions());
+  writer->Write(WireBytesHash(native_module_->wire_bytes()));
 }
 
-bool NativeModuleSerializer::WriteCode(const WasmCode* code, Writer* writer) {
-  DCHECK_IMPLIES(!FLAG_wasm_lazy_compilation, code != nullptr);
-  if (code == nullptr) {
+void NativeModuleSerializer::WriteCode(const WasmCode* code, Writer* writer) {
+  // Functions without code (or only with code for debugging) get compiled
+  // lazily after deserialization.
+  if (!IsSerializable(code)) {
     writer->Write(false);
-    return true;
+    return;
   }
   DCHECK_EQ(WasmCode::kFunction, code->kind());
-  // Only serialize TurboFan code, as Liftoff code can contain breakpoints or
-  // non-relocatable constants.
-  if (code->tier() != ExecutionTier::kTurbofan) {
-    if (FLAG_wasm_lazy_compilation) {
-      writer->Write(false);
-      return true;
-    }
-    return false;
-  }
   writer->Write(true);
   // Write the size of the entire code section, followed by the code header.
   writer->Write(code->constant_pool_offset());
@@ -432,39 +517,56 @@ bool NativeModuleSerializer::WriteCode(const WasmCode* code, Writer* writer) {
   if (code_start != serialized_code_start) {
     base::Memcpy(serialized_code_start, code_start, code_size);
   }
-  return true;
 }
 
-bool NativeModuleSerializer::Write(Writer* writer) {
+void NativeModuleSerializer::Write(Writer* writer) {
   DCHECK(!write_called_);
   write_called_ = true;
 
   WriteHeader(writer);
 
-  for (WasmCode* code : code_table_) {
-    if (!WriteCode(code, writer)) return false;
+  for (size_t i = 0; i < code_table_.size(); ++i) {
+    // Serialized code does not depend on its position, so code from a
+    // previous serialization can be copied over as is.
+    Vector<const byte> previous = PreviousCodeFor(i, code_table_[i]);
+    if (previous.empty()) {
+      WriteCode(code_table_[i], writer);
+    } else {
+      writer->WriteVector(previous);
+    }
   }
-  return true;
 }
 
 WasmSerializer::WasmSerializer(NativeModule* native_module)
     : native_module_(native_module),
       code_table_(native_module->SnapshotCodeTable()) {}
 
+bool WasmSerializer::MergeWith(Vector<const byte> previous) {
+  std::vector<PreviousCode> previous_code;
+  if (!ReadPreviousCode(native_module_, previous, &previous_code)) {
+    return false;
+  }
+  DCHECK_EQ(code_table_.size(), previous_code.size());
+  previous_code_ = std::move(previous_code);
+  return true;
+}
+
 size_t WasmSerializer::GetSerializedNativeModuleSize() const {
-  NativeModuleSerializer serializer(native_module_, VectorOf(code_table_));
+  NativeModuleSerializer serializer(native_module_, VectorOf(code_table_),
+                                    VectorOf(previous_code_));
   return kHeaderSize + serializer.Measure();
 }
 
 bool WasmSerializer::SerializeNativeModule(Vector<byte> buffer) const {
-  NativeModuleSerializer serializer(native_module_, VectorOf(code_table_));
+  NativeModuleSerializer serializer(native_module_, VectorOf(code_table_),
+                                    VectorOf(previous_code_));
   size_t measured_size = kHeaderSize + serializer.Measure();
   if (buffer.size() < measured_size) return false;
 
   Writer writer(buffer);
   WriteHeader(&writer);
 
-  if (!serializer.Write(&writer)) return false;
+  serializer.Write(&writer);
   DCHECK_EQ(measured_size, writer.bytes_written());
   return true;
 }
@@ -513,6 +615,12 @@ class V8_EXPORT_PRIVATE NativeModuleDeserializer {
 
   bool Read(Reader* reader);
 
+  // Functions which were serialized without code, or with Liftoff code.
+  Vector<const int> lazy_functions() const { return VectorOf(lazy_functions_); }
+  Vector<const int> liftoff_functions() const {
+    return VectorOf(liftoff_functions_);
+  }
+
  private:
   friend class CopyAndRelocTask;
   friend class PublishTask;
@@ -524,6 +632,8 @@ class V8_EXPORT_PRIVATE NativeModuleDeserializer {
 
   NativeModule* const native_module_;
   bool read_called_;
+  std::vector<int> lazy_functions_;
+  std::vector<int> liftoff_functions_;
 #ifdef DEBUG
   std::atomic<int> total_published_{0};
 #endif
@@ -666,19 +776,21 @@ bool NativeModuleDeserializer::Read(Reader* reader) {
 }
 
 bool NativeModuleDeserializer::ReadHeader(Reader* reader) {
+  if (reader->current_size() < kHeaderSize) return false;
   size_t functions = reader->Read<uint32_t>();
   size_t imports = reader->Read<uint32_t>();
+  uint64_t wire_bytes_hash = reader->Read<uint64_t>();
   return functions == native_module_->num_functions() &&
-         imports == native_module_->num_imported_functions();
+         imports == native_module_->num_imported_functions() &&
+         wire_bytes_hash == WireBytesHash(native_module_->wire_bytes());
 }
 
 DeserializationUnit NativeModuleDeserializer::ReadCodeAndAlloc(int fn_index,
                                                                Reader* reader) {
   bool has_code = reader->Read<bool>();
   if (!has_code) {
-    DCHECK(FLAG_wasm_lazy_compilation ||
-           native_module_->enabled_features().has_compilation_hints());
     native_module_->UseLazyStub(fn_index);
+    lazy_functions_.push_back(fn_index);
     return {{}, nullptr};
   }
   int constant_pool_offset = reader->Read<int>();
@@ -694,6 +806,7 @@ DeserializationUnit NativeModuleDeserializer::ReadCodeAndAlloc(int fn_index,
   int protected_instructions_size = reader->Read<int>();
   WasmCode::Kind kind = reader->Read<WasmCode::Kind>();
   ExecutionTier tier = reader->Read<ExecutionTier>();
+  if (tier == ExecutionTier::kLiftoff) liftoff_functions_.push_back(fn_index);
 
   DeserializationUnit unit;
   unit.src_code_buffer = reader->ReadVector<byte>(code_size);
@@ -826,7 +939,14 @@ MaybeHandle<WasmModuleObject> DeserializeNativeModule(
     NativeModuleDeserializer deserializer(shared_native_module.get());
     Reader reader(data + WasmSerializer::kHeaderSize);
     bool error = !deserializer.Read(&reader);
-    shared_native_module->compilation_state()->InitializeAfterDeserialization();
+    // A failed deserialization leaves an incomplete code table behind, so do
+    // not schedule any (top tier) compilation for it; the module is discarded
+    // below.
+    if (!error) {
+      shared_native_module->compilation_state()
+          ->InitializeAfterDeserialization(deserializer.lazy_functions(),
+                                           deserializer.liftoff_functions());
+    }
     wasm_engine->UpdateNativeModuleCache(error, &shared_native_module, isolate);
     if (error) return {};
   }
@@ -6,6 +6,7 @@
 #define V8_WASM_WASM_SERIALIZATION_H_
 
 #include "src/wasm/wasm-objects.h"
+#include "src/wasm/wasm-tier.h"
 
 namespace v8 {
 namespace internal {
@@ -14,10 +15,28 @@ namespace wasm {
 // Support for serializing WebAssembly {NativeModule} objects. This class takes
 // a snapshot of the module state at instantiation, and other code that modifies
 // the module after that won't affect the serialized result.
+// Modules do not need to be fully compiled: the available Liftoff and TurboFan
+// code is written, all other functions are compiled lazily after
+// deserialization.
 class V8_EXPORT_PRIVATE WasmSerializer {
  public:
+  // The serialized code of a single function, as found in an earlier
+  // serialization of the same module.
+  struct PreviousCode {
+    ExecutionTier tier = ExecutionTier::kNone;
+    Vector<const byte> bytes;
+  };
+
   explicit WasmSerializer(NativeModule* native_module);
 
+  // Keep the code of functions in {previous}, the result of an earlier
+  // serialization of the same module, unless the module has code of at least
+  // the same tier for them now. This allows embedders to grow an existing
+  // cache entry instead of replacing it. {previous} must stay alive until
+  // serialization finished. Returns false (and keeps nothing) if {previous}
+  // cannot be used for this module.
+  bool MergeWith(Vector<const byte> previous);
+
   // Measure the required buffer size needed for serialization.
   size_t GetSerializedNativeModuleSize() const;
 
@@ -30,6 +49,7 @@ class V8_EXPORT_PRIVATE WasmSerializer {
   // [1] version hash
   // [2] supported CPU features
   // [3] flag hash
+  // [4] format version
   // ...  number of functions
   // ... serialized functions
   static constexpr size_t kMagicNumberOffset = 0;
@@ -38,11 +58,21 @@ class V8_EXPORT_PRIVATE WasmSerializer {
       kVersionHashOffset + kUInt32Size;
   static constexpr size_t kFlagHashOffset =
       kSupportedCPUFeaturesOffset + kUInt32Size;
-  static constexpr size_t kHeaderSize = 4 * kUInt32Size;
+  static constexpr size_t kFormatVersionOffset = kFlagHashOffset + kUInt32Size;
+  static constexpr size_t kHeaderSize = 5 * kUInt32Size;
+
+  // The version of the layout of serialized modules. The version hash only
+  // changes with the V8 version, so this must be bumped whenever the layout
+  // changes within a version.
+  // 1: The module header holds a hash of the wire bytes, and Liftoff code
+  //    is serialized.
+  static constexpr uint32_t kFormatVersion = 1;
 
  private:
   NativeModule* native_module_;
   std::vector<WasmCode*> code_table_;
+  // Indexed by declared function index, or empty if there is nothing to merge.
+  std::vector<PreviousCode> previous_code_;
 };
 
 // Support for deserializing WebAssembly {NativeModule} objects.
@@ -891,7 +891,20 @@ TEST(CloneCharacterStreams) {
     CHECK(!two_byte_string_stream->can_be_cloned());
   }
 
-  // Chunk sources currently not cloneable.
+  // Utf-8 chunk sources are cloneable, clones share the fetched chunks.
+  {
+    const char* chunks[] = {"abc", "defg", "hi", ""};
+    ChunkSource chunk_source(chunks);
+    std::unique_ptr<i::Utf16CharacterStream> utf8_streaming_stream(
+        i::ScannerStream::For(&chunk_source,
+                              v8::ScriptCompiler::StreamedSource::UTF8));
+    CHECK(utf8_streaming_stream->can_be_cloned());
+    CHECK(!utf8_streaming_stream->can_access_heap());
+    TestCloneCharacterStream(one_byte_source, utf8_streaming_stream.get(),
+                             length);
+  }
+
+  // Other chunk sources currently not cloneable.
   {
     const char* chunks[] = {"1234", "\0"};
     ChunkSource chunk_source(chunks);
@@ -900,11 +913,6 @@ TEST(CloneCharacterStreams) {
                               v8::ScriptCompiler::StreamedSource::ONE_BYTE));
     CHECK(!one_byte_streaming_stream->can_be_cloned());
 
-    std::unique_ptr<i::Utf16CharacterStream> utf8_streaming_stream(
-        i::ScannerStream::For(&chunk_source,
-                              v8::ScriptCompiler::StreamedSource::UTF8));
-    CHECK(!utf8_streaming_stream->can_be_cloned());
-
     std::unique_ptr<i::Utf16CharacterStream> two_byte_streaming_stream(
         i::ScannerStream::For(&chunk_source,
                               v8::ScriptCompiler::StreamedSource::TWO_BYTE));
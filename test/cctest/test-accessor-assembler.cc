@@ -23,6 +23,7 @@ namespace {
 
 void TestStubCacheOffsetCalculation(StubCache::Table table) {
   Isolate* isolate(CcTest::InitIsolateOnce());
+  StubCache* stub_cache = isolate->load_stub_cache();
   const int kNumParams = 2;
   CodeAssemblerTester data(isolate, kNumParams + 1);  // Include receiver.
   AccessorAssembler m(data.state());
@@ -31,13 +32,14 @@ void TestStubCacheOffsetCalculation(StubCache::Table table) {
     auto name = m.Parameter<Name>(1);
     auto map = m.Parameter<Map>(2);
     TNode<IntPtrT> primary_offset =
-        m.StubCachePrimaryOffsetForTesting(name, map);
+        m.StubCachePrimaryOffsetForTesting(stub_cache, name, map);
     Node* result;
     if (table == StubCache::kPrimary) {
       result = primary_offset;
     } else {
       CHECK_EQ(StubCache::kSecondary, table);
-      result = m.StubCacheSecondaryOffsetForTesting(name, primary_offset);
+      result = m.StubCacheSecondaryOffsetForTesting(stub_cache, name,
+                                                    primary_offset);
     }
     m.Return(m.SmiTag(result));
   }
@@ -79,12 +81,12 @@ void TestStubCacheOffsetCalculation(StubCache::Table table) {
 
       int expected_result;
       {
-        int primary_offset = StubCache::PrimaryOffsetForTesting(*name, *map);
+        int primary_offset = stub_cache->PrimaryOffsetForTesting(*name, *map);
         if (table == StubCache::kPrimary) {
           expected_result = primary_offset;
         } else {
           expected_result =
-              StubCache::SecondaryOffsetForTesting(*name, primary_offset);
+              stub_cache->SecondaryOffsetForTesting(*name, primary_offset);
         }
       }
       Handle<Object> result = ft.Call(name, map).ToHandleChecked();
@@ -117,15 +119,19 @@ Handle<Code> CreateCodeOfKind(CodeKind kind) {
 
 }  // namespace
 
-TEST(TryProbeStubCache) {
+namespace {
+
+void TestTryProbeStubCache(int primary_table_bits, int secondary_table_bits) {
   using Label = CodeStubAssembler::Label;
   Isolate* isolate(CcTest::InitIsolateOnce());
   const int kNumParams = 3;
   CodeAssemblerTester data(isolate, kNumParams + 1);  // Include receiver.
   AccessorAssembler m(data.state());
 
-  StubCache stub_cache(isolate);
+  StubCache stub_cache(isolate, primary_table_bits, secondary_table_bits);
   stub_cache.Clear();
+  const int primary_table_size = stub_cache.primary_table_size();
+  const int secondary_table_size = stub_cache.secondary_table_size();
 
   {
     auto receiver = m.Parameter<Object>(1);
@@ -166,21 +172,21 @@ TEST(TryProbeStubCache) {
   Factory* factory = isolate->factory();
 
   // Generate some number of names.
-  for (int i = 0; i < StubCache::kPrimaryTableSize / 7; i++) {
+  for (int i = 0; i < primary_table_size / 7; i++) {
     Handle<Name> name;
     switch (rand_gen.NextInt(3)) {
       case 0: {
         // Generate string.
         std::stringstream ss;
         ss << "s" << std::hex
-           << (rand_gen.NextInt(Smi::kMaxValue) % StubCache::kPrimaryTableSize);
+           << (rand_gen.NextInt(Smi::kMaxValue) % primary_table_size);
         name = factory->InternalizeUtf8String(ss.str().c_str());
         break;
       }
       case 1: {
         // Generate number string.
         std::stringstream ss;
-        ss << (rand_gen.NextInt(Smi::kMaxValue) % StubCache::kPrimaryTableSize);
+        ss << (rand_gen.NextInt(Smi::kMaxValue) % primary_table_size);
         name = factory->InternalizeUtf8String(ss.str().c_str());
         break;
       }
@@ -196,7 +202,7 @@ TEST(TryProbeStubCache) {
   }
 
   // Generate some number of receiver maps and receivers.
-  for (int i = 0; i < StubCache::kSecondaryTableSize / 2; i++) {
+  for (int i = 0; i < secondary_table_size / 2; i++) {
     Handle<Map> map = Map::Create(isolate, 0);
     receivers.push_back(factory->NewJSObjectFromMap(map));
   }
@@ -211,7 +217,7 @@ TEST(TryProbeStubCache) {
   DisallowGarbageCollection no_gc;
 
   // Populate {stub_cache}.
-  const int N = StubCache::kPrimaryTableSize + StubCache::kSecondaryTableSize;
+  const int N = primary_table_size + secondary_table_size;
   for (int i = 0; i < N; i++) {
     int index = rand_gen.NextInt();
     Handle<Name> name = names[index % names.size()];
@@ -223,6 +229,7 @@ TEST(TryProbeStubCache) {
   // Perform some queries.
   bool queried_existing = false;
   bool queried_non_existing = false;
+  size_t expected_misses = 0;
   for (int i = 0; i < N; i++) {
     int index = rand_gen.NextInt();
     Handle<Name> name = names[index % names.size()];
@@ -230,6 +237,7 @@ TEST(TryProbeStubCache) {
     MaybeObject handler = stub_cache.Get(*name, receiver->map());
     if (handler.ptr() == kNullAddress) {
       queried_non_existing = true;
+      expected_misses++;
     } else {
       queried_existing = true;
     }
@@ -246,6 +254,7 @@ TEST(TryProbeStubCache) {
     MaybeObject handler = stub_cache.Get(*name, receiver->map());
     if (handler.ptr() == kNullAddress) {
       queried_non_existing = true;
+      expected_misses++;
     } else {
       queried_existing = true;
     }
@@ -255,7 +264,22 @@ TEST(TryProbeStubCache) {
   }
   // Ensure we performed both kind of queries.
   CHECK(queried_existing && queried_non_existing);
+
+  // The generated code counted every probe and every miss.
+  CHECK_EQ(static_cast<size_t>(2 * N), stub_cache.lookup_count());
+  CHECK_EQ(expected_misses, stub_cache.miss_count());
 }
 
+}  // namespace
+
+TEST(TryProbeStubCache) {
+  TestTryProbeStubCache(FLAG_stub_cache_primary_bits,
+                        FLAG_stub_cache_secondary_bits);
+}
+
+TEST(TryProbeStubCacheSmallTables) { TestTryProbeStubCache(6, 5); }
+
+TEST(TryProbeStubCacheLargeTables) { TestTryProbeStubCache(13, 11); }
+
 }  // namespace internal
 }  // namespace v8
@@ -38,6 +38,7 @@
 #endif
 
 #include "include/v8-fast-api-calls.h"
+#include "include/v8-profiler.h"
 #include "include/v8-util.h"
 #include "src/api/api-inl.h"
 #include "src/base/overflowing-math.h"
@@ -16734,6 +16735,36 @@ TEST(GetHeapSpaceStatistics) {
   CHECK_EQ(total_physical_size, heap_statistics.total_physical_size());
 }
 
+TEST(GetStubCacheStatistics) {
+  if (!i::FLAG_use_ic) return;
+  LocalContext c1;
+  v8::Isolate* isolate = c1->GetIsolate();
+  v8::HandleScope scope(isolate);
+  v8::StubCacheStatistics before;
+  CHECK_EQ(0u, before.load_lookups());
+  CHECK(isolate->GetStubCacheStatistics(&before));
+
+  // Make the load in {load} megamorphic, so that it probes the stub cache.
+  CompileRun(
+      "function load(o) { return o.x; }"
+      "var objects = [];"
+      "for (var i = 0; i < 10; i++) {"
+      "  var o = {x: i};"
+      "  o['p' + i] = i;"
+      "  objects.push(o);"
+      "}"
+      "for (var j = 0; j < 100; j++) objects.forEach(load);");
+
+  v8::StubCacheStatistics after;
+  CHECK(isolate->GetStubCacheStatistics(&after));
+  CHECK_LT(before.load_lookups(), after.load_lookups());
+  CHECK_LE(before.load_misses(), after.load_misses());
+  CHECK_LE(after.load_misses(), after.load_lookups());
+  // Most of the lookups hit, as there are only ten receiver maps.
+  CHECK_LT(after.load_misses() - before.load_misses(),
+           after.load_lookups() - before.load_lookups());
+}
+
 TEST(NumberOfNativeContexts) {
   static const size_t kNumTestContexts = 10;
   i::Isolate* isolate = CcTest::i_isolate();
@@ -19005,6 +19036,60 @@ TEST(RegExp) {
   }
 }
 
+TEST(RegExpStatistics) {
+  FlagScope<bool> regexp_stats(&i::FLAG_regexp_stats, true);
+  LocalContext context;
+  v8::Isolate* isolate = context->GetIsolate();
+  v8::HandleScope scope(isolate);
+  v8::RegExpProfiler::ResetStatistics(isolate);
+
+  CompileRun(
+      "for (var i = 0; i < 10; i++) /a+b/.exec('aaab');"
+      "/a/.exec('xaxa');"
+      "new RegExp('a+b').exec('ab');"
+      "/(a+)+b/.test('a'.repeat(16));"
+      "'cd'.repeat(5).replace(/c+d/g, () => 'x');");
+
+  std::vector<v8::RegExpStatistics> stats =
+      v8::RegExpProfiler::GetStatistics(isolate);
+  CHECK_EQ(4, stats.size());
+  for (size_t i = 1; i < stats.size(); i++) {
+    CHECK_GE(stats[i - 1].total_time_ms, stats[i].total_time_ms);
+  }
+
+  for (const v8::RegExpStatistics& entry : stats) {
+    CHECK_EQ(entry.executions,
+             entry.atom_executions + entry.interpreted_executions +
+                 entry.native_code_executions + entry.experimental_executions);
+    if (entry.source == "a+b") {
+      // Regexps with the same source and flags share their statistics.
+      CHECK_EQ(v8::RegExp::kNone, entry.flags);
+      CHECK_EQ(11, entry.executions);
+    } else if (entry.source == "a") {
+      CHECK_EQ(1, entry.executions);
+      CHECK_EQ(1, entry.atom_executions);
+      CHECK_EQ(0, entry.backtracks);
+    } else if (entry.source == "c+d") {
+      // All five matches are found in a single batch.
+      CHECK_EQ(v8::RegExp::kGlobal, entry.flags);
+      CHECK_EQ(1, entry.executions);
+    } else {
+      CHECK(entry.source == "(a+)+b");
+      CHECK_EQ(1, entry.executions);
+      CHECK_LT(0, entry.backtracks + entry.backtrack_limit_fallbacks);
+    }
+  }
+
+  v8::RegExpProfiler::ResetStatistics(isolate);
+  CHECK(v8::RegExpProfiler::GetStatistics(isolate).empty());
+
+  {
+    FlagScope<bool> no_regexp_stats(&i::FLAG_regexp_stats, false);
+    CompileRun("/a+b/.exec('ab');");
+  }
+  CHECK(v8::RegExpProfiler::GetStatistics(isolate).empty());
+}
+
 
 THREADED_TEST(Equals) {
   LocalContext localContext;
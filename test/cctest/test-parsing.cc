@@ -30,6 +30,7 @@
 #include <string.h>
 
 #include <memory>
+#include <string>
 
 #include "src/init/v8.h"
 
@@ -55,6 +56,7 @@
 #include "test/cctest/cctest.h"
 #include "test/cctest/scope-test-helper.h"
 #include "test/cctest/unicode-helpers.h"
+#include "test/common/flag-utils.h"
 
 namespace v8 {
 namespace internal {
@@ -706,6 +708,7 @@ TEST(ScanHTMLEndComments) {
   }
 }
 
+
 TEST(ScanHtmlComments) {
   i::UnoptimizedCompileFlags flags =
       i::UnoptimizedCompileFlags::ForTest(CcTest::i_isolate());
@@ -745,6 +748,154 @@ class ScriptResource : public v8::String::ExternalOneByteStringResource {
   size_t length_;
 };
 
+namespace {
+
+int parallel_preparse_results_produced = 0;
+int parallel_preparse_results_consumed = 0;
+
+int* LookupParallelPreparseCounter(const char* name) {
+  if (strcmp(name, "c:V8.ParallelPreparseResultsProduced") == 0) {
+    return &parallel_preparse_results_produced;
+  }
+  if (strcmp(name, "c:V8.ParallelPreparseResultsConsumed") == 0) {
+    return &parallel_preparse_results_consumed;
+  }
+  return nullptr;
+}
+
+// A script with kParallelPreparseFunctionCount top-level function
+// declarations, enough for several chunks of the parallel preparser, which
+// returns ParallelPreparseExpectedResult.
+constexpr int kParallelPreparseFunctionCount = 20000;
+
+std::string ParallelPreparseSource() {
+  std::string source;
+  for (int i = 0; i < kParallelPreparseFunctionCount; i++) {
+    std::string index = std::to_string(i);
+    source += "function f" + index + "(a, b) {\n" +
+              "  var x = a + " + index + ";\n" +
+              "  return function() { return x + b; };\n" +
+              "}\n";
+    // Text which looks like a function declaration with a syntax error to the
+    // workers.  They have to go on with the next declaration.
+    if (i % 100 == 0) {
+      source += "var t" + index + " = `\nfunction e(a {\n`;\n";
+    }
+  }
+  // Function declarations at the beginning of a line which aren't top-level
+  // declarations.
+  source += "var s = `\nfunction f0(a, b) { return 0; }\n`;\n";
+  source += "{\nfunction g(a) { return a; }\n}\n";
+  source += "function h() {\n  'use strict';\n  return this;\n}\n";
+  source += "var sum = 0;\n";
+  source += "for (var i = 0; i < " +
+            std::to_string(kParallelPreparseFunctionCount) +
+            "; i++) sum += this['f' + i](i, 1)();\n";
+  source += "sum + g(1) + (h() === undefined ? 1 : 0) + s.length;\n";
+  return source;
+}
+
+double ParallelPreparseExpectedResult() {
+  // The sum of 2 * i + 1 is kParallelPreparseFunctionCount squared.
+  return static_cast<double>(kParallelPreparseFunctionCount) *
+             kParallelPreparseFunctionCount +
+         2 + strlen("\nfunction f0(a, b) { return 0; }\n");
+}
+
+// Streams a source in chunks of the same size.
+class ParallelPreparseSourceStream
+    : public v8::ScriptCompiler::ExternalSourceStream {
+ public:
+  ParallelPreparseSourceStream(const std::string& source, size_t chunk_size)
+      : source_(source), chunk_size_(chunk_size) {}
+
+  size_t GetMoreData(const uint8_t** src) override {
+    size_t length = std::min(chunk_size_, source_.length() - position_);
+    // The caller takes ownership of the data.
+    uint8_t* copy = new uint8_t[length];
+    memcpy(copy, source_.data() + position_, length);
+    position_ += length;
+    *src = copy;
+    return length;
+  }
+
+ private:
+  const std::string& source_;
+  const size_t chunk_size_;
+  size_t position_ = 0;
+};
+
+}  // namespace
+
+TEST(ParallelPreparse) {
+  i::FlagScope<bool> parallel_preparse(&i::FLAG_parallel_preparse, true);
+  i::FlagScope<int> min_size(&i::FLAG_parallel_preparse_min_size, 1);
+  // Preparse all chunks before the parser goes on, so that it finds all
+  // results.
+  i::FlagScope<bool> join(&i::FLAG_parallel_preparse_join, true);
+  v8::Isolate* isolate = CcTest::isolate();
+  v8::HandleScope handles(isolate);
+  LocalContext env;
+  isolate->SetCounterFunction(LookupParallelPreparseCounter);
+  parallel_preparse_results_produced = 0;
+  parallel_preparse_results_consumed = 0;
+
+  // Only external strings are preparsed in parallel.
+  std::string source = ParallelPreparseSource();
+  v8::Local<v8::String> script_source =
+      v8::String::NewExternalOneByte(
+          isolate, new ScriptResource(source.c_str(), source.length()))
+          .ToLocalChecked();
+  v8::Local<v8::Value> result = CompileRun(script_source);
+  CHECK_EQ(ParallelPreparseExpectedResult(),
+           result->NumberValue(env.local()).FromJust());
+
+  // The parser preparses the functions in the first chunk itself, the
+  // workers the others, despite the errors in between.  The workers also
+  // preparse the function in the template, which the parser doesn't use.
+  CHECK_LT(kParallelPreparseFunctionCount / 2,
+           parallel_preparse_results_consumed);
+  CHECK_LT(parallel_preparse_results_consumed,
+           parallel_preparse_results_produced);
+  isolate->SetCounterFunction(nullptr);
+}
+
+TEST(ParallelPreparseStreaming) {
+  i::FlagScope<bool> parallel_preparse(&i::FLAG_parallel_preparse, true);
+  i::FlagScope<int> min_size(&i::FLAG_parallel_preparse_min_size, 1);
+  i::FlagScope<bool> join(&i::FLAG_parallel_preparse_join, true);
+  v8::Isolate* isolate = CcTest::isolate();
+  v8::HandleScope handles(isolate);
+  LocalContext env;
+  isolate->SetCounterFunction(LookupParallelPreparseCounter);
+  parallel_preparse_results_produced = 0;
+  parallel_preparse_results_consumed = 0;
+
+  // UTF-8 streams are split into chunks as the parser goes, and the workers
+  // fetch data from the stream themselves when they get ahead of the parser.
+  std::string source = ParallelPreparseSource();
+  v8::ScriptCompiler::StreamedSource streamed_source(
+      std::make_unique<ParallelPreparseSourceStream>(source, 16 * i::KB),
+      v8::ScriptCompiler::StreamedSource::UTF8);
+  std::unique_ptr<v8::ScriptCompiler::ScriptStreamingTask> task(
+      v8::ScriptCompiler::StartStreaming(isolate, &streamed_source));
+  // The source stream never blocks, so the task can run on this thread.
+  task->Run();
+  v8::ScriptOrigin origin(v8_str("http://foo.com"));
+  v8::Local<v8::Script> script =
+      v8::ScriptCompiler::Compile(env.local(), &streamed_source,
+                                  v8_str(source.c_str()), origin)
+          .ToLocalChecked();
+  v8::Local<v8::Value> result = script->Run(env.local()).ToLocalChecked();
+  CHECK_EQ(ParallelPreparseExpectedResult(),
+           result->NumberValue(env.local()).FromJust());
+
+  CHECK_LT(0, parallel_preparse_results_consumed);
+  CHECK_LE(parallel_preparse_results_consumed,
+           parallel_preparse_results_produced);
+  isolate->SetCounterFunction(nullptr);
+}
+
 
 TEST(StandAlonePreParser) {
   v8::V8::Initialize();
@@ -43,6 +43,8 @@
 #include "src/regexp/regexp-interpreter.h"
 #include "src/regexp/regexp-macro-assembler-arch.h"
 #include "src/regexp/regexp-parser.h"
+#include "src/regexp/regexp-prefilter.h"
+#include "src/regexp/regexp-shared-cache.h"
 #include "src/regexp/regexp.h"
 #include "src/strings/char-predicates-inl.h"
 #include "src/strings/string-stream.h"
@@ -2340,6 +2342,121 @@ TEST(UnicodePropertyEscapeCodeSize) {
   }
 }
 
+// Checks the literals extracted for the prefilter, joined by '|', or that
+// there are none if `expected` is nullptr.
+static void CheckPrefilterLiterals(const char* input, JSRegExp::Flags flags,
+                                   const char* expected) {
+  Isolate* isolate = CcTest::i_isolate();
+
+  v8::HandleScope scope(CcTest::isolate());
+  Zone zone(isolate->allocator(), ZONE_NAME);
+  Handle<String> str = isolate->factory()->NewStringFromAsciiChecked(input);
+  FlatStringReader reader(isolate, str);
+  RegExpCompileData result;
+  CHECK(v8::internal::RegExpParser::ParseRegExp(isolate, &zone, &reader, flags,
+                                                &result));
+  ZoneList<Vector<const uc16>>* literals =
+      RegExpPrefilter::ExtractLiterals(result.tree, flags, &zone);
+  if (expected == nullptr) {
+    CHECK_NULL(literals);
+    return;
+  }
+  CHECK_NOT_NULL(literals);
+  std::ostringstream os;
+  for (int i = 0; i < literals->length(); i++) {
+    if (i > 0) os << "|";
+    for (uc16 c : literals->at(i)) os << static_cast<char>(c);
+  }
+  if (strcmp(expected, os.str().c_str()) != 0) {
+    printf("%s | %s\n", expected, os.str().c_str());
+  }
+  CHECK_EQ(0, strcmp(expected, os.str().c_str()));
+}
+
+TEST(RegExpPrefilterLiterals) {
+  const JSRegExp::Flags kNone = JSRegExp::kNone;
+  const JSRegExp::Flags kIgnoreCase = JSRegExp::kIgnoreCase;
+
+  CheckPrefilterLiterals("abc", kNone, "abc");
+  CheckPrefilterLiterals("(GET|POST|PUT) \\/api", kNone,
+                         "GET /api|POST /ap|PUT /api");
+  CheckPrefilterLiterals("a*b", kNone, "b|a");
+  CheckPrefilterLiterals("[ab]c", kNone, "ac|bc");
+  CheckPrefilterLiterals("\\bfoo(?=bar)", kNone, "foo");
+  CheckPrefilterLiterals("(a)\\1b", kNone, "a");
+  CheckPrefilterLiterals("error: \\d+", kNone, "error: ");
+  CheckPrefilterLiterals("Error: \\d+", kIgnoreCase, "error: ");
+  CheckPrefilterLiterals("abcdefghij", kNone, "abcdefgh");
+
+  // Patterns that can match without consuming one of a few literals.
+  CheckPrefilterLiterals("a|", kNone, nullptr);
+  CheckPrefilterLiterals("a?", kNone, nullptr);
+  CheckPrefilterLiterals(".*foo", kNone, nullptr);
+  CheckPrefilterLiterals("[a-z]foo", kNone, nullptr);
+  CheckPrefilterLiterals("[^a]", kNone, nullptr);
+  CheckPrefilterLiterals("\\1(a)", kNone, nullptr);
+  CheckPrefilterLiterals("a|b|c|d|e|f|g|h|i", kNone, nullptr);
+
+  // Flags for which the prefilter would not pay off or be incorrect.
+  CheckPrefilterLiterals("abc", JSRegExp::kSticky, nullptr);
+  CheckPrefilterLiterals("abc", JSRegExp::kUnicode | JSRegExp::kIgnoreCase,
+                         nullptr);
+  CheckPrefilterLiterals("\\u{1f600}", JSRegExp::kUnicode, nullptr);
+}
+
+namespace {
+
+// Runs `source` in a fresh isolate and returns the result as a string.
+std::string RunInNewIsolate(const char* source) {
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate = v8::Isolate::New(create_params);
+  std::string result;
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    v8::HandleScope handle_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+    v8::String::Utf8Value value(isolate, CompileRun(source));
+    result = *value;
+  }
+  isolate->Dispose();
+  return result;
+}
+
+}  // namespace
+
+TEST(RegExpSharedCache) {
+  FlagScope<bool> shared_cache(&FLAG_regexp_shared_cache, true);
+  FlagScope<bool> interpret_all(&FLAG_regexp_interpret_all, true);
+  RegExpSharedCache* cache = RegExpSharedCache::Get();
+  cache->Clear();
+
+  const char* kDate =
+      "var m = /(?<year>\\d{4})-(?<month>\\d\\d)/.exec('on 2021-03-14');"
+      "m.groups.year + '/' + m.groups.month + '/' + m.index";
+  CHECK_EQ(0, strcmp("2021/03/3", RunInNewIsolate(kDate).c_str()));
+  const size_t size = cache->size();
+  CHECK_LT(0u, size);
+
+  // The second isolate installs the bytecode from the cache.
+  CHECK_EQ(0, strcmp("2021/03/3", RunInNewIsolate(kDate).c_str()));
+  CHECK_EQ(size, cache->size());
+
+  // The bytecode for two-byte subjects has its own entry.
+  const char* kTwoByteDate =
+      "var m = /(?<year>\\d{4})-(?<month>\\d\\d)/.exec('\\u1234 2021-03-14');"
+      "m.groups.year + '/' + m.groups.month + '/' + m.index";
+  CHECK_EQ(0, strcmp("2021/03/2", RunInNewIsolate(kTwoByteDate).c_str()));
+  CHECK_LT(size, cache->size());
+
+  // Entries larger than the cache are not added.
+  cache->Clear();
+  FlagScope<size_t> cache_size(&FLAG_regexp_shared_cache_size, 0);
+  CHECK_EQ(0, strcmp("true", RunInNewIsolate("/a+b/.test('aab')").c_str()));
+  CHECK_EQ(0u, cache->size());
+}
+
 #undef CHECK_PARSE_ERROR
 #undef CHECK_SIMPLE
 #undef CHECK_MIN_MAX
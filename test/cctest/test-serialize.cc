@@ -29,6 +29,7 @@
 #include <sys/stat.h>
 
 #include "src/api/api-inl.h"
+#include "src/builtins/builtins.h"
 #include "src/codegen/assembler-inl.h"
 #include "src/codegen/compilation-cache.h"
 #include "src/codegen/compiler.h"
@@ -2491,6 +2492,57 @@ TEST(CodeSerializerAfterExecute) {
   FLAG_always_opt = prev_always_opt_value;
 }
 
+TEST(CodeSerializerRegExpData) {
+  const char* source = "'xxabcdefxx'.replace(/x+/g, '')";
+  v8::ScriptCompiler::CachedData* cache =
+      CompileRunAndProduceCache(source, CodeCacheType::kAfterExecute);
+
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* isolate2 = v8::Isolate::New(create_params);
+  Isolate* i_isolate2 = reinterpret_cast<Isolate*>(isolate2);
+  {
+    v8::Isolate::Scope iscope(isolate2);
+    v8::HandleScope scope(isolate2);
+    v8::Local<v8::Context> context = v8::Context::New(isolate2);
+    v8::Context::Scope context_scope(context);
+
+    v8::Local<v8::String> source_str = v8_str(source);
+    v8::ScriptOrigin origin(v8_str("test"));
+    v8::ScriptCompiler::Source source(source_str, origin, cache);
+    v8::Local<v8::UnboundScript> script =
+        v8::ScriptCompiler::CompileUnboundScript(
+            isolate2, &source, v8::ScriptCompiler::kConsumeCodeCache)
+            .ToLocalChecked();
+    CHECK(!cache->rejected);
+
+    // The regexp data is restored without its native code, which is either
+    // replaced by the bytecode trampoline or recompiled on first use.
+    Handle<String> pattern =
+        i_isolate2->factory()->InternalizeUtf8String("x+");
+    Handle<FixedArray> data =
+        i_isolate2->compilation_cache()
+            ->LookupRegExp(pattern, JSRegExp::kGlobal)
+            .ToHandleChecked();
+    CHECK(data->get(JSRegExp::kTagIndex) == Smi::FromInt(JSRegExp::IRREGEXP));
+    Object code = data->get(JSRegExp::kIrregexpLatin1CodeIndex);
+    if (data->get(JSRegExp::kIrregexpLatin1BytecodeIndex).IsByteArray()) {
+      CHECK(code == *BUILTIN_CODE(i_isolate2, RegExpInterpreterTrampoline));
+    } else {
+      CHECK(code == Smi::FromInt(JSRegExp::kUninitializedValue));
+    }
+
+    v8::Local<v8::Value> result = script->BindToCurrentContext()
+                                      ->Run(isolate2->GetCurrentContext())
+                                      .ToLocalChecked();
+    CHECK(result->ToString(isolate2->GetCurrentContext())
+              .ToLocalChecked()
+              ->Equals(isolate2->GetCurrentContext(), v8_str("abcdef"))
+              .FromJust());
+  }
+  isolate2->Dispose();
+}
+
 TEST(CodeSerializerFlagChange) {
   const char* source = "function f() { return 'abc'; }; f() + 'def'";
   v8::ScriptCompiler::CachedData* cache = CompileRunAndProduceCache(source);
@@ -0,0 +1,250 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/api/api-inl.h"
+#include "test/cctest/cctest.h"
+#include "test/cctest/wasm/wasm-run-utils.h"
+#include "test/common/wasm/test-signatures.h"
+#include "test/common/wasm/wasm-macro-gen.h"
+
+namespace v8 {
+namespace internal {
+namespace wasm {
+namespace test_run_wasm_memory64 {
+
+// The interpreter is not covered here; these tests run Liftoff and TurboFan.
+template <typename ReturnType, typename... ParamTypes>
+class Memory64Runner : public WasmRunner<ReturnType, ParamTypes...> {
+ public:
+  explicit Memory64Runner(TestExecutionTier execution_tier)
+      : WasmRunner<ReturnType, ParamTypes...>(execution_tier) {
+    this->builder().SetMemory64();
+  }
+};
+
+namespace {
+void CheckMemoryEquals(TestingModuleBuilder* builder, size_t index,
+                       const std::vector<byte>& expected) {
+  const byte* mem_start = builder->raw_mem_start<byte>();
+  CHECK_LE(index + expected.size(), builder->mem_size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    CHECK_EQ(expected[i], mem_start[index + i]);
+  }
+}
+}  // namespace
+
+WASM_COMPILED_EXEC_TEST(Load) {
+  EXPERIMENTAL_FLAG_SCOPE(memory64);
+  Memory64Runner<uint32_t, uint64_t> r(execution_tier);
+  uint32_t* memory =
+      r.builder().AddMemoryElems<uint32_t>(kWasmPageSize / sizeof(int32_t));
+
+  BUILD(r, WASM_LOAD_MEM(MachineType::Int32(), WASM_GET_LOCAL(0)));
+
+  CHECK_EQ(0, r.Call(0));
+
+  r.builder().WriteMemory(&memory[0], 0x12345678);
+  CHECK_EQ(0x12345678, r.Call(0));
+  CHECK_EQ(0x123456, r.Call(1));
+  CHECK_EQ(0x1234, r.Call(2));
+  CHECK_EQ(0x12, r.Call(3));
+  CHECK_EQ(0x0, r.Call(4));
+
+  CHECK_TRAP(r.Call(kWasmPageSize - 3));
+  CHECK_TRAP(r.Call(kWasmPageSize));
+  // Indexes with any of the upper 32 bits set trap, even if the lower 32 bits
+  // are in bounds.
+  CHECK_TRAP(r.Call(uint64_t{1} << 32));
+  CHECK_TRAP(r.Call((uint64_t{1} << 32) | 1));
+  CHECK_TRAP(r.Call(uint64_t{1} << 63));
+  CHECK_TRAP(r.Call(std::numeric_limits<uint64_t>::max()));
+}
+
+WASM_COMPILED_EXEC_TEST(Store) {
+  EXPERIMENTAL_FLAG_SCOPE(memory64);
+  Memory64Runner<uint32_t, uint64_t, uint32_t> r(execution_tier);
+  r.builder().AddMemory(kWasmPageSize);
+
+  BUILD(r,
+        WASM_STORE_MEM(MachineType::Int32(), WASM_GET_LOCAL(0),
+                       WASM_GET_LOCAL(1)),
+        WASM_ONE);
+
+  CHECK_EQ(1, r.Call(4, 0x11223344));
+  CheckMemoryEquals(&r.builder(), 0, {0, 0, 0, 0, 0x44, 0x33, 0x22, 0x11});
+  CHECK_EQ(1, r.Call(kWasmPageSize - 4, 0x55));
+  CheckMemoryEquals(&r.builder(), kWasmPageSize - 4, {0x55, 0, 0, 0});
+
+  CHECK_TRAP(r.Call(kWasmPageSize - 3, 0));
+  CHECK_TRAP(r.Call(uint64_t{1} << 32, 0xff));
+  CHECK_TRAP(r.Call((uint64_t{1} << 32) | 8, 0xff));
+  CheckMemoryEquals(&r.builder(), 8, {0, 0, 0, 0});
+}
+
+#if V8_HOST_ARCH_64_BIT
+WASM_COMPILED_EXEC_TEST(LoadStoreAbove4GiB) {
+  EXPERIMENTAL_FLAG_SCOPE(memory64);
+  Memory64Runner<uint64_t, uint64_t, uint64_t> r(execution_tier);
+  constexpr size_t kMemSize = size_t{4} * GB + kWasmPageSize;
+  byte* memory = r.builder().AddMemory(kMemSize);
+
+  // Stores {value} at {index} and loads it back.
+  BUILD(r,
+        WASM_STORE_MEM(MachineType::Int64(), WASM_GET_LOCAL(0),
+                       WASM_GET_LOCAL(1)),
+        WASM_LOAD_MEM(MachineType::Int64(), WASM_GET_LOCAL(0)));
+
+  constexpr uint64_t kValue = 0x0123456789abcdef;
+  constexpr uint64_t kIndex = uint64_t{4} * GB + 8;
+  CHECK_EQ(kValue, r.Call(kIndex, kValue));
+  CHECK_EQ(kValue, r.builder().ReadMemory(
+                       reinterpret_cast<uint64_t*>(memory + kIndex)));
+  // The index was not truncated to its lower 32 bits.
+  CHECK_EQ(0, r.builder().ReadMemory(reinterpret_cast<uint64_t*>(memory + 8)));
+
+  CHECK_EQ(kValue, r.Call(kMemSize - 8, kValue));
+  CHECK_TRAP64(r.Call(kMemSize - 7, kValue));
+  CHECK_TRAP64(r.Call(kMemSize, kValue));
+  CHECK_TRAP64(r.Call(uint64_t{8} * GB, kValue));
+}
+#endif  // V8_HOST_ARCH_64_BIT
+
+WASM_COMPILED_EXEC_TEST(MemoryGrow) {
+  EXPERIMENTAL_FLAG_SCOPE(memory64);
+  Memory64Runner<int64_t, int64_t> r(execution_tier);
+  r.builder().AddMemory(kWasmPageSize);
+  r.builder().SetMaxMemPages(4);
+
+  BUILD(r, WASM_GROW_MEMORY(WASM_GET_LOCAL(0)));
+
+  CHECK_EQ(1, r.Call(1));
+  CHECK_EQ(2, r.Call(0));
+  CHECK_EQ(-1, r.Call(3));
+  // Deltas of 2^32 pages or more fail, even if their lower 32 bits would be a
+  // valid delta.
+  CHECK_EQ(-1, r.Call(int64_t{1} << 32));
+  CHECK_EQ(-1, r.Call((int64_t{1} << 32) + 1));
+  CHECK_EQ(-1, r.Call(std::numeric_limits<int64_t>::max()));
+  CHECK_EQ(-1, r.Call(-1));
+  // Failed attempts did not grow the memory.
+  CHECK_EQ(2, r.Call(2));
+  CHECK_EQ(4, r.Call(0));
+}
+
+#if V8_HOST_ARCH_64_BIT
+// {WebAssembly.Memory.prototype.grow} lets memory64 memories grow beyond the
+// limit of 32-bit memories.
+TEST(MemoryGrowFromJS) {
+  EXPERIMENTAL_FLAG_SCOPE(memory64);
+  Memory64Runner<int64_t> r(TestExecutionTier::kTurbofan);
+  r.builder().AddMemory(kWasmPageSize);
+  const uint32_t max_pages = max_mem_pages() + 1;
+  r.builder().SetMaxMemPages(max_pages);
+  BUILD(r, WASM_MEMORY_SIZE);
+
+  Isolate* isolate = r.main_isolate();
+  Handle<WasmMemoryObject> memory(
+      r.builder().instance_object()->memory_object(), isolate);
+  v8::Local<v8::Context> context = CcTest::isolate()->GetCurrentContext();
+  CHECK(context->Global()
+            ->Set(context, v8_str("memory"),
+                  v8::Utils::ToLocal(Handle<JSObject>::cast(memory)))
+            .FromJust());
+
+  EmbeddedVector<char, 64> source;
+  SNPrintF(source, "memory.grow(%u)", max_pages - 1);
+  CHECK_EQ(1, CompileRun(source.begin())->Int32Value(context).FromJust());
+  CHECK_EQ(int64_t{max_pages}, r.Call());
+  // Growing beyond the declared maximum throws.
+  CHECK(CompileRun("(() => {"
+                   "  try { memory.grow(1); } catch (e) {"
+                   "    return e instanceof RangeError;"
+                   "  }"
+                   "  return false;"
+                   "})()")
+            ->BooleanValue(CcTest::isolate()));
+  CHECK_EQ(int64_t{max_pages}, r.Call());
+}
+#endif  // V8_HOST_ARCH_64_BIT
+
+WASM_COMPILED_EXEC_TEST(MemoryFill) {
+  EXPERIMENTAL_FLAG_SCOPE(memory64);
+  EXPERIMENTAL_FLAG_SCOPE(bulk_memory);
+  Memory64Runner<uint32_t, uint64_t, uint32_t, uint64_t> r(execution_tier);
+  r.builder().AddMemory(kWasmPageSize);
+
+  BUILD(r,
+        WASM_MEMORY_FILL(WASM_GET_LOCAL(0), WASM_GET_LOCAL(1),
+                         WASM_GET_LOCAL(2)),
+        kExprI32Const, 0);
+
+  CHECK_EQ(0, r.Call(1, 33, 5));
+  CheckMemoryEquals(&r.builder(), 0, {0, 33, 33, 33, 33, 33, 0});
+  CHECK_EQ(0, r.Call(kWasmPageSize - 1, 7, 1));
+  CheckMemoryEquals(&r.builder(), kWasmPageSize - 1, {7});
+
+  CHECK_EQ(0xDEADBEEF, r.Call(kWasmPageSize, 1, 1));
+  CHECK_EQ(0xDEADBEEF, r.Call(uint64_t{1} << 32, 1, 1));
+  CHECK_EQ(0xDEADBEEF, r.Call((uint64_t{1} << 32) | 16, 1, 1));
+  // A size whose lower 32 bits are zero still traps.
+  CHECK_EQ(0xDEADBEEF, r.Call(16, 1, uint64_t{1} << 32));
+  CheckMemoryEquals(&r.builder(), 16, {0});
+}
+
+WASM_COMPILED_EXEC_TEST(MemoryCopy) {
+  EXPERIMENTAL_FLAG_SCOPE(memory64);
+  EXPERIMENTAL_FLAG_SCOPE(bulk_memory);
+  Memory64Runner<uint32_t, uint64_t, uint64_t, uint64_t> r(execution_tier);
+  byte* mem = r.builder().AddMemory(kWasmPageSize);
+
+  BUILD(r,
+        WASM_MEMORY_COPY(WASM_GET_LOCAL(0), WASM_GET_LOCAL(1),
+                         WASM_GET_LOCAL(2)),
+        kExprI32Const, 0);
+
+  const byte initial[] = {11, 22, 33, 44, 55, 66, 77, 88};
+  memcpy(mem, initial, sizeof(initial));
+
+  CHECK_EQ(0, r.Call(10, 0, 4));
+  CheckMemoryEquals(&r.builder(), 8, {0, 0, 11, 22, 33, 44, 0});
+  CHECK_EQ(0, r.Call(kWasmPageSize - 8, 0, 8));
+  CheckMemoryEquals(&r.builder(), kWasmPageSize - 8,
+                    {11, 22, 33, 44, 55, 66, 77, 88});
+
+  CHECK_EQ(0xDEADBEEF, r.Call(kWasmPageSize - 7, 0, 8));
+  CHECK_EQ(0xDEADBEEF, r.Call(uint64_t{1} << 32, 0, 1));
+  CHECK_EQ(0xDEADBEEF, r.Call(32, uint64_t{1} << 32, 1));
+  CHECK_EQ(0xDEADBEEF, r.Call(32, 0, uint64_t{1} << 32));
+  CheckMemoryEquals(&r.builder(), 32, {0});
+}
+
+WASM_COMPILED_EXEC_TEST(MemoryInit) {
+  EXPERIMENTAL_FLAG_SCOPE(memory64);
+  EXPERIMENTAL_FLAG_SCOPE(bulk_memory);
+  Memory64Runner<uint32_t, uint64_t, uint32_t, uint32_t> r(execution_tier);
+  r.builder().AddMemory(kWasmPageSize);
+  const byte data[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  r.builder().AddPassiveDataSegment(ArrayVector(data));
+
+  // The destination is an i64, the segment offset and size stay i32.
+  BUILD(r,
+        WASM_MEMORY_INIT(0, WASM_GET_LOCAL(0), WASM_GET_LOCAL(1),
+                         WASM_GET_LOCAL(2)),
+        kExprI32Const, 0);
+
+  CHECK_EQ(0, r.Call(10, 2, 3));
+  CheckMemoryEquals(&r.builder(), 9, {0, 2, 3, 4, 0});
+  CHECK_EQ(0, r.Call(kWasmPageSize - 2, 8, 2));
+  CheckMemoryEquals(&r.builder(), kWasmPageSize - 2, {8, 9});
+
+  CHECK_EQ(0xDEADBEEF, r.Call(kWasmPageSize - 1, 0, 2));
+  CHECK_EQ(0xDEADBEEF, r.Call(uint64_t{1} << 32, 0, 1));
+  CHECK_EQ(0xDEADBEEF, r.Call((uint64_t{1} << 32) | 20, 0, 1));
+  CheckMemoryEquals(&r.builder(), 20, {0});
+}
+
+}  // namespace test_run_wasm_memory64
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
@@ -2936,6 +2936,10 @@ void RunShuffleOpTest(TestExecutionTier execution_tier, LowerSimd lower_simd,
 
 #define SHUFFLE_LIST(V)  \
   V(S128Identity)        \
+  V(S64x2Dup)            \
+  V(S64x2ZipLeft)        \
+  V(S64x2ZipRight)       \
+  V(S64x2Blend)          \
   V(S32x4Dup)            \
   V(S32x4ZipLeft)        \
   V(S32x4ZipRight)       \
@@ -2944,6 +2948,7 @@ void RunShuffleOpTest(TestExecutionTier execution_tier, LowerSimd lower_simd,
   V(S32x4TransposeLeft)  \
   V(S32x4TransposeRight) \
   V(S32x2Reverse)        \
+  V(S32x4Shufps)         \
   V(S32x4Irregular)      \
   V(S16x8Dup)            \
   V(S16x8ZipLeft)        \
@@ -2980,6 +2985,14 @@ using ShuffleMap = std::map<ShuffleKey, const Shuffle>;
 ShuffleMap test_shuffles = {
     {kS128Identity,
      {{16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31}}},
+    {kS64x2Dup,
+     {{24, 25, 26, 27, 28, 29, 30, 31, 24, 25, 26, 27, 28, 29, 30, 31}}},
+    {kS64x2ZipLeft,
+     {{0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23}}},
+    {kS64x2ZipRight,
+     {{8, 9, 10, 11, 12, 13, 14, 15, 24, 25, 26, 27, 28, 29, 30, 31}}},
+    {kS64x2Blend,
+     {{0, 1, 2, 3, 4, 5, 6, 7, 24, 25, 26, 27, 28, 29, 30, 31}}},
     {kS32x4Dup,
      {{16, 17, 18, 19, 16, 17, 18, 19, 16, 17, 18, 19, 16, 17, 18, 19}}},
     {kS32x4ZipLeft, {{0, 1, 2, 3, 16, 17, 18, 19, 4, 5, 6, 7, 20, 21, 22, 23}}},
@@ -2995,6 +3008,8 @@ ShuffleMap test_shuffles = {
      {{4, 5, 6, 7, 20, 21, 22, 23, 12, 13, 14, 15, 28, 29, 30, 31}}},
     {kS32x2Reverse,  // swizzle only
      {{4, 5, 6, 7, 0, 1, 2, 3, 12, 13, 14, 15, 8, 9, 10, 11}}},
+    {kS32x4Shufps,
+     {{12, 13, 14, 15, 0, 1, 2, 3, 24, 25, 26, 27, 20, 21, 22, 23}}},
     {kS32x4Irregular,
      {{0, 1, 2, 3, 16, 17, 18, 19, 16, 17, 18, 19, 20, 21, 22, 23}}},
     {kS16x8Dup,
@@ -644,6 +644,61 @@ STREAM_TEST(TestErrorInCodeSectionDetectedByCompiler) {
   CHECK(tester.IsPromiseRejected());
 }
 
+// Create a module with two invalid functions (#1 and #3) in between valid
+// functions.
+ZoneBuffer GetModuleWithInvalidFunctions(Zone* zone) {
+  ZoneBuffer buffer(zone);
+  TestSignatures sigs;
+  WasmModuleBuilder builder(zone);
+  for (int i = 0; i < 5; ++i) {
+    WasmFunctionBuilder* f = builder.AddFunction(sigs.i_iii());
+    bool invalid = i % 2 == 1;
+    // Returning an i64 value from a function of type i32 is a type error.
+    uint8_t code[] = {invalid ? kExprI64Const : kExprI32Const, 0, kExprEnd};
+    f->EmitCode(code, arraysize(code));
+  }
+  builder.WriteTo(&buffer);
+  return buffer;
+}
+
+// Test that invalid lazily compiled functions get detected by the validation
+// that runs in the background, and that the first invalid function is
+// reported, no matter how the bytes arrive.
+STREAM_TEST(TestErrorInLazyFunctionDetectedByValidation) {
+  FlagScope<bool> lazy_compilation(&FLAG_wasm_lazy_compilation, true);
+  FlagScope<bool> no_lazy_validation(&FLAG_wasm_lazy_validation, false);
+  std::string error_messages[2];
+  for (bool cut_stream : {false, true}) {
+    StreamTester tester(isolate);
+    ZoneBuffer buffer = GetModuleWithInvalidFunctions(tester.zone());
+    Isolate* i_isolate = reinterpret_cast<i::Isolate*>(isolate);
+    size_t first_invalid =
+        GetFunctionOffset(i_isolate, buffer.begin(), buffer.size(), 1);
+    size_t first_valid_after =
+        GetFunctionOffset(i_isolate, buffer.begin(), buffer.size(), 2);
+
+    if (cut_stream) {
+      size_t offset =
+          GetFunctionOffset(i_isolate, buffer.begin(), buffer.size(), 4);
+      tester.OnBytesReceived(buffer.begin(), offset);
+      tester.RunCompilerTasks();
+      tester.OnBytesReceived(buffer.begin() + offset, buffer.size() - offset);
+    } else {
+      tester.OnBytesReceived(buffer.begin(), buffer.size());
+    }
+    tester.FinishStream();
+    tester.RunCompilerTasks();
+
+    CHECK(tester.IsPromiseRejected());
+    const std::string& message = tester.error_message();
+    size_t error_offset = std::stoul(message.substr(message.rfind("@+") + 2));
+    CHECK_LE(first_invalid, error_offset);
+    CHECK_GT(first_valid_after, error_offset);
+    error_messages[cut_stream] = message;
+  }
+  CHECK_EQ(error_messages[0], error_messages[1]);
+}
+
 // Test Abort before any bytes arrive.
 STREAM_TEST(TestAbortImmediately) {
   StreamTester tester(isolate);
@@ -0,0 +1,222 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "include/v8-fast-api-calls.h"
+#include "src/api/api-inl.h"
+#include "src/wasm/wasm-engine.h"
+#include "src/wasm/wasm-module-builder.h"
+#include "src/wasm/wasm-objects-inl.h"
+#include "test/cctest/cctest.h"
+#include "test/common/wasm/flag-utils.h"
+#include "test/common/wasm/test-signatures.h"
+#include "test/common/wasm/wasm-macro-gen.h"
+#include "test/common/wasm/wasm-module-runner.h"
+
+namespace v8 {
+namespace internal {
+namespace wasm {
+namespace test_wasm_fast_api_calls {
+
+namespace {
+
+struct ApiChecker {
+  static void FastCallback(v8::ApiObject receiver, int32_t a, int32_t b,
+                           v8::FastApiCallbackOptions& options) {
+    if (request_fallback) {
+      options.fallback = 1;
+      return;
+    }
+    ++fast_calls;
+    sum = a + b;
+    v8::Object* receiver_obj = reinterpret_cast<v8::Object*>(&receiver);
+    receiver_data = receiver_obj->InternalFieldCount() > 0
+                        ? receiver_obj->GetAlignedPointerFromInternalField(0)
+                        : nullptr;
+  }
+
+  static void SlowCallback(const v8::FunctionCallbackInfo<v8::Value>& info) {
+    ++slow_calls;
+    v8::Local<v8::Context> context = info.GetIsolate()->GetCurrentContext();
+    sum = info[0]->Int32Value(context).FromJust() +
+          info[1]->Int32Value(context).FromJust();
+  }
+
+  static void Reset() {
+    fast_calls = 0;
+    slow_calls = 0;
+    sum = 0;
+    receiver_data = nullptr;
+    request_fallback = false;
+  }
+
+  static int fast_calls;
+  static int slow_calls;
+  static int32_t sum;
+  static void* receiver_data;
+  static bool request_fallback;
+};
+
+int ApiChecker::fast_calls = 0;
+int ApiChecker::slow_calls = 0;
+int32_t ApiChecker::sum = 0;
+void* ApiChecker::receiver_data = nullptr;
+bool ApiChecker::request_fallback = false;
+
+// Builds a module which imports "m.f" with signature [i32, i32] -> [], and
+// exports "main", which passes its parameters to the import.
+ZoneBuffer BuildModule(Zone* zone) {
+  TestSignatures sigs;
+  WasmModuleBuilder builder(zone);
+  uint32_t import_index =
+      builder.AddImport(CStrVector("f"), sigs.v_ii(), CStrVector("m"));
+  WasmFunctionBuilder* f = builder.AddFunction(sigs.v_ii());
+  uint8_t code[] = {WASM_CALL_FUNCTION(import_index, WASM_GET_LOCAL(0),
+                                       WASM_GET_LOCAL(1)),
+                    kExprEnd};
+  f->EmitCode(code, arraysize(code));
+  builder.AddExport(CStrVector("main"), f);
+  ZoneBuffer buffer(zone);
+  builder.WriteTo(&buffer);
+  return buffer;
+}
+
+// Instantiates the module with the global "f" as the import.
+Handle<WasmInstanceObject> Instantiate(Isolate* isolate,
+                                       const ZoneBuffer& buffer) {
+  ErrorThrower thrower(isolate, "Instantiate");
+  Handle<WasmModuleObject> module_object =
+      isolate->wasm_engine()
+          ->SyncCompile(isolate, WasmFeatures::FromIsolate(isolate), &thrower,
+                        ModuleWireBytes(buffer.begin(), buffer.end()))
+          .ToHandleChecked();
+  Handle<JSReceiver> imports = Handle<JSReceiver>::cast(
+      v8::Utils::OpenHandle(*CompileRun("({m: {f: f}})")));
+  Handle<WasmInstanceObject> instance =
+      isolate->wasm_engine()
+          ->SyncInstantiate(isolate, &thrower, module_object, imports, {})
+          .ToHandleChecked();
+  CHECK(!thrower.error());
+  return instance;
+}
+
+void CallMain(Isolate* isolate, Handle<WasmInstanceObject> instance, int a,
+              int b) {
+  Handle<Object> args[] = {handle(Smi::FromInt(a), isolate),
+                           handle(Smi::FromInt(b), isolate)};
+  testing::CallWasmFunctionForTesting(isolate, instance, "main", 2, args);
+}
+
+// Sets the global "api_func" to an API function with the fast callback.
+void SetupApiFunction(LocalContext* env) {
+  v8::Isolate* isolate = CcTest::isolate();
+  static v8::CFunction c_func =
+      v8::CFunction::MakeWithFallbackSupport(ApiChecker::FastCallback);
+  v8::Local<v8::FunctionTemplate> templ = v8::FunctionTemplate::New(
+      isolate, ApiChecker::SlowCallback, v8::Local<v8::Value>(),
+      v8::Local<v8::Signature>(), 2, v8::ConstructorBehavior::kThrow,
+      v8::SideEffectType::kHasSideEffect, &c_func);
+  CHECK((*env)
+            ->Global()
+            ->Set(env->local(), v8_str("api_func"),
+                  templ->GetFunction(env->local()).ToLocalChecked())
+            .FromJust());
+}
+
+}  // namespace
+
+TEST(WasmFastApiCall) {
+  FlagScope<bool> fast_api(&FLAG_wasm_fast_api, true);
+  v8::Isolate* isolate = CcTest::isolate();
+  Isolate* i_isolate = CcTest::i_isolate();
+  v8::HandleScope scope(isolate);
+  LocalContext env;
+  testing::SetupIsolateForWasmModule(i_isolate);
+  SetupApiFunction(&env);
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+  ZoneBuffer buffer = BuildModule(&zone);
+
+  ApiChecker::Reset();
+  CompileRun("var f = api_func;");
+  Handle<WasmInstanceObject> instance = Instantiate(i_isolate, buffer);
+  CallMain(i_isolate, instance, 3, 4);
+  CHECK_EQ(1, ApiChecker::fast_calls);
+  CHECK_EQ(0, ApiChecker::slow_calls);
+  CHECK_EQ(7, ApiChecker::sum);
+
+  // The fallback calls the API function like any other JS function.
+  ApiChecker::request_fallback = true;
+  CallMain(i_isolate, instance, 5, 6);
+  CHECK_EQ(1, ApiChecker::fast_calls);
+  CHECK_EQ(1, ApiChecker::slow_calls);
+  CHECK_EQ(11, ApiChecker::sum);
+}
+
+TEST(WasmFastApiCallBoundReceiver) {
+  FlagScope<bool> fast_api(&FLAG_wasm_fast_api, true);
+  v8::Isolate* isolate = CcTest::isolate();
+  Isolate* i_isolate = CcTest::i_isolate();
+  v8::HandleScope scope(isolate);
+  LocalContext env;
+  testing::SetupIsolateForWasmModule(i_isolate);
+  SetupApiFunction(&env);
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+  ZoneBuffer buffer = BuildModule(&zone);
+
+  static int receiver_data = 0;
+  v8::Local<v8::ObjectTemplate> object_template =
+      v8::ObjectTemplate::New(isolate);
+  object_template->SetInternalFieldCount(1);
+  v8::Local<v8::Object> receiver =
+      object_template->NewInstance(env.local()).ToLocalChecked();
+  receiver->SetAlignedPointerInInternalField(0, &receiver_data);
+  CHECK(env->Global()
+            ->Set(env.local(), v8_str("receiver"), receiver)
+            .FromJust());
+
+  // The bound receiver is passed to the C function.
+  ApiChecker::Reset();
+  CompileRun("var f = api_func.bind(receiver);");
+  Handle<WasmInstanceObject> instance = Instantiate(i_isolate, buffer);
+  CallMain(i_isolate, instance, 1, 2);
+  CHECK_EQ(1, ApiChecker::fast_calls);
+  CHECK_EQ(static_cast<void*>(&receiver_data), ApiChecker::receiver_data);
+  CHECK_EQ(3, ApiChecker::sum);
+
+  // Bound arguments are not supported, such functions are called via JS.
+  ApiChecker::Reset();
+  CompileRun("var f = api_func.bind(receiver, 10);");
+  instance = Instantiate(i_isolate, buffer);
+  CallMain(i_isolate, instance, 1, 2);
+  CHECK_EQ(0, ApiChecker::fast_calls);
+  CHECK_EQ(1, ApiChecker::slow_calls);
+  CHECK_EQ(11, ApiChecker::sum);
+}
+
+TEST(WasmFastApiCallDisabled) {
+  FlagScope<bool> fast_api(&FLAG_wasm_fast_api, false);
+  v8::Isolate* isolate = CcTest::isolate();
+  Isolate* i_isolate = CcTest::i_isolate();
+  v8::HandleScope scope(isolate);
+  LocalContext env;
+  testing::SetupIsolateForWasmModule(i_isolate);
+  SetupApiFunction(&env);
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+  ZoneBuffer buffer = BuildModule(&zone);
+
+  ApiChecker::Reset();
+  CompileRun("var f = api_func;");
+  Handle<WasmInstanceObject> instance = Instantiate(i_isolate, buffer);
+  CallMain(i_isolate, instance, 3, 4);
+  CHECK_EQ(0, ApiChecker::fast_calls);
+  CHECK_EQ(1, ApiChecker::slow_calls);
+  CHECK_EQ(7, ApiChecker::sum);
+}
+
+}  // namespace test_wasm_fast_api_calls
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,164 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/api/api-inl.h"
+#include "src/wasm/wasm-engine.h"
+#include "src/wasm/wasm-function-code-cache.h"
+#include "src/wasm/wasm-module-builder.h"
+#include "test/cctest/cctest.h"
+#include "test/common/wasm/flag-utils.h"
+#include "test/common/wasm/test-signatures.h"
+#include "test/common/wasm/wasm-macro-gen.h"
+#include "test/common/wasm/wasm-module-runner.h"
+
+namespace v8 {
+namespace internal {
+namespace wasm {
+namespace test_wasm_function_code_cache {
+
+namespace {
+
+// Builds a module exporting "add" and "load", plus a function "other" which
+// differs for each {n}, so that the module bytes differ as well.
+ZoneBuffer BuildModule(Zone* zone, int n, uint32_t memory_pages) {
+  TestSignatures sigs;
+  WasmModuleBuilder builder(zone);
+  builder.SetMinMemorySize(memory_pages);
+  {
+    WasmFunctionBuilder* f = builder.AddFunction(sigs.i_ii());
+    uint8_t code[] = {WASM_I32_ADD(WASM_GET_LOCAL(0), WASM_GET_LOCAL(1)),
+                      kExprEnd};
+    f->EmitCode(code, arraysize(code));
+    builder.AddExport(CStrVector("add"), f);
+  }
+  {
+    WasmFunctionBuilder* f = builder.AddFunction(sigs.i_i());
+    uint8_t code[] = {WASM_LOAD_MEM(MachineType::Int32(), WASM_GET_LOCAL(0)),
+                      kExprEnd};
+    f->EmitCode(code, arraysize(code));
+    builder.AddExport(CStrVector("load"), f);
+  }
+  {
+    WasmFunctionBuilder* f = builder.AddFunction(sigs.i_v());
+    uint8_t code[] = {WASM_I32V_2(n), kExprEnd};
+    f->EmitCode(code, arraysize(code));
+    builder.AddExport(CStrVector("other"), f);
+  }
+  ZoneBuffer buffer(zone);
+  builder.WriteTo(&buffer);
+  return buffer;
+}
+
+Handle<WasmInstanceObject> CompileAndInstantiate(Isolate* isolate,
+                                                 const ZoneBuffer& buffer) {
+  ErrorThrower thrower(isolate, "CompileAndInstantiate");
+  Handle<WasmInstanceObject> instance =
+      testing::CompileAndInstantiateForTesting(
+          isolate, &thrower, ModuleWireBytes(buffer.begin(), buffer.end()))
+          .ToHandleChecked();
+  CHECK(!thrower.error());
+  return instance;
+}
+
+int32_t CallAdd(Isolate* isolate, Handle<WasmInstanceObject> instance, int a,
+                int b) {
+  Handle<Object> args[] = {handle(Smi::FromInt(a), isolate),
+                           handle(Smi::FromInt(b), isolate)};
+  return testing::CallWasmFunctionForTesting(isolate, instance, "add", 2,
+                                             args);
+}
+
+}  // namespace
+
+TEST(FunctionCodeCacheSharedAcrossModules) {
+  FlagScope<bool> code_cache(&FLAG_wasm_function_code_cache, true);
+  FlagScope<bool> no_liftoff(&FLAG_liftoff, false);
+  FlagScope<bool> no_lazy(&FLAG_wasm_lazy_compilation, false);
+  Isolate* isolate = CcTest::InitIsolateOnce();
+  HandleScope scope(isolate);
+  testing::SetupIsolateForWasmModule(isolate);
+  WasmFunctionCodeCache* cache = isolate->wasm_engine()->function_code_cache();
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+
+  size_t initial_entries = cache->num_entries();
+  Handle<WasmInstanceObject> instance1 =
+      CompileAndInstantiate(isolate, BuildModule(&zone, 1, 1));
+  CHECK_EQ(initial_entries + 3, cache->num_entries());
+
+  // Only "other" differs, so it is the only new entry.
+  Handle<WasmInstanceObject> instance2 =
+      CompileAndInstantiate(isolate, BuildModule(&zone, 2, 1));
+  CHECK_EQ(initial_entries + 4, cache->num_entries());
+
+  CHECK_EQ(7, CallAdd(isolate, instance1, 3, 4));
+  CHECK_EQ(7, CallAdd(isolate, instance2, 3, 4));
+  CHECK_EQ(-1, CallAdd(isolate, instance2, 1, -2));
+}
+
+TEST(FunctionCodeCacheKeyIncludesMemorySize) {
+  FlagScope<bool> code_cache(&FLAG_wasm_function_code_cache, true);
+  FlagScope<bool> no_liftoff(&FLAG_liftoff, false);
+  FlagScope<bool> no_lazy(&FLAG_wasm_lazy_compilation, false);
+  Isolate* isolate = CcTest::InitIsolateOnce();
+  HandleScope scope(isolate);
+  testing::SetupIsolateForWasmModule(isolate);
+  WasmFunctionCodeCache* cache = isolate->wasm_engine()->function_code_cache();
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+
+  size_t initial_entries = cache->num_entries();
+  CompileAndInstantiate(isolate, BuildModule(&zone, 1, 1));
+  CHECK_EQ(initial_entries + 3, cache->num_entries());
+
+  // Bounds checks depend on the memory size, so "load" cannot be shared.
+  Handle<WasmInstanceObject> instance =
+      CompileAndInstantiate(isolate, BuildModule(&zone, 2, 2));
+  CHECK_EQ(initial_entries + 5, cache->num_entries());
+
+  // Out-of-bounds accesses still trap in the second module.
+  Handle<Object> args[] = {handle(Smi::FromInt(2 * kWasmPageSize), isolate)};
+  bool exception = false;
+  testing::CallWasmFunctionForTesting(isolate, instance, "load", 1, args,
+                                      &exception);
+  CHECK(exception);
+}
+
+TEST(FunctionCodeCacheLookupOnlyForValidatedBodies) {
+  FlagScope<bool> code_cache(&FLAG_wasm_function_code_cache, true);
+  FlagScope<bool> no_liftoff(&FLAG_liftoff, false);
+  FlagScope<bool> lazy(&FLAG_wasm_lazy_compilation, true);
+  FlagScope<bool> no_lazy_validation(&FLAG_wasm_lazy_validation, false);
+  Isolate* isolate = CcTest::InitIsolateOnce();
+  HandleScope scope(isolate);
+  testing::SetupIsolateForWasmModule(isolate);
+  WasmFunctionCodeCache* cache = isolate->wasm_engine()->function_code_cache();
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+
+  // Lazy functions are validated before the module runs, so compiling "add"
+  // on its first call looks it up in the cache.
+  Handle<WasmInstanceObject> instance1 =
+      CompileAndInstantiate(isolate, BuildModule(&zone, 3, 1));
+  CHECK_EQ(7, CallAdd(isolate, instance1, 3, 4));
+  Handle<WasmInstanceObject> instance2 =
+      CompileAndInstantiate(isolate, BuildModule(&zone, 4, 1));
+  size_t hits = cache->num_hits();
+  CHECK_EQ(7, CallAdd(isolate, instance2, 3, 4));
+  CHECK_EQ(hits + 1, cache->num_hits());
+
+  // Eagerly compiled TurboFan code is validated by TurboFan itself. The body
+  // is only added to the cache afterwards, it is never looked up.
+  FlagScope<bool> no_lazy(&FLAG_wasm_lazy_compilation, false);
+  hits = cache->num_hits();
+  Handle<WasmInstanceObject> instance3 =
+      CompileAndInstantiate(isolate, BuildModule(&zone, 5, 1));
+  CHECK_EQ(hits, cache->num_hits());
+  CHECK_EQ(7, CallAdd(isolate, instance3, 3, 4));
+}
+
+}  // namespace test_wasm_function_code_cache
+}  // namespace wasm
+}  // namespace internal
+}  // namespace v8
@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
 
 #include "include/libplatform/libplatform.h"
@@ -245,6 +246,7 @@ class MetricsRecorder : public v8::metrics::Recorder {
   std::vector<v8::metrics::WasmModuleCompiled> module_compiled_;
   std::vector<v8::metrics::WasmModuleInstantiated> module_instantiated_;
   std::vector<v8::metrics::WasmModuleTieredUp> module_tiered_up_;
+  std::vector<v8::metrics::WasmModuleCodeSpaceUsage> code_space_usage_;
 
   void AddMainThreadEvent(const v8::metrics::WasmModuleDecoded& event,
                           v8::metrics::Recorder::ContextId id) override {
@@ -266,6 +268,10 @@ class MetricsRecorder : public v8::metrics::Recorder {
     CHECK(!id.IsEmpty());
     module_tiered_up_.emplace_back(event);
   }
+  void AddThreadSafeEvent(
+      const v8::metrics::WasmModuleCodeSpaceUsage& event) override {
+    code_space_usage_.emplace_back(event);
+  }
 };
 
 COMPILE_TEST(TestEventMetrics) {
@@ -354,6 +360,178 @@ COMPILE_TEST(TestEventMetrics) {
   CHECK_LE(0, recorder->module_tiered_up_.back().wall_clock_duration_in_us);
 }
 
+COMPILE_TEST(TestCodeSpaceUsageMetrics) {
+  // Run code GC as soon as the Liftoff code is replaced by TurboFan code. The
+  // code space is compacted explicitly below, once the location of the
+  // TurboFan code is known.
+  FlagScope<bool> tier_up(&FLAG_wasm_tier_up, true);
+  FlagScope<bool> stress_gc(&FLAG_stress_wasm_code_gc, true);
+  FlagScope<bool> compaction(&FLAG_wasm_code_compaction, false);
+  FlagScope<uint32_t> threshold(&FLAG_wasm_code_compaction_threshold, 0);
+  std::shared_ptr<MetricsRecorder> recorder =
+      std::make_shared<MetricsRecorder>();
+  reinterpret_cast<v8::Isolate*>(isolate)->SetMetricsRecorder(recorder);
+
+  TestSignatures sigs;
+  v8::internal::AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+
+  WasmModuleBuilder* builder = zone.New<WasmModuleBuilder>(&zone);
+  // The Liftoff code of {pad} spans several pages, such that the TurboFan code
+  // of all functions is allocated behind it and can be moved down once the
+  // Liftoff code is freed.
+  WasmFunctionBuilder* pad = builder->AddFunction(sigs.i_i());
+  for (int i = 0; i < 4000; ++i) {
+    byte code[] = {WASM_SET_LOCAL(
+        0, WASM_I32_ADD(WASM_GET_LOCAL(0), WASM_I32V_1(1)))};
+    pad->EmitCode(code, sizeof(code));
+  }
+  pad->EmitGetLocal(0);
+  pad->Emit(kExprEnd);
+  WasmFunctionBuilder* twice = builder->AddFunction(sigs.i_i());
+  {
+    byte code[] = {WASM_I32_ADD(WASM_GET_LOCAL(0), WASM_GET_LOCAL(0)),
+                   kExprEnd};
+    twice->EmitCode(code, sizeof(code));
+  }
+  // {lookup} returns 10 + min(x, kNumCases - 1) via a br_table, which TurboFan
+  // compiles to a jump table with internal references.
+  constexpr int kNumCases = 8;
+  WasmFunctionBuilder* lookup = builder->AddFunction(sigs.i_i());
+  for (int i = 0; i < kNumCases; ++i) lookup->EmitWithU8(kExprBlock, kVoidCode);
+  lookup->EmitGetLocal(0);
+  lookup->EmitWithU32V(kExprBrTable, kNumCases - 1);
+  for (int i = 0; i < kNumCases; ++i) lookup->EmitU32V(i);
+  for (int i = 0; i < kNumCases; ++i) {
+    lookup->Emit(kExprEnd);
+    lookup->EmitI32Const(10 + i);
+    if (i < kNumCases - 1) lookup->Emit(kExprReturn);
+  }
+  lookup->Emit(kExprEnd);
+  builder->AllocateIndirectFunctions(1);
+  builder->SetIndirectFunction(0, twice->func_index());
+  uint32_t sig_index = builder->AddSignature(sigs.i_i());
+  // {main} makes direct calls, an indirect call through the table, and calls
+  // {lookup}: twice(pad(0)) + table[0](3) + lookup(5) = 8000 + 6 + 15.
+  WasmFunctionBuilder* main = builder->AddFunction(sigs.i_v());
+  {
+    byte code[] = {
+        WASM_I32_ADD(
+            WASM_I32_ADD(
+                WASM_CALL_FUNCTION(twice->func_index(),
+                                   WASM_CALL_FUNCTION(pad->func_index(),
+                                                      WASM_ZERO)),
+                WASM_CALL_INDIRECT(sig_index, WASM_I32V_1(3), WASM_ZERO)),
+            WASM_CALL_FUNCTION(lookup->func_index(), WASM_I32V_1(5))),
+        kExprEnd};
+    main->EmitCode(code, sizeof(code));
+  }
+  builder->AddExport(CStrVector("main"), main);
+  builder->AddExport(CStrVector("lookup"), lookup);
+  ZoneBuffer buffer(&zone);
+  builder->WriteTo(&buffer);
+  const uint32_t num_functions = main->func_index() + 1;
+
+  auto enabled_features = WasmFeatures::FromIsolate(isolate);
+  CompilationStatus status = CompilationStatus::kPending;
+  std::string error_message;
+  std::shared_ptr<NativeModule> native_module;
+  isolate->wasm_engine()->AsyncCompile(
+      isolate, enabled_features,
+      std::make_shared<TestCompileResolver>(&status, &error_message, isolate,
+                                            &native_module),
+      ModuleWireBytes(buffer.begin(), buffer.end()), true,
+      "CompileAndInstantiateWasmModuleForTesting");
+
+  while (status == CompilationStatus::kPending) {
+    platform->ExecuteTasks();
+  }
+  CHECK_EQ(CompilationStatus::kFinished, status);
+  auto all_turbofan = [&]() {
+    for (uint32_t i = 0; i < num_functions; ++i) {
+      if (!native_module->HasCodeWithTier(i, ExecutionTier::kTurbofan)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  // Wait for top tier compilation, code GC, and the code space task.
+  while (recorder->code_space_usage_.empty() || !all_turbofan()) {
+    platform->ExecuteTasks();
+  }
+  platform->ExecuteTasks();  // Complete pending code GCs.
+
+  const v8::metrics::WasmModuleCodeSpaceUsage usage =
+      recorder->code_space_usage_.back();
+  CHECK_EQ(1, usage.code_space_count);
+  CHECK_LT(0, usage.freed_code_size_in_bytes);
+  CHECK_LT(0, usage.live_code_size_in_bytes);
+  CHECK_GE(usage.committed_code_space_in_bytes, usage.live_code_size_in_bytes);
+  CHECK_EQ(
+      usage.committed_code_space_in_bytes - usage.live_code_size_in_bytes,
+      usage.fragmented_code_space_in_bytes);
+  CHECK_EQ(0, usage.relocated_code_size_in_bytes);
+
+  // Compact the code space like the code space task does, and check that code
+  // was moved to lower addresses.
+  std::vector<Address> old_code_starts;
+  {
+    WasmCodeRefScope code_ref_scope;
+    for (uint32_t i = 0; i < num_functions; ++i) {
+      old_code_starts.push_back(
+          native_module->GetCode(i)->instruction_start());
+    }
+  }
+  size_t relocated_size;
+  {
+    NativeModuleModificationScope modification_scope(native_module.get());
+    relocated_size = native_module->CompactCode();
+  }
+  CHECK_LT(0, relocated_size);
+  CHECK_GE(usage.live_code_size_in_bytes, relocated_size);
+  {
+    WasmCodeRefScope code_ref_scope;
+    size_t moved_size = 0;
+    for (uint32_t i = 0; i < num_functions; ++i) {
+      WasmCode* code = native_module->GetCode(i);
+      CHECK_EQ(ExecutionTier::kTurbofan, code->tier());
+      CHECK_LE(code->instruction_start(), old_code_starts[i]);
+      if (code->instruction_start() < old_code_starts[i]) {
+        moved_size += code->instructions().size();
+      }
+      CHECK_EQ(code, native_module->Lookup(code->instruction_start()));
+    }
+    CHECK_EQ(relocated_size, moved_size);
+  }
+
+  // Run the moved code: direct calls and calls through the table go via the
+  // jump table, and {lookup} uses internal references.
+  Handle<WasmModuleObject> module_object =
+      isolate->wasm_engine()->ImportNativeModule(isolate, native_module, {});
+  ErrorThrower thrower(isolate, "TestCodeSpaceUsageMetrics");
+  Handle<WasmInstanceObject> instance =
+      isolate->wasm_engine()
+          ->SyncInstantiate(isolate, &thrower, module_object, {}, {})
+          .ToHandleChecked();
+  CHECK_EQ(8021, testing::CallWasmFunctionForTesting(isolate, instance, "main",
+                                                     0, nullptr));
+  for (int i = 0; i < kNumCases + 2; ++i) {
+    Handle<Object> params[] = {handle(Smi::FromInt(i), isolate)};
+    CHECK_EQ(10 + std::min(i, kNumCases - 1),
+             testing::CallWasmFunctionForTesting(isolate, instance, "lookup",
+                                                 1, params));
+  }
+
+  // The old copies get freed by the next code GC, which reports the code space
+  // usage again.
+  const size_t num_events = recorder->code_space_usage_.size();
+  while (recorder->code_space_usage_.size() == num_events) {
+    platform->ExecuteTasks();
+  }
+  CHECK_GT(usage.committed_code_space_in_bytes,
+           recorder->code_space_usage_.back().committed_code_space_in_bytes);
+}
+
 }  // namespace wasm
 }  // namespace internal
 }  // namespace v8
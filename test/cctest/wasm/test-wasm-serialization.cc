@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include <stdlib.h>
 #include <string.h>
 
@@ -57,6 +59,14 @@ class WasmSerializationTest {
     *slot = Version::Hash() + 1;
   }
 
+  void InvalidateFormatVersion() {
+    uint32_t* slot = reinterpret_cast<uint32_t*>(
+        const_cast<uint8_t*>(serialized_bytes_.data()) +
+        WasmSerializer::kFormatVersionOffset);
+    CHECK_EQ(WasmSerializer::kFormatVersion, *slot);
+    *slot = WasmSerializer::kFormatVersion - 1;
+  }
+
   void InvalidateWireBytes() {
     memset(const_cast<uint8_t*>(wire_bytes_.data()), 0, wire_bytes_.size() / 2);
   }
@@ -229,6 +239,16 @@ TEST(DeserializeMismatchingVersion) {
   test.CollectGarbage();
 }
 
+TEST(DeserializeMismatchingFormatVersion) {
+  WasmSerializationTest test;
+  {
+    HandleScope scope(CcTest::i_isolate());
+    test.InvalidateFormatVersion();
+    CHECK(test.Deserialize().is_null());
+  }
+  test.CollectGarbage();
+}
+
 TEST(DeserializeNoSerializedData) {
   WasmSerializationTest test;
   {
@@ -350,6 +370,236 @@ TEST(TierDownAfterDeserialization) {
   CHECK_EQ(ExecutionTier::kLiftoff, liftoff_code->tier());
 }
 
+namespace {
+
+// Builds a module exporting the functions "f0" and "f1", which return
+// {base} and {base + 1}.
+ZoneBuffer BuildTwoFunctionModule(Zone* zone, int base = 0) {
+  TestSignatures sigs;
+  WasmModuleBuilder builder(zone);
+  for (int i = 0; i < 2; ++i) {
+    WasmFunctionBuilder* f = builder.AddFunction(sigs.i_v());
+    byte code[] = {WASM_I32V_1(base + i), kExprEnd};
+    f->EmitCode(code, sizeof(code));
+    builder.AddExport(CStrVector(i == 0 ? "f0" : "f1"), f);
+  }
+  ZoneBuffer buffer(zone);
+  builder.WriteTo(&buffer);
+  return buffer;
+}
+
+// Compiles {wire_bytes} in a new isolate, calls the exported function
+// {function_name}, and serializes the module (merged with {previous}). The
+// isolate is disposed afterwards, such that the native module dies and later
+// deserialization does not find it in the module cache.
+v8::OwnedBuffer CompileRunAndSerialize(const ZoneBuffer& wire_bytes,
+                                       const char* function_name,
+                                       v8::MemorySpan<const uint8_t> previous) {
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* v8_isolate = v8::Isolate::New(create_params);
+  Isolate* isolate = reinterpret_cast<Isolate*>(v8_isolate);
+  std::weak_ptr<NativeModule> weak_native_module;
+  v8::OwnedBuffer serialized;
+  {
+    v8::HandleScope scope(v8_isolate);
+    v8::Local<v8::Context> context = v8::Context::New(v8_isolate);
+    context->Enter();
+    testing::SetupIsolateForWasmModule(isolate);
+    ErrorThrower thrower(isolate, "CompileRunAndSerialize");
+    Handle<WasmInstanceObject> instance =
+        testing::CompileAndInstantiateForTesting(
+            isolate, &thrower,
+            ModuleWireBytes(wire_bytes.begin(), wire_bytes.end()))
+            .ToHandleChecked();
+    testing::CallWasmFunctionForTesting(isolate, instance, function_name, 0,
+                                        nullptr);
+    Handle<WasmModuleObject> module_object(instance->module_object(), isolate);
+    weak_native_module = module_object->shared_native_module();
+    v8::Local<v8::WasmModuleObject> v8_module_object =
+        v8::Utils::ToLocal(Handle<JSObject>::cast(module_object))
+            .As<v8::WasmModuleObject>();
+    serialized = v8_module_object->GetCompiledModule().SerializeAndMerge(
+        previous);
+    CHECK_LT(0, serialized.size);
+    context->Exit();
+  }
+  v8_isolate->Dispose();
+  while (weak_native_module.lock()) {
+  }
+  return serialized;
+}
+
+Handle<WasmModuleObject> DeserializeInCurrentIsolate(
+    const ZoneBuffer& wire_bytes, const v8::OwnedBuffer& serialized) {
+  return DeserializeNativeModule(
+             CcTest::i_isolate(), {serialized.buffer.get(), serialized.size},
+             VectorOf(wire_bytes.begin(), wire_bytes.size()), {})
+      .ToHandleChecked();
+}
+
+}  // namespace
+
+TEST(SerializeLiftoffCodeOfLazyModule) {
+  FlagScope<bool> lazy_compilation(&FLAG_wasm_lazy_compilation, true);
+  FlagScope<bool> liftoff(&FLAG_liftoff, true);
+  FlagScope<bool> no_tier_up(&FLAG_wasm_tier_up, false);
+  CcTest::InitIsolateOnce();
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+  ZoneBuffer wire_bytes = BuildTwoFunctionModule(&zone);
+
+  v8::OwnedBuffer serialized = CompileRunAndSerialize(wire_bytes, "f0", {});
+
+  Isolate* isolate = CcTest::i_isolate();
+  v8::HandleScope scope(CcTest::isolate());
+  v8::Local<v8::Context> context = v8::Context::New(CcTest::isolate());
+  v8::Context::Scope context_scope(context);
+  Handle<WasmModuleObject> module_object =
+      DeserializeInCurrentIsolate(wire_bytes, serialized);
+  NativeModule* native_module = module_object->native_module();
+  CHECK(native_module->HasCodeWithTier(0, ExecutionTier::kLiftoff));
+  CHECK(!native_module->HasCode(1));
+
+  // The function without code gets compiled lazily.
+  ErrorThrower thrower(isolate, "SerializeLiftoffCodeOfLazyModule");
+  Handle<WasmInstanceObject> instance =
+      isolate->wasm_engine()
+          ->SyncInstantiate(isolate, &thrower, module_object, {}, {})
+          .ToHandleChecked();
+  CHECK_EQ(1, testing::CallWasmFunctionForTesting(isolate, instance, "f1", 0,
+                                                  nullptr));
+  CHECK(native_module->HasCode(1));
+}
+
+TEST(MergeWithPreviousSerialization) {
+  FlagScope<bool> lazy_compilation(&FLAG_wasm_lazy_compilation, true);
+  FlagScope<bool> liftoff(&FLAG_liftoff, true);
+  FlagScope<bool> no_tier_up(&FLAG_wasm_tier_up, false);
+  CcTest::InitIsolateOnce();
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+  ZoneBuffer wire_bytes = BuildTwoFunctionModule(&zone);
+
+  v8::OwnedBuffer first = CompileRunAndSerialize(wire_bytes, "f0", {});
+  // The second run only compiles "f1", but keeps the code of "f0".
+  v8::OwnedBuffer merged = CompileRunAndSerialize(
+      wire_bytes, "f1", {first.buffer.get(), first.size});
+  CHECK_LT(first.size, merged.size);
+
+  v8::HandleScope scope(CcTest::isolate());
+  v8::Local<v8::Context> context = v8::Context::New(CcTest::isolate());
+  v8::Context::Scope context_scope(context);
+  Handle<WasmModuleObject> module_object =
+      DeserializeInCurrentIsolate(wire_bytes, merged);
+  NativeModule* native_module = module_object->native_module();
+  CHECK(native_module->HasCodeWithTier(0, ExecutionTier::kLiftoff));
+  CHECK(native_module->HasCodeWithTier(1, ExecutionTier::kLiftoff));
+}
+
+TEST(MergeWithSerializationOfOtherModule) {
+  FlagScope<bool> lazy_compilation(&FLAG_wasm_lazy_compilation, true);
+  FlagScope<bool> liftoff(&FLAG_liftoff, true);
+  FlagScope<bool> no_tier_up(&FLAG_wasm_tier_up, false);
+  CcTest::InitIsolateOnce();
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+  // Same function counts and signatures, different code.
+  ZoneBuffer other_wire_bytes = BuildTwoFunctionModule(&zone, 10);
+  ZoneBuffer wire_bytes = BuildTwoFunctionModule(&zone);
+
+  v8::OwnedBuffer other = CompileRunAndSerialize(other_wire_bytes, "f0", {});
+  // The code of the other module must not be merged in.
+  v8::OwnedBuffer serialized = CompileRunAndSerialize(
+      wire_bytes, "f1", {other.buffer.get(), other.size});
+
+  Isolate* isolate = CcTest::i_isolate();
+  v8::HandleScope scope(CcTest::isolate());
+  v8::Local<v8::Context> context = v8::Context::New(CcTest::isolate());
+  v8::Context::Scope context_scope(context);
+  // The serialization of the other module is rejected on deserialization.
+  CHECK(DeserializeNativeModule(
+            isolate, {other.buffer.get(), other.size},
+            VectorOf(wire_bytes.begin(), wire_bytes.size()), {})
+            .is_null());
+
+  Handle<WasmModuleObject> module_object =
+      DeserializeInCurrentIsolate(wire_bytes, serialized);
+  NativeModule* native_module = module_object->native_module();
+  CHECK(!native_module->HasCode(0));
+  CHECK(native_module->HasCodeWithTier(1, ExecutionTier::kLiftoff));
+
+  ErrorThrower thrower(isolate, "MergeWithSerializationOfOtherModule");
+  Handle<WasmInstanceObject> instance =
+      isolate->wasm_engine()
+          ->SyncInstantiate(isolate, &thrower, module_object, {}, {})
+          .ToHandleChecked();
+  CHECK_EQ(0, testing::CallWasmFunctionForTesting(isolate, instance, "f0", 0,
+                                                  nullptr));
+}
+
+TEST(DeserializeLiftoffCodeInNewIsolate) {
+  FlagScope<bool> lazy_compilation(&FLAG_wasm_lazy_compilation, true);
+  FlagScope<bool> liftoff(&FLAG_liftoff, true);
+  FlagScope<bool> no_tier_up(&FLAG_wasm_tier_up, false);
+  FlagScope<bool> bulk_memory(&FLAG_experimental_wasm_bulk_memory, true);
+  CcTest::InitIsolateOnce();
+  AccountingAllocator allocator;
+  Zone zone(&allocator, ZONE_NAME);
+
+  // Liftoff calls a C function for memory.fill, which is embedded as an
+  // external reference in the code.
+  TestSignatures sigs;
+  WasmModuleBuilder builder(&zone);
+  WasmFunctionBuilder* f = builder.AddFunction(sigs.i_v());
+  byte code[] = {
+      WASM_MEMORY_FILL(WASM_ZERO, WASM_I32V_1(42), WASM_I32V_1(16)),
+      WASM_LOAD_MEM(MachineType::Uint8(), WASM_I32V_1(15)), kExprEnd};
+  f->EmitCode(code, sizeof(code));
+  builder.AddExport(CStrVector("fill"), f);
+  ZoneBuffer wire_bytes(&zone);
+  builder.WriteTo(&wire_bytes);
+
+  v8::OwnedBuffer serialized = CompileRunAndSerialize(wire_bytes, "fill", {});
+
+  // The external reference is serialized as a tag, not as an address.
+  Address fill_address = ExternalReference::wasm_memory_fill().address();
+  const uint8_t* fill_address_bytes =
+      reinterpret_cast<const uint8_t*>(&fill_address);
+  const uint8_t* serialized_end = serialized.buffer.get() + serialized.size;
+  CHECK_EQ(serialized_end,
+           std::search(serialized.buffer.get(), serialized_end,
+                       fill_address_bytes,
+                       fill_address_bytes + sizeof(fill_address)));
+
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* v8_isolate = v8::Isolate::New(create_params);
+  Isolate* isolate = reinterpret_cast<Isolate*>(v8_isolate);
+  {
+    v8::Isolate::Scope isolate_scope(v8_isolate);
+    v8::HandleScope scope(v8_isolate);
+    v8::Local<v8::Context> context = v8::Context::New(v8_isolate);
+    v8::Context::Scope context_scope(context);
+    testing::SetupIsolateForWasmModule(isolate);
+    Handle<WasmModuleObject> module_object =
+        DeserializeNativeModule(
+            isolate, {serialized.buffer.get(), serialized.size},
+            VectorOf(wire_bytes.begin(), wire_bytes.size()), {})
+            .ToHandleChecked();
+    CHECK(module_object->native_module()->HasCodeWithTier(
+        0, ExecutionTier::kLiftoff));
+    ErrorThrower thrower(isolate, "DeserializeLiftoffCodeInNewIsolate");
+    Handle<WasmInstanceObject> instance =
+        isolate->wasm_engine()
+            ->SyncInstantiate(isolate, &thrower, module_object, {}, {})
+            .ToHandleChecked();
+    CHECK_EQ(42, testing::CallWasmFunctionForTesting(isolate, instance, "fill",
+                                                     0, nullptr));
+  }
+  v8_isolate->Dispose();
+}
+
 }  // namespace test_wasm_serialization
 }  // namespace wasm
 }  // namespace internal
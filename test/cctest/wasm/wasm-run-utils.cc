@@ -84,12 +84,13 @@ TestingModuleBuilder::~TestingModuleBuilder() {
   native_module_->SetWireBytes({});
 }
 
-byte* TestingModuleBuilder::AddMemory(uint32_t size, SharedFlag shared) {
+byte* TestingModuleBuilder::AddMemory(size_t size, SharedFlag shared) {
   CHECK(!test_module_->has_memory);
   CHECK_NULL(mem_start_);
   CHECK_EQ(0, mem_size_);
   DCHECK(!instance_object_->has_memory_object());
-  uint32_t initial_pages = RoundUp(size, kWasmPageSize) / kWasmPageSize;
+  uint32_t initial_pages =
+      static_cast<uint32_t>(RoundUp(size, kWasmPageSize) / kWasmPageSize);
   uint32_t maximum_pages = (test_module_->maximum_pages != 0)
                                ? test_module_->maximum_pages
                                : initial_pages;
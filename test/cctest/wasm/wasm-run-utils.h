@@ -103,7 +103,7 @@ class TestingModuleBuilder {
 
   void ChangeOriginToAsmjs() { test_module_->origin = kAsmJsSloppyOrigin; }
 
-  byte* AddMemory(uint32_t size, SharedFlag shared = SharedFlag::kNotShared);
+  byte* AddMemory(size_t size, SharedFlag shared = SharedFlag::kNotShared);
 
   size_t CodeTableLength() const { return native_module_->num_functions(); }
 
@@ -128,7 +128,7 @@ class TestingModuleBuilder {
     return static_cast<byte>(size - 1);
   }
 
-  uint32_t mem_size() { return mem_size_; }
+  size_t mem_size() { return mem_size_; }
 
   template <typename T>
   T* raw_mem_start() {
@@ -187,6 +187,10 @@ class TestingModuleBuilder {
 
   void SetHasSharedMemory() { test_module_->has_shared_memory = true; }
 
+  // Makes the memory a memory64, which uses i64 indexes. Call this before
+  // adding the memory and building any function.
+  void SetMemory64() { test_module_->is_memory64 = true; }
+
   enum FunctionType { kImport, kWasm };
   uint32_t AddFunction(const FunctionSig* sig, const char* name,
                        FunctionType type);
@@ -261,7 +265,7 @@ class TestingModuleBuilder {
   WasmFeatures enabled_features_;
   uint32_t global_offset = 0;
   byte* mem_start_ = nullptr;
-  uint32_t mem_size_ = 0;
+  size_t mem_size_ = 0;
   alignas(16) byte globals_data_[kMaxGlobalsSize];
   std::unique_ptr<WasmInterpreter> interpreter_;
   TestExecutionTier execution_tier_;
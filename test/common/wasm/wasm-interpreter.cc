@@ -1662,8 +1662,10 @@ class WasmInterpreterInternals {
         // validation.
         DCHECK_LT(imm.data_segment_index, module()->num_declared_data_segments);
         *len += imm.length;
-        uint64_t size = ToMemType(Pop());
-        uint64_t src = ToMemType(Pop());
+        // Only the destination is a memory offset; source and size refer to
+        // the data segment.
+        uint64_t size = Pop().to<uint32_t>();
+        uint64_t src = Pop().to<uint32_t>();
         uint64_t dst = ToMemType(Pop());
         Address dst_addr;
         uint64_t src_max =
@@ -2796,7 +2798,7 @@ class WasmInterpreterInternals {
         MemoryAccessImmediate<Decoder::kNoValidation> imm(
             decoder, code->at(pc + *len), 4, module()->is_memory64);
         // Pop address and do nothing.
-        Pop().to<uint32_t>();
+        ToMemType(Pop());
         *len += imm.length;
         return true;
       }
@@ -3681,14 +3683,18 @@ class WasmInterpreterInternals {
         case kExprMemoryGrow: {
           MemoryIndexImmediate<Decoder::kNoValidation> imm(&decoder,
                                                            code->at(pc + 1));
-          // TODO(clemensb): Fix this for memory64.
-          uint32_t delta_pages = Pop().to<uint32_t>();
+          uint64_t delta_pages = ToMemType(Pop());
           HandleScope handle_scope(isolate_);  // Avoid leaking handles.
           Handle<WasmMemoryObject> memory(instance_object_->memory_object(),
                                           isolate_);
+          // A delta of 2^32 pages or more can never succeed.
           int32_t result =
-              WasmMemoryObject::Grow(isolate_, memory, delta_pages);
-          Push(WasmValue(result));
+              delta_pages > kMaxUInt32
+                  ? -1
+                  : WasmMemoryObject::Grow(isolate_, memory,
+                                           static_cast<uint32_t>(delta_pages));
+          Push(module()->is_memory64 ? WasmValue(int64_t{result})
+                                     : WasmValue(result));
           len = 1 + imm.length;
           // Treat one grow_memory instruction like 1000 other instructions,
           // because it is a really expensive operation.
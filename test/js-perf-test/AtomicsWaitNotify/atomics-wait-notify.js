@@ -0,0 +1,79 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Many workers doing Atomics.wait/notify at the same time, either each on its
+// own address or all on the same one. The waits use a zero timeout, so the
+// score mostly reflects the cost of adding and removing waiters and looking
+// them up, including the contention between threads.
+
+const kWorkers = 8;
+const kRounds = 100;
+
+// Indices into the shared Int32Array.
+const kGeneration = 0;
+const kDone = 1;
+const kFirstSlot = 16;
+// Keep the distinct addresses on different cache lines.
+const kSlotDistance = 16;
+const kStop = -1;
+
+const workerScript = `
+  onmessage = function(msg) {
+    const i32a = new Int32Array(msg.sab);
+    const index = msg.index;
+    let generation = 0;
+    while (true) {
+      Atomics.wait(i32a, ${kGeneration}, generation);
+      generation = Atomics.load(i32a, ${kGeneration});
+      if (generation == ${kStop}) break;
+      for (let i = 0; i < ${kRounds}; ++i) {
+        Atomics.wait(i32a, index, 0, 0);
+        Atomics.notify(i32a, index, 1);
+      }
+      Atomics.add(i32a, ${kDone}, 1);
+      Atomics.notify(i32a, ${kDone}, 1);
+    }
+  };`;
+
+let i32a;
+let workers;
+
+function StartWorkers(shared) {
+  i32a = new Int32Array(
+      new SharedArrayBuffer((kFirstSlot + kWorkers * kSlotDistance) * 4));
+  workers = [];
+  for (let id = 0; id < kWorkers; ++id) {
+    const worker = new Worker(workerScript, {type: 'string'});
+    const index = shared ? kFirstSlot : kFirstSlot + id * kSlotDistance;
+    worker.postMessage({sab: i32a.buffer, index: index});
+    workers.push(worker);
+  }
+}
+
+function StopWorkers() {
+  Atomics.store(i32a, kGeneration, kStop);
+  Atomics.notify(i32a, kGeneration);
+  for (const worker of workers) worker.terminate();
+  workers = undefined;
+}
+
+function RunRound() {
+  Atomics.store(i32a, kDone, 0);
+  Atomics.add(i32a, kGeneration, 1);
+  Atomics.notify(i32a, kGeneration);
+  let done;
+  while ((done = Atomics.load(i32a, kDone)) < kWorkers) {
+    Atomics.wait(i32a, kDone, done);
+  }
+}
+
+new BenchmarkSuite('Distinct', [1000], [
+  new Benchmark('Distinct', false, false, 0, RunRound,
+                () => StartWorkers(false), StopWorkers),
+]);
+
+new BenchmarkSuite('Shared', [1000], [
+  new Benchmark('Shared', false, false, 0, RunRound,
+                () => StartWorkers(true), StopWorkers),
+]);
@@ -0,0 +1,39 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Scans a log for regexps that start with one of a few literals, which are
+// found by the prefilter before the matcher runs.
+
+const lines = [];
+for (let i = 0; i < 200; i++) {
+  lines.push(`2021-01-${10 + i % 20} 12:00:${10 + i % 50} INFO worker-${i} ` +
+             `handled job ${i * 7} in ${i % 13}ms`);
+  if (i % 40 == 0) lines.push(`GET /api/users/${i} 200`);
+  if (i % 50 == 0) lines.push(`POST /api/login 401`);
+  if (i % 70 == 0) lines.push(`Error: timeout after ${i}s`);
+}
+const log = lines.join("\n");
+
+function RequestTest() {
+  /(GET|POST|PUT) \/api\/(\w+)/.test(log);
+}
+
+function RequestMatchAll() {
+  log.match(/(?:GET|POST|PUT) \/api\/\w+/g);
+}
+
+function ErrorCaseInsensitiveMatch() {
+  log.match(/error: timeout after (\d+)s/gi);
+}
+
+function MissingLiteralTest() {
+  /DELETE \/api/.test(log);
+}
+
+var benchmarks = [ [RequestTest, () => {}],
+                   [RequestMatchAll, () => {}],
+                   [ErrorCaseInsensitiveMatch, () => {}],
+                   [MissingLiteralTest, () => {}],
+                 ];
+createBenchmarkSuite("PrefilterTest");
@@ -12,6 +12,7 @@ load('inline_test.js')
 load('complex_case_test.js');
 load('case_test.js');
 load('match.js');
+load('prefilter_test.js');
 load('replace.js');
 load('search.js');
 load('split.js');
@@ -0,0 +1,52 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Searches in a long subject with regexps on the experimental linear-time
+// engine.  Regexps without capture groups are matched without running the
+// NFA, the captures of a match are extracted from the match only.
+
+const kSubject = (() => {
+  const words = ["lorem", "ipsum", "dolor", "sit", "amet", "consectetur"];
+  const parts = [];
+  for (let i = 0; i < 20000; ++i) parts.push(words[(i * 7) % words.length]);
+  parts.push("needle42");
+  return parts.join(" ");
+})();
+
+function Check(condition) {
+  if (!condition) throw new Error("Unexpected result");
+}
+
+function NoMatch() {
+  Check(!/needle\d+x|haystack/l.test(kSubject));
+}
+
+function Match() {
+  Check(/needle\d+/l.exec(kSubject).index > 0);
+}
+
+function Captures() {
+  const match = /(needle)(\d+)/l.exec(kSubject);
+  Check(match[2] === "42");
+}
+
+function Global() {
+  Check(kSubject.match(/sit|amet/gl).length === 6666);
+}
+
+new BenchmarkSuite('NoMatch', [1000], [
+  new Benchmark('NoMatch', false, false, 0, NoMatch),
+]);
+
+new BenchmarkSuite('Match', [1000], [
+  new Benchmark('Match', false, false, 0, Match),
+]);
+
+new BenchmarkSuite('Captures', [1000], [
+  new Benchmark('Captures', false, false, 0, Captures),
+]);
+
+new BenchmarkSuite('Global', [1000], [
+  new Benchmark('Global', false, false, 0, Global),
+]);
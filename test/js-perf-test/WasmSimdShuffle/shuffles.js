@@ -0,0 +1,105 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Shuffle-heavy wasm SIMD kernels. Each kernel reads pairs of vectors from
+// the first half of memory, shuffles them with a single i8x16.shuffle and
+// writes the result to the second half, so the score mostly reflects the
+// instruction sequence chosen for the shuffle pattern.
+
+const kInputBytes = 0x8000;
+
+const kernels = {
+  // Byte swizzle of each pixel, e.g. for image format conversion.
+  RgbaToBgra: [2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15],
+  // Even 32 bit lanes of both inputs.
+  Deinterleave32: [0, 1, 2, 3, 8, 9, 10, 11, 16, 17, 18, 19, 24, 25, 26, 27],
+  // Low 64 bit lanes of both inputs.
+  Interleave64: [0, 1, 2, 3, 4, 5, 6, 7, 16, 17, 18, 19, 20, 21, 22, 23],
+  // One step of a 4x4 32 bit matrix transpose.
+  Transpose32: [0, 1, 2, 3, 16, 17, 18, 19, 8, 9, 10, 11, 24, 25, 26, 27],
+  // Sliding window over the concatenation of both inputs.
+  ByteRotate: [4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19],
+  // Odd 16 bit lanes from the second input, lanes don't move.
+  Blend16: [0, 1, 18, 19, 4, 5, 22, 23, 8, 9, 26, 27, 12, 13, 30, 31],
+  // Broadcast of the high 64 bit lane.
+  Splat64: [8, 9, 10, 11, 12, 13, 14, 15, 8, 9, 10, 11, 12, 13, 14, 15],
+  // Low half from a permutation of the first input, high half from the second.
+  Permute32: [12, 13, 14, 15, 0, 1, 2, 3, 24, 25, 26, 27, 20, 21, 22, 23],
+};
+
+function uleb(value) {
+  const bytes = [];
+  do {
+    let b = value & 0x7f;
+    value >>>= 7;
+    if (value != 0) b |= 0x80;
+    bytes.push(b);
+  } while (value != 0);
+  return bytes;
+}
+
+function string(str) {
+  return [...uleb(str.length), ...Array.from(str, c => c.charCodeAt(0))];
+}
+
+function section(id, contents) {
+  return [id, ...uleb(contents.length), ...contents];
+}
+
+// (func (param $n i32) (local $i i32)
+//   (loop
+//     (v128.store offset=0x8000 (local.get $i)
+//       (i8x16.shuffle <shuffle> (v128.load (local.get $i))
+//                                (v128.load offset=16 (local.get $i))))
+//     (br_if 0 (i32.lt_u (local.tee $i (i32.add (local.get $i)
+//                                               (i32.const 32)))
+//                        (local.get $n)))))
+function kernelBody(shuffle) {
+  const body = [
+    1, 1, 0x7f,                             // one i32 local
+    0x03, 0x40,                             // loop
+    0x20, 1,                                // local.get $i
+    0x20, 1, 0xfd, 0x00, 4, 0,              // v128.load
+    0x20, 1, 0xfd, 0x00, 4, 16,             // v128.load offset=16
+    0xfd, 0x0d, ...shuffle,                 // i8x16.shuffle
+    0xfd, 0x0b, 4, ...uleb(kInputBytes),    // v128.store offset=0x8000
+    0x20, 1, 0x41, 32, 0x6a, 0x22, 1,       // $i += 32
+    0x20, 0, 0x49, 0x0d, 0,                 // br_if 0 ($i < $n)
+    0x0b,                                   // end loop
+    0x0b                                    // end function
+  ];
+  return [...uleb(body.length), ...body];
+}
+
+function buildModule() {
+  const names = Object.keys(kernels);
+  const exports = [];
+  const bodies = [];
+  names.forEach((name, index) => {
+    exports.push(...string(name), 0, index);
+    bodies.push(...kernelBody(kernels[name]));
+  });
+  const bytes = [
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+    ...section(1, [1, 0x60, 1, 0x7f, 0]),
+    ...section(3, [...uleb(names.length), ...names.map(() => 0)]),
+    ...section(5, [1, 0, 1]),
+    ...section(7, [...uleb(names.length + 1), ...exports,
+                   ...string('memory'), 2, 0]),
+    ...section(10, [...uleb(names.length), ...bodies])
+  ];
+  return new WebAssembly.Instance(
+      new WebAssembly.Module(new Uint8Array(bytes))).exports;
+}
+
+const instance = buildModule();
+const input = new Uint8Array(instance.memory.buffer, 0, kInputBytes);
+for (let i = 0; i < input.length; ++i) input[i] = i * 7;
+
+for (const name of Object.keys(kernels)) {
+  const kernel = instance[name];
+  new BenchmarkSuite(name, [1000], [
+    new Benchmark(name, false, false, 0, () => kernel(kInputBytes)),
+  ]);
+}
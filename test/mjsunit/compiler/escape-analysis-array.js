@@ -32,3 +32,37 @@
   assertEquals("first", f(0));
   assertEquals("second", f(1));
 })();
+
+// Test constant index stores to an array literal.
+(function testArrayLiteralConstantIndexStore() {
+  function f(x) {
+    const a = [x, x];
+    a[0] = x + 1;
+    a[1] = x + 2;
+    return a[0] + a[1];
+  }
+
+  %PrepareFunctionForOptimization(f);
+  assertEquals(5, f(1));
+  assertEquals(7, f(2));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(9, f(3));
+  assertOptimized(f);
+})();
+
+// Test rematerialization of a stored-to array literal on deopt.
+(function testArrayLiteralConstantIndexStoreDeopt() {
+  function f(x, deopt) {
+    const a = [x, x];
+    a[1] = x + 1;
+    if (deopt) %DeoptimizeNow();
+    return a[0] * a[1];
+  }
+
+  %PrepareFunctionForOptimization(f);
+  assertEquals(2, f(1, false));
+  assertEquals(6, f(2, false));
+  %OptimizeFunctionOnNextCall(f);
+  assertEquals(12, f(3, false));
+  assertEquals(20, f(4, true));
+})();
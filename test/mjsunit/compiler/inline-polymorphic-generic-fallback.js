@@ -0,0 +1,50 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --polymorphic-inlining
+
+// A polymorphic call site where one of the targets is loaded from a mutable
+// field, so only the other targets are known constants.
+(function() {
+  class A { f() { return 1; } }
+  class B { f() { return 2; } }
+  const c = { f: function() { return 3; } };
+  c.f = function() { return 4; };
+
+  function call(o) { return o.f(); }
+
+  %PrepareFunctionForOptimization(call);
+  assertEquals(1, call(new A));
+  assertEquals(2, call(new B));
+  assertEquals(4, call(c));
+  %OptimizeFunctionOnNextCall(call);
+  assertEquals(1, call(new A));
+  assertEquals(2, call(new B));
+  assertEquals(4, call(c));
+  c.f = function() { return 5; };
+  assertEquals(5, call(c));
+  assertOptimized(call);
+})();
+
+// Exceptions thrown from the generic target must still be caught.
+(function() {
+  class A { f() { return 1; } }
+  const b = { f: function() { return 2; } };
+  b.f = function() { throw 42; };
+
+  function call(o) {
+    try {
+      return o.f();
+    } catch (e) {
+      return e;
+    }
+  }
+
+  %PrepareFunctionForOptimization(call);
+  assertEquals(1, call(new A));
+  assertEquals(42, call(b));
+  %OptimizeFunctionOnNextCall(call);
+  assertEquals(1, call(new A));
+  assertEquals(42, call(b));
+})();
@@ -0,0 +1,60 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --turbo-loop-variable
+// Flags: --turbo-loop-bounds-check-elimination
+
+// Bounds checks dominated by the loop condition must not deoptimize.
+(function() {
+  function sum(a) {
+    let s = 0;
+    for (let i = 0; i < a.length; i++) {
+      s += a[i];
+    }
+    return s;
+  }
+
+  %PrepareFunctionForOptimization(sum);
+  assertEquals(6, sum([1, 2, 3]));
+  assertEquals(10, sum([1, 2, 3, 4]));
+  %OptimizeFunctionOnNextCall(sum);
+  assertEquals(15, sum([1, 2, 3, 4, 5]));
+  assertEquals(0, sum([]));
+  assertOptimized(sum);
+})();
+
+// Shrinking the array inside the loop must still be observed.
+(function() {
+  function popping(a) {
+    let s = 0;
+    for (let i = 0; i < a.length; i++) {
+      if (i == 1) a.length = 1;
+      s += a[i];
+    }
+    return s;
+  }
+
+  %PrepareFunctionForOptimization(popping);
+  assertEquals(NaN, popping([1, 2, 3]));
+  assertEquals(NaN, popping([1, 2, 3]));
+  %OptimizeFunctionOnNextCall(popping);
+  assertEquals(NaN, popping([1, 2, 3]));
+})();
+
+// Loop conditions against a different length must keep the check.
+(function() {
+  function copy(a, b) {
+    for (let i = 0; i < a.length; i++) {
+      b[i] = a[i] + b[i];
+    }
+    return b;
+  }
+
+  %PrepareFunctionForOptimization(copy);
+  assertEquals([2, 4], copy([1, 2], [1, 2]));
+  assertEquals([2, 4], copy([1, 2], [1, 2]));
+  %OptimizeFunctionOnNextCall(copy);
+  assertEquals([2, 4], copy([1, 2], [1, 2]));
+  assertEquals([2, NaN], copy([1, 2], [1]));
+})();
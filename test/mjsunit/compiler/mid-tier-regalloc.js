@@ -0,0 +1,31 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --turbo-force-mid-tier-regalloc
+
+// Exercise the mid-tier register allocator on optimized JavaScript code with
+// loops, floating point values, exception handlers and deoptimization.
+function f(a, x, deopt) {
+  let sum = 0;
+  let product = 1.5;
+  for (let i = 0; i < a.length; i++) {
+    sum += a[i];
+    product *= x;
+  }
+  try {
+    if (sum > 100) throw sum;
+  } catch (e) {
+    sum = -e;
+  }
+  if (deopt) %DeoptimizeNow();
+  return sum + product;
+}
+
+%PrepareFunctionForOptimization(f);
+assertEquals(6 + 1.5 * 8, f([1, 2, 3], 2, false));
+assertEquals(6 + 1.5 * 8, f([1, 2, 3], 2, false));
+%OptimizeFunctionOnNextCall(f);
+assertEquals(6 + 1.5 * 8, f([1, 2, 3], 2, false));
+assertEquals(-200 + 1.5 * 4, f([100, 100], 2, false));
+assertEquals(6 + 1.5 * 8, f([1, 2, 3], 2, true));
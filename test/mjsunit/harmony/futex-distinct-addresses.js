@@ -0,0 +1,74 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --harmony-sharedarraybuffer
+
+// Waiters are kept in a hashed table of per-address lists. Check that
+// notifying an address only wakes the waiters on that address, also when many
+// addresses are waited on at the same time.
+
+if (this.Worker) {
+  (function TestWakeDistinctAndSharedAddresses() {
+    const kDistinctWaiters = 6;
+    const kSharedWaiters = 3;
+    const kSharedIndex = 32;
+    const kDoneIndex = 33;
+    const sab = new SharedArrayBuffer(64 * 4);
+    const i32a = new Int32Array(sab);
+
+    const workerScript =
+      `onmessage = function(msg) {
+         const i32a = new Int32Array(msg.sab);
+         const result = Atomics.wait(i32a, msg.index, 0);
+         Atomics.add(i32a, ${kDoneIndex}, 1);
+         postMessage(result);
+       };`;
+
+    // Distinct waiters wait on every other index, so that the indices in
+    // between are never waited on.
+    const workers = [];
+    for (let id = 0; id < kDistinctWaiters; id++) {
+      workers[id] = new Worker(workerScript, {type: 'string'});
+      workers[id].postMessage({sab: sab, index: id * 2});
+    }
+    for (let id = 0; id < kSharedWaiters; id++) {
+      const worker = new Worker(workerScript, {type: 'string'});
+      worker.postMessage({sab: sab, index: kSharedIndex});
+      workers.push(worker);
+    }
+
+    // Spin until all workers are waiting on the futex.
+    for (let id = 0; id < kDistinctWaiters; id++) {
+      while (%AtomicsNumWaitersForTesting(i32a, id * 2) != 1) {}
+    }
+    while (%AtomicsNumWaitersForTesting(i32a, kSharedIndex) != kSharedWaiters) {
+    }
+
+    // Nobody waits on the odd indices.
+    for (let id = 0; id < kDistinctWaiters; id++) {
+      assertEquals(0, Atomics.notify(i32a, id * 2 + 1));
+    }
+
+    // Wake the distinct waiters one by one.
+    for (let id = 0; id < kDistinctWaiters; id++) {
+      assertEquals(1, Atomics.notify(i32a, id * 2));
+      assertEquals('ok', workers[id].getMessage());
+      assertEquals(id + 1, Atomics.load(i32a, kDoneIndex));
+      assertEquals(0, %AtomicsNumWaitersForTesting(i32a, id * 2));
+      assertEquals(kSharedWaiters,
+                   %AtomicsNumWaitersForTesting(i32a, kSharedIndex));
+    }
+
+    // Wake all the shared waiters at once.
+    assertEquals(kSharedWaiters, Atomics.notify(i32a, kSharedIndex));
+    for (let id = kDistinctWaiters; id < workers.length; id++) {
+      assertEquals('ok', workers[id].getMessage());
+    }
+    assertEquals(kDistinctWaiters + kSharedWaiters,
+                 Atomics.load(i32a, kDoneIndex));
+    assertEquals(0, %AtomicsNumWaitersForTesting(i32a, kSharedIndex));
+
+    for (const worker of workers) worker.terminate();
+  })();
+}
@@ -0,0 +1,74 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --default-to-experimental-regexp-engine
+// Flags: --enable-experimental-regexp-engine
+
+// The experimental engine handles back references by tracking the captures
+// they refer to.  If there are too many different captures per input position,
+// it falls back to the backtracking engine, which must not change results.
+
+function Test(regexp, subject, expectedResult, expectedLastIndex) {
+  assertEquals("EXPERIMENTAL", %RegexpTypeTag(regexp));
+  const result = regexp.exec(subject);
+  if (result instanceof Array && expectedResult instanceof Array) {
+    assertArrayEquals(expectedResult, result);
+  } else {
+    assertEquals(expectedResult, result);
+  }
+  assertEquals(expectedLastIndex, regexp.lastIndex);
+}
+
+Test(/(a+)b\1/, "xaabaa", ["aabaa", "aa"], 0);
+Test(/(a*)b\1/, "aaba", ["aba", "a"], 0);
+Test(/(a*)b\1/, "aabx", ["b", ""], 0);
+Test(/(\w+)\s+\1/, "hello world world foo", ["world world", "world"], 0);
+Test(/(a)(b)\2\1/, "xabbay", ["abba", "a", "b"], 0);
+Test(/(a)\1\1/, "aaxaaa", ["aaa", "a"], 0);
+Test(/(ab)\1/, "abacabab", ["abab", "ab"], 0);
+Test(/(ab)\1/, "abaab", null, 0);
+
+// Back references to undefined captures match the empty string.
+Test(/(?:(a)|b)\1c/, "bc", ["bc", undefined], 0);
+Test(/\1(a)/, "a", ["a", "a"], 0);
+Test(/(?:(a)|(b))\1\2/, "bb", ["bb", undefined, "b"], 0);
+
+// Captures in quantifier bodies are reset in every iteration.
+Test(/(?:(a)|b\1)+/, "abab", ["abab", undefined], 0);
+Test(/(?:(a)\1|b)+c/, "aabaac", ["aabaac", "a"], 0);
+
+// Named back references.
+Test(/(?<x>ab)\k<x>/, "xabab", ["abab", "ab"], 0);
+
+// Global and sticky regexps.
+Test(/(\w)\1/g, "ab cc dd", ["cc", "c"], 5);
+Test(/(\w)\1/y, "ab cc dd", null, 0);
+assertEquals(["cc", "dd", "ee"], "ab cc dd ee".match(/(\w)\1/g));
+assertEquals("ab_c_d_e", "ab cc dd ee".replace(/ (\w)\1/g, "_$1"));
+
+// Two byte subjects.
+Test(/(.)\1/, "쁰섊섊쁰", ["섊섊", "섊"], 0);
+
+// Back references combined with lookarounds outside of them.
+Test(/(a+)(?=b)b\1/, "aab aaba", ["aba", "a"], 0);
+Test(/(?<!x)(a)\1/, "xaa aa", ["aa", "a"], 0);
+
+// Many different captures per input position exceed the memoization budget,
+// so these searches fall back to the backtracking engine.
+(function TestFallback() {
+  const regexp = /(a*)(a*)(a*)b\1\2\3/;
+  const as = "a".repeat(30);
+  Test(regexp, as + "b" + as, [as + "b" + as, as, "", ""], 0);
+  Test(regexp, as + "c" + as, null, 0);
+  Test(regexp, "aab", ["b", "", "", ""], 0);
+})();
+
+// Back references within lookarounds or within the group they refer to are
+// not supported.
+assertNotEquals("EXPERIMENTAL", %RegexpTypeTag(/(?=(a)\1)/));
+assertNotEquals("EXPERIMENTAL", %RegexpTypeTag(/(?<=(a)\1)b/));
+assertNotEquals("EXPERIMENTAL", %RegexpTypeTag(/(a\1)/));
+
+// The linear flag guarantees linear time, which back references don't.
+assertThrows(() => /(a)\1/l, SyntaxError);
@@ -0,0 +1,103 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --enable-experimental-regexp-engine
+// Flags: --experimental-regexp-engine-lazy-dfa
+// Flags: --experimental-regexp-engine-dfa-cache-size=1
+
+// The experimental engine finds match ends with a lazily built dfa, the small
+// cache size forces it to discard its states repeatedly on longer inputs.
+// Results must be the same as those of the backtracking engine.
+
+function Test(source, flags, subject) {
+  const linear = new RegExp(source, flags + "l");
+  const backtracking = new RegExp(source, flags);
+  assertEquals("EXPERIMENTAL", %RegexpTypeTag(linear));
+
+  assertEquals(backtracking.exec(subject), linear.exec(subject));
+  assertEquals(backtracking.lastIndex, linear.lastIndex);
+  assertEquals(subject.match(backtracking), subject.match(linear));
+  assertEquals(subject.replace(backtracking, "[$&]"),
+               subject.replace(linear, "[$&]"));
+}
+
+const subjects = [
+  "",
+  "a",
+  "abc",
+  "xxabcabcxx",
+  "aaaaaaaaab",
+  "abababababa",
+  "foo bar\nbaz qux",
+  "12ab34cd56",
+  "쁰dab섊abc",
+  "ab".repeat(200) + "c",
+  "xyz".repeat(500) + "abc" + "xyz".repeat(500),
+];
+
+const patterns = [
+  "abc",
+  "a|ab|abc",
+  "a*",
+  "a*?b",
+  "a+b",
+  "(?:ab)+",
+  "(a)(b)?",
+  "(a|ab)(c|bcd)?",
+  "((a)|(b))*",
+  "^abc",
+  "abc$",
+  "^$",
+  "^a*$",
+  "[a-c]{2,4}",
+  "[^a]+",
+  "\\d+\\w",
+  ".*c",
+  "x*y?z",
+  "(?:xyz)*abc",
+];
+
+for (const pattern of patterns) {
+  for (const subject of subjects) {
+    Test(pattern, "", subject);
+    Test(pattern, "g", subject);
+  }
+}
+
+// Sticky regexps start matching at lastIndex.
+(function TestSticky() {
+  const subject = "xxabcabc";
+  const linear = /abc/yl;
+  const backtracking = /abc/y;
+  for (let i = 0; i < subject.length; i++) {
+    linear.lastIndex = i;
+    backtracking.lastIndex = i;
+    assertEquals(backtracking.exec(subject), linear.exec(subject));
+    assertEquals(backtracking.lastIndex, linear.lastIndex);
+  }
+})();
+
+// Assertions other than ^ and $ are not handled by the dfa.
+Test("\\bab", "g", "ab cab ab");
+Test("^ab", "gm", "ab\nab\ncab");
+
+// Dfas are cached per bytecode and reused by later searches, also by other
+// regexps with the same bytecode.  More regexps than fit into the cache are
+// interleaved so that entries are evicted and built again.
+(function TestCachedDfas() {
+  const sources = ["abc", "a+b", "x*y?z", "[a-c]{2,4}", "(?:ab)+", ".*c"];
+  const subject = "xyzabcaab".repeat(50);
+  for (let round = 0; round < 3; round++) {
+    for (const source of sources) {
+      const linear = new RegExp(source, "gl");
+      const backtracking = new RegExp(source, "g");
+      let expected;
+      while ((expected = backtracking.exec(subject)) !== null) {
+        assertEquals(expected, linear.exec(subject));
+        assertEquals(backtracking.lastIndex, linear.lastIndex);
+      }
+      assertNull(linear.exec(subject));
+    }
+  }
+})();
@@ -0,0 +1,26 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --enable-experimental-regexp-engine
+
+// Global regexps on the experimental engine that produce more matches than
+// fit into one batch of the global cache, including batches that end in an
+// empty match.
+
+(function TestGlobalZeroLengthMatches() {
+  const regexp = /c*/gl;
+  assertEquals("EXPERIMENTAL", %RegexpTypeTag(regexp));
+  assertEquals("-" + "x-".repeat(200), "x".repeat(200).replace(regexp, "-"));
+  assertEquals("-" + "x-".repeat(200),
+               "x".repeat(200).replace(regexp, () => "-"));
+  assertEquals(201, "x".repeat(200).match(regexp).length);
+  assertEquals(201, [..."x".repeat(200).matchAll(regexp)].length);
+})();
+
+(function TestGlobalMixedMatches() {
+  const regexp = /a+|c*/gl;
+  const subject = "a".repeat(30) + "x".repeat(200);
+  assertEquals("--" + "x-".repeat(200), subject.replace(regexp, "-"));
+  assertEquals(202, subject.match(regexp).length);
+})();
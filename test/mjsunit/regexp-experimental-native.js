@@ -0,0 +1,141 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --enable-experimental-regexp-engine
+// Flags: --regexp-tier-up --regexp-tier-up-ticks=1 --no-regexp-interpret-all
+// Flags: --experimental-regexp-engine-native-code --no-force-slow-path
+// Flags: --regexp-backtracks-before-fallback=1000
+
+// Experimental regexps without capture groups tier up from the interpreter to
+// native code compiled from their dfa.  Results must be the same as those of
+// the backtracking engine on both tiers.
+
+const kLatin1 = true;
+const kUC16 = false;
+
+function Test(source, flags, subject) {
+  const linear = new RegExp(source, flags + "l");
+  const backtracking = new RegExp(source, flags);
+  assertEquals("EXPERIMENTAL", %RegexpTypeTag(linear));
+
+  // The first execution runs on the interpreter and marks the regexp for
+  // tier-up, the following ones run on native code.
+  for (let i = 0; i < 3; i++) {
+    linear.lastIndex = 0;
+    backtracking.lastIndex = 0;
+    assertEquals(backtracking.exec(subject), linear.exec(subject));
+    assertEquals(backtracking.lastIndex, linear.lastIndex);
+  }
+  assertTrue(%RegexpHasNativeCode(linear, kLatin1));
+  assertTrue(%RegexpHasNativeCode(linear, kUC16));
+
+  assertEquals(subject.match(backtracking), subject.match(linear));
+  assertEquals(subject.replace(backtracking, "[$&]"),
+               subject.replace(linear, "[$&]"));
+  assertEquals(subject.split(backtracking), subject.split(linear));
+  assertEquals([...subject.matchAll(new RegExp(source, "g"))],
+               [...subject.matchAll(new RegExp(source, "gl"))]);
+}
+
+const subjects = [
+  "",
+  "a",
+  "abc",
+  "xxabcabcxx",
+  "aaaaaaaaab",
+  "abababababa",
+  "foo bar\nbaz qux",
+  "12ab34cd56",
+  "쁰dab섊abc",
+  "ab".repeat(200) + "c",
+  "xyz".repeat(500) + "abc" + "xyz".repeat(500),
+];
+
+const patterns = [
+  "",
+  "abc",
+  "a|ab|abc",
+  "a*",
+  "a*?b",
+  "a+b",
+  "(?:ab)+",
+  "^",
+  "$",
+  "^abc",
+  "abc$",
+  "^$",
+  "^a*$",
+  "a*$",
+  "(?:^|b)a",
+  "(?:c|$)",
+  "[a-c]{2,4}",
+  "[^a]+",
+  "\\d+\\w",
+  ".*c",
+  "x*y?z",
+  "(?:xyz)*abc",
+  "[섊-쁰]+",
+];
+
+for (const pattern of patterns) {
+  for (const subject of subjects) {
+    Test(pattern, "", subject);
+    Test(pattern, "g", subject);
+  }
+}
+
+// Sticky regexps start matching at lastIndex.
+(function TestSticky() {
+  const subject = "xxabcabc";
+  const linear = /abc/yl;
+  const backtracking = /abc/y;
+  for (let round = 0; round < 2; round++) {
+    for (let i = 0; i < subject.length; i++) {
+      linear.lastIndex = i;
+      backtracking.lastIndex = i;
+      assertEquals(backtracking.exec(subject), linear.exec(subject));
+      assertEquals(backtracking.lastIndex, linear.lastIndex);
+    }
+  }
+  assertTrue(%RegexpHasNativeCode(linear, kLatin1));
+})();
+
+// Long subjects tier up right away.
+(function TestLongSubject() {
+  const linear = /ab+c/l;
+  assertEquals(["abbc"], linear.exec("x".repeat(2000) + "abbc"));
+  assertTrue(%RegexpHasNativeCode(linear, kLatin1));
+})();
+
+// Native code only computes the match boundaries, so regexps with capture
+// groups stay on the interpreter.
+(function TestCaptures() {
+  const linear = /(a)(b)?/l;
+  for (let i = 0; i < 3; i++) {
+    assertEquals(/(a)(b)?/.exec("xab"), linear.exec("xab"));
+  }
+  assertFalse(%RegexpHasNativeCode(linear, kLatin1));
+})();
+
+// Regexps whose dfa is too large stay on the interpreter.
+(function TestLargeDfa() {
+  const subject = "ab".repeat(50) + "a";
+  const linear = /[ab]*a[ab]{12}b/l;
+  for (let i = 0; i < 3; i++) {
+    assertEquals(/[ab]*a[ab]{12}b/.exec(subject), linear.exec(subject));
+  }
+  assertFalse(%RegexpHasNativeCode(linear, kLatin1));
+})();
+
+// Regexps that fall back to the experimental engine on excessive
+// backtracking keep their experimental data, which tiers up as well.
+(function TestFallback() {
+  const regexp = /^(?:a+)+$/;
+  const subject = "a".repeat(30) + "b";
+  for (let i = 0; i < 5; i++) {
+    assertNull(regexp.exec(subject));
+    assertEquals(["aaaa"], regexp.exec("aaaa"));
+  }
+  assertEquals("IRREGEXP", %RegexpTypeTag(regexp));
+})();
@@ -96,3 +96,51 @@ Test(/x$/m, "x\na", ["x"], 0);
 
 // The dotall flag.
 Test(/asdf.xyz/s,  "asdf\nxyz", ["asdf\nxyz"], 0);
+
+// Lookarounds.
+Test(/a(?=b)/, "aaab", ["a"], 0);
+Test(/a(?!b)/, "abac", ["a"], 0);
+Test(/(?<=b)a/, "aaba", ["a"], 0);
+Test(/(?<!b)a/, "baa", ["a"], 0);
+Test(/\d+(?=px)/, "12em 34px", ["34"], 0);
+Test(/(?<=\$)\d+/, "12 $34", ["34"], 0);
+Test(/(?<!\$)\b\d+/, "$12 34", ["34"], 0);
+Test(/(?<=ab)c/, "abc", ["c"], 0);
+Test(/a(?=b)/g, "aaab", ["a"], 3);
+// Assertions and quantifiers in lookarounds.
+Test(/a(?=bc$)/m, "abd\nabc", ["a"], 0);
+Test(/(?<=^|,)\w+/, "x,yz", ["x"], 0);
+Test(/x(?=.*y)/s, "x\nz\ny", ["x"], 0);
+// Nested lookarounds.
+Test(/(?=(?<=a)b)\w/, "cbab", ["b"], 0);
+Test(/(?<=(?=b)\w)c/, "acbc", ["c"], 0);
+// Lookarounds in quantifiers.
+Test(/(?:a(?=b)|\w)+/, "cabx", ["cabx"], 0);
+Test(/(?:(?!x).)*/, "abcxd", ["abc"], 0);
+Test(/(?:(?=a)\w){2}/, "baab", ["aa"], 0);
+// Captures in negative lookarounds never participate in a match.
+Test(/(a)(?!(b))/, "aba", ["a", "a", undefined], 0);
+Test(/(?<!(b))(a)/, "ba a", ["a", undefined, "a"], 0);
+// Captures in positive lookarounds are not supported.
+assertNotEquals("EXPERIMENTAL", %RegexpTypeTag(/(?=(a))a/));
+assertNotEquals("EXPERIMENTAL", %RegexpTypeTag(/(?<=(a))b/));
+
+// Exec loops and global regexps with more matches than fit into one batch
+// run the same regexp with lookarounds repeatedly on the same subject.
+(function TestLookaroundsInLoops() {
+  const subject = "12px 3em 45pt; ".repeat(1000);
+  const regexp = /(?<![\d.])\d+(?=px)/g;
+  assertEquals(%RegexpTypeTag(regexp), "EXPERIMENTAL");
+  let count = 0;
+  let match;
+  while ((match = regexp.exec(subject)) !== null) {
+    assertEquals("12", match[0]);
+    assertEquals(count * 15, match.index);
+    if (count == 500) %CollectGarbage("clear lookaround cache");
+    count++;
+  }
+  assertEquals(1000, count);
+  assertEquals(1000, [...subject.matchAll(regexp)].length);
+  assertEquals(1000, subject.match(regexp).length);
+  assertEquals(null, "3em ".repeat(1000).match(/\d+(?!em)/g));
+})();
@@ -35,3 +35,10 @@ assertArrayEquals([match], regexp.exec(subject));
 regexp = %NewRegExpWithBacktrackLimit(regexp.source + "(?=a)", "", 100)
 assertEquals(null, regexp.exec(subject));
 assertEquals(null, regexp.exec(subject));
+
+// Regexps with back references fall back to the experimental engine, too.
+regexp = /^(a+)+\1x$/;
+subject = "a".repeat(30) + "y";
+assertEquals(null, regexp.exec(subject));
+assertEquals(null, regexp.exec(subject));
+assertArrayEquals(["aaaax", "a"], regexp.exec("aaaax"));
@@ -0,0 +1,149 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --regexp-prefilter --allow-natives-syntax
+// Flags: --enable-experimental-regexp-engine
+
+// Regexps all of whose matches start with one of a few literals skip to the
+// next occurrence of a literal before running the matcher.  Results must be
+// the same as for the equivalent regexp without a prefilter, which the
+// trailing empty alternative that never matches prevents.
+
+function Test(source, flags, subject) {
+  const prefiltered = new RegExp(source, flags);
+  const plain = new RegExp("(?:" + source + ")|(?!)", flags);
+
+  assertEquals(plain.exec(subject), prefiltered.exec(subject));
+  assertEquals(plain.lastIndex, prefiltered.lastIndex);
+  assertEquals(subject.match(plain), subject.match(prefiltered));
+  assertEquals(subject.replace(plain, "[$&]"),
+               subject.replace(prefiltered, "[$&]"));
+  assertEquals(subject.split(plain), subject.split(prefiltered));
+
+  const step = Math.max(1, Math.floor(subject.length / 20));
+  for (let i = 0; i <= subject.length + 1; i += step) {
+    plain.lastIndex = i;
+    prefiltered.lastIndex = i;
+    assertEquals(plain.exec(subject), prefiltered.exec(subject));
+    assertEquals(plain.lastIndex, prefiltered.lastIndex);
+  }
+}
+
+const log = [
+  "GET /api/users 200",
+  "POST /api/login 401",
+  "put /api/users/7 500",
+  "DELETE /index.html 404",
+  "Error: timeout after 30s",
+  "error: 12 retries",
+].join("\n");
+
+const subjects = [
+  "",
+  "GET",
+  log,
+  log.repeat(20),
+  "ሴ" + log + "ሴ",
+  // A sliced two-byte string.
+  ("ሴ".repeat(20) + log).substring(10),
+  "x".repeat(1000) + "POST /api" + "x".repeat(1000),
+];
+
+const patterns = [
+  "GET",
+  "(GET|POST|PUT) \\/api",
+  "(?:GET|POST|PUT|DELETE) \\/(\\w+)",
+  "error: (\\d+)",
+  "[Ee]rror",
+  "\\d+ retries",
+  "a*b",
+  "\\bapi\\b",
+  "(?<=\\/)api",
+  "^GET",
+  "\\d{3}$",
+  "abcdefghijklmnop",
+  "ሴG",
+];
+
+for (const pattern of patterns) {
+  for (const subject of subjects) {
+    for (const flags of ["", "g", "i", "gi", "m", "gm", "u", "gu"]) {
+      Test(pattern, flags, subject);
+    }
+  }
+}
+
+// Matches that start with a surrogate pair are found when starting at the
+// trail surrogate.
+(function TestSurrogatePairs() {
+  Test("\\u{1f600}a", "gu", "x\u{1f600}a\u{1f600}a");
+  Test("[\\u{1f600}b]a", "gu", "ba\u{1f600}a");
+})();
+
+// The experimental engine applies the prefilter before each match in
+// NfaInterpreter::FindNextMatch.  Its results must be the same as those of
+// irregexp without a prefilter.
+function TestLinear(source, flags, subject) {
+  const linear = new RegExp(source, flags + "l");
+  const plain = new RegExp("(?:" + source + ")|(?!)", flags);
+  assertEquals("EXPERIMENTAL", %RegexpTypeTag(linear));
+
+  assertEquals(plain.exec(subject), linear.exec(subject));
+  assertEquals(plain.lastIndex, linear.lastIndex);
+  assertEquals(subject.match(plain), subject.match(linear));
+  assertEquals(subject.replace(plain, "[$&]"),
+               subject.replace(linear, "[$&]"));
+
+  const step = Math.max(1, Math.floor(subject.length / 20));
+  for (let i = 0; i <= subject.length + 1; i += step) {
+    plain.lastIndex = i;
+    linear.lastIndex = i;
+    assertEquals(plain.exec(subject), linear.exec(subject));
+    assertEquals(plain.lastIndex, linear.lastIndex);
+  }
+}
+
+const linearPatterns = [
+  "GET",
+  "(GET|POST|PUT) \\/api",
+  "(?:GET|POST|PUT|DELETE) \\/(\\w+)",
+  "error: (\\d+)",
+  "[Ee]rror",
+  "\\d+ retries",
+  "^GET",
+  "\\d{3}$",
+  "abcdefghijklmnop",
+  "ሴG",
+];
+
+for (const pattern of linearPatterns) {
+  for (const subject of subjects) {
+    for (const flags of ["", "g", "m", "gm"]) {
+      TestLinear(pattern, flags, subject);
+    }
+  }
+}
+
+(function TestLinearNoMatch() {
+  // None of the literals occurs.
+  TestLinear("(GET|POST) \\/api", "g", "x".repeat(1000));
+  assertEquals(null, /(GET|POST) \/api/l.exec("x".repeat(1000)));
+  // The literals occur, but the rest of the pattern never matches.
+  TestLinear("(GET|POST) \\/api", "g", "GET /x POST /y ".repeat(100));
+  assertEquals(null, /(GET|POST) \/api/gl.exec("GET /x POST /y ".repeat(100)));
+})();
+
+(function TestLinearSeveralCandidates() {
+  // Many candidates are rejected by the matcher before the real matches.
+  const subject = "GET /x POST /y ".repeat(100) + "POST /api GET /api";
+  TestLinear("(GET|POST) \\/api", "", subject);
+  TestLinear("(GET|POST) \\/api", "g", subject);
+  const regexp = /(GET|POST) \/api/gl;
+  assertEquals(["POST /api", "POST"], regexp.exec(subject));
+  assertEquals(subject.length - "GET /api".length - 1, regexp.lastIndex);
+  assertEquals(["GET /api", "GET"], regexp.exec(subject));
+  assertEquals(subject.length, regexp.lastIndex);
+  assertEquals(null, regexp.exec(subject));
+  assertEquals(0, regexp.lastIndex);
+})();
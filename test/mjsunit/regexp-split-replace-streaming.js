@@ -0,0 +1,99 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Global replaces with a string and splits by unmodified regexps iterate over
+// the matches in the runtime and write their results directly.  Compare them
+// with the generic implementations, which a regexp with an own exec property
+// is routed to.
+
+function Slow(regexp) {
+  const slow = new RegExp(regexp.source, regexp.flags);
+  slow.exec = RegExp.prototype.exec;
+  return slow;
+}
+
+function LastMatch() {
+  return [RegExp.lastMatch, RegExp.leftContext, RegExp.$1, RegExp.$2];
+}
+
+function TestReplace(regexp, subject, replacement) {
+  "x".match(/x/);
+  const expected = subject.replace(Slow(regexp), replacement);
+  const expected_last_match = LastMatch();
+  "x".match(/x/);
+  assertEquals(expected, subject.replace(regexp, replacement));
+  assertEquals(expected_last_match, LastMatch());
+}
+
+function TestSplit(regexp, subject, limit) {
+  "x".match(/x/);
+  const expected = subject.split(Slow(regexp), limit);
+  const expected_last_match = LastMatch();
+  "x".match(/x/);
+  assertEquals(expected, subject.split(regexp, limit));
+  assertEquals(expected_last_match, LastMatch());
+}
+
+const subjects = [
+  "",
+  "a",
+  "{{name}} is {{ age }} years old",
+  "a, b,c ,, d,",
+  "aaa bbb aaa",
+  "ሴ{{x}}ሴ, ሴ",
+  "\u{1f600}a\u{1f600}",
+  "{{x}}".repeat(500),
+];
+
+const regexps = [
+  /{{\s*(\w+)\s*}}/g,
+  /\s*,\s*/g,
+  /(a)|(b)/g,
+  /x*/g,
+  /(?:)/g,
+  /$/g,
+  /a/g,
+  /\u{1f600}|/gu,
+  /(?<word>\w+)/g,
+];
+
+const replacements = [
+  "", "-", "[$&]", "$1", "$2$1", "$`|$'", "$$", "<$<word>>", "ሴ$1",
+];
+
+for (const regexp of regexps) {
+  for (const subject of subjects) {
+    for (const replacement of replacements) {
+      TestReplace(regexp, subject, replacement);
+    }
+  }
+}
+
+for (const regexp of regexps) {
+  const non_global = new RegExp(regexp.source, regexp.flags.replace("g", ""));
+  for (const subject of subjects) {
+    for (const limit of [undefined, 1, 2, 3, 7]) {
+      TestSplit(regexp, subject, limit);
+      TestSplit(non_global, subject, limit);
+    }
+  }
+}
+
+(function TestSplitResults() {
+  assertEquals(["a", "b", "c", "", "d", ""], "a, b,c ,, d,".split(/\s*,\s*/));
+  assertEquals(["a", "b", "c"], "abc".split(/x*/));
+  assertEquals(["", "a", undefined, " ", undefined, "b", ""],
+               "a b".split(/(a)|(b)/));
+  assertEquals(["", "a", undefined], "a b".split(/(a)|(b)/, 3));
+  assertEquals(["\u{1f600}", "a", "\u{1f600}"],
+               "\u{1f600}a\u{1f600}".split(/(?:)/u));
+})();
+
+(function TestReplaceResults() {
+  assertEquals("<name> is <age> years old",
+               "{{name}} is {{ age }} years old".replace(
+                   /{{\s*(\w+)\s*}}/g, "<$1>"));
+  assertEquals("[a][b]", "ab".replace(/(?<c>.)/g, "[$<c>]"));
+  assertEquals("ሴaሴb", "ab".replace(/(.)/g, "ሴ$1"));
+})();
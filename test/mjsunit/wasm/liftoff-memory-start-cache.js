@@ -0,0 +1,98 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --liftoff --no-wasm-tier-up
+
+load('test/mjsunit/wasm/wasm-module-builder.js');
+
+// Liftoff keeps the memory start in a register across memory accesses, merges
+// and loops. Check that the cached value is dropped when the memory can move.
+
+(function testMemoryAccessesInLoop() {
+  print(arguments.callee.name);
+  const builder = new WasmModuleBuilder();
+  builder.addMemory(1, 10, true);
+  builder.addFunction('fill', kSig_i_i)
+      .addLocals(kWasmI32, 2)
+      .addBody([
+        kExprLoop, kWasmStmt,
+          // mem[i * 4] = i
+          kExprLocalGet, 1, kExprI32Const, 2, kExprI32Shl,
+          kExprLocalGet, 1,
+          kExprI32StoreMem, 2, 0,
+          // sum += mem[i * 4]
+          kExprLocalGet, 2,
+          kExprLocalGet, 1, kExprI32Const, 2, kExprI32Shl,
+          kExprI32LoadMem, 2, 0,
+          kExprI32Add,
+          kExprLocalSet, 2,
+          // if (++i < n) continue
+          kExprLocalGet, 1, kExprI32Const, 1, kExprI32Add,
+          kExprLocalTee, 1,
+          kExprLocalGet, 0,
+          kExprI32LtU,
+          kExprBrIf, 0,
+        kExprEnd,
+        kExprLocalGet, 2
+      ])
+      .exportFunc();
+  const instance = builder.instantiate();
+  assertTrue(%IsLiftoffFunction(instance.exports.fill));
+  assertEquals(0, instance.exports.fill(1));
+  assertEquals(45, instance.exports.fill(10));
+  assertEquals(499500, instance.exports.fill(1000));
+})();
+
+(function testMemoryGrowInLoop() {
+  print(arguments.callee.name);
+  const builder = new WasmModuleBuilder();
+  const grow_index = builder.addImport('m', 'grow', kSig_v_v);
+  builder.addImportedMemory('m', 'memory', 1, 100);
+  builder.addFunction('store_and_grow', kSig_i_i)
+      .addLocals(kWasmI32, 1)
+      .addBody([
+        kExprLoop, kWasmStmt,
+          // mem[i * 4] = i
+          kExprLocalGet, 1, kExprI32Const, 2, kExprI32Shl,
+          kExprLocalGet, 1,
+          kExprI32StoreMem, 2, 0,
+          // Grow the memory from JS in every odd iteration.
+          kExprLocalGet, 1, kExprI32Const, 1, kExprI32And,
+          kExprIf, kWasmStmt,
+            kExprCallFunction, grow_index,
+          kExprEnd,
+          // if (++i < n) continue
+          kExprLocalGet, 1, kExprI32Const, 1, kExprI32Add,
+          kExprLocalTee, 1,
+          kExprLocalGet, 0,
+          kExprI32LtU,
+          kExprBrIf, 0,
+        kExprEnd,
+        // return mem[(n - 1) * 4]
+        kExprLocalGet, 0, kExprI32Const, 1, kExprI32Sub,
+        kExprI32Const, 2, kExprI32Shl,
+        kExprI32LoadMem, 2, 0
+      ])
+      .exportFunc();
+  builder.addFunction('grow_and_load', kSig_i_i)
+      .addBody([
+        kExprLocalGet, 0, kExprI32LoadMem, 2, 0,
+        kExprDrop,
+        kExprI32Const, 1, kExprMemoryGrow, kMemoryZero,
+        kExprDrop,
+        kExprLocalGet, 0, kExprI32LoadMem, 2, 0
+      ])
+      .exportFunc();
+
+  const memory = new WebAssembly.Memory({initial: 1, maximum: 100});
+  const instance =
+      builder.instantiate({m: {memory: memory, grow: () => memory.grow(1)}});
+  assertTrue(%IsLiftoffFunction(instance.exports.store_and_grow));
+  assertEquals(9, instance.exports.store_and_grow(10));
+  const view = new Int32Array(memory.buffer);
+  for (let i = 0; i < 10; ++i) assertEquals(i, view[i]);
+
+  view[3] = 17;
+  assertEquals(17, instance.exports.grow_and_load(12));
+})();
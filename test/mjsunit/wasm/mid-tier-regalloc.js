@@ -0,0 +1,67 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --no-liftoff --no-wasm-tier-up
+// Flags: --turbo-mid-tier-regalloc-threshold=100
+
+// The functions below have far more than 100 virtual registers, so TurboFan
+// allocates their registers with the mid-tier allocator.
+
+load('test/mjsunit/wasm/wasm-module-builder.js');
+
+const kNumTerms = 300;
+
+// Pushes x * 1, x * 2, ..., x * kNumTerms and then adds them all up, which
+// keeps every product live at once and forces spills.
+function sumOfMultiples(local_index) {
+  const body = [];
+  for (let k = 1; k <= kNumTerms; ++k) {
+    body.push(kExprLocalGet, local_index, ...wasmI32Const(k), kExprI32Mul);
+  }
+  for (let k = 1; k < kNumTerms; ++k) body.push(kExprI32Add);
+  return body;
+}
+
+function expectedSum(x) {
+  return Math.imul(x, kNumTerms * (kNumTerms + 1) / 2);
+}
+
+const builder = new WasmModuleBuilder();
+builder.addFunction('straight', kSig_i_i)
+    .addBody(sumOfMultiples(0))
+    .exportFunc();
+// loop(x, n) adds up sumOfMultiples(x), sumOfMultiples(x + 1), ... for n
+// iterations.
+builder.addFunction('loop', kSig_i_ii)
+    .addLocals(kWasmI32, 1)
+    .addBody([
+      kExprLoop, kWasmStmt,
+        kExprLocalGet, 2,
+        ...sumOfMultiples(0),
+        kExprI32Add,
+        kExprLocalSet, 2,
+        kExprLocalGet, 0, kExprI32Const, 1, kExprI32Add, kExprLocalSet, 0,
+        kExprLocalGet, 1, kExprI32Const, 1, kExprI32Sub, kExprLocalTee, 1,
+        kExprBrIf, 0,
+      kExprEnd,
+      kExprLocalGet, 2
+    ])
+    .exportFunc();
+const instance = builder.instantiate();
+
+assertFalse(%IsLiftoffFunction(instance.exports.straight));
+assertFalse(%IsLiftoffFunction(instance.exports.loop));
+
+for (const x of [0, 1, -7, 123456, 0x7fffffff]) {
+  assertEquals(expectedSum(x), instance.exports.straight(x));
+}
+
+function expectedLoop(x, n) {
+  let acc = 0;
+  for (let i = 0; i < n; ++i) acc = (acc + expectedSum(x + i)) | 0;
+  return acc;
+}
+for (const [x, n] of [[0, 1], [3, 10], [-50, 100], [0x7ffffff0, 32]]) {
+  assertEquals(expectedLoop(x, n), instance.exports.loop(x, n));
+}
@@ -0,0 +1,36 @@
+// Copyright 2021 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --allow-natives-syntax --wasm-dynamic-tiering --liftoff
+// Flags: --wasm-tier-up --wasm-tiering-budget=16 --no-stress-opt
+
+load('test/mjsunit/wasm/wasm-module-builder.js');
+
+const builder = new WasmModuleBuilder();
+builder.addFunction('hot', kSig_i_i)
+    .addBody([kExprLocalGet, 0, kExprI32Const, 1, kExprI32Add])
+    .exportFunc();
+builder.addFunction('cold', kSig_i_i)
+    .addBody([kExprLocalGet, 0, kExprI32Const, 2, kExprI32Add])
+    .exportFunc();
+
+const instance = builder.instantiate();
+const hot = instance.exports.hot;
+const cold = instance.exports.cold;
+
+// Functions stay in Liftoff until they reach the tiering budget.
+for (let i = 0; i < 15; ++i) assertEquals(i + 1, hot(i));
+assertEquals(2, cold(0));
+assertTrue(%IsLiftoffFunction(hot));
+assertTrue(%IsLiftoffFunction(cold));
+
+// The 16th call triggers tier-up of {hot} only.
+assertEquals(16, hot(15));
+while (%IsLiftoffFunction(hot)) {
+  assertEquals(17, hot(16));
+}
+
+// No eager TurboFan compilation happened for the cold function.
+assertTrue(%IsLiftoffFunction(cold));
+assertEquals(3, cold(1));
@@ -493,5 +493,39 @@ TEST(UnicodeTest, IncrementalUTF8DecodingVsNonIncrementalUtf8Decoding) {
   }
 }
 
+TEST(UnicodeTest, Utf8DecoderBlocks) {
+  // Mix ASCII runs, which are checked in blocks, with well-formed and
+  // ill-formed sequences at and around the block boundaries.
+  const std::vector<std::vector<byte>> pieces = {
+      {'a'},
+      {0xC3, 0xA9},              // U+00E9
+      {0xE2, 0x82, 0xAC},        // U+20AC
+      {0xF0, 0x9F, 0x98, 0x80},  // U+1F600
+      {0xED, 0xA0, 0x80},        // Surrogate.
+      {0xE0, 0x80, 0xAF},        // Overlong.
+      {0xF4, 0x90, 0x80, 0x80},  // Above U+10FFFF.
+      {0xE2, 0x82},              // Incomplete.
+      {0x80},                    // Lone continuation byte.
+  };
+  for (const auto& piece : pieces) {
+    for (int prefix = kUtf8BlockSize - 4; prefix <= kUtf8BlockSize + 4;
+         prefix++) {
+      std::vector<byte> bytes(prefix, 'x');
+      bytes.insert(bytes.end(), piece.begin(), piece.end());
+      bytes.insert(bytes.end(), kUtf8BlockSize * 2, 'y');
+      bytes.insert(bytes.end(), piece.begin(), piece.end());
+
+      std::vector<unibrow::uchar> output_incremental;
+      DecodeIncrementally(bytes, &output_incremental);
+      std::vector<unibrow::uchar> output_utf16;
+      DecodeUtf16(bytes, &output_utf16);
+      CHECK_EQ(output_incremental.size(), output_utf16.size());
+      for (size_t i = 0; i < output_utf16.size(); ++i) {
+        CHECK_EQ(output_incremental[i], output_utf16[i]);
+      }
+    }
+  }
+}
+
 }  // namespace internal
 }  // namespace v8
@@ -5020,6 +5020,54 @@ TEST_P(FunctionBodyDecoderTestOnBothMemoryTypes, 64BitOffset) {
 #undef ZERO_FOR_TYPE
 }
 
+TEST_P(FunctionBodyDecoderTestOnBothMemoryTypes, MemorySizeAndGrow) {
+  builder.InitializeMemory(GetParam());
+  // memory.size and memory.grow use the index type of the memory.
+  Validate(!is_memory64(), sigs.i_v(), {WASM_MEMORY_SIZE});
+  Validate(is_memory64(), sigs.l_v(), {WASM_MEMORY_SIZE});
+  Validate(!is_memory64(), sigs.i_v(), {WASM_GROW_MEMORY(WASM_ZERO)});
+  Validate(is_memory64(), sigs.l_v(), {WASM_GROW_MEMORY(WASM_ZERO64)});
+  Validate(false, sigs.l_v(), {WASM_GROW_MEMORY(WASM_ZERO)});
+  Validate(false, sigs.i_v(), {WASM_GROW_MEMORY(WASM_ZERO64)});
+}
+
+TEST_P(FunctionBodyDecoderTestOnBothMemoryTypes, BulkMemoryIndexTypes) {
+  WASM_FEATURE_SCOPE(bulk_memory);
+  builder.InitializeMemory(GetParam());
+  builder.SetDataSegmentCount(1);
+  // Addresses and sizes use the index type of the memory. The offset and size
+  // within the data segment of memory.init are always i32.
+  Validate(!is_memory64(), sigs.v_v(),
+           {WASM_MEMORY_INIT(0, WASM_ZERO, WASM_ZERO, WASM_ZERO)});
+  Validate(is_memory64(), sigs.v_v(),
+           {WASM_MEMORY_INIT(0, WASM_ZERO64, WASM_ZERO, WASM_ZERO)});
+  Validate(!is_memory64(), sigs.v_v(),
+           {WASM_MEMORY_COPY(WASM_ZERO, WASM_ZERO, WASM_ZERO)});
+  Validate(is_memory64(), sigs.v_v(),
+           {WASM_MEMORY_COPY(WASM_ZERO64, WASM_ZERO64, WASM_ZERO64)});
+  Validate(!is_memory64(), sigs.v_v(),
+           {WASM_MEMORY_FILL(WASM_ZERO, WASM_ZERO, WASM_ZERO)});
+  Validate(is_memory64(), sigs.v_v(),
+           {WASM_MEMORY_FILL(WASM_ZERO64, WASM_ZERO, WASM_ZERO64)});
+}
+
+TEST_P(FunctionBodyDecoderTestOnBothMemoryTypes, AtomicIndexTypes) {
+  WASM_FEATURE_SCOPE(threads);
+  builder.InitializeMemory(GetParam());
+  Validate(!is_memory64(), sigs.i_v(),
+           {WASM_ATOMICS_LOAD_OP(kExprI32AtomicLoad, WASM_ZERO,
+                                 MachineRepresentation::kWord32)});
+  Validate(is_memory64(), sigs.i_v(),
+           {WASM_ATOMICS_LOAD_OP(kExprI32AtomicLoad, WASM_ZERO64,
+                                 MachineRepresentation::kWord32)});
+  Validate(!is_memory64(), sigs.i_v(),
+           {WASM_ATOMICS_BINOP(kExprI32AtomicAdd, WASM_ZERO, WASM_ZERO,
+                               MachineRepresentation::kWord32)});
+  Validate(is_memory64(), sigs.i_v(),
+           {WASM_ATOMICS_BINOP(kExprI32AtomicAdd, WASM_ZERO64, WASM_ZERO,
+                               MachineRepresentation::kWord32)});
+}
+
 #undef B1
 #undef B2
 #undef B3
@@ -74,6 +74,38 @@ TEST_F(Memory64DecodingTest, MemoryLimitLEB64) {
   // supported.
 }
 
+TEST_F(Memory64DecodingTest, MemoryLimitAboveMemory32Limit) {
+  // 128Ki pages (8GiB) exceed the limit for 32-bit memories, but are within
+  // the engine limit for memory64.
+  ModuleResult result =
+      DecodeModule({SECTION(Memory, ENTRY_COUNT(1), kMemory64WithMaximum,
+                            U32V_3(0), U32V_3(0x20000))});
+  EXPECT_OK(result);
+  EXPECT_EQ(0x20000u, result.value()->maximum_pages);
+
+  result = DecodeModule({SECTION(Memory, ENTRY_COUNT(1), kMemory64NoMaximum,
+                                 U32V_3(kV8MaxWasmMemory64Pages + 1))});
+  EXPECT_FALSE(result.ok());
+}
+
+TEST_F(Memory64DecodingTest, DataSegmentOffsetType) {
+  // Active data segments of a memory64 memory take an i64 offset.
+  ModuleResult result = DecodeModule(
+      {SECTION(Memory, ENTRY_COUNT(1), kMemory64NoMaximum, U32V_1(1)),
+       SECTION(Data, ENTRY_COUNT(1), 0 /* memory index */, kExprI64Const,
+               U64V_1(8), kExprEnd, U32V_1(3), 'a', 'b', 'c')});
+  EXPECT_OK(result);
+  ASSERT_EQ(1u, result.value()->data_segments.size());
+  EXPECT_EQ(WasmInitExpr::kI64Const,
+            result.value()->data_segments[0].dest_addr.kind());
+
+  result = DecodeModule(
+      {SECTION(Memory, ENTRY_COUNT(1), kMemory64NoMaximum, U32V_1(1)),
+       SECTION(Data, ENTRY_COUNT(1), 0 /* memory index */, kExprI32Const,
+               U32V_1(8), kExprEnd, U32V_1(3), 'a', 'b', 'c')});
+  EXPECT_FALSE(result.ok());
+}
+
 }  // namespace module_decoder_unittest
 }  // namespace wasm
 }  // namespace internal
@@ -38,6 +38,10 @@ class SimdShuffleTest : public ::testing::Test {
   static bool TryMatchSplat(const Shuffle& shuffle, int* index) {
     return SimdShuffle::TryMatchSplat<LANES>(&shuffle[0], index);
   }
+  static bool TryMatch64x2Shuffle(const Shuffle& shuffle,
+                                  uint8_t* shuffle64x2) {
+    return SimdShuffle::TryMatch64x2Shuffle(&shuffle[0], shuffle64x2);
+  }
   static bool TryMatch32x4Shuffle(const Shuffle& shuffle,
                                   uint8_t* shuffle32x4) {
     return SimdShuffle::TryMatch32x4Shuffle(&shuffle[0], shuffle32x4);
@@ -199,6 +203,24 @@ TEST_F(SimdShuffleTest, TryMatchConcat) {
       {{0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3}}, &offset));
 }
 
+TEST_F(SimdShuffleTest, TryMatch64x2Shuffle) {
+  uint8_t shuffle64x2[2];
+  // Match if each group of 8 bytes is from the same 64 bit lane.
+  EXPECT_TRUE(TryMatch64x2Shuffle(
+      {{8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23}},
+      shuffle64x2));
+  EXPECT_EQ(1, shuffle64x2[0]);
+  EXPECT_EQ(2, shuffle64x2[1]);
+  // Bytes must be in order in the 64 bit lane.
+  EXPECT_FALSE(TryMatch64x2Shuffle(
+      {{8, 9, 10, 11, 12, 13, 15, 14, 16, 17, 18, 19, 20, 21, 22, 23}},
+      shuffle64x2));
+  // Each group must start with the first byte in the 64 bit lane.
+  EXPECT_FALSE(TryMatch64x2Shuffle(
+      {{4, 5, 6, 7, 8, 9, 10, 11, 16, 17, 18, 19, 20, 21, 22, 23}},
+      shuffle64x2));
+}
+
 TEST_F(SimdShuffleTest, TryMatch32x4Shuffle) {
   uint8_t shuffle32x4[4];
   // Match if each group of 4 bytes is from the same 32 bit lane.
@@ -255,6 +277,19 @@ TEST_F(SimdShuffleTest, TryMatchBlend) {
       {{1, 17, 2, 19, 4, 21, 6, 23, 8, 25, 10, 27, 12, 29, 14, 31}}));
 }
 
+TEST(SimdShuffleMatchTest, TryMatchShufps) {
+  // Lanes 0 and 1 from the first input, lanes 2 and 3 from the second.
+  uint8_t unzip[4]{0, 2, 4, 6};
+  EXPECT_TRUE(SimdShuffle::TryMatchShufps(unzip));
+  uint8_t permute[4]{3, 3, 7, 5};
+  EXPECT_TRUE(SimdShuffle::TryMatchShufps(permute));
+  // Interleaved inputs can't be done with a single shufps.
+  uint8_t zip[4]{0, 4, 1, 5};
+  EXPECT_FALSE(SimdShuffle::TryMatchShufps(zip));
+  uint8_t high_from_first[4]{0, 4, 5, 3};
+  EXPECT_FALSE(SimdShuffle::TryMatchShufps(high_from_first));
+}
+
 TEST(SimdShufflePackTest, PackShuffle4) {
   uint8_t arr[4]{0b0001, 0b0010, 0b0100, 0b1000};
   EXPECT_EQ(0b00001001, SimdShuffle::PackShuffle4(arr));
@@ -150,6 +150,26 @@ TEST_F(DisjointAllocationPoolTest, MergingSkipLargerSrcWithGap) {
   CheckPool(a, {{10, 5}, {20, 15}, {36, 4}});
 }
 
+TEST_F(DisjointAllocationPoolTest, Overlaps) {
+  DisjointAllocationPool a = Make({{10, 5}, {20, 5}});
+  CHECK(!a.Overlaps({0, 10}));
+  CHECK(a.Overlaps({0, 11}));
+  CHECK(a.Overlaps({12, 1}));
+  CHECK(a.Overlaps({14, 10}));
+  CHECK(!a.Overlaps({15, 5}));
+  CHECK(a.Overlaps({24, 1}));
+  CHECK(!a.Overlaps({25, 10}));
+  CHECK(!a.Overlaps({12, 0}));
+}
+
+TEST_F(DisjointAllocationPoolTest, ExtractFromMiddle) {
+  // Freed code regions are removed from the middle of the allocated code
+  // space.
+  DisjointAllocationPool a = Make({{10, 20}});
+  CheckRange(a.AllocateInRegion(5, {15, 5}), {15, 5});
+  CheckPool(a, {{10, 5}, {20, 10}});
+}
+
 }  // namespace wasm_heap_unittest
 }  // namespace wasm
 }  // namespace internal